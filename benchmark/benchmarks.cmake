@@ -0,0 +1,14 @@
+cmake_minimum_required(VERSION 3.0)
+
+message(STATUS "Including benchmarks dependencies...")
+
+find_package(benchmark QUIET)
+find_library(BENCHMARK_LIB benchmark)
+
+if(benchmark_FOUND OR BENCHMARK_LIB)
+    message(STATUS "Google Benchmark found: ${BENCHMARK_LIB}")
+    set(BENCHMARK_FOUND TRUE)
+else()
+    message(STATUS "Google Benchmark not found, benchmarks are not built")
+    set(BENCHMARK_FOUND FALSE)
+endif()
@@ -0,0 +1,97 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// Measured project's headers
+#include <stp/bpdu.hpp>
+#include <stp/logger.hpp>
+#include <stp/mac.hpp>
+#include <stp/port.hpp>
+#include <stp/system.hpp>
+
+// C++ Standard Library
+#include <string>
+
+namespace BenchBridge {
+
+using namespace Stp;
+
+/**
+ * @brief The NullOutInterface class drops everything sent by the bridge and counts BPDUs
+ */
+class NullOutInterface final : public OutInterface {
+public:
+    Result FlushFdb(const u16) noexcept override { return Result::Success; }
+    Result SetForwarding(const u16, const bool) noexcept override { return Result::Success; }
+    Result SetLearning(const u16, const bool) noexcept override { return Result::Success; }
+    Result SendOutBpdu(const u16, ByteStreamH) noexcept override {
+        ++TxBpdus;
+        return Result::Success;
+    }
+
+    u64 TxBpdus = 0;
+};
+
+class NullLogger final : public LoggingSystem::Logger {
+public:
+    void operator<<(std::string&&) noexcept override {}
+};
+
+inline Bpdu::BridgeSystemIdHandler MacData(const u64 address) noexcept {
+    return Bpdu::BridgeSystemIdHandler{{
+            static_cast<u8>(address >> 40), static_cast<u8>(address >> 32),
+            static_cast<u8>(address >> 24), static_cast<u8>(address >> 16),
+            static_cast<u8>(address >> 8), static_cast<u8>(address) }};
+}
+
+inline Mac MacAddress(const u64 address) noexcept {
+    return Mac{ MacData(address) };
+}
+
+inline Bpdu::BridgeIdHandler BridgeIdData(const u16 priority, const u64 address) noexcept {
+    return Bpdu::BridgeIdHandler{{ static_cast<u8>(priority >> 8), static_cast<u8>(priority),
+                                   static_cast<u8>(address >> 40), static_cast<u8>(address >> 32),
+                                   static_cast<u8>(address >> 24), static_cast<u8>(address >> 16),
+                                   static_cast<u8>(address >> 8), static_cast<u8>(address) }};
+}
+
+inline Bpdu::PortIdHandler PortIdData(const u8 priority, const u16 portNo) noexcept {
+    return Bpdu::PortIdHandler{{ static_cast<u8>(priority | ((portNo >> 8) & 0x0F)),
+                                 static_cast<u8>(portNo) }};
+}
+
+/**
+ * @brief RstBpdu builds RST BPDU with default priorities and timers of the sender
+ */
+inline Bpdu RstBpdu(const u64 rootAddr, const u32 rootPathCost, const u64 bridgeAddr,
+                    const u16 portNo, const PortRole role) noexcept {
+    Bpdu bpdu{};
+    bpdu.SetProtocolVersionIdentifier(+Bpdu::ProtocolVersionIdentifier::Rst);
+    bpdu.SetBpduType(+Bpdu::Type::Rst);
+    bpdu.SetPortRoleFlag(role);
+    bpdu.SetLearnigFlag();
+    bpdu.SetForwardingFlag();
+    bpdu.SetRootIdentifier(BridgeIdData(0x8000, rootAddr));
+    bpdu.SetRootPathCost(rootPathCost);
+    bpdu.SetBridgeIdentifier(BridgeIdData(0x8000, bridgeAddr));
+    bpdu.SetPortIdentifier(PortIdData(0x80, portNo));
+    bpdu.SetMessageAge(1 * Time::BpduUnitsPerSecond);
+    bpdu.SetMaxAge(20 * Time::BpduUnitsPerSecond);
+    bpdu.SetHelloTime(2 * Time::BpduUnitsPerSecond);
+    bpdu.SetForwardDelay(15 * Time::BpduUnitsPerSecond);
+
+    return bpdu;
+}
+
+inline ByteStream Encoded(Bpdu bpdu) {
+    ByteStream data;
+    bpdu.Encode(data);
+
+    return data;
+}
+
+} // namespace BenchBridge
@@ -0,0 +1,316 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Measured project's headers
+#include <stp/bpdu.hpp>
+#include <stp/bridge.hpp>
+#include <stp/bridge_id.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/mac.hpp>
+#include <stp/path_cost.hpp>
+#include <stp/priority_vector.hpp>
+#include <stp/sm_conditions.hpp>
+#include <stp/sm_procedures.hpp>
+
+// Benchmark helpers
+#include "bench_bridge.hpp"
+
+// Google Benchmark headers
+#include <benchmark/benchmark.h>
+
+// C++ Standard Library
+#include <random>
+#include <vector>
+
+using namespace Stp;
+using namespace BenchBridge;
+
+namespace {
+
+/// @brief Power of two, so inputs are picked by masking the iteration counter
+constexpr std::size_t kCorpusSize = 4096;
+constexpr std::size_t kCorpusMask = kCorpusSize - 1;
+constexpr u64 kCorpusSeed = 0x5354505F42454E43ULL;
+
+/**
+ * @brief The Corpus class keeps inputs which resemble traffic of the bridge in a campus
+ *        network: most BPDUs carry the same root, path costs are sums of a few hops of common
+ *        link speeds, designated bridges are drawn from a few hundred bridges of single vendor
+ *        and a small share of BPDUs are legacy Configuration and TCN BPDUs.
+ */
+class Corpus {
+public:
+    static const Corpus& Instance() {
+        static const Corpus corpus{};
+        return corpus;
+    }
+
+    std::vector<Bpdu> Bpdus;
+    std::vector<ByteStream> Encoded;
+    std::vector<PriorityVector> Vectors; ///< Priority vectors of received RST and Config BPDUs
+    std::vector<Bpdu::BridgeIdHandler> BridgeIds;
+    std::vector<Bpdu::BridgeSystemIdHandler> Macs;
+    std::vector<u32> SpeedsMb;
+
+private:
+    Corpus() {
+        std::mt19937_64 random{ kCorpusSeed };
+        std::discrete_distribution<u32> rootPick{ 90, 6, 3, 1 };
+        std::discrete_distribution<u32> typePick{ 85, 12, 3 };
+        std::discrete_distribution<u32> speedPick{ 5, 20, 40, 25, 5, 3, 2 };
+        std::uniform_int_distribution<u32> hopsPick{ 0, 7 };
+        std::uniform_int_distribution<u32> bridgePick{ 0, 255 };
+        std::uniform_int_distribution<u32> portPick{ 1, 48 };
+        std::uniform_int_distribution<u32> rolePick{ 1, 3 };
+        std::bernoulli_distribution flagPick{ 0.1 };
+        const u16 rootPriorities[] = { 0x1000, 0x8000, 0x8000, 0x9000 };
+        const u32 speeds[] = { 10, 100, 1000, 10000, 25000, 40000, 100000 };
+
+        for (std::size_t idx = 0; idx < kCorpusSize; ++idx) {
+            const u32 root = rootPick(random);
+            const u32 hops = hopsPick(random);
+            const u32 speed = speeds[speedPick(random)];
+            const u64 rootAddr = kVendorOui | root;
+            const u64 bridgeAddr = kVendorOui | (0x100 + bridgePick(random));
+
+            Bpdu bpdu{};
+            switch (typePick(random)) {
+            case 0:
+                bpdu.SetProtocolVersionIdentifier(+Bpdu::ProtocolVersionIdentifier::Rst);
+                bpdu.SetBpduType(+Bpdu::Type::Rst);
+                bpdu.SetPortRoleFlag(static_cast<PortRole>(rolePick(random)));
+                bpdu.SetLearnigFlag();
+                bpdu.SetForwardingFlag();
+                if (flagPick(random)) {
+                    bpdu.SetProposalFlag();
+                }
+
+                if (flagPick(random)) {
+                    bpdu.SetAgreementFlag();
+                }
+
+                if (flagPick(random)) {
+                    bpdu.SetTcFlag();
+                }
+
+                break;
+            case 1:
+                bpdu.SetBpduType(+Bpdu::Type::Config);
+                break;
+            default:
+                bpdu.SetBpduType(+Bpdu::Type::Tcn);
+                break;
+            }
+
+            if (+Bpdu::Type::Tcn != bpdu.BpduType()) {
+                bpdu.SetRootIdentifier(BridgeIdData(rootPriorities[root], rootAddr));
+                bpdu.SetRootPathCost(hops * PathCost::SpeedMbToPathCostValue(speed));
+                bpdu.SetBridgeIdentifier(BridgeIdData(0x8000, bridgeAddr));
+                bpdu.SetPortIdentifier(PortIdData(0x80, static_cast<u16>(portPick(random))));
+                bpdu.SetMessageAge(static_cast<u16>(hops * Time::BpduUnitsPerSecond));
+                bpdu.SetMaxAge(20 * Time::BpduUnitsPerSecond);
+                bpdu.SetHelloTime(2 * Time::BpduUnitsPerSecond);
+                bpdu.SetForwardDelay(15 * Time::BpduUnitsPerSecond);
+                PathCost rootPathCost{};
+                rootPathCost.SetPathCost(bpdu.RootPathCost());
+                Vectors.emplace_back(BridgeId{ bpdu.RootIdentifier() }, rootPathCost,
+                                     BridgeId{ bpdu.BridgeIdentifier() },
+                                     PortId{ bpdu.PortIdentifier() });
+            }
+
+            Bpdus.push_back(bpdu);
+            Encoded.push_back(BenchBridge::Encoded(bpdu));
+            BridgeIds.push_back(BridgeIdData(0x8000, bridgeAddr));
+            Macs.push_back(MacData(bridgeAddr));
+            SpeedsMb.push_back(speed);
+        }
+
+        // Comparisons run over the whole corpus, so it has to be power of two as well
+        while (Vectors.size() < kCorpusSize) {
+            Vectors.push_back(Vectors[Vectors.size() % 64]);
+        }
+
+        Vectors.resize(kCorpusSize);
+    }
+
+    static constexpr u64 kVendorOui = 0x001C0E000000ULL;
+};
+
+void BM_BpduDecode(benchmark::State& state) {
+    const Corpus& corpus = Corpus::Instance();
+    Bpdu bpdu{};
+    std::size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bpdu.Decode(corpus.Encoded[idx++ & kCorpusMask]));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BpduDecode);
+
+void BM_BpduEncode(benchmark::State& state) {
+    std::vector<Bpdu> bpdus = Corpus::Instance().Bpdus;
+    ByteStream output;
+    output.reserve(+Bpdu::Size::Max);
+    std::size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bpdus[idx++ & kCorpusMask].Encode(output));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BpduEncode);
+
+void BM_PriorityVectorLess(benchmark::State& state) {
+    const std::vector<PriorityVector>& vectors = Corpus::Instance().Vectors;
+    std::size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vectors[idx & kCorpusMask] < vectors[(idx + 1) & kCorpusMask]);
+        ++idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PriorityVectorLess);
+
+void BM_PriorityVectorEqual(benchmark::State& state) {
+    const std::vector<PriorityVector>& vectors = Corpus::Instance().Vectors;
+    std::size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vectors[idx & kCorpusMask] == vectors[(idx + 1) & kCorpusMask]);
+        ++idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PriorityVectorEqual);
+
+void BM_BridgeIdFromBpduData(benchmark::State& state) {
+    const std::vector<Bpdu::BridgeIdHandler>& bridgeIds = Corpus::Instance().BridgeIds;
+    std::size_t idx = 0;
+    for (auto _ : state) {
+        BridgeId bridgeId{ bridgeIds[idx++ & kCorpusMask] };
+        benchmark::DoNotOptimize(bridgeId);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BridgeIdFromBpduData);
+
+void BM_BridgeIdConvertToBpduData(benchmark::State& state) {
+    std::vector<BridgeId> bridgeIds;
+    for (const auto& data : Corpus::Instance().BridgeIds) {
+        bridgeIds.emplace_back(data);
+    }
+
+    std::size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bridgeIds[idx++ & kCorpusMask].ConvertToBpduData());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BridgeIdConvertToBpduData);
+
+void BM_MacFromBpduData(benchmark::State& state) {
+    const std::vector<Bpdu::BridgeSystemIdHandler>& macs = Corpus::Instance().Macs;
+    std::size_t idx = 0;
+    for (auto _ : state) {
+        Mac mac{ macs[idx++ & kCorpusMask] };
+        benchmark::DoNotOptimize(mac);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MacFromBpduData);
+
+void BM_SpeedMbToPathCostValue(benchmark::State& state) {
+    const std::vector<u32>& speeds = Corpus::Instance().SpeedsMb;
+    std::size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PathCost::SpeedMbToPathCostValue(speeds[idx++ & kCorpusMask]));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpeedMbToPathCostValue);
+
+/// @brief Port which has designated information of the campus root recorded from its neighbour
+void BM_RcvInfo(benchmark::State& state) {
+    const Corpus& corpus = Corpus::Instance();
+    SystemH system = std::make_shared<System>(std::make_shared<NullOutInterface>(),
+                                              std::make_shared<NullLogger>(),
+                                              std::make_shared<VirtualClock>());
+    Bridge bridge{ system };
+    bridge.AddPort(1);
+    Port& port = *bridge.GetPort(1);
+    port.SetPortPriority(corpus.Vectors[0]);
+    port.GetPortTimes().SetMaxAge(Time::FromSeconds(20));
+    port.SetRcvdBpdu(true);
+
+    // Roles of legacy BPDUs are decoded by port receive machine before RcvInfo() is called
+    std::vector<Bpdu> received;
+    for (const Bpdu& bpdu : corpus.Bpdus) {
+        if (+Bpdu::Type::Rst == bpdu.BpduType()) {
+            received.push_back(bpdu);
+        }
+    }
+
+    std::size_t idx = 0;
+    for (auto _ : state) {
+        port.SetRxBpdu(received[idx++ % received.size()]);
+        benchmark::DoNotOptimize(SmConditions::RcvInfo(port));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RcvInfo);
+
+/// @brief Converged bridge, whose ports have received information from the corpus
+void BM_UpdtRolesTree(benchmark::State& state) {
+    const Corpus& corpus = Corpus::Instance();
+    SystemH system = std::make_shared<System>(std::make_shared<NullOutInterface>(),
+                                              std::make_shared<NullLogger>(),
+                                              std::make_shared<VirtualClock>());
+    Engine engine{ MacAddress(0x001C0E00FFFFULL), system };
+    const u16 portCount = static_cast<u16>(state.range(0));
+    for (u16 portNo = 1; portNo <= portCount; ++portNo) {
+        engine.AddPort(portNo, corpus.SpeedsMb[portNo], true);
+    }
+
+    // Only RST BPDUs carry roles which are accepted by every port
+    std::vector<ByteStream> received;
+    for (std::size_t idx = 0; received.size() < portCount; ++idx) {
+        if (+Bpdu::Type::Rst == corpus.Bpdus[idx].BpduType()) {
+            received.push_back(corpus.Encoded[idx]);
+        }
+    }
+
+    for (u32 tick = 0; tick < 3; ++tick) {
+        for (u16 portNo = 1; portNo <= portCount; ++portNo) {
+            engine.ProcessBpdu(portNo, received[portNo - 1]);
+        }
+
+        engine.Tick();
+    }
+
+    Bridge& bridge = engine.GetBridgeInstance();
+    for (auto _ : state) {
+        SmProcedures::UpdtRolesTree(bridge);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetComplexityN(portCount);
+    state.SetItemsProcessed(state.iterations() * portCount);
+}
+BENCHMARK(BM_UpdtRolesTree)->Arg(8)->Arg(24)->Arg(48)->Arg(512)->Complexity();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,343 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Measured project's headers
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+
+// Benchmark helpers
+#include "bench_bridge.hpp"
+
+// Google Benchmark headers
+#include <benchmark/benchmark.h>
+
+// C++ Standard Library
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// GNU C Library
+#include <malloc.h>
+
+using namespace Stp;
+using namespace BenchBridge;
+
+namespace {
+
+/// @brief Bytes currently allocated on the heap, counted by replaced global operator new
+std::atomic<s64> gLiveBytes{ 0 };
+/// @brief Blocks currently allocated on the heap
+std::atomic<s64> gLiveBlocks{ 0 };
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    void* ptr = std::malloc(size);
+    if (nullptr == ptr) {
+        throw std::bad_alloc{};
+    }
+
+    gLiveBytes.fetch_add(static_cast<s64>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+    gLiveBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    return ptr;
+}
+
+// GCC does not know that operator new has been replaced as well and warns about free()
+#if defined(__GNUC__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* ptr) noexcept {
+    if (nullptr == ptr) {
+        return;
+    }
+
+    gLiveBytes.fetch_sub(static_cast<s64>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+    gLiveBlocks.fetch_sub(1, std::memory_order_relaxed);
+    std::free(ptr);
+}
+#if defined(__GNUC__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic pop
+#endif
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+namespace {
+
+/// @brief Steady state and reconvergence are measured from 8 ports up to this number
+constexpr u16 kMinPorts = 8;
+constexpr u16 kMaxPorts = 16384;
+/// @brief Warm up of the bridge, longer than forward delay and migration time
+constexpr u32 kConvergenceTicks = 60;
+/// @brief Doubling number of ports has to increase tick cost less than 2^1.5 times
+constexpr double kMaxScalingExponent = 1.5;
+/// @brief Costs of the smallest bridges are dominated by constant overhead and are not fitted
+constexpr u16 kMinFittedPorts = 64;
+
+/**
+ * @brief The Chassis class is the measured bridge with many ports. Port 1 is connected to the
+ *        root bridge and the others to downstream bridges, which have selected them as their
+ *        root ports. Every neighbour sends BPDU once per tick.
+ */
+class Chassis {
+public:
+    static constexpr u64 kRootAddr = 0x020000000001ULL;
+    static constexpr u64 kOtherRootAddr = 0x020000000002ULL;
+    static constexpr u64 kChassisAddr = 0x020000000100ULL;
+    static constexpr u64 kDownstreamAddr = 0x030000000000ULL;
+    static constexpr u32 kSpeedMb = 10000;
+
+    explicit Chassis(const u16 portCount)
+        : _out{ std::make_shared<NullOutInterface>() }, _clock{ std::make_shared<VirtualClock>() },
+          _engine{ }, _rootBpdus{ }, _downstreamBpdus(portCount + 1), _bytesPerPort{ 0 },
+          _blocksPerPort{ 0 } {
+        SystemH system = std::make_shared<System>(_out, std::make_shared<NullLogger>(), _clock);
+        _engine = std::make_unique<Engine>(MacAddress(kChassisAddr), system);
+        const s64 bytesEmpty = gLiveBytes.load(std::memory_order_relaxed);
+        const s64 blocksEmpty = gLiveBlocks.load(std::memory_order_relaxed);
+        for (u16 portNo = 1; portNo <= portCount; ++portNo) {
+            _engine->AddPort(portNo, kSpeedMb, true);
+        }
+
+        _bytesPerPort = static_cast<double>(gLiveBytes.load(std::memory_order_relaxed)
+                                            - bytesEmpty) / portCount;
+        _blocksPerPort = static_cast<double>(gLiveBlocks.load(std::memory_order_relaxed)
+                                             - blocksEmpty) / portCount;
+
+        const u32 cost = PathCost::SpeedMbToPathCostValue(kSpeedMb);
+        _rootBpdus[0] = Encoded(RstBpdu(kRootAddr, 0, kRootAddr, 1, PortRole::Designated));
+        _rootBpdus[1] = Encoded(RstBpdu(kOtherRootAddr, 0, kRootAddr, 1, PortRole::Designated));
+        for (u16 portNo = 2; portNo <= portCount; ++portNo) {
+            _downstreamBpdus[portNo] = Encoded(RstBpdu(kRootAddr, 2 * cost,
+                                                       kDownstreamAddr + portNo, 1,
+                                                       PortRole::Root));
+        }
+
+        for (u32 tick = 0; tick < kConvergenceTicks; ++tick) {
+            ReceiveFromRoot(0);
+            ReceiveFromDownstream();
+            Tick();
+        }
+    }
+
+    void ReceiveFromRoot(const u8 root) {
+        _engine->ProcessBpdu(1, _rootBpdus[root]);
+    }
+
+    void ReceiveFromDownstream() {
+        for (u16 portNo = 2; portNo < _downstreamBpdus.size(); ++portNo) {
+            _engine->ProcessBpdu(portNo, _downstreamBpdus[portNo]);
+        }
+    }
+
+    void Tick() {
+        _clock->Advance(std::chrono::seconds{ 1 });
+        _engine->Tick();
+    }
+
+    u16 PortCount() const noexcept { return static_cast<u16>(_downstreamBpdus.size() - 1); }
+    double BytesPerPort() const noexcept { return _bytesPerPort; }
+    double BlocksPerPort() const noexcept { return _blocksPerPort; }
+    u64 TxBpdus() const noexcept { return _out->TxBpdus; }
+
+private:
+    Sptr<NullOutInterface> _out;
+    Sptr<VirtualClock> _clock;
+    EngineH _engine;
+    /// @brief Superior information of two different roots, the second one is worse
+    ByteStream _rootBpdus[2];
+    std::vector<ByteStream> _downstreamBpdus; ///< Indexed by port number
+    double _bytesPerPort;
+    double _blocksPerPort;
+};
+
+void SetCounters(benchmark::State& state, const Chassis& chassis, const u64 rxBpdusPerTick,
+                 const u64 txBpdusBefore) {
+    state.SetComplexityN(chassis.PortCount());
+    state.counters["ports"] = chassis.PortCount();
+    state.counters["bytes_per_port"] = chassis.BytesPerPort();
+    state.counters["allocs_per_port"] = chassis.BlocksPerPort();
+    // Time per processed BPDU, not their rate
+    state.counters["time_per_bpdu"] = benchmark::Counter(
+                static_cast<double>(rxBpdusPerTick),
+                benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    state.counters["tx_bpdus_per_tick"] = benchmark::Counter(
+                static_cast<double>(chassis.TxBpdus() - txBpdusBefore),
+                benchmark::Counter::kAvgIterations);
+}
+
+/// @brief Converged bridge, where only root bridge sends BPDUs
+void BM_TickSteadyState(benchmark::State& state) {
+    Chassis chassis{ static_cast<u16>(state.range(0)) };
+    const u64 txBpdusBefore = chassis.TxBpdus();
+    for (auto _ : state) {
+        chassis.ReceiveFromRoot(0);
+        chassis.Tick();
+    }
+
+    SetCounters(state, chassis, 1, txBpdusBefore);
+}
+
+/// @brief Converged bridge, where every neighbour sends BPDU once per tick
+void BM_TickSteadyStateAllPortsRx(benchmark::State& state) {
+    Chassis chassis{ static_cast<u16>(state.range(0)) };
+    const u64 txBpdusBefore = chassis.TxBpdus();
+    for (auto _ : state) {
+        chassis.ReceiveFromRoot(0);
+        chassis.ReceiveFromDownstream();
+        chassis.Tick();
+    }
+
+    SetCounters(state, chassis, chassis.PortCount(), txBpdusBefore);
+}
+
+/// @brief Root changes on every tick, so roles of all ports are selected again and every
+///        designated port transmits new information
+void BM_TickReconvergence(benchmark::State& state) {
+    Chassis chassis{ static_cast<u16>(state.range(0)) };
+    const u64 txBpdusBefore = chassis.TxBpdus();
+    u8 root = 0;
+    for (auto _ : state) {
+        root ^= 1;
+        chassis.ReceiveFromRoot(root);
+        chassis.Tick();
+    }
+
+    SetCounters(state, chassis, 1, txBpdusBefore);
+}
+
+/// @brief Sizes of per-port state are reported together with context of the run
+void AddFootprintContext() {
+    benchmark::AddCustomContext("sizeof_port", std::to_string(sizeof(Port)));
+    benchmark::AddCustomContext("sizeof_port_slab", std::to_string(StateMachine::SlabSize()));
+    benchmark::AddCustomContext("sizeof_priority_vector", std::to_string(sizeof(PriorityVector)));
+    benchmark::AddCustomContext("sizeof_bpdu", std::to_string(sizeof(Bpdu)));
+    benchmark::AddCustomContext("sizeof_port_stats", std::to_string(sizeof(PortStats)));
+}
+
+/**
+ * @brief The ScalingReporter class prints results as the console reporter does and fits
+ *        exponent k of cost ~ N^k for every benchmark by least squares on logarithms
+ */
+class ScalingReporter final : public benchmark::ConsoleReporter {
+public:
+    void ReportRuns(const std::vector<Run>& reports) override {
+        ConsoleReporter::ReportRuns(reports);
+        for (const Run& run : reports) {
+            if (run.error_occurred || (Run::RT_Iteration != run.run_type)
+                    || (run.complexity_n < kMinFittedPorts)) {
+                continue;
+            }
+
+            _samples[run.run_name.function_name].push_back(
+                        Sample{ static_cast<double>(run.complexity_n), run.GetAdjustedCPUTime() });
+        }
+    }
+
+    /// @return true if none of benchmarks scales worse than allowed
+    bool CheckScaling(std::ostream& out) const {
+        bool passed = true;
+        for (const auto& family : _samples) {
+            if (family.second.size() < 2) {
+                continue;
+            }
+
+            const double exponent = FitExponent(family.second);
+            const bool familyPassed = exponent <= kMaxScalingExponent;
+            out << family.first << ": cost ~ N^" << exponent
+                << (familyPassed ? "" : " exceeds allowed N^") ;
+            if (not familyPassed) {
+                out << kMaxScalingExponent;
+            }
+
+            out << std::endl;
+            passed = passed && familyPassed;
+        }
+
+        return passed;
+    }
+
+private:
+    struct Sample {
+        double Ports;
+        double Time;
+    };
+
+    static double FitExponent(const std::vector<Sample>& samples) noexcept {
+        double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+        for (const Sample& sample : samples) {
+            const double x = std::log(sample.Ports);
+            const double y = std::log(sample.Time);
+            sumX += x;
+            sumY += y;
+            sumXX += x * x;
+            sumXY += x * y;
+        }
+
+        const double count = static_cast<double>(samples.size());
+        return (count * sumXY - sumX * sumY) / (count * sumXX - sumX * sumX);
+    }
+
+    std::map<std::string, std::vector<Sample>> _samples;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Own options are consumed before the rest is passed to Google Benchmark
+    long maxPorts = kMaxPorts;
+    int argCount = 1;
+    for (int idx = 1; idx < argc; ++idx) {
+        constexpr char kMaxPortsOption[] = "--max_ports=";
+        if (0 == std::strncmp(argv[idx], kMaxPortsOption, sizeof(kMaxPortsOption) - 1)) {
+            maxPorts = std::strtol(argv[idx] + sizeof(kMaxPortsOption) - 1, nullptr, 10);
+        }
+        else {
+            argv[argCount++] = argv[idx];
+        }
+    }
+
+    argc = argCount;
+    if ((maxPorts < kMinPorts) || (maxPorts > kMaxPorts)) {
+        std::cerr << "--max_ports has to be in range [" << kMinPorts << ", " << kMaxPorts << "]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::pair<const char*, void (*)(benchmark::State&)> benchmarks[] = {
+        { "BM_TickSteadyState", BM_TickSteadyState },
+        { "BM_TickSteadyStateAllPortsRx", BM_TickSteadyStateAllPortsRx },
+        { "BM_TickReconvergence", BM_TickReconvergence }
+    };
+    // Range is known at run-time, so benchmarks are registered here instead of BENCHMARK macro
+    for (const auto& bm : benchmarks) {
+        benchmark::RegisterBenchmark(bm.first, bm.second)
+                ->RangeMultiplier(2)->Range(kMinPorts, maxPorts)
+                ->Unit(benchmark::kMicrosecond);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    AddFootprintContext();
+    ScalingReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    return reporter.CheckScaling(std::cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -109,7 +109,8 @@ public:
     using PortIdHandler = std::array<u8, +FieldSize::PortIdentifier>;
 
     Bpdu() noexcept;
-    Bpdu(const Bpdu& copyFrom) noexcept;
+    Bpdu(const Bpdu& copyFrom) noexcept = default;
+    Bpdu& operator=(const Bpdu& copyFrom) noexcept = default;
 
     ~Bpdu() = default;
 
@@ -117,8 +118,9 @@ public:
     Result Decode(const ByteStream& input) noexcept;
 
     /// @brief 9.3 BPDU formats and parameters
-    union DataUnit {
-        u8 encodedStream[+Size::Max];
+    /// @note Fields are kept in host layout, which does not match octet offsets on the wire.
+    ///       Encode() and Decode() translate field by field, so no raw copy is kept.
+    struct DataUnit {
         struct {                            // Octet
             u16 ProtocolIdentifier;         // 1-2
             u8 ProtocolVersionIdentifier;   // 3
@@ -142,6 +144,8 @@ public:
     void SetProtocolVersionIdentifier(const u8 value) noexcept;
     u8 BpduType() const noexcept;
     void SetBpduType(const u8 value) noexcept;
+    /// @brief All flags in layout of octet 5
+    u8 Flags() const noexcept;
     u8 TcAckFlag() const noexcept;
     void SetTcAckFlag() noexcept;
     void ClearTcAckFlag() noexcept;
@@ -170,6 +174,7 @@ public:
     void SetBridgeIdentifier(const BridgeIdHandler& value) noexcept;
     const PortIdHandler& PortIdentifier() const noexcept;
     void SetPortIdentifier(const PortIdHandler& value) noexcept;
+    /// @note Times of BPDU are kept in units of 1/256 second, as they are encoded (9.2.8)
     u16 MessageAge() const noexcept;
     void SetMessageAge(const u16 value) noexcept;
     u16 MaxAge() const noexcept;
@@ -204,6 +209,8 @@ private:
     static u16 ConvertEndianessBpduDataToTime(const BpduTimeFieldHandler& bpduData) noexcept;
     static void ConvertEndianessTimeToBpduData(const u16 time,
                                                BpduTimeFieldHandler& bpduData) noexcept;
+    static u16 DecodeTime(const ByteStream& input, const FieldOffset offset) noexcept;
+    static void EncodeTime(const u16 time, const FieldOffset offset, ByteStream& output) noexcept;
 
     bool IsValidBpduType(const u8 type) noexcept;
     u8 GetSizeFromBpduType(const Type type) noexcept;
@@ -233,6 +240,8 @@ inline void Bpdu::SetProtocolVersionIdentifier(const u8 value) noexcept { _data.
 inline u8 Bpdu::BpduType() const noexcept { return _data.Fields.BpduType; }
 inline void Bpdu::SetBpduType(const u8 value) noexcept { _data.Fields.BpduType = value; }
 
+inline u8 Bpdu::Flags() const noexcept { return _data.Fields.Flags; }
+
 inline u8 Bpdu::TcAckFlag() const noexcept {
     return (_data.Fields.Flags >> static_cast<u8>(OffsetFlag::TcAck)) & 0x01;
 }
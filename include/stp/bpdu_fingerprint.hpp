@@ -0,0 +1,109 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "bpdu.hpp"
+#include "lib.hpp"
+
+// C Standard Library
+#include <cstring>
+
+// C++ Standard Library
+#include <algorithm>
+#include <array>
+
+namespace Stp {
+
+/**
+ * @brief The BpduFingerprint class keeps raw copy of the received BPDU data. It is used to
+ *        recognize BPDU which is byte-identical to the previously received one without decoding.
+ * @note Only octets defined for the BPDU type are compared, so trailing padding of the frame
+ *       does not make difference. BPDU of unknown type never matches.
+ */
+class BpduFingerprint {
+public:
+    BpduFingerprint() noexcept;
+
+    void Assign(const ByteStream& data) noexcept;
+    void Clear() noexcept;
+    bool Matches(const ByteStream& data) const noexcept;
+    u8 Size() const noexcept;
+
+    bool operator==(const BpduFingerprint& comparedTo) const noexcept;
+
+private:
+    static u8 SignificantSize(const ByteStream& data) noexcept;
+
+    /// @brief RST BPDU is the longest one of known types
+    std::array<u8, +Bpdu::Size::Rst> _data;
+    u8 _size;
+};
+
+inline BpduFingerprint::BpduFingerprint() noexcept
+    : _data{ }, _size{ 0 } {
+    // Nothing more to do
+}
+
+inline void BpduFingerprint::Assign(const ByteStream& data) noexcept {
+    _size = SignificantSize(data);
+    std::copy_n(data.cbegin(), _size, _data.begin());
+}
+
+inline void BpduFingerprint::Clear() noexcept {
+    _size = 0;
+}
+
+inline bool BpduFingerprint::Matches(const ByteStream& data) const noexcept {
+    if (0 == _size) {
+        return false;
+    }
+
+    if (SignificantSize(data) != _size) {
+        return false;
+    }
+
+    return 0 == std::memcmp(_data.data(), data.data(), _size);
+}
+
+inline u8 BpduFingerprint::Size() const noexcept {
+    return _size;
+}
+
+inline bool BpduFingerprint::operator==(const BpduFingerprint& comparedTo) const noexcept {
+    if ((0 == _size) || (comparedTo._size != _size)) {
+        return false;
+    }
+
+    return 0 == std::memcmp(_data.data(), comparedTo._data.data(), _size);
+}
+
+inline u8 BpduFingerprint::SignificantSize(const ByteStream& data) noexcept {
+    if (data.size() <= +Bpdu::FieldOffset::BpduType) {
+        return 0;
+    }
+
+    ByteStream::size_type size;
+    switch (static_cast<Bpdu::Type>(data[+Bpdu::FieldOffset::BpduType])) {
+    case Bpdu::Type::Config:
+        size = +Bpdu::Size::Config;
+        break;
+    case Bpdu::Type::Tcn:
+        size = +Bpdu::Size::Tcn;
+        break;
+    case Bpdu::Type::Rst:
+        size = +Bpdu::Size::Rst;
+        break;
+    default:
+        // Unknown BPDU type is never fingerprinted, as it does not pass decoding
+        return 0;
+    }
+
+    return static_cast<u8>(std::min(size, data.size()));
+}
+
+} // namespace Stp
@@ -0,0 +1,126 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "clock.hpp"
+#include "lib.hpp"
+#include "port_stats.hpp"
+#include "seqlock.hpp"
+
+// C++ Standard Library
+#include <atomic>
+#include <mutex>
+
+namespace Stp {
+
+/**
+ * @brief The BpduPolicerConfig struct keeps limits of BPDUs received by every port, see
+ *        Management::SetBpduPolicer()
+ */
+struct BpduPolicerConfig {
+    /// @brief BPDUs per second passed to the RSTP by the port, 0 disables the policer
+    u32 Rate = 0;
+    /// @brief BPDUs passed at once, above the rate, by the port which has been silent
+    u32 Burst = 0;
+    /// @brief BPDUs per second offered by the port which make it err-disabled, 0 if the port is
+    ///        never disabled. Bursts above the rate are allowed as above.
+    u32 ErrDisableRate = 0;
+
+    /**
+     * @brief Validate checks that the burst is allowed by the enabled policer and that the port
+     *        is err-disabled above the rate of the policer
+     * @return Result::Success if limits might be applied, otherwise Result::Fail
+     */
+    Result Validate() const noexcept;
+};
+
+/**
+ * @brief The BpduPolicer class limits BPDUs which are queued to the RSTP by every port, before
+ *        they are queued, so the RSTP thread handles bounded number of them, regardless of the
+ *        offered traffic (e.g. by a loop or misbehaving neighbour). Every port has its token
+ *        bucket, kept as the single atomic theoretical arrival time (GCRA), so it might be
+ *        called by many threads receiving BPDUs without locking. The same threads count there
+ *        BPDUs which they fail to decode, see Management::SetIngressDecode().
+ */
+class BpduPolicer {
+public:
+    enum class Verdict : u8 {
+        Pass, ///< BPDU has to be passed to the RSTP
+        Drop, ///< BPDU has exceeded the rate of the port, or the port is err-disabled
+        ErrDisable ///< BPDU has to be dropped and the port disabled, told only to one caller
+    };
+
+    BpduPolicer() noexcept;
+    ~BpduPolicer();
+
+    BpduPolicer(const BpduPolicer&) = delete;
+    BpduPolicer& operator=(const BpduPolicer&) = delete;
+
+    /// @return Result::Fail if the config is not valid, otherwise Result::Success
+    Result Configure(const BpduPolicerConfig& config);
+    BpduPolicerConfig Config() const noexcept;
+    /**
+     * @brief AddPort allocates the bucket of the port added to the RSTP, so BPDUs are policed
+     *        and counted without allocation. The bucket is kept once the port is removed.
+     */
+    void AddPort(const u16 portNo);
+
+    /**
+     * @brief Police accounts BPDU received by the port. BPDUs of ports which have not been
+     *        added are passed, as the RSTP drops them anyway.
+     * @param time of reception, by the clock of the RSTP
+     */
+    Verdict Police(const u16 portNo, const Clock::Duration time) noexcept;
+    /// @return Number of BPDUs dropped by the port
+    u64 Dropped(const u16 portNo) const noexcept;
+    bool ErrDisabled(const u16 portNo) const noexcept;
+    /// @brief ClearErrDisabled lets the port enabled again pass BPDUs
+    void ClearErrDisabled(const u16 portNo) noexcept;
+    /// @brief CountDecodeDrop accounts BPDU of the port dropped by decoding on ingress
+    void CountDecodeDrop(const u16 portNo, const BpduDropReason reason) noexcept;
+    /// @return Number of BPDUs of the port dropped by decoding on ingress for the reason
+    u64 DecodeDropped(const u16 portNo, const BpduDropReason reason) const noexcept;
+
+private:
+    struct Bucket {
+        /// @brief Time at which the bucket gets full again, in nanoseconds
+        std::atomic<s64> PassedTat;
+        /// @brief The same for all BPDUs offered by the port, limited by ErrDisableRate
+        std::atomic<s64> OfferedTat;
+        std::atomic<u64> Dropped;
+        std::atomic<bool> ErrDisabled;
+        /// @brief Indexed by BpduDropReason
+        std::atomic<u64> DecodeDropped[BpduDropReasonCount];
+    };
+
+    /// @brief Limits converted to intervals, so policing does not divide
+    struct Limits {
+        s64 PassedIntervalNs;
+        s64 PassedToleranceNs;
+        s64 OfferedIntervalNs;
+        s64 OfferedToleranceNs;
+        BpduPolicerConfig Config;
+    };
+
+    /// @brief Buckets are allocated by pages as ports are added, so other port numbers cost
+    ///        nothing
+    static constexpr u32 _kPageSize = 256;
+    static constexpr u32 _kPageCount = 65536 / _kPageSize;
+
+    /// @return true if BPDU conforms the bucket, which is updated then
+    static bool Conform(std::atomic<s64>& tat, const s64 nowNs, const s64 intervalNs,
+                        const s64 toleranceNs) noexcept;
+    Bucket* FindBucket(const u16 portNo) const noexcept;
+
+    std::atomic<Bucket*> _pages[_kPageCount];
+    SeqLock<Limits> _limits;
+    /// @brief Limits might be configured by many threads, while SeqLock takes one writer
+    std::mutex _mtxLimits;
+};
+
+} // namespace Stp
@@ -7,7 +7,9 @@
 #pragma once
 
 // This project's headers
+#include "bridge_config.hpp"
 #include "bridge_id.hpp"
+#include "latency_tracker.hpp"
 #include "logger.hpp"
 #include "port.hpp"
 #include "priority_vector.hpp"
@@ -15,24 +17,38 @@
 #include "specifiers.hpp"
 #include "system.hpp"
 #include "time.hpp"
+#include "tracer.hpp"
 
 // C++ Standard Library
 #include <memory>
-#include <map>
+#include <utility>
+#include <vector>
 
 namespace Stp {
 
+/**
+ * @brief The FailoverPlan struct keeps the root path priority vector (17.6) of the port which
+ *        would replace the root port on its loss. It is refreshed after every role selection,
+ *        so the loss of the root port does not need to look for the best vector of all ports
+ *        again. Only the backup root port is planned, roles of other ports are not.
+ */
+struct FailoverPlan {
+    /// @brief Root port which loss is covered by the plan, 0 if the plan is not valid
+    u16 RootPortNo = 0;
+    /// @brief Port number is 0 if the bridge would become the root bridge
+    PortId BackupPortId;
+    PriorityVector BackupPriority;
+    Time BackupTimes;
+};
+
 class Bridge {
 public:
+    /// @brief Ports sorted by their numbers, kept flat so ports do not cost allocations of nodes
+    using PortList = std::vector<std::pair<u16, PortH>>;
+
     // By default, assigned to VLAN #1
     static constexpr u16 ExtensionDefaultValue = 1;
 
-    /// @todo Make it dynamic managementable
-    static constexpr u8 ForceProtocolVersion = 2;
-
-    /// @todo Make it dynamic managementable
-    static constexpr u32 AgeingTime = 300;
-
     Bridge(SystemH system) noexcept;
     Bridge(const Bridge&) = default;
     Bridge(Bridge&&) = default;
@@ -69,14 +85,53 @@ public:
     Time& GetRootTimes() noexcept;
     void SetRootTimes(const Time& value) noexcept;
 
+    const FailoverPlan& Failover() const noexcept;
+    FailoverPlan& GetFailover() noexcept;
+
+    /// @brief 17.13.4, managed by Management::SetBridgeConfig()
+    u8 ForceProtocolVersion() const noexcept;
+    void SetForceProtocolVersion(const u8 value) noexcept;
+
+    /// @brief 17.13.12, managed by Management::SetBridgeConfig()
+    u8 TxHoldCount() const noexcept;
+    void SetTxHoldCount(const u8 value) noexcept;
+
+    /// @brief 17.19.1 in milliseconds, managed by Management::SetBridgeConfig()
+    u32 AgeingTime() const noexcept;
+    void SetAgeingTime(const u32 value) noexcept;
+
+    /// @brief Time elapsing between ticks of Port Timers machines (17.22)
+    u32 TickIntervalMs() const noexcept;
+    void SetTickIntervalMs(const u32 value) noexcept;
+
+    /// @brief Port Role Selection machines do not select roles while it is set, so ports added
+    ///        by Engine::AddPorts() are selected all at once
+    bool RoleSelectionDeferred() const noexcept;
+    void SetRoleSelectionDeferred(const bool value) noexcept;
+
+    /// @brief Set by procedures which change variables of all ports (e.g. updtRolesTree()), so
+    ///        Engine publishes every port, not only those whose machines have moved
+    bool TreeChanged() const noexcept;
+    void SetTreeChanged(const bool value) noexcept;
+
     const Mac& Address() const noexcept;
     Mac& GetAddress() noexcept;
     void SetAddress(const Mac& value) noexcept;
 
     void AddPort(const u16 portNo);
+    /// @brief AddPort adds port which has been created by the caller
+    void AddPort(const u16 portNo, PortH port);
     void RemovePort(const u16 portNo);
-    PortH GetPort(const u16 portNo);
-    std::map<u16, PortH>& GetAllPorts();
+    PortH GetPort(const u16 portNo) const;
+    const PortList& AllPorts() const noexcept;
+    PortList& GetAllPorts();
+
+    /// @return Time of the clock which drives the STP
+    Clock::Duration Now() const noexcept;
+    const LatencyTracker& LatencyTrackerInstance() const noexcept;
+    LatencyTracker& GetLatencyTracker() noexcept;
+    const Tracer& TracerInstance() const noexcept;
+    Tracer& GetTracer() noexcept;
 
     __virtual Result FlushFdb(const u16 portNo);
     __virtual Result SetForwarding(const u16 portNo, const bool enable);
@@ -89,19 +144,19 @@ public:
     __virtual void SetSystemLogSeverity(const LoggingSystem::Logger::LogSeverity logSeverity);
 
 private:
+    /// @return Position of the port, or of the first port with greater number
+    PortList::const_iterator FindPosition(const u16 portNo) const noexcept;
+
     /// @brief 17.18.1
     bool _begin;
 
     /// @brief 17.18.2
-    /// @todo Should be dynamic managementable
     BridgeId _bridgeId;
 
     /// @brief 17.18.3
-    /// @todo Should be dynamic managementable
     PriorityVector _bridgePriority;
 
     /// @brief 17.18.4
-    /// @todo Should be dynamic managementable
     Time _bridgeTimes;
 
     /// @brief 17.18.5
@@ -113,12 +168,33 @@ private:
     /// @brief 17.18.7
     Time _rootTimes;
 
+    FailoverPlan _failover;
+
+    /// @brief 17.13.4
+    u8 _forceProtocolVersion;
+
+    /// @brief 17.13.12
+    u8 _txHoldCount;
+
+    /// @brief 17.19.1
+    u32 _ageingTime;
+
+    u32 _tickIntervalMs;
+
+    bool _roleSelectionDeferred;
+
+    bool _treeChanged;
+
     Mac _addr;
 
-    std::map<u16, PortH> _ports;
+    PortList _ports;
 
     SystemH _system;
 
+    LatencyTrackerH _latencyTracker;
+
+    TracerH _tracer;
+
     LoggingSystem::SystemLoggingManager _systemLoggingManager;
 }; // End of Bridge class declaration
 
@@ -127,6 +203,28 @@ using BridgeH = Sptr<Bridge>;
 inline bool Bridge::Begin() const __noexcept { return _begin; }
 inline void Bridge::SetBegin(const bool value) noexcept { _begin = value; }
 
+inline u8 Bridge::ForceProtocolVersion() const noexcept { return _forceProtocolVersion; }
+inline void Bridge::SetForceProtocolVersion(const u8 value) noexcept {
+    _forceProtocolVersion = value;
+}
+
+inline u8 Bridge::TxHoldCount() const noexcept { return _txHoldCount; }
+inline void Bridge::SetTxHoldCount(const u8 value) noexcept { _txHoldCount = value; }
+
+inline u32 Bridge::AgeingTime() const noexcept { return _ageingTime; }
+inline void Bridge::SetAgeingTime(const u32 value) noexcept { _ageingTime = value; }
+
+inline u32 Bridge::TickIntervalMs() const noexcept { return _tickIntervalMs; }
+inline void Bridge::SetTickIntervalMs(const u32 value) noexcept { _tickIntervalMs = value; }
+
+inline bool Bridge::RoleSelectionDeferred() const noexcept { return _roleSelectionDeferred; }
+inline void Bridge::SetRoleSelectionDeferred(const bool value) noexcept {
+    _roleSelectionDeferred = value;
+}
+
+inline bool Bridge::TreeChanged() const noexcept { return _treeChanged; }
+inline void Bridge::SetTreeChanged(const bool value) noexcept { _treeChanged = value; }
+
 inline const BridgeId& Bridge::BridgeIdentifier() const noexcept { return _bridgeId; }
 inline BridgeId& Bridge::GetBridgeIdentifier() noexcept { return _bridgeId; }
 inline void Bridge::SetBridgeIdentifier(const BridgeId& value) noexcept { _bridgeId = value; }
@@ -151,23 +249,55 @@ inline const Time& Bridge::RootTimes() const noexcept { return _rootTimes; }
 inline Time& Bridge::GetRootTimes() noexcept { return _rootTimes; }
 inline void Bridge::SetRootTimes(const Time& value) noexcept { _rootTimes = value; }
 
+inline const FailoverPlan& Bridge::Failover() const noexcept { return _failover; }
+inline FailoverPlan& Bridge::GetFailover() noexcept { return _failover; }
+
 inline const Mac& Bridge::Address() const noexcept { return _addr; }
 inline Mac& Bridge::GetAddress() noexcept { return _addr; }
 inline void Bridge::SetAddress(const Mac& value) noexcept { _addr = value; }
 
+inline Clock::Duration Bridge::Now() const noexcept {
+    return _system->Clock->Now();
+}
+
+inline const LatencyTracker& Bridge::LatencyTrackerInstance() const noexcept {
+    return *_latencyTracker;
+}
+
+inline LatencyTracker& Bridge::GetLatencyTracker() noexcept {
+    return *_latencyTracker;
+}
+
+inline const Tracer& Bridge::TracerInstance() const noexcept {
+    return *_tracer;
+}
+
+inline Tracer& Bridge::GetTracer() noexcept {
+    return *_tracer;
+}
+
 inline Result Bridge::FlushFdb(const u16 portNo) {
+    _tracer->RecordHardwareCall(TraceHardwareCall::FlushFdb, portNo);
     return _system->OutInterface->FlushFdb(portNo);
 }
 
 inline Result Bridge::SetForwarding(const u16 portNo, const bool enable) {
+    if (enable) {
+        _latencyTracker->RecordForwarding();
+    }
+
+    _tracer->RecordHardwareCall(TraceHardwareCall::SetForwarding, portNo, enable);
     return _system->OutInterface->SetForwarding(portNo, enable);
 }
 
 inline Result Bridge::SetLearning(const u16 portNo, const bool enable) {
+    _tracer->RecordHardwareCall(TraceHardwareCall::SetLearning, portNo, enable);
     return _system->OutInterface->SetLearning(portNo, enable);
 }
 
 inline Result Bridge::SendOutBpdu(const u16 portNo, ByteStreamH data) {
+    _latencyTracker->RecordTransmit();
+    _tracer->RecordHardwareCall(TraceHardwareCall::SendOutBpdu, portNo);
     return _system->OutInterface->SendOutBpdu(portNo, data);
 }
 
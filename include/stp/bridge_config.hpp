@@ -0,0 +1,79 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "lib.hpp"
+#include "port.hpp"
+#include "priority_vector.hpp"
+#include "time.hpp"
+
+namespace Stp {
+
+/**
+ * @brief The BridgeConfig struct keeps managed parameters of the bridge (17.13). Default values
+ *        are the recommended ones of Table 17-1 and Table 17-2.
+ */
+struct BridgeConfig {
+    /// @brief Protocol versions which might be forced (17.13.4)
+    enum ProtocolVersion : u8 {
+        Stp = 0,
+        Rstp = 2
+    };
+
+    static constexpr u32 DefaultAgeingTime = 300;
+
+    /// @brief 17.13.7, multiple of 4096
+    u16 Priority = +PriorityVector::RecommendedBridgePriority::Value;
+    /// @brief 17.13.6, in seconds. Ports might use shorter one, see Engine::SetPortFastHello().
+    u16 HelloTime = +Time::RecommendedValue::BridgeHelloTime;
+    /// @brief 17.13.8, in seconds
+    u16 MaxAge = +Time::RecommendedValue::BridgeMaxAge;
+    /// @brief 17.13.5, in seconds
+    u16 ForwardDelay = +Time::RecommendedValue::BridgeForwardDelay;
+    /// @brief 17.13.12, maximum number of BPDUs transmitted by the port per hello time
+    u8 TxHoldCount = Port::RecommendedValue::TransmitHoldCount;
+    /// @brief 17.13.4
+    u8 ForceProtocolVersion = ProtocolVersion::Rstp;
+    /// @brief 17.19.1, ageing time of filtering database in seconds (Table 7-5)
+    u32 AgeingTime = DefaultAgeingTime;
+
+    /**
+     * @brief Validate checks ranges of Table 17-1 and relation of timers (17.14):
+     *        2 * (ForwardDelay - 1) >= MaxAge >= 2 * (HelloTime + 1)
+     * @return Result::Success if parameters might be applied, otherwise Result::Fail
+     */
+    Result Validate() const noexcept;
+};
+
+/**
+ * @brief The PortSpec struct describes the port added together with many others, see
+ *        Management::AddPorts()
+ */
+struct PortSpec {
+    u16 PortNo = 0;
+    /// @brief In Megabits [Mb]
+    u32 Speed = 0;
+    bool Enabled = false;
+};
+
+/**
+ * @brief The PortConfig namespace keeps ranges of managed parameters of the port
+ */
+namespace PortConfig {
+
+/// @return Result::Success if priority is multiple of 16 in range [0, 240] (17.13.10)
+Result ValidatePriority(const u32 priority) noexcept;
+/// @return Result::Success if path cost is in range [1, 200000000] (17.13.11)
+Result ValidatePathCost(const u32 pathCost) noexcept;
+/// @return Result::Success if hello time is 0 (fast hello disabled) or in range
+///         [Time::MinFastHelloTimeMs, Time::MaxFastHelloTimeMs]
+Result ValidateFastHelloTime(const u32 helloTimeMs) noexcept;
+
+} // namespace PortConfig
+
+} // namespace Stp
@@ -0,0 +1,88 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "bridge_config.hpp"
+#include "bridge_id.hpp"
+#include "lib.hpp"
+#include "port.hpp"
+#include "port_id.hpp"
+#include "priority_vector.hpp"
+#include "time.hpp"
+
+// C++ Standard Library
+#include <algorithm>
+#include <vector>
+
+namespace Stp {
+
+/**
+ * @brief The PortSnapshot struct is read-only copy of variables of the port (17.19), which are
+ *        queried by management
+ */
+struct PortSnapshot {
+    u16 PortNo = 0;
+    PortRole Role = PortRole::Disabled;
+    Port::Info InfoIs = Port::Info::Disabled;
+    bool Enabled = false;
+    bool Learning = false;
+    bool Forwarding = false;
+    bool OperEdge = false;
+    bool SendRstp = false; ///< Port transmits RST BPDUs, otherwise Configuration and TCN BPDUs
+    bool AdminEdge = false;
+    bool AutoEdge = false;
+    bool PointToPoint = false;
+    /// @brief In milliseconds, 0 if the port uses hello time of the bridge
+    u16 FastHelloTime = 0;
+    class PortId PortIdentifier;
+    u32 PathCost = 0;
+    /// @brief 17.19.21, information of the designated bridge of the attached LAN
+    PriorityVector PortPriority;
+    /// @brief 17.19.4, information which the port would transmit as designated port
+    PriorityVector DesignatedPriority;
+    /// @note Times and timers are kept in milliseconds
+    Time PortTimes;
+    SmTimers Timers;
+};
+
+/**
+ * @brief The BridgeSnapshot struct is read-only copy of variables of the bridge (17.18) and
+ *        all its ports, as seen after single evaluation of state machines
+ */
+struct BridgeSnapshot {
+    /// @brief Incremented by every publication, so readers might detect change of state
+    u64 Version = 0;
+    /// @brief Time of the clock of the RSTP at the publication. Evaluation which changes
+    ///        nothing is not published, so it is time of the last change of state.
+    u64 TimeMs = 0;
+    BridgeId BridgeIdentifier;
+    PriorityVector RootPriority;
+    class PortId RootPortId;
+    /// @brief Port which would replace the root port on its loss, 0 if there is none. Roles
+    ///        which other ports would take then are not planned.
+    u16 BackupRootPortNo = 0;
+    Time RootTimes;
+    Time BridgeTimes;
+    BridgeConfig Config;
+    /// @brief Sorted by port number
+    std::vector<PortSnapshot> Ports;
+
+    /// @return The port, nullptr if there is no such port
+    const PortSnapshot* FindPort(const u16 portNo) const noexcept;
+};
+
+inline const PortSnapshot* BridgeSnapshot::FindPort(const u16 portNo) const noexcept {
+    const auto found = std::lower_bound(Ports.begin(), Ports.end(), portNo,
+                                        [](const PortSnapshot& port, const u16 no) {
+        return port.PortNo < no;
+    });
+
+    return ((found != Ports.end()) && (found->PortNo == portNo)) ? &*found : nullptr;
+}
+
+} // namespace Stp
@@ -0,0 +1,128 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "clock.hpp"
+#include "lib.hpp"
+
+// C++ Standard Library
+#include <atomic>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+namespace Stp {
+
+/**
+ * @brief The BudgetedQueue class passes items pushed by any thread to the single thread, which
+ *        handles them in slices limited by the deadline. Items left by the slice wait for the
+ *        next one, so the thread might run other work (e.g. ticks of the RSTP) in time however
+ *        many items are pushed. Depth of the queue and its high-water mark are read by any
+ *        thread.
+ */
+template <typename T>
+class BudgetedQueue {
+public:
+    BudgetedQueue() noexcept;
+
+    BudgetedQueue(const BudgetedQueue&) = delete;
+    BudgetedQueue& operator=(const BudgetedQueue&) = delete;
+
+    /// @note Might be called from any thread
+    void Push(T item);
+    /**
+     * @brief Drain handles items in order until the queue is empty or the clock reaches the
+     *        deadline. At least one item is handled, so the queue makes progress even if the
+     *        deadline has passed already.
+     * @param handle called with every item, which it takes
+     * @return true if items are left for the next slice
+     */
+    template <typename Handler>
+    bool Drain(const Clock& clock, const Clock::Duration deadline, Handler&& handle);
+
+    u64 Depth() const noexcept;
+    /// @return The greatest depth since the queue has been created
+    u64 HighWater() const noexcept;
+    /// @return Number of handled items
+    u64 Handled() const noexcept;
+    /// @return Number of slices which have reached the deadline before the queue got empty
+    u64 Deferred() const noexcept;
+
+private:
+    std::queue<T> _items;
+    std::mutex _mtxItems;
+    std::atomic<u64> _depth;
+    std::atomic<u64> _highWater;
+    std::atomic<u64> _handled;
+    std::atomic<u64> _deferred;
+};
+
+template <typename T>
+BudgetedQueue<T>::BudgetedQueue() noexcept
+    : _items{ }, _mtxItems{ }, _depth{ 0 }, _highWater{ 0 }, _handled{ 0 }, _deferred{ 0 } {
+    // Nothing more to do
+}
+
+template <typename T>
+void BudgetedQueue<T>::Push(T item) {
+    std::lock_guard<std::mutex> itemsGuard{ _mtxItems };
+    _items.push(std::move(item));
+    const u64 depth = _items.size();
+    _depth.store(depth, std::memory_order_relaxed);
+    // Only written under the mutex, so it does not need compare-exchange
+    if (depth > _highWater.load(std::memory_order_relaxed)) {
+        _highWater.store(depth, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+template <typename Handler>
+bool BudgetedQueue<T>::Drain(const Clock& clock, const Clock::Duration deadline,
+                             Handler&& handle) {
+    std::unique_lock<std::mutex> itemsGuard{ _mtxItems, std::defer_lock };
+    while (true) {
+        itemsGuard.lock();
+        if (_items.empty()) {
+            return false;
+        }
+
+        T item{ std::move(_items.front()) };
+        _items.pop();
+        _depth.store(_items.size(), std::memory_order_relaxed);
+        itemsGuard.unlock();
+
+        handle(std::move(item));
+        _handled.fetch_add(1, std::memory_order_relaxed);
+        if ((clock.Now() >= deadline) && (_depth.load(std::memory_order_relaxed) > 0)) {
+            _deferred.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+template <typename T>
+inline u64 BudgetedQueue<T>::Depth() const noexcept {
+    return _depth.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+inline u64 BudgetedQueue<T>::HighWater() const noexcept {
+    return _highWater.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+inline u64 BudgetedQueue<T>::Handled() const noexcept {
+    return _handled.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+inline u64 BudgetedQueue<T>::Deferred() const noexcept {
+    return _deferred.load(std::memory_order_relaxed);
+}
+
+} // namespace Stp
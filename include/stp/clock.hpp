@@ -0,0 +1,194 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "lib.hpp"
+
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Stp {
+
+/**
+ * @brief The Wakeup class lets other threads end waiting of the clock before its time, e.g. once
+ *        they have queued work for the waiting thread
+ */
+class Wakeup {
+public:
+    Wakeup() noexcept;
+
+    Wakeup(const Wakeup&) = delete;
+    Wakeup& operator=(const Wakeup&) = delete;
+
+    /// @note Might be called from any thread. Notification made before waiting is not lost.
+    void Notify();
+    /// @return true if notified since the last call
+    bool Consume();
+    /**
+     * @brief WaitUntil blocks the caller until notification or until the time of steady clock
+     * @return true if notified
+     */
+    bool WaitUntil(const std::chrono::steady_clock::time_point time);
+
+private:
+    std::mutex _mtx;
+    std::condition_variable _notified;
+    bool _pending;
+};
+
+/**
+ * @brief The Clock class is the source of time for the STP. Time is measured from the clock's own
+ *        epoch, so only differences between two readings are meaningful.
+ */
+class Clock {
+public:
+    using Duration = std::chrono::nanoseconds;
+
+    virtual ~Clock() = default;
+
+    /**
+     * @brief Now reads current time
+     * @return Time elapsed since the clock's epoch
+     */
+    virtual Duration Now() const noexcept = 0;
+    /**
+     * @brief WaitUntil blocks the caller until the time is reached
+     * @param time point (since the clock's epoch) to wait for
+     */
+    virtual void WaitUntil(const Duration time) = 0;
+    /**
+     * @brief WaitUntil blocks the caller until the time is reached or until the wakeup is
+     *        notified, whichever comes first
+     * @return true if waiting has been ended by the wakeup
+     */
+    virtual bool WaitUntil(const Duration time, Wakeup& wakeup);
+};
+
+using ClockH = Sptr<Clock>;
+
+/**
+ * @brief The SystemClock class follows the wall time and really sleeps while waiting
+ */
+class SystemClock final : public Clock {
+public:
+    Duration Now() const noexcept override;
+    void WaitUntil(const Duration time) override;
+    bool WaitUntil(const Duration time, Wakeup& wakeup) override;
+
+private:
+    static std::chrono::steady_clock::time_point ToTimePoint(const Duration time) noexcept;
+};
+
+/**
+ * @brief The VirtualClock class is the discrete-event clock. Waiting moves time straight to the
+ *        requested point without sleeping, so scenarios which take minutes of protocol time
+ *        complete as fast as the CPU is able to process events.
+ */
+class VirtualClock final : public Clock {
+public:
+    explicit VirtualClock(const Duration start = Duration::zero()) noexcept;
+
+    using Clock::WaitUntil;
+
+    Duration Now() const noexcept override;
+    /// @note Time never goes backward, so waiting for the past point does nothing
+    void WaitUntil(const Duration time) override;
+    void Advance(const Duration duration) noexcept;
+
+private:
+    std::atomic<s64> _nowNs;
+};
+
+inline Wakeup::Wakeup() noexcept
+    : _mtx{ }, _notified{ }, _pending{ false } {
+}
+
+inline void Wakeup::Notify() {
+    {
+        std::lock_guard<std::mutex> pendingGuard{ _mtx };
+        if (_pending) {
+            return;
+        }
+
+        _pending = true;
+    }
+
+    _notified.notify_one();
+}
+
+inline bool Wakeup::Consume() {
+    std::lock_guard<std::mutex> pendingGuard{ _mtx };
+    const bool pending = _pending;
+    _pending = false;
+
+    return pending;
+}
+
+inline bool Wakeup::WaitUntil(const std::chrono::steady_clock::time_point time) {
+    std::unique_lock<std::mutex> pendingGuard{ _mtx };
+    const bool pending = _notified.wait_until(pendingGuard, time, [this]() { return _pending; });
+    _pending = false;
+
+    return pending;
+}
+
+inline bool Clock::WaitUntil(const Duration time, Wakeup& wakeup) {
+    // The clock which can't be woken up checks only notifications made before waiting
+    if (wakeup.Consume()) {
+        return true;
+    }
+
+    WaitUntil(time);
+
+    return false;
+}
+
+inline Clock::Duration SystemClock::Now() const noexcept {
+    return std::chrono::duration_cast<Duration>(
+                std::chrono::steady_clock::now().time_since_epoch());
+}
+
+inline void SystemClock::WaitUntil(const Duration time) {
+    std::this_thread::sleep_until(ToTimePoint(time));
+}
+
+inline bool SystemClock::WaitUntil(const Duration time, Wakeup& wakeup) {
+    return wakeup.WaitUntil(ToTimePoint(time));
+}
+
+inline std::chrono::steady_clock::time_point SystemClock::ToTimePoint(const Duration time)
+    noexcept {
+    return std::chrono::steady_clock::time_point{
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(time) };
+}
+
+inline VirtualClock::VirtualClock(const Duration start) noexcept
+    : _nowNs{ start.count() } {
+}
+
+inline Clock::Duration VirtualClock::Now() const noexcept {
+    return Duration{ _nowNs.load(std::memory_order_acquire) };
+}
+
+inline void VirtualClock::WaitUntil(const Duration time) {
+    s64 now = _nowNs.load(std::memory_order_relaxed);
+    while ((now < time.count())
+           && not _nowNs.compare_exchange_weak(now, time.count(), std::memory_order_acq_rel)) {
+        // Retry with time read by failed exchange
+    }
+}
+
+inline void VirtualClock::Advance(const Duration duration) noexcept {
+    _nowNs.fetch_add(duration.count(), std::memory_order_acq_rel);
+}
+
+} // namespace Stp
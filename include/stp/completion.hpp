@@ -0,0 +1,71 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "lib.hpp"
+
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace Stp {
+
+/**
+ * @brief The CompletionGroup class tracks completion of management commands, which are
+ *        performed asynchronously by the RSTP thread. The caller owns the group and passes it
+ *        to any number of commands, then waits once until all of them have been performed.
+ *        Commands keep only pointer to the group, so tracking does not allocate memory.
+ * @note The group must outlive all commands passed to it. It might be destroyed once Wait() or
+ *       WaitFor() has reported that all of them have been performed.
+ */
+class CompletionGroup {
+public:
+    CompletionGroup() noexcept;
+
+    CompletionGroup(const CompletionGroup&) = delete;
+    CompletionGroup& operator=(const CompletionGroup&) = delete;
+
+    /// @brief Expect registers command which is going to be completed
+    void Expect() noexcept;
+    /// @brief Complete is called once the command has been performed
+    void Complete(const Result result);
+
+    /**
+     * @brief Wait blocks until all expected commands have been performed
+     * @return Result::Success if all of them succeeded, otherwise Result::Fail
+     */
+    Result Wait();
+    /**
+     * @brief WaitFor does the same as the above one, but gives up after the timeout
+     * @return Result::Success if all commands succeeded, otherwise Result::Fail (also on timeout)
+     */
+    Result WaitFor(const std::chrono::milliseconds timeout);
+
+    /// @return Number of commands which have not been performed yet
+    u64 Pending() const noexcept;
+    /// @return Number of performed commands which have failed
+    u64 Failed() const noexcept;
+
+private:
+    std::atomic<u64> _pending;
+    std::atomic<u64> _failed;
+    std::mutex _mtx;
+    std::condition_variable _done;
+};
+
+inline u64 CompletionGroup::Pending() const noexcept {
+    return _pending.load(std::memory_order_acquire);
+}
+
+inline u64 CompletionGroup::Failed() const noexcept {
+    return _failed.load(std::memory_order_acquire);
+}
+
+} // namespace Stp
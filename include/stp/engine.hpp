@@ -0,0 +1,484 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "bpdu.hpp"
+#include "bpdu_fingerprint.hpp"
+#include "bridge.hpp"
+#include "bridge_snapshot.hpp"
+#include "clock.hpp"
+#include "engine_stats.hpp"
+#include "latency_tracker.hpp"
+#include "lib.hpp"
+#include "logger.hpp"
+#include "mac.hpp"
+#include "port.hpp"
+#include "port_stats.hpp"
+#include "rcu_cell.hpp"
+#include "replication.hpp"
+#include "seqlock.hpp"
+#include "state_image.hpp"
+#include "state_machine.hpp"
+#include "system.hpp"
+
+// C++ Standard Library
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Stp {
+
+/**
+ * @brief The StateMachine class groups all state machines which run on the single port. The
+ *        port, its machines and all its counters are kept in single slab, so every port costs
+ *        one heap allocation and its state is not scattered over the heap.
+ */
+class StateMachine {
+public:
+    /// @brief StateMachine creates new port of the bridge together with its machines
+    explicit StateMachine(BridgeH bridge);
+    /**
+     * @brief TickEvent runs every state machine of the port once
+     * @return true if any state machine has moved to another state, otherwise false
+     */
+    bool TickEvent();
+    /// @return The port, which shares ownership of the slab
+    PortH PortInstance() const noexcept;
+    /// @return The port, without sharing ownership of the slab
+    Port& GetPortData() noexcept;
+    u16 PortNo() const noexcept;
+    /**
+     * @brief MarkChanged records that the publication of the version changes the port
+     * @return false if it has been recorded already
+     */
+    bool MarkChanged(const u64 version) noexcept;
+    /// @return Counters of the port visible to other threads
+    const SeqLock<PortStats>& StatsSnapshot() const noexcept;
+    SeqLock<PortStats>& GetStatsSnapshot() noexcept;
+    /// @brief SkipInitBridge lets the port join role selection of ports added together with it
+    void SkipInitBridge() noexcept;
+    /**
+     * @brief ChangeOperEdge sets operEdge changed by management and moves Bridge Detection
+     *        machine (17.25) to the state which keeps it
+     */
+    void ChangeOperEdge(const bool operEdge) noexcept;
+    /// @brief SaveState writes variables of the port and states of its machines to the record
+    void SaveState(StateImage::PortRecord& record) const noexcept;
+    /// @return true if every machine knows its state saved in the record
+    static bool KnowsStates(const StateImage::PortRecord& record) noexcept;
+    /**
+     * @brief RestoreState restores the port and its machines saved by SaveState(), without
+     *        executing actions of restored states
+     * @param elapsedMs time elapsed since the record has been written
+     */
+    void RestoreState(const StateImage::PortRecord& record, const u32 elapsedMs) noexcept;
+#ifdef STP_ENGINE_STATS
+    const PortMachineCounters& Counters() const noexcept;
+#endif
+
+    /// @return Size of the slab allocated for every port
+    static std::size_t SlabSize() noexcept;
+
+private:
+    struct Slab;
+
+    Sptr<Slab> _slab;
+};
+
+/**
+ * @brief The Engine class represents the RSTP running on the single bridge. It owns the bridge
+ *        instance together with state machines of all its ports and performs requests
+ *        synchronously, so the caller is responsible for serializing access to it.
+ */
+class Engine {
+public:
+    Engine(const Mac& bridgeAddr, SystemH system);
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    /**
+     * @brief AddPort adds port to the bridge and starts state machines on it
+     * @param portNo port number to add
+     * @param speed of port in Megabits [Mb]
+     * @param enabled indicates if port is enabled (true) or disabled (false)
+     * @return Result::Success if port has been added, otherwise Result::Fail
+     */
+    Result AddPort(const u16 portNo, const u32 speed, const bool enabled);
+    /**
+     * @brief RemovePort stops state machines on the port and removes it from the bridge
+     * @param portNo port number to remove
+     * @return Result::Success if port has been removed, otherwise Result::Fail
+     */
+    Result RemovePort(const u16 portNo);
+    /**
+     * @brief AddPorts adds many ports at once (e.g. at startup of chassis). Ports are
+     *        initialized together and roles of all ports are selected once afterwards, so time
+     *        of adding grows linearly with number of ports.
+     * @param ports to add, in any order
+     * @return Result::Success if ports have been added, otherwise Result::Fail and none of them
+     *         is added (some port exists or is given twice)
+     */
+    Result AddPorts(const std::vector<PortSpec>& ports);
+    /**
+     * @brief RemovePorts removes many ports at once and reselects roles of remaining ports
+     * @param portNos port numbers to remove
+     * @return Result::Success if ports have been removed, otherwise Result::Fail and none of
+     *         them is removed (some port does not exist or is given twice)
+     */
+    Result RemovePorts(const std::vector<u16>& portNos);
+    /**
+     * @brief SetPortEnabled changes operational state of the port (e.g. on link up or down).
+     *        State machines are evaluated at once, so information of disabled port is discarded
+     *        and roles are reselected without waiting for the next tick.
+     * @param portNo port number which state has changed
+     * @param enabled true if port is operational, otherwise false
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    Result SetPortEnabled(const u16 portNo, const bool enabled);
+    /**
+     * @brief SetPortsEnabled does the same as SetPortEnabled() for many ports (e.g. on failure
+     *        of line card), which are reselected by single evaluation of state machines
+     * @param portNos port numbers which state has changed
+     * @return Result::Success if all ports exist, otherwise Result::Fail and none of them is
+     *         changed
+     */
+    Result SetPortsEnabled(const std::vector<u16>& portNos, const bool enabled);
+    /**
+     * @brief SetPortAdminEdge sets administrative value of edge port (14.8.2.1.3 j). The port
+     *        becomes edge port, or stops being the one, at once and state machines are evaluated.
+     *        The port which is still detected as edge port by autoEdge stays the one.
+     * @return Result::Success if the port exists, otherwise Result::Fail
+     */
+    Result SetPortAdminEdge(const u16 portNo, const bool adminEdge);
+    /**
+     * @brief SetPortAutoEdge enables detection of edge port by lack of BPDUs (14.8.2.1.3 l).
+     *        The port which is edge port only by detection stops being the one once it is
+     *        disabled. State machines are evaluated at once.
+     * @return Result::Success if the port exists, otherwise Result::Fail
+     */
+    Result SetPortAutoEdge(const u16 portNo, const bool autoEdge);
+    /**
+     * @brief SetPortPointToPoint tells whether the port is connected to point-to-point LAN
+     *        (6.4.3). Only such ports complete rapid proposal/agreement handshake, other ones
+     *        wait for expiry of forward delay timers. State machines are evaluated at once.
+     * @return Result::Success if the port exists, otherwise Result::Fail
+     */
+    Result SetPortPointToPoint(const u16 portNo, const bool pointToPoint);
+    /**
+     * @brief SetPortPriority changes priority of port identifier (17.13.10) and reselects role
+     *        of the port
+     * @param priority multiple of 16 in range [0, 240]
+     * @return Result::Success if the port exists and priority is valid, otherwise Result::Fail
+     */
+    Result SetPortPriority(const u16 portNo, const u32 priority);
+    /**
+     * @brief SetPortPathCost changes path cost of the port (17.13.11) and reselects role of the
+     *        port
+     * @param pathCost in range [1, 200000000]
+     * @return Result::Success if the port exists and path cost is valid, otherwise Result::Fail
+     */
+    Result SetPortPathCost(const u16 portNo, const u32 pathCost);
+    /**
+     * @brief SetBridgeConfig applies managed parameters of the bridge without restart. Roles of
+     *        all ports are reselected, so changed information is transmitted (17.13). Change of
+     *        protocol version makes ports check protocol of the LAN again (mcheck) and change of
+     *        transmit hold count resets txCount. State machines are evaluated at once.
+     * @return Result::Success if parameters are valid, otherwise Result::Fail
+     */
+    Result SetBridgeConfig(const BridgeConfig& config);
+    /// @brief GetBridgeConfig reads managed parameters of the bridge
+    void GetBridgeConfig(BridgeConfig& config) const noexcept;
+    /**
+     * @brief SetPortFastHello makes the port transmit BPDUs and advertise hello time shorter than
+     *        one second, so loss of BPDUs on its link is detected after three of them. Peer port
+     *        has to be configured the same way, otherwise it treats hello time as one second.
+     *        The engine has to tick as often as the shortest hello time of its ports, see
+     *        TickIntervalMs().
+     * @param helloTimeMs in range [Time::MinFastHelloTimeMs, Time::MaxFastHelloTimeMs], 0 to use
+     *        hello time of the bridge again
+     * @return Result::Success if the port exists and hello time is valid, otherwise Result::Fail
+     */
+    Result SetPortFastHello(const u16 portNo, const u32 helloTimeMs);
+    /**
+     * @brief ProcessBpdu decodes BPDU data and passes it to the port which received it
+     * @param rxPortNo port number from which received BPDU
+     * @param data BPDU data unit
+     * @return Result::Success if BPDU has been accepted, otherwise Result::Fail
+     */
+    Result ProcessBpdu(const u16 rxPortNo, const ByteStream& data);
+    /**
+     * @brief ProcessBpdu does the same as the above one for BPDU which has been accepted at
+     *        given time, so latency of its handling is measured from that time
+     * @param ingressTime time of the clock of the bridge, Clock::Duration::min() if unknown
+     */
+    Result ProcessBpdu(const u16 rxPortNo, const ByteStream& data,
+                       const Clock::Duration ingressTime);
+    /**
+     * @brief ProcessDecodedBpdu passes BPDU which has been already decoded and validated to
+     *        the port which received it
+     * @param rxPortNo port number from which received BPDU
+     * @param bpdu decoded BPDU
+     * @param fingerprint raw copy of received BPDU data
+     * @param ingressTime time of acceptance of BPDU, Clock::Duration::min() if unknown
+     * @return Result::Success if BPDU has been accepted, otherwise Result::Fail
+     */
+    Result ProcessDecodedBpdu(const u16 rxPortNo, const Bpdu& bpdu,
+                              const BpduFingerprint& fingerprint,
+                              const Clock::Duration ingressTime);
+    /**
+     * @brief Tick signals that TickIntervalMs() elapsed and runs state machines of all ports
+     */
+    void Tick();
+    /// @return Period of calling Tick(), one second unless some port is in fast hello mode
+    u32 TickIntervalMs() const noexcept;
+    /**
+     * @brief Evaluate runs state machines of all ports without advancing timers, until none of
+     *        them changes its state
+     */
+    void Evaluate();
+    void SetLogSeverity(const LoggingSystem::Logger::LogSeverity logSeverity);
+    void GetRxFastPathCounters(u64& hits, u64& misses) const noexcept;
+    /**
+     * @brief GetStats reads counters of state machines of all ports. It might be called from
+     *        any thread while the engine is running.
+     * @param stats snapshot of counters
+     * @return Result::Success if counters have been read, Result::Fail if they have been
+     *         compiled out (STP_ENGINE_STATS is not defined)
+     */
+    Result GetStats(EngineStats& stats) const;
+    /**
+     * @brief GetPortStats reads protocol counters of the port, as published after the last
+     *        evaluation of state machines. It might be called from any thread.
+     * @param portNo port number which counters to read
+     * @param stats counters of the port
+     * @return Result::Success if the port exists, otherwise Result::Fail
+     */
+    Result GetPortStats(const u16 portNo, PortStats& stats) const;
+    /**
+     * @brief GetAllPortStats reads protocol counters of all ports. It might be called from any
+     *        thread.
+     * @param stats counters indexed by port number
+     */
+    void GetAllPortStats(std::map<u16, PortStats>& stats) const;
+    /**
+     * @brief GetLatencyReport reads histograms of latency from acceptance of BPDU to its
+     *        consumption and to reaction of the bridge. It might be called from any thread.
+     * @param report snapshot of histograms
+     */
+    void GetLatencyReport(LatencyReport& report) const;
+    /**
+     * @brief StartTrace starts recording of state transitions, BPDUs, timer expiries and
+     *        hardware calls into the trace buffer. It might be called from any thread.
+     * @param capacity number of the newest events kept by the buffer
+     * @param stateSpans exports states of machines as spans with duration
+     * @return Result::Success if tracing has started, otherwise Result::Fail
+     */
+    Result StartTrace(const u32 capacity, const bool stateSpans);
+    /// @brief StopTrace stops recording and keeps recorded events for export
+    void StopTrace() noexcept;
+    /**
+     * @brief WriteTrace exports recorded events as Chrome Trace Event JSON, which might be
+     *        opened by chrome://tracing or Perfetto UI. It might be called from any thread.
+     */
+    void WriteTrace(std::ostream& out) const;
+    /**
+     * @brief ReadSnapshot takes read-only state of the bridge and its ports, as published after
+     *        the last evaluation of state machines which has changed it. It never waits for the
+     *        RSTP, so it might be called from any thread at any rate.
+     * @note The snapshot is kept alive until the guard is destroyed, which should not outlive
+     *       the engine
+     */
+    RcuCell<BridgeSnapshot>::ReadGuard ReadSnapshot() const noexcept;
+    /**
+     * @brief StartStateImage mirrors state of the bridge, its ports and their state machines
+     *        into memory-mapped file after every evaluation, so the next run of the RSTP might
+     *        continue from it, see RestoreStateImage()
+     * @return Result::Success if the file has been mapped, otherwise Result::Fail
+     */
+    Result StartStateImage(const std::string& path);
+    /// @brief StopStateImage stops mirroring, the file keeps the last image
+    void StopStateImage() noexcept;
+    /**
+     * @brief RestoreStateImage adds ports mirrored by the previous run of the RSTP and lets
+     *        their machines continue from saved states, with timers advanced by time elapsed
+     *        since then. OutInterface is not called, so forwarding state of hardware is kept.
+     * @return Result::Success if state has been restored, Result::Fail if the engine has
+     *         ports already or the file does not hold complete image of this bridge, written
+     *         by compatible version since the clock has been started (e.g. before reboot)
+     */
+    Result RestoreStateImage(const std::string& path);
+    /**
+     * @brief StartReplication streams changes of state of the bridge, its ports and their state
+     *        machines to the standby RSTP connected to the local socket, after every evaluation.
+     *        The standby connected later receives the whole state first.
+     * @return Result::Success if the socket listens on the path, otherwise Result::Fail
+     */
+    Result StartReplication(const std::string& path);
+    /// @brief StopReplication disconnects the standby and closes the socket
+    void StopReplication() noexcept;
+    /**
+     * @brief TakeOver adds ports of the replica received from the primary RSTP and lets their
+     *        machines continue, as RestoreStateImage() does
+     * @param elapsedMs time elapsed since the last frame has been received, which timers are
+     *        advanced by
+     * @return Result::Success if state has been taken over, Result::Fail if the engine has ports
+     *         already or the replica does not hold complete state of this bridge
+     */
+    Result TakeOver(const Replica& replica, const u32 elapsedMs);
+
+    const Bridge& BridgeInstance() const noexcept;
+    Bridge& GetBridgeInstance() noexcept;
+
+    /**
+     * @brief DecodeBpdu decodes and validates BPDU data, then filters BPDU which has been
+     *        received by the port which transmitted it
+     * @note It does not touch state of any engine, so might be called from any thread
+     * @param data BPDU data unit
+     * @param rxPortNo port number from which received BPDU
+     * @param bridgeAddr MAC address of the bridge which received BPDU
+     * @param bpdu decoded BPDU
+     * @return Result::Success if BPDU is valid, otherwise Result::Fail
+     */
+    static Result DecodeBpdu(const ByteStream& data, const u16 rxPortNo, const u64 bridgeAddr,
+                             Bpdu& bpdu) noexcept;
+    /**
+     * @brief DecodeBpdu does the same as the above one and tells why BPDU has been rejected
+     * @param reason of rejection, valid only if Result::Fail has been returned
+     */
+    static Result DecodeBpdu(const ByteStream& data, const u16 rxPortNo, const u64 bridgeAddr,
+                             Bpdu& bpdu, BpduDropReason& reason) noexcept;
+
+private:
+    /// @brief Protects from endless evaluation if state machines would oscillate
+    static constexpr u8 _kMaxEvaluationPasses = 64;
+
+    /// @brief Creates the port with its state machines and registers them
+    StateMachine& StartPort(const PortSpec& spec);
+    /// @brief Stops state machines of the port and removes it
+    void StopPort(const u16 portNo);
+    /// @return Position of machines of the port, or of the first port with greater number
+    std::vector<StateMachine>::iterator FindPosition(const u16 portNo) noexcept;
+    /// @return Machines of the port, nullptr if there is no such port
+    StateMachine* FindStateMachine(const u16 portNo) noexcept;
+    const StateMachine* FindStateMachine(const u16 portNo) const noexcept;
+    bool TryRxFastPath(Port& port, const bool repeated,
+                       const Clock::Duration ingressTime) noexcept;
+    /// @brief Counts and traces BPDU received by the port
+    void CountRx(Port& port, const Bpdu& bpdu) noexcept;
+    /// @brief Records changes of role and state of changed ports and publishes their counters
+    void PublishStats() noexcept;
+    void PublishStats(StateMachine& sm, const u64 nowMs) noexcept;
+    /// @brief Makes Port Role Selection machine recompute role of the port (17.13)
+    void Reselect(Port& port);
+    /// @brief Ticks as often as the shortest hello time of ports requires
+    void UpdateTickInterval() noexcept;
+    /// @brief Records that the next publication changes the port
+    void MarkChanged(const u16 portNo);
+    void MarkChanged(StateMachine& sm);
+    /// @brief Records that the next publication changes every port
+    void MarkAllChanged() noexcept;
+    /**
+     * @brief CollectChangedPorts lists ports changed by publications after the given one, in
+     *        order of their numbers. Ports which have been removed are listed too.
+     * @param baseline version of published state which records hold, 0 if none
+     * @return false if changed ports are not known, so every record has to be written again
+     */
+    bool CollectChangedPorts(const u64 baseline, std::vector<u16>& portNos) const;
+    /**
+     * @brief UpdateRecords writes records of listed ports again, inserts records of added
+     *        ports and erases records of removed ones. Records are kept in order of port
+     *        numbers and there has to be room for records of all current ports.
+     * @param save writes state of the port to its record, which port number is set already
+     * @return Number of records after the update
+     */
+    template <typename Record, typename SaveRecord>
+    u32 UpdateRecords(Record* records, u32 count, const std::vector<u16>& portNos,
+                      SaveRecord save);
+    /// @brief Publishes state of the bridge and its ports to readers of snapshot, if it has
+    ///        changed since the last publication
+    void PublishSnapshot();
+    /// @brief Writes state of the bridge and its ports to the state image
+    void SaveStateImage();
+    /// @brief Writes state of every port in order of their numbers
+    void SavePorts(StateImage::PortRecord* records) const noexcept;
+    /// @brief Adds ports of the records, which have been checked, and restores their state
+    void RestorePorts(const StateImage::BridgeRecord& bridge,
+                      const StateImage::PortRecord* records, const u32 portCount,
+                      const u32 elapsedMs);
+    /// @return true if the records hold state of this bridge which might be restored
+    bool CanRestore(const StateImage::BridgeRecord& bridge,
+                    const StateImage::PortRecord* records, const u32 portCount) const noexcept;
+    /// @brief Sends changes of state to the standby
+    void Replicate();
+
+    BridgeH _bridge;
+    /// @brief Sorted by port numbers. Modified only under the mutex, so other threads which read
+    ///        published counters of ports do not race with adding of ports.
+    std::vector<StateMachine> _runningStateMachines;
+    mutable std::mutex _mtxRunningStateMachines;
+    std::atomic<u64> _rxFastPathHits;
+    std::atomic<u64> _rxFastPathMisses;
+    RcuCell<BridgeSnapshot> _snapshot;
+    u64 _snapshotVersion;
+    /// @brief Port changed by the publication of the version
+    struct PortChange {
+        u64 Version;
+        u16 PortNo;
+    };
+    /// @brief Changed ports are kept for the last publications only, as the snapshot and the
+    ///        state image reuse copies which are a few publications old
+    static constexpr u64 _kKeptPublications = 8;
+    /// @brief In order of versions, the next publication included
+    std::vector<PortChange> _portChanges;
+    /// @brief Changed ports of this and earlier publications are not kept anymore
+    u64 _portChangesFloor;
+    /// @brief The last publication, or the next one, which has changed every port
+    u64 _allPortsChangedVersion;
+    /// @brief Number of ports changed since the last publication
+    u32 _changedPortCount;
+    /// @brief State of the bridge or any port has changed since the last publication
+    bool _changed;
+    /// @brief Reused by every publication, so it does not allocate once ports have settled
+    std::vector<u16> _changedPorts;
+    Uptr<StateImage> _stateImage;
+    std::string _stateImagePath;
+    /// @brief Versions of published state which slots of the image hold, 0 if none
+    u64 _activeImageVersion;
+    u64 _inactiveImageVersion;
+    Uptr<ReplicationChannel> _replicationChannel;
+    ReplicationEncoder _replicationEncoder;
+    /// @brief Reused by every frame, so replication does not allocate once ports have settled
+    std::vector<StateImage::PortRecord> _replicatedPorts;
+    /// @brief Version of published state which replicated records hold, 0 if none
+    u64 _replicatedVersion;
+    ByteStream _replicationFrame;
+};
+
+using EngineH = Uptr<Engine>;
+
+inline RcuCell<BridgeSnapshot>::ReadGuard Engine::ReadSnapshot() const noexcept {
+    return _snapshot.Read();
+}
+
+inline u32 Engine::TickIntervalMs() const noexcept {
+    return _bridge->TickIntervalMs();
+}
+
+inline const Bridge& Engine::BridgeInstance() const noexcept {
+    return *_bridge;
+}
+
+inline Bridge& Engine::GetBridgeInstance() noexcept {
+    return *_bridge;
+}
+
+} // namespace Stp
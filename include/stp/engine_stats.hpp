@@ -0,0 +1,171 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "lib.hpp"
+
+// C++ Standard Library
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#endif
+
+namespace Stp {
+
+/**
+ * @brief The MachineType enum represents state machines in order in which they run on every port
+ */
+enum class MachineType : u8 {
+    Pti, ///< Port Timers
+    Prx, ///< Port Receive
+    Ppm, ///< Port Protocol Migration
+    Bdm, ///< Bridge Detection
+    Ptx, ///< Port Transmit
+    Pim, ///< Port Information
+    Prs, ///< Port Role Selection
+    Prt, ///< Port Role Transitions
+    Pst, ///< Port State Transition
+    Tcm, ///< Topology Change
+    Count
+};
+
+constexpr u8 MachineTypeCount = static_cast<u8>(MachineType::Count);
+
+const char* MachineTypeName(const MachineType type) noexcept;
+
+/**
+ * @brief ReadCycles reads time stamp counter of the CPU, or monotonic clock in nanoseconds on
+ *        architectures without it
+ */
+inline u64 ReadCycles() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/// @brief Size of the cache line of the CPU, assumed as the same on all supported architectures
+constexpr std::size_t CacheLineSize = 64;
+
+/**
+ * @brief The MachineCounters class counts work done by the single state machine of the single
+ *        port. Only the RSTP thread writes them, while any other thread might read them at any
+ *        time. Every instance takes the whole cache line, so writes of one machine do not
+ *        invalidate counters of its neighbours read by the other thread.
+ */
+class alignas(CacheLineSize) MachineCounters {
+public:
+    /**
+     * @brief RecordExecution counts single execution of current state
+     * @param cycles spent in execution
+     * @param transition true if machine has moved to another state
+     */
+    void RecordExecution(const u64 cycles, const bool transition) noexcept;
+    /**
+     * @brief RecordGuard counts single evaluation of condition of transition
+     * @param met true if the condition has been met, also for re-entry of current state
+     */
+    void RecordGuard(const bool met) noexcept;
+
+    u64 Executions() const noexcept;
+    u64 Transitions() const noexcept;
+    u64 GuardEvaluations() const noexcept;
+    u64 GuardHits() const noexcept;
+    u64 Cycles() const noexcept;
+
+private:
+    /// @brief Single writer does not need atomic read-modify-write
+    static void Add(std::atomic<u64>& counter, const u64 value) noexcept;
+
+    std::atomic<u64> _executions{ 0 };
+    std::atomic<u64> _transitions{ 0 };
+    std::atomic<u64> _guardEvaluations{ 0 };
+    std::atomic<u64> _guardHits{ 0 };
+    std::atomic<u64> _cycles{ 0 };
+};
+
+static_assert(sizeof(MachineCounters) == CacheLineSize, "Counters take the single cache line");
+static_assert(alignof(MachineCounters) == CacheLineSize, "Counters start at the cache line");
+
+using PortMachineCounters = std::array<MachineCounters, MachineTypeCount>;
+
+/**
+ * @brief The MachineStats struct is snapshot of counters of the single state machine
+ */
+struct MachineStats {
+    u64 Executions = 0;
+    u64 Transitions = 0; ///< Executions which have moved machine to another state
+    u64 GuardEvaluations = 0; ///< Conditions of transitions evaluated by executions
+    u64 GuardHits = 0; ///< Met conditions, including re-entries of the current state
+    u64 Cycles = 0; ///< CPU cycles spent in executions
+
+    /// @return Share of evaluated conditions which have been met
+    double GuardHitRate() const noexcept;
+    MachineStats& operator+=(const MachineStats& other) noexcept;
+};
+
+/**
+ * @brief The EngineStats class is snapshot of counters of all state machines of the bridge.
+ *        Counters are read one by one, so the snapshot is not consistent between machines.
+ */
+class EngineStats {
+public:
+    using PortStats = std::array<MachineStats, MachineTypeCount>;
+
+    std::map<u16, PortStats> Ports; ///< Indexed by port number
+
+    /// @return Sum of counters of given machine of all ports
+    MachineStats Total(const MachineType type) const noexcept;
+};
+
+inline void MachineCounters::RecordExecution(const u64 cycles, const bool transition) noexcept {
+    Add(_executions, 1);
+    Add(_cycles, cycles);
+    if (transition) {
+        Add(_transitions, 1);
+    }
+}
+
+inline void MachineCounters::RecordGuard(const bool met) noexcept {
+    Add(_guardEvaluations, 1);
+    if (met) {
+        Add(_guardHits, 1);
+    }
+}
+
+inline u64 MachineCounters::Executions() const noexcept {
+    return _executions.load(std::memory_order_relaxed);
+}
+
+inline u64 MachineCounters::Transitions() const noexcept {
+    return _transitions.load(std::memory_order_relaxed);
+}
+
+inline u64 MachineCounters::GuardEvaluations() const noexcept {
+    return _guardEvaluations.load(std::memory_order_relaxed);
+}
+
+inline u64 MachineCounters::GuardHits() const noexcept {
+    return _guardHits.load(std::memory_order_relaxed);
+}
+
+inline u64 MachineCounters::Cycles() const noexcept {
+    return _cycles.load(std::memory_order_relaxed);
+}
+
+inline void MachineCounters::Add(std::atomic<u64>& counter, const u64 value) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // namespace Stp
@@ -0,0 +1,121 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "lib.hpp"
+
+// C++ Standard Library
+#include <atomic>
+#include <ostream>
+#include <vector>
+
+namespace Stp {
+
+/**
+ * @brief The LatencyDistribution class is snapshot of the latency histogram
+ */
+class LatencyDistribution {
+public:
+    LatencyDistribution() = default;
+    LatencyDistribution(std::vector<u64>&& buckets, const u64 sumUs, const u64 maxUs);
+
+    u64 Count() const noexcept;
+    u64 MaxUs() const noexcept;
+    double MeanUs() const noexcept;
+    /**
+     * @brief PercentileUs finds value below which given share of samples falls
+     * @param percentile in range [0, 100]
+     * @return Upper bound of the bucket with the percentile, so error is below 1/8 of value
+     */
+    u64 PercentileUs(const double percentile) const noexcept;
+    /// @brief Counts of samples indexed as LatencyHistogram::BucketIndex() does
+    const std::vector<u64>& Buckets() const noexcept;
+    /// @brief Writes summary and non-empty buckets as JSON object
+    void WriteJson(std::ostream& out) const;
+
+private:
+    std::vector<u64> _buckets;
+    u64 _count = 0;
+    u64 _sumUs = 0;
+    u64 _maxUs = 0;
+};
+
+/**
+ * @brief The LatencyHistogram class counts latencies in microseconds in logarithmic buckets,
+ *        as HDR histogram does: every power of two is split into 8 linear sub-buckets, so
+ *        relative error of recorded value is below 12.5% in whole range of 64 bit values.
+ *        Only one thread records samples, while any thread might read the histogram.
+ */
+class LatencyHistogram {
+public:
+    static constexpr u8 SubBucketBits = 3;
+    static constexpr u16 SubBucketCount = 1 << SubBucketBits;
+    /// @brief Values below 2 * SubBucketCount are counted exactly
+    static constexpr u16 BucketCount = 2 * SubBucketCount
+                                       + (64 - SubBucketBits - 1) * SubBucketCount;
+
+    LatencyHistogram() noexcept;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(const u64 valueUs) noexcept;
+    LatencyDistribution Read() const;
+
+    static u16 BucketIndex(const u64 valueUs) noexcept;
+    /// @return The smallest value counted by the bucket
+    static u64 BucketLowerBound(const u16 index) noexcept;
+    /// @return The greatest value counted by the bucket
+    static u64 BucketUpperBound(const u16 index) noexcept;
+
+private:
+    /// @brief Single writer does not need atomic read-modify-write
+    static void Add(std::atomic<u64>& counter, const u64 value) noexcept;
+
+    std::atomic<u64> _buckets[BucketCount];
+    std::atomic<u64> _sumUs;
+    std::atomic<u64> _maxUs;
+};
+
+inline u64 LatencyDistribution::Count() const noexcept {
+    return _count;
+}
+
+inline u64 LatencyDistribution::MaxUs() const noexcept {
+    return _maxUs;
+}
+
+inline const std::vector<u64>& LatencyDistribution::Buckets() const noexcept {
+    return _buckets;
+}
+
+inline void LatencyHistogram::Record(const u64 valueUs) noexcept {
+    Add(_buckets[BucketIndex(valueUs)], 1);
+    Add(_sumUs, valueUs);
+    if (valueUs > _maxUs.load(std::memory_order_relaxed)) {
+        _maxUs.store(valueUs, std::memory_order_relaxed);
+    }
+}
+
+inline u16 LatencyHistogram::BucketIndex(const u64 valueUs) noexcept {
+    if (valueUs < 2 * SubBucketCount) {
+        return static_cast<u16>(valueUs);
+    }
+
+    const u8 msb = static_cast<u8>(63 - __builtin_clzll(valueUs));
+    const u8 shift = msb - SubBucketBits;
+    const u16 subBucket = static_cast<u16>(valueUs >> shift) - SubBucketCount;
+
+    return static_cast<u16>(2 * SubBucketCount + (shift - 1) * SubBucketCount + subBucket);
+}
+
+inline void LatencyHistogram::Add(std::atomic<u64>& counter, const u64 value) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // namespace Stp
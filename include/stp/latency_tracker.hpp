@@ -0,0 +1,118 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "clock.hpp"
+#include "latency_histogram.hpp"
+#include "lib.hpp"
+#include "port.hpp"
+
+// C++ Standard Library
+#include <chrono>
+#include <ostream>
+
+namespace Stp {
+
+/**
+ * @brief The LatencyStage enum represents events measured from acceptance of BPDU by
+ *        management interface
+ */
+enum class LatencyStage : u8 {
+    Receive, ///< BPDU has been consumed by Port Receive machine (or the repeated-BPDU fast path)
+    Transmit, ///< The first BPDU has been sent out after received new information
+    Forwarding, ///< The first port has started forwarding after received new information
+    Count
+};
+
+constexpr u8 LatencyStageCount = static_cast<u8>(LatencyStage::Count);
+
+const char* LatencyStageName(const LatencyStage stage) noexcept;
+
+/**
+ * @brief The LatencyReport class is snapshot of latency histograms of all stages
+ */
+class LatencyReport {
+public:
+    const LatencyDistribution& Stage(const LatencyStage stage) const noexcept;
+    LatencyDistribution& GetStage(const LatencyStage stage) noexcept;
+    /// @brief Writes distributions of all stages as JSON object indexed by name of stage
+    void WriteJson(std::ostream& out) const;
+
+private:
+    LatencyDistribution _stages[LatencyStageCount];
+};
+
+/**
+ * @brief The LatencyTracker class measures time from acceptance of BPDU to its consumption by
+ *        the port and to reaction of the bridge on new information carried by it. Repeated
+ *        information does not start measurement of reaction, as it causes no reaction.
+ */
+class LatencyTracker {
+public:
+    /// @brief Twice the maximum Forward Delay (17.14), longer reaction can't be caused by BPDU
+    static constexpr std::chrono::seconds MaxForwardingLatency{ 2 * 30 };
+
+    explicit LatencyTracker(ClockH clock) noexcept;
+
+    LatencyTracker(const LatencyTracker&) = delete;
+    LatencyTracker& operator=(const LatencyTracker&) = delete;
+
+    /// @brief Records time of consumption of BPDU received by the port
+    void RecordReceive(const Port& port) noexcept;
+    /**
+     * @brief RecordRcvdInfo starts measurement of reaction if the port has received new
+     *        information, then forgets time of acceptance of received BPDU
+     */
+    void RecordRcvdInfo(Port& port) noexcept;
+    void RecordTransmit() noexcept;
+    void RecordForwarding() noexcept;
+
+    /// @note Might be called from any thread
+    void Read(LatencyReport& report) const;
+
+private:
+    u64 ElapsedUs(const Clock::Duration since) const noexcept;
+    LatencyHistogram& Histogram(const LatencyStage stage) noexcept;
+
+    ClockH _clock;
+    LatencyHistogram _histograms[LatencyStageCount];
+    /// @brief Acceptance of the oldest new information which still waits for reaction
+    Clock::Duration _transmitSince;
+    Clock::Duration _forwardingSince;
+    bool _transmitPending;
+    bool _forwardingPending;
+};
+
+using LatencyTrackerH = Sptr<LatencyTracker>;
+
+inline const LatencyDistribution& LatencyReport::Stage(const LatencyStage stage) const noexcept {
+    return _stages[static_cast<u8>(stage)];
+}
+
+inline LatencyDistribution& LatencyReport::GetStage(const LatencyStage stage) noexcept {
+    return _stages[static_cast<u8>(stage)];
+}
+
+inline void LatencyTracker::RecordReceive(const Port& port) noexcept {
+    if (port.RxIngressTimed()) {
+        Histogram(LatencyStage::Receive).Record(ElapsedUs(port.RxIngressTime()));
+    }
+}
+
+inline void LatencyTracker::RecordTransmit() noexcept {
+    if (_transmitPending) {
+        _transmitPending = false;
+        Histogram(LatencyStage::Transmit).Record(ElapsedUs(_transmitSince));
+    }
+}
+
+inline LatencyHistogram& LatencyTracker::Histogram(const LatencyStage stage) noexcept {
+    return _histograms[static_cast<u8>(stage)];
+}
+
+} // namespace Stp
@@ -7,11 +7,29 @@
 #pragma once
 
 // This project's headers
+#include "bpdu.hpp"
+#include "bpdu_fingerprint.hpp"
+#include "bpdu_policer.hpp"
+#include "bridge_config.hpp"
+#include "bridge_snapshot.hpp"
+#include "clock.hpp"
+#include "completion.hpp"
+#include "engine_stats.hpp"
+#include "latency_tracker.hpp"
 #include "lib.hpp"
 #include "logger.hpp"
 #include "mac.hpp"
+#include "port_stats.hpp"
+#include "request_stats.hpp"
 #include "system.hpp"
 
+// C++ Standard Library
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace Stp {
 
 /**
@@ -27,12 +45,63 @@ public:
      * @return Result::Success if operation completed with success, otherwise Result::Fail
      */
     static Result AddPort(const u16 portNo, const u32 speed, const bool enabled);
+    /**
+     * @brief AddPort does the same as the above one and reports its result to the completion
+     *        group, once the RSTP has performed it
+     * @param completion group which has to outlive the command
+     */
+    static Result AddPort(const u16 portNo, const u32 speed, const bool enabled,
+                          CompletionGroup& completion);
     /**
      * @brief RemovePort removes port from the RSTP
      * @param portNo port number to add to the RSTP
      * @return Result::Success if operation completed with success, otherwise Result::Fail
      */
     static Result RemovePort(const u16 portNo);
+    /// @brief RemovePort does the same as the above one and reports its result to the group
+    static Result RemovePort(const u16 portNo, CompletionGroup& completion);
+    /**
+     * @brief AddPorts adds many ports to the RSTP at once, e.g. all ports of chassis at its
+     *        startup. The RSTP initializes them together and selects roles once for all of them,
+     *        instead of once for every added port.
+     * @param ports to add, fails as a whole if any of them exists or is given twice
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result AddPorts(const std::vector<PortSpec>& ports);
+    /// @brief AddPorts does the same as the above one and reports its result to the group
+    static Result AddPorts(const std::vector<PortSpec>& ports, CompletionGroup& completion);
+    /**
+     * @brief RemovePorts removes many ports from the RSTP at once, e.g. all ports of removed
+     *        line card, and reselects roles of remaining ports
+     * @param portNos port numbers to remove, fails as a whole if any of them does not exist
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result RemovePorts(const std::vector<u16>& portNos);
+    /// @brief RemovePorts does the same as the above one and reports its result to the group
+    static Result RemovePorts(const std::vector<u16>& portNos, CompletionGroup& completion);
+    /**
+     * @brief SetPortEnabled signals change of operational state of the port, e.g. loss of
+     *        carrier. Information received by the port is discarded and roles of ports are
+     *        reselected at once, without waiting for expiry of the information.
+     * @param portNo port number which state has changed
+     * @param enabled true if the port is operational, otherwise false
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result SetPortEnabled(const u16 portNo, const bool enabled);
+    /// @brief SetPortEnabled does the same as the above one and reports its result to the group
+    static Result SetPortEnabled(const u16 portNo, const bool enabled,
+                                 CompletionGroup& completion);
+    /**
+     * @brief SetPortsEnabled does the same as SetPortEnabled() for many ports at once, e.g. on
+     *        failure of line card. The RSTP reselects roles once for all of them.
+     * @param portNos port numbers which state has changed
+     * @param enabled true if ports are operational, otherwise false
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result SetPortsEnabled(const std::vector<u16>& portNos, const bool enabled);
+    /// @brief SetPortsEnabled does the same as the above one and reports its result to the group
+    static Result SetPortsEnabled(const std::vector<u16>& portNos, const bool enabled,
+                                  CompletionGroup& completion);
     /**
      * @brief ProcessBpdu passes the BPDU data to process by the RSTP
      * @param portNo port number from which received BPDU
@@ -40,12 +109,253 @@ public:
      * @return Result::Success if operation completed with success, otherwise Result::Fail
      */
     static Result ProcessBpdu(const u16 rxPortNo, ByteStreamH bpdu);
+    /**
+     * @brief ProcessBpdu does the same as the above one and reports to the group whether the
+     *        port has accepted BPDU. BPDU rejected on the caller's thread is reported at once.
+     */
+    static Result ProcessBpdu(const u16 rxPortNo, ByteStreamH bpdu, CompletionGroup& completion);
+    /**
+     * @brief SetPortAdminEdge sets administrative value of edge port (14.8.2.1.3 j). The port
+     *        becomes edge port once it is disabled, as Bridge Detection machine defines.
+     * @param portNo port number to configure
+     * @param adminEdge true if the port is connected to end station only
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result SetPortAdminEdge(const u16 portNo, const bool adminEdge);
+    /// @brief SetPortAdminEdge does the same as the above one and reports its result to the group
+    static Result SetPortAdminEdge(const u16 portNo, const bool adminEdge,
+                                   CompletionGroup& completion);
+    /**
+     * @brief SetPortAutoEdge enables detection of edge port, which does not receive BPDUs
+     *        (14.8.2.1.3 l). It is enabled by default.
+     * @param portNo port number to configure
+     * @param autoEdge true to detect edge port
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result SetPortAutoEdge(const u16 portNo, const bool autoEdge);
+    /// @brief SetPortAutoEdge does the same as the above one and reports its result to the group
+    static Result SetPortAutoEdge(const u16 portNo, const bool autoEdge,
+                                  CompletionGroup& completion);
+    /**
+     * @brief SetPortPointToPoint tells whether the port is connected to point-to-point LAN
+     *        (6.4.3), e.g. full duplex link. Only such ports complete rapid proposal/agreement
+     *        handshake, other ones wait for expiry of forward delay timers. It is disabled by
+     *        default.
+     * @param portNo port number to configure
+     * @param pointToPoint true if the port is connected to point-to-point LAN
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result SetPortPointToPoint(const u16 portNo, const bool pointToPoint);
+    /// @brief SetPortPointToPoint does the same as the above one and reports its result to the
+    ///        group
+    static Result SetPortPointToPoint(const u16 portNo, const bool pointToPoint,
+                                      CompletionGroup& completion);
+    /**
+     * @brief SetPortPriority changes priority of identifier of the port (17.13.10)
+     * @param portNo port number to configure
+     * @param priority multiple of 16 in range [0, 240]
+     * @return Result::Success if operation completed with success, Result::Fail if priority is
+     *         invalid
+     */
+    static Result SetPortPriority(const u16 portNo, const u32 priority);
+    /// @brief SetPortPriority does the same as the above one and reports its result to the group
+    static Result SetPortPriority(const u16 portNo, const u32 priority,
+                                  CompletionGroup& completion);
+    /**
+     * @brief SetPortPathCost changes path cost of the port (17.13.11), which is derived from
+     *        speed of the port by default
+     * @param portNo port number to configure
+     * @param pathCost in range [1, 200000000]
+     * @return Result::Success if operation completed with success, Result::Fail if path cost is
+     *         invalid
+     */
+    static Result SetPortPathCost(const u16 portNo, const u32 pathCost);
+    /// @brief SetPortPathCost does the same as the above one and reports its result to the group
+    static Result SetPortPathCost(const u16 portNo, const u32 pathCost,
+                                  CompletionGroup& completion);
+    /**
+     * @brief SetPortFastHello makes the port transmit BPDUs more often than once per second, so
+     *        loss of BPDUs on its link is detected after three hello times. Ports on both ends of
+     *        the link have to be configured the same way. The RSTP ticks as often as the shortest
+     *        hello time of its ports.
+     * @param portNo port number to configure
+     * @param helloTimeMs hello time in milliseconds, 0 to use hello time of the bridge
+     * @return Result::Success if operation completed with success, Result::Fail if hello time is
+     *         invalid
+     */
+    static Result SetPortFastHello(const u16 portNo, const u32 helloTimeMs);
+    /// @brief SetPortFastHello does the same as the above one and reports its result to the group
+    static Result SetPortFastHello(const u16 portNo, const u32 helloTimeMs,
+                                   CompletionGroup& completion);
+    /**
+     * @brief SetBridgeConfig changes priority, timers, transmit hold count, forced protocol
+     *        version and ageing time of the bridge. The RSTP applies them without restart, roles
+     *        of ports are reselected and changed information is transmitted.
+     * @param config parameters of the bridge, validated on the caller's thread
+     * @return Result::Success if operation completed with success, Result::Fail if parameters
+     *         are invalid
+     */
+    static Result SetBridgeConfig(const BridgeConfig& config);
+    /// @brief SetBridgeConfig does the same as the above one and reports its result to the group
+    static Result SetBridgeConfig(const BridgeConfig& config, CompletionGroup& completion);
+    /**
+     * @brief GetBridgeConfig reads parameters of the bridge, as published by the RSTP after the
+     *        last evaluation of state machines
+     * @param config parameters of the bridge
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result GetBridgeConfig(BridgeConfig& config);
+    /**
+     * @brief SetIngressDecode selects where received BPDU data is decoded. When enabled,
+     *        ProcessBpdu() decodes, validates and filters looped back BPDU on the caller's thread
+     *        and passes only decoded BPDU to the RSTP. Otherwise raw data is queued and decoded
+     *        by the RSTP thread (default).
+     * @param enable true to decode BPDU on the caller's thread, false to decode by the RSTP
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result SetIngressDecode(const bool enable);
+    /**
+     * @brief SetBpduPolicer limits BPDUs which ProcessBpdu() queues to the RSTP for every port.
+     *        BPDUs above the rate of the port are dropped on the caller's thread and counted as
+     *        BpduDropReason::Policed, so the load of the RSTP thread stays bounded however many
+     *        of them are offered. The port which offers more than ErrDisableRate BPDUs per
+     *        second is err-disabled: it is disabled as by SetPortEnabled() and all its BPDUs are
+     *        dropped until it is enabled again by SetPortEnabled() or SetPortsEnabled().
+     * @param config limits of every port, Rate of 0 disables the policer (default)
+     * @return Result::Success if limits have been applied, Result::Fail if they are not valid
+     */
+    static Result SetBpduPolicer(const BpduPolicerConfig& config);
+    /**
+     * @brief GetBpduPolicer reads limits applied by SetBpduPolicer()
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result GetBpduPolicer(BpduPolicerConfig& config);
     /**
      * @brief SetLogSeverity sets which messages from RSTP should be logged
      * @param logSeverity represents ID of logged message from RSTP
      * @return Result::Success if operation completed with success, otherwise Result::Fail
      */
     static Result SetLogSeverity(const LoggingSystem::Logger::LogSeverity logSeverity);
+    /// @brief SetLogSeverity does the same as the above one and reports its result to the group
+    static Result SetLogSeverity(const LoggingSystem::Logger::LogSeverity logSeverity,
+                                 CompletionGroup& completion);
+    /**
+     * @brief GetRxFastPathCounters reads how many received BPDUs have been recognized as
+     *        repeated ones and handled without full decode (hits) and how many have been passed
+     *        through the full decode path (misses)
+     * @param hits number of BPDUs handled by the repeated-BPDU fast path
+     * @param misses number of BPDUs handled by the full decode path
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result GetRxFastPathCounters(u64& hits, u64& misses);
+    /**
+     * @brief GetEngineStats reads per port counters of executions, transitions, met conditions
+     *        and spent CPU cycles of every state machine, without stopping the RSTP
+     * @param stats snapshot of counters
+     * @return Result::Success if operation completed with success, Result::Fail if the RSTP has
+     *         not been started yet or counters have been compiled out (STP_ENGINE_STATS option)
+     */
+    static Result GetEngineStats(EngineStats& stats);
+    /**
+     * @brief GetPortStats reads counters of received, dropped and transmitted BPDUs and changes
+     *        of role and state of the port. Counters are published by the RSTP once per tick and
+     *        read without blocking it.
+     * @param portNo port number which counters to read
+     * @param stats counters of the port
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result GetPortStats(const u16 portNo, PortStats& stats);
+    /**
+     * @brief GetAllPortStats reads counters of all ports, as GetPortStats() does
+     * @param stats counters indexed by port number
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result GetAllPortStats(std::map<u16, PortStats>& stats);
+    /**
+     * @brief GetLatencyReport reads histograms of latency measured from acceptance of BPDU by
+     *        ProcessBpdu() to its consumption by Port Receive machine, to the first BPDU sent
+     *        out and to the first port set to forwarding in reaction to new information
+     * @param report snapshot of histograms, might be exported by LatencyReport::WriteJson()
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result GetLatencyReport(LatencyReport& report);
+    /**
+     * @brief GetRequestStats reads depth and high-water mark of the queue of requests and how
+     *        late the RSTP has run its ticks. Requests are processed in slices which end before
+     *        the next tick is due, so the queue growing faster than it drains shows up as
+     *        deferred slices instead of tick overruns.
+     * @param stats counters since the start of the RSTP
+     * @return Result::Success if operation completed with success, Result::Fail if the RSTP has
+     *         not been started yet
+     */
+    static Result GetRequestStats(RequestStats& stats);
+    /**
+     * @brief StartTrace starts recording of state transitions, received and transmitted BPDUs,
+     *        timer expiries and calls of OutInterface into the trace buffer, which keeps the
+     *        newest events. Previously recorded events are discarded.
+     * @param capacity number of events kept by the buffer
+     * @param stateSpans exports states of machines as spans with duration, instead of instant
+     *        events of transitions
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result StartTrace(const u32 capacity, const bool stateSpans);
+    /**
+     * @brief StopTrace stops recording, recorded events are still available for export
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result StopTrace();
+    /**
+     * @brief ExportTrace writes recorded events as Chrome Trace Event JSON, which might be
+     *        opened by chrome://tracing or Perfetto UI
+     * @param out stream to write JSON to
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result ExportTrace(std::ostream& out);
+    /**
+     * @brief GetBridgeSnapshot reads state of the bridge and all its ports, as published by the
+     *        RSTP after every evaluation of state machines. Reading never blocks the RSTP, so
+     *        it might be done by agents of SNMP or gNMI at any rate.
+     * @param snapshot copy of the latest published state
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result GetBridgeSnapshot(BridgeSnapshot& snapshot);
+    /**
+     * @brief GetPortSnapshot reads state of the single port, as GetBridgeSnapshot() does
+     * @param portNo port number which state to read
+     * @param snapshot copy of the latest published state of the port
+     * @return Result::Success if the port exists, otherwise Result::Fail
+     */
+    static Result GetPortSnapshot(const u16 portNo, PortSnapshot& snapshot);
+    /**
+     * @brief RestoreStateImage continues from state of the bridge, its ports and their state
+     *        machines mirrored by the previous run of the RSTP, e.g. before upgrade. Ports of the
+     *        image are added and keep their roles and forwarding state without calls of
+     *        OutInterface, so traffic is not disturbed. It has to be requested before adding
+     *        any port; if it fails, ports are added as after cold start.
+     * @param path of the file written by StartStateImage()
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result RestoreStateImage(const std::string& path);
+    /// @brief RestoreStateImage does the same as the above one and reports its result to the group
+    static Result RestoreStateImage(const std::string& path, CompletionGroup& completion);
+    /**
+     * @brief StartStateImage mirrors state of the bridge, its ports and their state machines
+     *        into memory-mapped file after every evaluation of state machines
+     * @param path of the file, which is created if it does not exist
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result StartStateImage(const std::string& path);
+    /// @brief StartStateImage does the same as the above one and reports its result to the group
+    static Result StartStateImage(const std::string& path, CompletionGroup& completion);
+    /**
+     * @brief StartReplication streams changes of state of the RSTP to the hot-standby RSTP
+     *        started by RunStandby() with the same path, e.g. on the other control plane
+     * @param path of the local socket, which the RSTP listens on
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result StartReplication(const std::string& path);
+    /// @brief StartReplication does the same as the above one and reports its result to the group
+    static Result StartReplication(const std::string& path, CompletionGroup& completion);
     /**
      * @brief RunStp starts the RSTP
      * @param bridgeAddr MAC address of bridge on which run STP
@@ -53,6 +363,19 @@ public:
      * @return Result::Success if operation completed with success, otherwise Result::Fail
      */
     static Result RunStp(Mac bridgeAddr, SystemH system);
+    /**
+     * @brief RunStandby starts the RSTP as hot standby of the primary RSTP, which streams its
+     *        state by StartReplication(). The standby keeps the received state and does not run
+     *        state machines, nor call OutInterface. Once the primary closes the connection (e.g.
+     *        it has died) or stays silent for three seconds, the standby takes over its state and
+     *        runs as RunStp() does, without reconvergence. If the primary is not reachable at
+     *        all, the RSTP starts without any port.
+     * @param bridgeAddr MAC address of the bridge, the same as of the primary
+     * @param system includes functionality used by STP to cooperate with bridge's system/OS
+     * @param path of the local socket which the primary listens on
+     * @return Result::Success if operation completed with success, otherwise Result::Fail
+     */
+    static Result RunStandby(Mac bridgeAddr, SystemH system, const std::string& path);
 };
 
 /**
@@ -62,7 +385,28 @@ enum class RequestId : u8 {
     AddPort,
     RemovePort,
     ProcessBpdu,
-    SetLogSeverity
+    ProcessDecodedBpdu,
+    SetLogSeverity,
+    SetPortAttribute,
+    SetBridgeConfig,
+    SetPortsEnabled,
+    AddPorts,
+    RemovePorts,
+    RestoreStateImage,
+    StartStateImage,
+    StartReplication
+};
+
+/**
+ * @brief The PortAttribute enum represents managed attributes of the port
+ */
+enum class PortAttribute : u8 {
+    AdminEdge,
+    AutoEdge,
+    PointToPoint,
+    Priority,
+    PathCost,
+    FastHelloTime
 };
 
 /**
@@ -72,12 +416,17 @@ class Command {
 public:
     virtual ~Command() = default;
     RequestId Id() const noexcept;
+    /// @param completion group notified once the command has been performed, might be nullptr
+    void SetCompletion(CompletionGroup* completion) noexcept;
+    /// @brief Complete reports result of the command to its group, if it has any
+    void Complete(const Result result);
 
 protected:
     Command(const RequestId reqId);
 
 private:
     RequestId _reqId;
+    CompletionGroup* _completion;
 };
 
 /**
@@ -113,13 +462,35 @@ private:
  */
 class ProcessBpduReq : public Command {
 public:
-    ProcessBpduReq(const u16 rxPortNo, ByteStreamH bpdu);
+    ProcessBpduReq(const u16 rxPortNo, ByteStreamH bpdu, const Clock::Duration ingressTime);
     ByteStream& GetBpduData();
     u16 GetRxPortNo() const noexcept;
+    Clock::Duration GetIngressTime() const noexcept;
 
 private:
     u16 _rxPortNo; ///< Port number from which received BPDU
     ByteStreamH _bpdu; ///< Received BPDU data
+    Clock::Duration _ingressTime; ///< Time of acceptance of BPDU by management interface
+};
+
+/**
+ * @brief The ProcessDecodedBpduReq class represents user's request for process BPDU which has
+ *        been already decoded and validated on the caller's thread
+ */
+class ProcessDecodedBpduReq : public Command {
+public:
+    ProcessDecodedBpduReq(const u16 rxPortNo, const Bpdu& bpdu, const BpduFingerprint& fingerprint,
+                          const Clock::Duration ingressTime);
+    const Bpdu& GetBpdu() const noexcept;
+    const BpduFingerprint& GetFingerprint() const noexcept;
+    u16 GetRxPortNo() const noexcept;
+    Clock::Duration GetIngressTime() const noexcept;
+
+private:
+    u16 _rxPortNo; ///< Port number from which received BPDU
+    Bpdu _bpdu; ///< Decoded BPDU
+    BpduFingerprint _fingerprint; ///< Raw copy of received BPDU data
+    Clock::Duration _ingressTime; ///< Time of acceptance of BPDU by management interface
 };
 
 /**
@@ -135,8 +506,94 @@ private:
     LoggingSystem::Logger::LogSeverity _logSeverity;
 };
 
+/**
+ * @brief The SetPortAttributeReq class represents user's request for change managed attribute
+ *        of the port
+ */
+class SetPortAttributeReq : public Command {
+public:
+    /// @param value of the attribute, 0 or 1 for flags
+    SetPortAttributeReq(const u16 portNo, const PortAttribute attribute, const u32 value);
+    u16 GetPortNo() const noexcept;
+    PortAttribute GetAttribute() const noexcept;
+    u32 GetValue() const noexcept;
+
+private:
+    u32 _value;
+    u16 _portNo;
+    PortAttribute _attribute;
+};
+
+/**
+ * @brief The SetBridgeConfigReq class represents user's request for change parameters of the
+ *        bridge
+ */
+class SetBridgeConfigReq : public Command {
+public:
+    SetBridgeConfigReq(const BridgeConfig& config);
+    const BridgeConfig& GetConfig() const noexcept;
+
+private:
+    BridgeConfig _config;
+};
+
+/**
+ * @brief The SetPortsEnabledReq class represents user's request for change operational state
+ *        of ports
+ */
+class SetPortsEnabledReq : public Command {
+public:
+    SetPortsEnabledReq(std::vector<u16> portNos, const bool enabled);
+    const std::vector<u16>& GetPortNos() const noexcept;
+    bool GetEnabled() const noexcept;
+
+private:
+    std::vector<u16> _portNos;
+    bool _enabled;
+};
+
+/**
+ * @brief The AddPortsReq class represents user's request for add many ports to the RSTP at once
+ */
+class AddPortsReq : public Command {
+public:
+    AddPortsReq(std::vector<PortSpec> ports);
+    const std::vector<PortSpec>& GetPorts() const noexcept;
+
+private:
+    std::vector<PortSpec> _ports;
+};
+
+/**
+ * @brief The RemovePortsReq class represents user's request for remove many ports from the RSTP
+ *        at once
+ */
+class RemovePortsReq : public Command {
+public:
+    RemovePortsReq(std::vector<u16> portNos);
+    const std::vector<u16>& GetPortNos() const noexcept;
+
+private:
+    std::vector<u16> _portNos;
+};
+
+/**
+ * @brief The StateImageReq class represents user's request for restore or start mirroring of
+ *        state of the RSTP into the file, or to the standby
+ */
+class StateImageReq : public Command {
+public:
+    /// @param reqId RequestId::RestoreStateImage, RequestId::StartStateImage or
+    ///        RequestId::StartReplication
+    StateImageReq(const RequestId reqId, std::string path);
+    const std::string& GetPath() const noexcept;
+
+private:
+    std::string _path;
+};
+
 inline Command::Command(const RequestId reqId)
-    : _reqId{ reqId } {
+    : _reqId{ reqId }, _completion{ nullptr } {
     // Nothing more to do
 }
 
@@ -144,6 +601,22 @@ inline RequestId Command::Id() const noexcept {
     return _reqId;
 }
 
+inline void Command::SetCompletion(CompletionGroup* completion) noexcept {
+    _completion = completion;
+    if (_completion) {
+        _completion->Expect();
+    }
+}
+
+inline void Command::Complete(const Result result) {
+    if (_completion) {
+        // The group might be destroyed by its waiter once the command has been completed
+        CompletionGroup* const completion = _completion;
+        _completion = nullptr;
+        completion->Complete(result);
+    }
+}
+
 inline AddPortReq::AddPortReq(const u16 portNo, const u32 speed, const bool enabled)
     : Command{ RequestId::AddPort }, _speed{ speed }, _portNo{ portNo }, _enabled{ enabled } {
 }
@@ -168,8 +641,10 @@ inline u16 RemovePortReq::GetPortNo() const noexcept {
     return _portNo;
 }
 
-inline ProcessBpduReq::ProcessBpduReq(const u16 rxPortNo, ByteStreamH bpdu)
-    : Command{ RequestId::ProcessBpdu }, _rxPortNo{ rxPortNo }, _bpdu{ bpdu } {
+inline ProcessBpduReq::ProcessBpduReq(const u16 rxPortNo, ByteStreamH bpdu,
+                                      const Clock::Duration ingressTime)
+    : Command{ RequestId::ProcessBpdu }, _rxPortNo{ rxPortNo }, _bpdu{ bpdu },
+      _ingressTime{ ingressTime } {
 }
 
 inline ByteStream& ProcessBpduReq::GetBpduData() {
@@ -180,6 +655,33 @@ inline u16 ProcessBpduReq::GetRxPortNo() const noexcept {
     return _rxPortNo;
 }
 
+inline Clock::Duration ProcessBpduReq::GetIngressTime() const noexcept {
+    return _ingressTime;
+}
+
+inline ProcessDecodedBpduReq::ProcessDecodedBpduReq(const u16 rxPortNo, const Bpdu& bpdu,
+                                                    const BpduFingerprint& fingerprint,
+                                                    const Clock::Duration ingressTime)
+    : Command{ RequestId::ProcessDecodedBpdu }, _rxPortNo{ rxPortNo }, _bpdu{ bpdu },
+      _fingerprint{ fingerprint }, _ingressTime{ ingressTime } {
+}
+
+inline const Bpdu& ProcessDecodedBpduReq::GetBpdu() const noexcept {
+    return _bpdu;
+}
+
+inline const BpduFingerprint& ProcessDecodedBpduReq::GetFingerprint() const noexcept {
+    return _fingerprint;
+}
+
+inline u16 ProcessDecodedBpduReq::GetRxPortNo() const noexcept {
+    return _rxPortNo;
+}
+
+inline Clock::Duration ProcessDecodedBpduReq::GetIngressTime() const noexcept {
+    return _ingressTime;
+}
+
 inline SetLogSeverityReq::SetLogSeverityReq(LoggingSystem::Logger::LogSeverity logSeverity)
     : Command{ RequestId::SetLogSeverity }, _logSeverity{ logSeverity } {
 }
@@ -188,4 +690,66 @@ inline LoggingSystem::Logger::LogSeverity SetLogSeverityReq::GetLogSeverity() co
     return _logSeverity;
 }
 
+inline SetPortAttributeReq::SetPortAttributeReq(const u16 portNo, const PortAttribute attribute,
+                                                const u32 value)
+    : Command{ RequestId::SetPortAttribute }, _value{ value }, _portNo{ portNo },
+      _attribute{ attribute } {
+}
+
+inline u16 SetPortAttributeReq::GetPortNo() const noexcept {
+    return _portNo;
+}
+
+inline PortAttribute SetPortAttributeReq::GetAttribute() const noexcept {
+    return _attribute;
+}
+
+inline u32 SetPortAttributeReq::GetValue() const noexcept {
+    return _value;
+}
+
+inline SetBridgeConfigReq::SetBridgeConfigReq(const BridgeConfig& config)
+    : Command{ RequestId::SetBridgeConfig }, _config{ config } {
+}
+
+inline const BridgeConfig& SetBridgeConfigReq::GetConfig() const noexcept {
+    return _config;
+}
+
+inline SetPortsEnabledReq::SetPortsEnabledReq(std::vector<u16> portNos, const bool enabled)
+    : Command{ RequestId::SetPortsEnabled }, _portNos{ std::move(portNos) }, _enabled{ enabled } {
+}
+
+inline const std::vector<u16>& SetPortsEnabledReq::GetPortNos() const noexcept {
+    return _portNos;
+}
+
+inline bool SetPortsEnabledReq::GetEnabled() const noexcept {
+    return _enabled;
+}
+
+inline AddPortsReq::AddPortsReq(std::vector<PortSpec> ports)
+    : Command{ RequestId::AddPorts }, _ports{ std::move(ports) } {
+}
+
+inline const std::vector<PortSpec>& AddPortsReq::GetPorts() const noexcept {
+    return _ports;
+}
+
+inline RemovePortsReq::RemovePortsReq(std::vector<u16> portNos)
+    : Command{ RequestId::RemovePorts }, _portNos{ std::move(portNos) } {
+}
+
+inline const std::vector<u16>& RemovePortsReq::GetPortNos() const noexcept {
+    return _portNos;
+}
+
+inline StateImageReq::StateImageReq(const RequestId reqId, std::string path)
+    : Command{ reqId }, _path{ std::move(path) } {
+}
+
+inline const std::string& StateImageReq::GetPath() const noexcept {
+    return _path;
+}
+
 } // namespace Stp
@@ -7,6 +7,7 @@
 #pragma once
 
 // This project's headers
+#include "bridge.hpp"
 #include "lib.hpp"
 #include "port.hpp"
 #include "time.hpp"
@@ -14,22 +15,21 @@
 namespace Stp {
 namespace PerfParams {
 
-u16 HelloTime(const Port& port) noexcept;
-u16 MigrateTime() noexcept;
-u8 TxHoldCount() noexcept;
+u32 HelloTime(const Port& port) noexcept;
+u32 MigrateTime() noexcept;
+u8 TxHoldCount(const Bridge& bridge) noexcept;
 
-inline u16 HelloTime(const Port& port) noexcept {
+inline u32 HelloTime(const Port& port) noexcept {
     return port.DesignatedTimes().HelloTime();
 }
 
-inline u16 MigrateTime() noexcept {
-    /// @todo Make it dynamic managementable
-    return +Time::RecommendedValue::MigrateTime;
+inline u32 MigrateTime() noexcept {
+    // Fixed by Table 17-1, as it is not carried by BPDUs and bridges have to agree on it
+    return Time::FromSeconds(+Time::RecommendedValue::MigrateTime);
 }
 
-inline u8 TxHoldCount() noexcept {
-    /// @todo Make it dynamic managementable
-    return Port::RecommendedValue::TransmitHoldCount;
+inline u8 TxHoldCount(const Bridge& bridge) noexcept {
+    return bridge.TxHoldCount();
 }
 
 } // namespace PerfParams
@@ -8,8 +8,11 @@
 
 // This project's headers
 #include "bpdu.hpp"
+#include "bpdu_fingerprint.hpp"
+#include "clock.hpp"
 #include "lib.hpp"
 #include "port_id.hpp"
+#include "port_stats.hpp"
 #include "priority_vector.hpp"
 #include "time.hpp"
 
@@ -46,18 +49,6 @@ public:
         OtherInfo
     };
 
-    /// @brief 14.8.2.1.3 j)
-    /// @todo Make it dynamic managementable
-    static constexpr bool adminEdge = false;
-
-    /// @brief 14.8.2.1.3 l)
-    /// @todo Make it dynamic managementable
-    static constexpr bool autoEdge = true;
-
-    /// @brief 6.4.3
-    /// @todo Make it dynamic managementable
-    static constexpr bool operPointToPointMAC = false;
-
     Port() noexcept;
     Port(const Port&) noexcept = default;
     Port(Port&&) = default;
@@ -67,9 +58,22 @@ public:
     Port& operator=(const Port&) noexcept = default;
     Port& operator=(Port&&) = default;
 
+    /// @brief In milliseconds
     u32 AgeingTime() const noexcept;
     void SetAgeingTime(const u32 value) noexcept;
-    void DecAgeingTime() noexcept;
+    void DecAgeingTime(const u32 elapsedMs) noexcept;
+
+    /**
+     * @brief Hello time of the port in milliseconds if it's shorter than one second, so loss of
+     *        BPDUs is detected within three of them. 0 if the port uses hello time of the bridge.
+     *        Managed by Management::SetPortFastHello().
+     */
+    u16 FastHelloTime() const noexcept;
+    void SetFastHelloTime(const u16 value) noexcept;
+
+    /// @brief 14.8.2.1.3 j), managed by Management::SetPortAdminEdge()
+    bool AdminEdge() const noexcept;
+    void SetAdminEdge(const bool value) noexcept;
 
     bool Agree() const noexcept;
     void SetAgree(const bool value) noexcept;
@@ -77,6 +81,10 @@ public:
     bool Agreed() const noexcept;
     void SetAgreed(const bool value) noexcept;
 
+    /// @brief 14.8.2.1.3 l), managed by Management::SetPortAutoEdge()
+    bool AutoEdge() const noexcept;
+    void SetAutoEdge(const bool value) noexcept;
+
     const PriorityVector& DesignatedPriority() const noexcept;
     PriorityVector& GetDesignatedPriority() noexcept;
     void SetDesignatedPriority(const PriorityVector& value) noexcept;
@@ -123,6 +131,10 @@ public:
     bool OperEdge() const noexcept;
     void SetOperEdge(const bool value) noexcept;
 
+    /// @brief 6.4.3, managed by Management::SetPortPointToPoint()
+    bool OperPointToPointMAC() const noexcept;
+    void SetOperPointToPointMAC(const bool value) noexcept;
+
     bool PortEnabled() const noexcept;
     void SetPortEnabled(const bool value) noexcept;
 
@@ -206,7 +218,8 @@ public:
 
     u8 TxCount() const noexcept;
     void SetTxCount(const u8 value) noexcept;
-    void DecTxCount() noexcept;
+    /// @brief DecTxCount decrements txCount once per every period which has elapsed
+    void DecTxCount(const u32 elapsedMs, const u32 periodMs) noexcept;
     void IncTxCount() noexcept;
 
     bool UpdtInfo() const noexcept;
@@ -220,153 +233,205 @@ public:
     SmTimers& SmTimersInstance() noexcept;
     void SetSmTimers(const SmTimers& value) noexcept;
 
-private:
-    /// @brief 17.19.1
-    u16 _ageingTime;
+    const BpduFingerprint& RxFingerprint() const noexcept;
+    BpduFingerprint& GetRxFingerprint() noexcept;
 
-    /// @brief 17.19.2
-    bool _agree;
+    bool RxFastPath() const noexcept;
+    void SetRxFastPath(const bool value) noexcept;
 
-    /// @brief 17.19.3
-    bool _agreed;
+    const PortStats& Stats() const noexcept;
+    PortStats& GetStats() noexcept;
+
+    /// @brief Time of acceptance of the oldest received BPDU which has not been handled yet
+    Clock::Duration RxIngressTime() const noexcept;
+    void SetRxIngressTime(const Clock::Duration value) noexcept;
+    bool RxIngressTimed() const noexcept;
+    void ClearRxIngressTime() noexcept;
+
+private:
+    // Variables of 17.19 used on every tick come first and their flags are packed into
+    // bit-fields, so they span three cache lines. Data of received BPDU and counters follow.
 
     /// @brief 17.19.4
     PriorityVector _dsgPriority;
 
+    /// @brief 17.19.14
+    PriorityVector _msgPriority;
+
+    /// @brief 17.19.21
+    PriorityVector _portPriority;
+
     /// @brief 17.19.5
     Time _dsgTimes;
 
+    /// @brief 17.19.15
+    Time _msgTimes;
+
+    /// @brief 17.19.22
+    Time _portTimes;
+
+    /// @brief Timer used by State Machine
+    SmTimers _smTimers;
+
+    /// @brief 17.19.20
+    PathCost _portPathCost;
+
+    /// @brief 17.19.19
+    class PortId _portId;
+
+    /// @brief 17.19.1
+    u32 _ageingTime;
+
+    u16 _fastHelloTime;
+
+    /// @brief Time elapsed since txCount was decremented last time
+    u16 _txCountElapsedMs;
+
+    /// @brief 17.19.10
+    Info _infoIs;
+
+    /// @brief 17.19.26
+    enum RcvdInfo _rcvdInfo;
+
+    /// @brief 17.19.35
+    PortRole _role;
+
+    /// @brief 17.19.37
+    PortRole _selectedRole;
+
+    /// @brief 17.19.44
+    u8 _txCount;
+
+    /// @brief 14.8.2.1.3 j)
+    bool _adminEdge : 1;
+
+    /// @brief 17.19.2
+    bool _agree : 1;
+
+    /// @brief 17.19.3
+    bool _agreed : 1;
+
+    /// @brief 14.8.2.1.3 l)
+    bool _autoEdge : 1;
+
     /// @brief 17.19.6
-    bool _disputed;
+    bool _disputed : 1;
 
     /// @brief 17.19.7
-    bool _fdbFlush;
+    bool _fdbFlush : 1;
 
     /// @brief 17.19.8
-    bool _forward;
+    bool _forward : 1;
 
     /// @brief 17.19.9
-    bool _forwarding;
-
-    /// @brief 17.19.10
-    Info _infoIs;
+    bool _forwarding : 1;
 
     /// @brief 17.19.11
-    bool _learn;
+    bool _learn : 1;
 
     /// @brief 17.19.12
-    bool _learning;
+    bool _learning : 1;
 
     /// @brief 17.19.13
-    bool _mcheck;
-
-    /// @brief 17.19.14
-    PriorityVector _msgPriority;
-
-    /// @brief 17.19.15
-    Time _msgTimes;
+    bool _mcheck : 1;
 
     /// @brief 17.19.16
-    bool _newInfo;
+    bool _newInfo : 1;
 
     /// @brief 17.19.17
-    bool _operEdge;
-
-    /// @brief 17.19.18
-    bool _portEnabled;
+    bool _operEdge : 1;
 
-    /// @brief 17.19.19
-    class PortId _portId;
-
-    /// @brief 17.19.20
-    PathCost _portPathCost;
-
-    /// @brief 17.19.21
-    PriorityVector _portPriority;
+    /// @brief 6.4.3
+    bool _operPointToPointMAC : 1;
 
-    /// @brief 17.19.22
-    Time _portTimes;
+    /// @brief 17.19.18
+    bool _portEnabled : 1;
 
     /// @brief 17.19.23
-    bool _proposed;
+    bool _proposed : 1;
 
     /// @brief 17.19.24
-    bool _proposing;
+    bool _proposing : 1;
 
     /// @brief 17.19.25
-    bool _rcvdBpdu;
-
-    /// @brief 17.19.26
-    enum RcvdInfo _rcvdInfo;
+    bool _rcvdBpdu : 1;
 
     /// @brief 17.19.27
-    bool _rcvdMsg;
+    bool _rcvdMsg : 1;
 
     /// @brief 17.19.28
-    bool _rcvdRstp;
+    bool _rcvdRstp : 1;
 
     /// @brief 17.19.29
-    bool _rcvdStp;
+    bool _rcvdStp : 1;
 
     /// @brief 17.19.30
-    bool _rcvdTc;
+    bool _rcvdTc : 1;
 
     /// @brief 17.19.31
-    bool _rcvdTcAck;
+    bool _rcvdTcAck : 1;
 
     /// @brief 17.19.32
-    bool _rcvdTcn;
+    bool _rcvdTcn : 1;
 
     /// @brief 17.19.33
-    bool _reRoot;
+    bool _reRoot : 1;
 
     /// @brief 17.19.34
-    bool _reselect;
-
-    /// @brief 17.19.35
-    PortRole _role;
+    bool _reselect : 1;
 
     /// @brief 17.19.36
-    bool _selected;
-
-    /// @brief 17.19.37
-    PortRole _selectedRole;
+    bool _selected : 1;
 
     /// @brief 17.19.38
-    bool _sendRstp;
+    bool _sendRstp : 1;
 
     /// @brief 17.19.39
-    bool _sync;
+    bool _sync : 1;
 
     /// @brief 17.19.40
-    bool _synced;
+    bool _synced : 1;
 
     /// @brief 17.19.41
-    bool _tcAck;
+    bool _tcAck : 1;
 
     /// @brief 17.19.42
-    bool _tcProp;
+    bool _tcProp : 1;
 
     /// @brief 17.19.43
-    bool _tick;
-
-    /// @brief 17.19.44
-    u8 _txCount;
+    bool _tick : 1;
 
     /// @brief 17.19.45
-    bool _updtInfo;
+    bool _updtInfo : 1;
+
+    /// @brief Indicates that BPDU matching _rxFingerprint may skip the full decode path
+    bool _rxFastPath : 1;
 
     class Bpdu _rxBpdu;
 
-    /// @brief Timer used by State Machine
-    SmTimers _smTimers;
+    /// @brief Raw data of the last BPDU passed through the full decode path
+    BpduFingerprint _rxFingerprint;
+
+    /// @brief Clock::Duration::min() if there is no received BPDU to measure latency for
+    Clock::Duration _rxIngressTime;
+
+    /// @brief Protocol counters, published to management by the engine
+    PortStats _stats;
 }; // End of 'Port' class declaration
 
 using PortH = Sptr<Port>;
 
 inline u32 Port::AgeingTime() const noexcept { return _ageingTime; }
-inline void Port::SetAgeingTime(const u32 value) noexcept { _ageingTime = static_cast<u16>(value); }
-inline void Port::DecAgeingTime() noexcept { dec(_ageingTime); }
+inline void Port::SetAgeingTime(const u32 value) noexcept { _ageingTime = value; }
+inline void Port::DecAgeingTime(const u32 elapsedMs) noexcept {
+    _ageingTime = _ageingTime > elapsedMs ? _ageingTime - elapsedMs : 0;
+}
+
+inline u16 Port::FastHelloTime() const noexcept { return _fastHelloTime; }
+inline void Port::SetFastHelloTime(const u16 value) noexcept { _fastHelloTime = value; }
+
+inline bool Port::AdminEdge() const noexcept { return _adminEdge; }
+inline void Port::SetAdminEdge(const bool value) noexcept { _adminEdge = value; }
 
 inline bool Port::Agree() const noexcept { return _agree; }
 inline void Port::SetAgree(const bool value) noexcept { _agree = value; }
@@ -374,6 +439,9 @@ inline void Port::SetAgree(const bool value) noexcept { _agree = value; }
 inline bool Port::Agreed() const noexcept { return _agreed; }
 inline void Port::SetAgreed(const bool value) noexcept { _agreed = value; }
 
+inline bool Port::AutoEdge() const noexcept { return _autoEdge; }
+inline void Port::SetAutoEdge(const bool value) noexcept { _autoEdge = value; }
+
 inline const PriorityVector& Port::DesignatedPriority() const noexcept { return _dsgPriority; }
 inline PriorityVector& Port::GetDesignatedPriority() noexcept { return _dsgPriority; }
 inline void Port::SetDesignatedPriority(const PriorityVector& value) noexcept { _dsgPriority = value; }
@@ -420,6 +488,11 @@ inline void Port::SetNewInfo(const bool value) noexcept { _newInfo = value; }
 inline bool Port::OperEdge() const noexcept { return _operEdge; }
 inline void Port::SetOperEdge(const bool value) noexcept { _operEdge = value; }
 
+inline bool Port::OperPointToPointMAC() const noexcept { return _operPointToPointMAC; }
+inline void Port::SetOperPointToPointMAC(const bool value) noexcept {
+    _operPointToPointMAC = value;
+}
+
 inline bool Port::PortEnabled() const noexcept { return _portEnabled; }
 inline void Port::SetPortEnabled(const bool value) noexcept { _portEnabled = value; }
 
@@ -503,10 +576,13 @@ inline void Port::SetTick(const bool value) noexcept { _tick = value; }
 
 inline u8 Port::TxCount() const noexcept { return _txCount; }
 inline void Port::SetTxCount(const u8 value) noexcept { _txCount = value; }
-inline void Port::DecTxCount() noexcept {
-    if (_txCount) {
-        --_txCount;
+inline void Port::DecTxCount(const u32 elapsedMs, const u32 periodMs) noexcept {
+    u32 elapsed = _txCountElapsedMs + elapsedMs;
+    for (; elapsed >= periodMs; elapsed -= periodMs) {
+        dec(_txCount);
     }
+
+    _txCountElapsedMs = static_cast<u16>(elapsed);
 }
 
 inline void Port::IncTxCount() noexcept {
@@ -526,4 +602,18 @@ inline SmTimers& Port::SmTimersInstance() noexcept { return _smTimers; }
 inline const SmTimers& Port::GetSmTimersInstance() const noexcept { return _smTimers; }
 inline void Port::SetSmTimers(const SmTimers& value) noexcept { _smTimers = value; }
 
+inline const BpduFingerprint& Port::RxFingerprint() const noexcept { return _rxFingerprint; }
+inline BpduFingerprint& Port::GetRxFingerprint() noexcept { return _rxFingerprint; }
+
+inline bool Port::RxFastPath() const noexcept { return _rxFastPath; }
+inline void Port::SetRxFastPath(const bool value) noexcept { _rxFastPath = value; }
+
+inline const PortStats& Port::Stats() const noexcept { return _stats; }
+inline PortStats& Port::GetStats() noexcept { return _stats; }
+
+inline Clock::Duration Port::RxIngressTime() const noexcept { return _rxIngressTime; }
+inline void Port::SetRxIngressTime(const Clock::Duration value) noexcept { _rxIngressTime = value; }
+inline bool Port::RxIngressTimed() const noexcept { return Clock::Duration::min() != _rxIngressTime; }
+inline void Port::ClearRxIngressTime() noexcept { _rxIngressTime = Clock::Duration::min(); }
+
 } // namespace Stp
@@ -50,7 +50,7 @@ inline PortId::PortId() noexcept
 
 inline bool PortId::operator==(const PortId& comparedTo) const noexcept {
     return (_priority == comparedTo._priority)
-            || (_portNum == comparedTo._portNum);
+            && (_portNum == comparedTo._portNum);
 }
 
 inline bool PortId::operator<(const PortId& comparedTo) const noexcept {
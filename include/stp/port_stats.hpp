@@ -0,0 +1,105 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "bpdu.hpp"
+#include "lib.hpp"
+
+namespace Stp {
+
+/**
+ * @brief The BpduDropReason enum represents why received BPDU has not been passed to the port
+ */
+enum class BpduDropReason : u8 {
+    Malformed, ///< BPDU data could not be decoded or failed validation
+    Looped, ///< BPDU has been transmitted by this bridge through the same port
+    PortDisabled, ///< BPDU has been received by disabled port and discarded by receive machine
+    Policed, ///< BPDU has exceeded the rate of the port before queuing, see BpduPolicer
+    Count
+};
+
+constexpr u8 BpduDropReasonCount = static_cast<u8>(BpduDropReason::Count);
+
+/**
+ * @brief The PortStats struct keeps protocol counters of the single port. They are updated by
+ *        the RSTP thread and published to management after every evaluation of state machines.
+ */
+struct PortStats {
+    u64 RxConfig = 0;
+    u64 RxRst = 0;
+    u64 RxTcn = 0;
+    u64 RxTc = 0; ///< Received Configuration and RST BPDUs with Topology Change flag
+    u64 Dropped[BpduDropReasonCount] = { }; ///< Indexed by BpduDropReason
+    u64 TxConfig = 0;
+    u64 TxRst = 0;
+    u64 TxTcn = 0;
+    u64 TxTc = 0; ///< Transmitted Configuration and RST BPDUs with Topology Change flag
+    u64 RoleChanges = 0;
+    u64 LastRoleChangeMs = 0; ///< Time of the clock of the RSTP
+    u64 StateChanges = 0; ///< Changes of learning or forwarding state
+    u64 LastStateChangeMs = 0; ///< Time of the clock of the RSTP
+    PortRole Role = PortRole::Disabled;
+    bool Learning = false;
+    bool Forwarding = false;
+    bool ErrDisabled = false; ///< The port has been disabled by BpduPolicer
+
+    void CountRx(const Bpdu& bpdu) noexcept;
+    void CountTx(const Bpdu& bpdu) noexcept;
+    void CountDrop(const BpduDropReason reason) noexcept;
+    u64 DroppedBy(const BpduDropReason reason) const noexcept;
+};
+
+inline void PortStats::CountRx(const Bpdu& bpdu) noexcept {
+    switch (bpdu.BpduType()) {
+    case +Bpdu::Type::Config:
+        ++RxConfig;
+        break;
+    case +Bpdu::Type::Rst:
+        ++RxRst;
+        break;
+    case +Bpdu::Type::Tcn:
+        ++RxTcn;
+        return;
+    default:
+        return;
+    }
+
+    if (bpdu.TcFlag()) {
+        ++RxTc;
+    }
+}
+
+inline void PortStats::CountTx(const Bpdu& bpdu) noexcept {
+    switch (bpdu.BpduType()) {
+    case +Bpdu::Type::Config:
+        ++TxConfig;
+        break;
+    case +Bpdu::Type::Rst:
+        ++TxRst;
+        break;
+    case +Bpdu::Type::Tcn:
+        ++TxTcn;
+        return;
+    default:
+        return;
+    }
+
+    if (bpdu.TcFlag()) {
+        ++TxTc;
+    }
+}
+
+inline void PortStats::CountDrop(const BpduDropReason reason) noexcept {
+    ++Dropped[static_cast<u8>(reason)];
+}
+
+inline u64 PortStats::DroppedBy(const BpduDropReason reason) const noexcept {
+    return Dropped[static_cast<u8>(reason)];
+}
+
+} // namespace Stp
@@ -74,9 +74,10 @@ public:
     void SetDesignatedPortId(const PortId& value) noexcept;
 
 private:
+    // Components are not kept in order of comparison, so both narrow ones share padding
     BridgeId _rootBridgeId;
-    PathCost _rootPathCost;
     BridgeId _bridgeId;
+    PathCost _rootPathCost;
     PortId _portId;
 }; // End of 'PriorityVector' class declaration
 
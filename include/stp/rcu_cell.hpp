@@ -0,0 +1,207 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "lib.hpp"
+
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace Stp {
+
+/**
+ * @brief The RcuCell class publishes immutable value created by the single thread to any
+ *        number of readers. Readers take the current value wait-free and keep it as long as
+ *        they hold the guard, while the writer swaps the pointer and reclaims replaced values
+ *        later, once no reader might hold them anymore. Neither of them ever waits for the
+ *        other one.
+ *
+ *        Readers announce themselves in one of two counters selected by the epoch. The writer
+ *        flips the epoch after every swap, so the counter of the previous epoch drains and
+ *        the value replaced before the flip is reclaimed after both counters have been seen
+ *        zero.
+ */
+template <typename T>
+class RcuCell {
+public:
+    /**
+     * @brief The ReadGuard class keeps the value read from the cell alive until destroyed
+     */
+    class ReadGuard {
+    public:
+        ReadGuard(ReadGuard&& other) noexcept;
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        /// @return The value, nullptr if nothing has been published yet
+        const T* Get() const noexcept;
+        const T& operator*() const noexcept;
+        const T* operator->() const noexcept;
+
+    private:
+        friend class RcuCell;
+
+        ReadGuard(std::atomic<u64>* readers, const T* value) noexcept;
+
+        std::atomic<u64>* _readers;
+        const T* _value;
+    };
+
+    RcuCell() noexcept;
+    ~RcuCell();
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    /// @note Might be called from any thread, the guard must not outlive the cell
+    ReadGuard Read() const noexcept;
+    /**
+     * @brief Publish replaces the current value and reclaims values which are not read anymore
+     * @note Only one thread might publish the value
+     */
+    void Publish(Uptr<T> value);
+    /**
+     * @brief Reuse gives back value which has been reclaimed, so the writer might fill it
+     *        again instead of allocating new one
+     * @return Value not read by anyone, nullptr if there is no such value
+     */
+    Uptr<T> Reuse() noexcept;
+    /// @return Number of replaced values still waiting for readers, only for the writer
+    std::size_t Retired() const noexcept;
+
+private:
+    struct RetiredValue {
+        T* Value;
+        bool Quiescent[2]; ///< Counter of the epoch has been seen zero since retirement
+    };
+
+    void Reclaim();
+
+    std::atomic<T*> _current;
+    std::atomic<u64> _epoch;
+    mutable std::atomic<u64> _readers[2];
+    std::vector<RetiredValue> _retired;
+    Uptr<T> _spare;
+};
+
+template <typename T>
+inline RcuCell<T>::ReadGuard::ReadGuard(std::atomic<u64>* readers, const T* value) noexcept
+    : _readers{ readers }, _value{ value } {
+    // Nothing more to do
+}
+
+template <typename T>
+inline RcuCell<T>::ReadGuard::ReadGuard(ReadGuard&& other) noexcept
+    : _readers{ other._readers }, _value{ other._value } {
+    other._readers = nullptr;
+    other._value = nullptr;
+}
+
+template <typename T>
+inline RcuCell<T>::ReadGuard::~ReadGuard() {
+    if (_readers) {
+        // The value must not be touched by the reader after the writer has seen it leaving
+        _readers->fetch_sub(1, std::memory_order_release);
+    }
+}
+
+template <typename T>
+inline const T* RcuCell<T>::ReadGuard::Get() const noexcept {
+    return _value;
+}
+
+template <typename T>
+inline const T& RcuCell<T>::ReadGuard::operator*() const noexcept {
+    return *_value;
+}
+
+template <typename T>
+inline const T* RcuCell<T>::ReadGuard::operator->() const noexcept {
+    return _value;
+}
+
+template <typename T>
+inline RcuCell<T>::RcuCell() noexcept
+    : _current{ nullptr }, _epoch{ 0 } {
+    _readers[0].store(0, std::memory_order_relaxed);
+    _readers[1].store(0, std::memory_order_relaxed);
+}
+
+template <typename T>
+inline RcuCell<T>::~RcuCell() {
+    delete _current.load(std::memory_order_relaxed);
+    for (const RetiredValue& retired : _retired) {
+        delete retired.Value;
+    }
+}
+
+template <typename T>
+inline typename RcuCell<T>::ReadGuard RcuCell<T>::Read() const noexcept {
+    // Any counter protects the value as long as it is incremented before the value is loaded,
+    // so the epoch might be stale
+    std::atomic<u64>& readers = _readers[_epoch.load(std::memory_order_relaxed) & 1];
+    readers.fetch_add(1, std::memory_order_seq_cst);
+
+    return ReadGuard{ &readers, _current.load(std::memory_order_seq_cst) };
+}
+
+template <typename T>
+inline void RcuCell<T>::Publish(Uptr<T> value) {
+    T* const previous = _current.exchange(value.release(), std::memory_order_seq_cst);
+    if (previous) {
+        _retired.push_back(RetiredValue{ previous, { false, false } });
+    }
+
+    // New readers use the other counter, so the current one drains
+    _epoch.fetch_add(1, std::memory_order_relaxed);
+    Reclaim();
+}
+
+template <typename T>
+inline Uptr<T> RcuCell<T>::Reuse() noexcept {
+    return std::move(_spare);
+}
+
+template <typename T>
+inline std::size_t RcuCell<T>::Retired() const noexcept {
+    return _retired.size();
+}
+
+template <typename T>
+inline void RcuCell<T>::Reclaim() {
+    for (u8 parity = 0; parity < 2; ++parity) {
+        // Reader which has not been counted yet will load the value published already
+        if (0 == _readers[parity].load(std::memory_order_seq_cst)) {
+            for (RetiredValue& retired : _retired) {
+                retired.Quiescent[parity] = true;
+            }
+        }
+    }
+
+    const auto reclaimed = std::partition(_retired.begin(), _retired.end(),
+                                          [](const RetiredValue& retired) {
+        return not (retired.Quiescent[0] && retired.Quiescent[1]);
+    });
+    for (auto it = reclaimed; it != _retired.end(); ++it) {
+        if (_spare) {
+            delete it->Value;
+        }
+        else {
+            _spare.reset(it->Value);
+        }
+    }
+
+    _retired.erase(reclaimed, _retired.end());
+}
+
+} // namespace Stp
@@ -0,0 +1,221 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "lib.hpp"
+#include "state_image.hpp"
+
+// C++ Standard Library
+#include <string>
+#include <vector>
+
+namespace Stp {
+
+/**
+ * @brief The Replica class keeps state of the bridge and its ports received from the primary
+ *        RSTP in frames of the replication stream, so the standby might take over from it (see
+ *        Engine::TakeOver()). Records are those of StateImage. The first frame carries all
+ *        ports, the next ones only ports which have changed, and ports which have been removed.
+ *        Timers of ports which have not been sent are advanced by time elapsed between frames,
+ *        as the primary advances them on every tick.
+ */
+class Replica {
+public:
+    static constexpr u32 Magic = 0x52505453; ///< "STPR"
+
+    /// @brief Every frame starts with the header, records follow it in the order of fields
+    struct FrameHeader {
+        u32 Magic;
+        /// @brief StateImage::LayoutVersion of records of the frame
+        u32 LayoutVersion;
+        /// @brief Incremented by every frame, so the lost one is detected
+        u64 Sequence;
+        /// @brief Time of the clock of the primary, in milliseconds
+        u64 TimeMs;
+        /// @brief Number of ports of the bridge after applying the frame
+        u32 PortCount;
+        /// @brief Number of records of ports which follow the record of the bridge
+        u32 ChangedCount;
+        /// @brief Number of port numbers of removed ports which follow records of ports
+        u32 RemovedCount;
+        /// @brief Not zero if the frame replaces all ports
+        u8 Full;
+        /// @brief Not zero if the record of the bridge follows the header
+        u8 HasBridge;
+        u8 Reserved[2];
+    };
+
+    Replica() noexcept;
+
+    /**
+     * @brief Apply updates the replica by the frame. Frame which is not the next one of the
+     *        stream is rejected, unless it is full.
+     * @return Result::Success if the frame has been applied, otherwise Result::Fail and the
+     *         replica waits for the next full frame
+     */
+    Result Apply(const ByteStream& frame);
+    /// @return true if the replica holds complete state of the primary
+    bool IsSynced() const noexcept;
+    u64 Sequence() const noexcept;
+    /// @return Time of the clock of the primary of the last applied frame, in milliseconds
+    u64 TimeMs() const noexcept;
+    const StateImage::BridgeRecord& Bridge() const noexcept;
+    /// @return Records of ports in ascending order of their numbers
+    const std::vector<StateImage::PortRecord>& Ports() const noexcept;
+
+private:
+    bool _synced;
+    u64 _sequence;
+    u64 _timeMs;
+    StateImage::BridgeRecord _bridge;
+    std::vector<StateImage::PortRecord> _ports;
+    /// @brief Reused by every frame, so applying of frames does not allocate
+    std::vector<StateImage::PortRecord> _merged;
+};
+
+/**
+ * @brief The ReplicationEncoder class encodes state of the primary into frames of the
+ *        replication stream. It keeps records which the standby ends up with, so only records
+ *        which differ from them are sent. Timers are compared with tolerance of one tick, so
+ *        ports whose timers only run down are not sent at all.
+ */
+class ReplicationEncoder {
+public:
+    ReplicationEncoder() noexcept;
+
+    /// @brief Reset makes the next frame full, e.g. for the standby which has just connected
+    void Reset() noexcept;
+    /**
+     * @brief Encode writes the frame which brings the standby to the given state
+     * @param ports records of ports in ascending order of their numbers
+     * @param timeMs time of the clock of the primary, in milliseconds
+     * @param toleranceMs difference of timers which is not sent, usually interval of ticks
+     */
+    void Encode(const StateImage::BridgeRecord& bridge,
+                const std::vector<StateImage::PortRecord>& ports, const u64 timeMs,
+                const u32 toleranceMs, ByteStream& frame);
+    /**
+     * @brief Encode does the same as the above one, but compares only listed ports, as other
+     *        ports have not changed since the previous frame
+     * @param changedPortNos in ascending order, port numbers of removed ports included
+     */
+    void Encode(const StateImage::BridgeRecord& bridge,
+                const std::vector<StateImage::PortRecord>& ports,
+                const std::vector<u16>& changedPortNos, const u64 timeMs, const u32 toleranceMs,
+                ByteStream& frame);
+
+private:
+    /// @brief Record held by the standby, with time of the frame which has sent it
+    struct SentPort {
+        StateImage::PortRecord Record;
+        u64 TimeMs;
+    };
+
+    /// @param changedPortNos nullptr if every port has to be compared
+    void Encode(const StateImage::BridgeRecord& bridge,
+                const std::vector<StateImage::PortRecord>& ports,
+                const std::vector<u16>* changedPortNos, const u64 timeMs, const u32 toleranceMs,
+                ByteStream& frame);
+    /// @brief Appends the port to the frame if the standby holds other state of it
+    void EncodePort(const u16 portNo, const std::vector<StateImage::PortRecord>& ports,
+                    const u32 toleranceMs, Replica::FrameHeader& header, ByteStream& frame);
+    /// @return true if the port has to be sent, as the standby holds other state of it
+    static bool Differs(const StateImage::PortRecord& current,
+                        const StateImage::PortRecord& standby, const u32 toleranceMs) noexcept;
+
+    bool _full;
+    u64 _sequence;
+    u64 _timeMs;
+    StateImage::BridgeRecord _bridge;
+    /// @brief In ascending order of port numbers. The standby advances timers of ports on
+    ///        every frame, which gives the same as advancing them once by the sum of elapsed
+    ///        times, so timers of the record are advanced only when it is compared.
+    std::vector<SentPort> _sent;
+    /// @brief Port numbers of both current and sent ports, if every port is compared
+    std::vector<u16> _portNos;
+    std::vector<u16> _removed;
+};
+
+/**
+ * @brief The ReplicationChannel class carries frames of the replication stream between
+ *        processes over the local (Unix domain) stream socket. The primary listens on the path
+ *        and sends frames without blocking: the standby which does not keep up is disconnected
+ *        and receives the full frame once it connects again.
+ * @note Only POSIX systems are supported, elsewhere the socket cannot be opened
+ */
+class ReplicationChannel {
+public:
+    ReplicationChannel() noexcept;
+    ~ReplicationChannel();
+
+    ReplicationChannel(const ReplicationChannel&) = delete;
+    ReplicationChannel& operator=(const ReplicationChannel&) = delete;
+
+    /// @return Result::Success if the socket listens on the path, otherwise Result::Fail
+    Result Listen(const std::string& path);
+    /**
+     * @brief AcceptStandby accepts the standby waiting for connection, which replaces the
+     *        connected one
+     * @return true if the standby has been accepted
+     */
+    bool AcceptStandby() noexcept;
+    bool IsConnected() const noexcept;
+    /**
+     * @brief Send queues the frame and sends as much of queued data as the socket takes
+     * @return Result::Fail if the standby has been disconnected, otherwise Result::Success
+     */
+    Result Send(const ByteStream& frame) noexcept;
+
+    /// @return Result::Success if connected to the primary listening on the path
+    Result Connect(const std::string& path);
+    /**
+     * @brief Receive waits for the next frame from the primary
+     * @return Result::Fail if nothing has been received within the timeout, or the primary has
+     *         closed the connection
+     */
+    Result Receive(ByteStream& frame, const u32 timeoutMs);
+    void Close() noexcept;
+
+private:
+    /// @brief Data queued for the standby which does not keep up, then it is disconnected
+    static constexpr std::size_t _kMaxPendingBytes = 16 * 1024 * 1024;
+
+    void Disconnect() noexcept;
+
+    int _listenFd;
+    int _fd;
+    std::string _listenPath;
+    ByteStream _pending;
+    ByteStream _received;
+};
+
+inline bool Replica::IsSynced() const noexcept {
+    return _synced;
+}
+
+inline u64 Replica::Sequence() const noexcept {
+    return _sequence;
+}
+
+inline u64 Replica::TimeMs() const noexcept {
+    return _timeMs;
+}
+
+inline const StateImage::BridgeRecord& Replica::Bridge() const noexcept {
+    return _bridge;
+}
+
+inline const std::vector<StateImage::PortRecord>& Replica::Ports() const noexcept {
+    return _ports;
+}
+
+inline bool ReplicationChannel::IsConnected() const noexcept {
+    return _fd >= 0;
+}
+
+} // namespace Stp
@@ -0,0 +1,28 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "lib.hpp"
+
+namespace Stp {
+
+/**
+ * @brief The RequestStats struct reports how the RSTP thread keeps up with queued requests and
+ *        with its ticks, see Management::GetRequestStats()
+ */
+struct RequestStats {
+    u64 QueueDepth = 0; ///< Requests waiting to be processed
+    u64 QueueHighWater = 0; ///< The greatest number of waiting requests since the start
+    u64 Processed = 0;
+    u64 DeferredSlices = 0; ///< Slices which have used their budget and left requests queued
+    u64 Ticks = 0;
+    u64 TickOverruns = 0; ///< Ticks which have run at least one tick interval late
+    u64 MaxTickLatenessUs = 0;
+};
+
+} // namespace Stp
@@ -0,0 +1,126 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "clock.hpp"
+#include "lib.hpp"
+
+// C++ Standard Library
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace Stp {
+
+/**
+ * @brief The Scheduler class runs tasks at given points of time of its clock. Tasks due at the
+ *        same time run in order in which they have been scheduled, so with the virtual clock
+ *        every run gives the same sequence of events.
+ * @note It is not thread-safe, tasks have to be scheduled from the thread which runs them.
+ */
+class Scheduler {
+public:
+    using Task = std::function<void()>;
+    using TaskId = u64;
+
+    explicit Scheduler(ClockH clock);
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    /**
+     * @brief ScheduleAt runs task once at the time
+     * @param time point (since the clock's epoch) at which task should run
+     * @param task to run
+     * @return Identifier of the task, which might be used to cancel it
+     */
+    TaskId ScheduleAt(const Clock::Duration time, Task task);
+    /**
+     * @brief ScheduleAfter runs task once after delay counted from now
+     */
+    TaskId ScheduleAfter(const Clock::Duration delay, Task task);
+    /**
+     * @brief ScheduleEvery runs task periodically. Next run is counted from the scheduled time
+     *        instead of the time of completion, so period does not drift.
+     * @param first point (since the clock's epoch) of the first run
+     * @param period interval between subsequent runs
+     * @param task to run
+     * @return Identifier of the task, which might be used to cancel it
+     */
+    TaskId ScheduleEvery(const Clock::Duration first, const Clock::Duration period, Task task);
+    /**
+     * @brief Cancel removes the task, even if it's periodic one
+     * @return Result::Success if task has been cancelled, otherwise Result::Fail
+     */
+    Result Cancel(const TaskId taskId);
+    /**
+     * @brief SetWakeup makes RunNext() stop waiting for the next task once the wakeup is notified
+     *        and run the task instead
+     * @param task runs on every notification, e.g. to schedule work queued by other threads
+     */
+    void SetWakeup(Wakeup& wakeup, Task task);
+
+    /**
+     * @brief RunNext waits until the earliest task is due and runs it, or runs the task of the
+     *        wakeup if it has been notified meanwhile
+     * @return true if any task has been run, false if there is nothing scheduled
+     */
+    bool RunNext();
+    /**
+     * @brief RunUntil runs all tasks due at or before the time and then waits for the time
+     * @return Number of tasks which have been run
+     */
+    u64 RunUntil(const Clock::Duration time);
+
+    bool Empty() noexcept;
+    /// @note Valid only if scheduler is not empty
+    Clock::Duration NextTime() noexcept;
+    Clock& ClockInstance() const noexcept;
+
+private:
+    struct Entry {
+        Clock::Duration Time;
+        u64 Seq;
+        TaskId Id;
+
+        bool operator>(const Entry& other) const noexcept;
+    };
+
+    struct ScheduledTask {
+        Task Run;
+        Clock::Duration Period;
+    };
+
+    void Push(const Clock::Duration time, const TaskId taskId);
+    void DropCancelled() noexcept;
+
+    ClockH _clock;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> _entries;
+    std::unordered_map<TaskId, ScheduledTask> _tasks;
+    u64 _seq;
+    TaskId _nextTaskId;
+    Wakeup* _wakeup;
+    Task _wakeupTask;
+};
+
+using SchedulerH = Uptr<Scheduler>;
+
+inline Scheduler::TaskId Scheduler::ScheduleAfter(const Clock::Duration delay, Task task) {
+    return ScheduleAt(_clock->Now() + delay, std::move(task));
+}
+
+inline Clock& Scheduler::ClockInstance() const noexcept {
+    return *_clock;
+}
+
+inline bool Scheduler::Entry::operator>(const Entry& other) const noexcept {
+    return (Time != other.Time) ? (Time > other.Time) : (Seq > other.Seq);
+}
+
+} // namespace Stp
@@ -0,0 +1,90 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "lib.hpp"
+
+// C++ Standard Library
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace Stp {
+
+/**
+ * @brief The SeqLock class publishes value written by the single thread to any number of
+ *        readers. The writer never waits for readers, readers retry copying when the value has
+ *        been changed in the meantime. The value is kept in relaxed atomic words, so concurrent
+ *        copying is not a data race.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "Value has to be copied word by word");
+
+public:
+    SeqLock() noexcept;
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /// @note Only one thread might store the value
+    void Store(const T& value) noexcept;
+    /// @note Might be called from any thread
+    T Load() const noexcept;
+
+private:
+    static constexpr std::size_t _kWords = (sizeof(T) + sizeof(u64) - 1) / sizeof(u64);
+
+    std::atomic<u32> _sequence; ///< Odd while the writer is storing the value
+    std::atomic<u64> _words[_kWords];
+};
+
+template <typename T>
+inline SeqLock<T>::SeqLock() noexcept
+    : _sequence{ 0 } {
+    Store(T{});
+}
+
+template <typename T>
+inline void SeqLock<T>::Store(const T& value) noexcept {
+    u64 words[_kWords] = { };
+    std::memcpy(words, &value, sizeof(T));
+
+    const u32 sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    // Readers which see any of new words have to see odd sequence as well
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t idx = 0; idx < _kWords; ++idx) {
+        _words[idx].store(words[idx], std::memory_order_relaxed);
+    }
+
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+template <typename T>
+inline T SeqLock<T>::Load() const noexcept {
+    u64 words[_kWords];
+    u32 before = 0;
+    u32 after = 0;
+    do {
+        before = _sequence.load(std::memory_order_acquire);
+        for (std::size_t idx = 0; idx < _kWords; ++idx) {
+            words[idx] = _words[idx].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = _sequence.load(std::memory_order_relaxed);
+    } while ((before != after) || (before & 1));
+
+    T value;
+    std::memcpy(&value, words, sizeof(T));
+
+    return value;
+}
+
+} // namespace Stp
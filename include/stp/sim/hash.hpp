@@ -0,0 +1,38 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "stp/lib.hpp"
+
+namespace Stp {
+namespace Sim {
+
+/**
+ * @brief Mix64 scrambles bits of the value (finalizer of SplitMix64). The simulator derives every
+ *        pseudo-random decision from it, so results do not depend on the standard library.
+ */
+constexpr u64 Mix64(u64 value) noexcept {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+constexpr u64 Mix64(const u64 first, const u64 second) noexcept {
+    return Mix64(Mix64(first) ^ second);
+}
+
+/**
+ * @brief UnitInterval maps hash onto the range [0, 1)
+ */
+constexpr double UnitInterval(const u64 hash) noexcept {
+    return static_cast<double>(hash >> 11) * (1.0 / 9007199254740992.0);
+}
+
+} // namespace Sim
+} // namespace Stp
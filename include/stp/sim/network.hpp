@@ -0,0 +1,226 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "stp/clock.hpp"
+#include "stp/engine.hpp"
+#include "stp/lib.hpp"
+#include "stp/sim/topology.hpp"
+
+// C++ Standard Library
+#include <queue>
+#include <vector>
+
+namespace Stp {
+namespace Sim {
+
+/**
+ * @brief The Config struct keeps parameters of the simulation
+ */
+struct Config {
+    u64 Seed = 1; ///< Seeds tick phases of bridges and losses on links
+    u32 StableWindowMs = 10000; ///< Tree is stable when nothing changed for this period
+    u32 Workers = 1; ///< Number of threads which run bridges, results do not depend on it
+    /// @brief Ports of links are point-to-point (6.4.3), so they complete rapid handshake
+    bool PointToPointLinks = false;
+    /// @brief Hello time of ports of links in milliseconds, 0 keeps hello time of bridges.
+    ///        Bridges tick as often as their engines require, see Engine::TickIntervalMs().
+    u32 FastHelloTimeMs = 0;
+};
+
+/**
+ * @brief The Report struct keeps results measured since previous report
+ */
+struct Report {
+    bool Converged; ///< Tree has been stable for Config::StableWindowMs before time limit
+    u64 ConvergenceTimeMs; ///< Time from start of the measurement to the last change of the tree
+    u64 BpdusSent;
+    u64 BpdusDelivered;
+    u64 BpdusLost; ///< Lost on links, sent through links which are down or to hosts
+    u64 FdbFlushes;
+    u64 Events; ///< Number of processed simulation events
+    u64 CpuTimeUs; ///< CPU time of threads running bridges, summed over all of them
+    u32 RootCount; ///< Number of distinct roots among running bridges
+};
+
+/**
+ * @brief The Network class runs many RSTP engines in the single process. Transmitted BPDUs are
+ *        delivered to peer bridges as discrete events ordered by virtual time, so every run
+ *        with the same topology and configuration gives the same results.
+ *
+ *        Bridges are partitioned across Config::Workers threads. Threads advance together in
+ *        time windows no longer than the shortest link delay (lookahead), so no BPDU sent within
+ *        the window might be delivered before its end and each thread processes events of its
+ *        bridges independently. BPDUs for bridges of other threads are passed through mailboxes
+ *        at the window boundary. Every bridge sees the same sequence of events regardless of
+ *        the number of threads, thus results do not depend on it.
+ */
+class Network {
+public:
+    /// @note Delay of every link has to be at least 1 ms, since it's used as lookahead
+    Network(const Topology& topology, const Config& config);
+    ~Network();
+
+    Network(const Network&) = delete;
+    Network& operator=(const Network&) = delete;
+
+    /**
+     * @brief RunUntilStable processes events until the tree is stable or time limit is exceeded
+     * @param maxDurationMs time limit of the measurement in virtual time
+     * @return Results measured since previous call
+     */
+    Report RunUntilStable(const u64 maxDurationMs);
+    /**
+     * @brief RunFor processes events for the given period even if the tree is stable earlier
+     * @return Results measured since previous call
+     */
+    Report RunFor(const u64 durationMs);
+
+    Result FailLink(const u32 linkIdx);
+    Result RestoreLink(const u32 linkIdx);
+    Result FailBridge(const u32 bridge);
+    /**
+     * @brief RestoreBridge boots failed bridge again with all protocol state lost and brings up
+     *        its links to running bridges
+     */
+    Result RestoreBridge(const u32 bridge);
+    /// @param hostIdx index of port in Topology::HostPorts()
+    Result FailHostPort(const u32 hostIdx);
+    Result RestoreHostPort(const u32 hostIdx);
+    /**
+     * @brief SetBridgeConfig changes parameters of the bridge at runtime. They are kept when
+     *        failed bridge is restored.
+     */
+    Result SetBridgeConfig(const u32 bridge, const BridgeConfig& config);
+
+    bool BridgeUp(const u32 bridge) const noexcept;
+
+    u64 NowMs() const noexcept;
+    u32 WorkerCount() const noexcept;
+    const Topology& TopologyInstance() const noexcept;
+    const Engine& EngineInstance(const u32 bridge) const noexcept;
+
+private:
+    class BridgeOutInterface;
+    class Barrier;
+
+    enum class EventKind : u8 {
+        Deliver, ///< Goes first, so tick at the same time sees delivered BPDU
+        Tick
+    };
+
+    /// @note Events are ordered by all fields except payload, which makes ordering total
+    struct Event {
+        u64 TimeMs;
+        u32 Bridge;
+        EventKind Kind;
+        u32 SrcBridge;
+        u64 SrcSeq;
+        u16 Port;
+        ByteStreamH Data;
+
+        bool operator>(const Event& other) const noexcept;
+    };
+
+    using EventQueue = std::priority_queue<Event, std::vector<Event>, std::greater<Event>>;
+
+    /// @brief Marks index of host port in BridgeNode::PortLinks
+    static constexpr u32 _kHostPortFlag = 0x80000000;
+
+    struct BridgeNode {
+        EngineH Engine;
+        BridgeConfig Settings;
+        /// @brief Index of link or host port (with _kHostPortFlag) attached to port
+        ///        (port number - 1)
+        std::vector<u32> PortLinks;
+        std::vector<u64> PortTxSeq; ///< Number of BPDUs sent through port, seeds losses
+        u64 TxSeq;
+        u64 Signature;
+        u32 Worker;
+        bool Up;
+    };
+
+    struct Counters {
+        u64 BpdusSent;
+        u64 BpdusDelivered;
+        u64 BpdusLost;
+        u64 FdbFlushes;
+        u64 Events;
+        u64 CpuNs;
+
+        Counters& operator+=(const Counters& other) noexcept;
+    };
+
+    /// @brief State published by worker at the end of window, read by all workers after it
+    struct WindowReport {
+        u64 NextTimeMs; ///< Earliest event owned by the worker or sent by it to the others
+        u64 LastChangeMs;
+    };
+
+    /// @brief Worker owns bridges assigned to it and events destined for them
+    struct Worker {
+        EventQueue Events;
+        /// @brief Indexed by parity of window and destination worker. Parity lets the owner
+        ///        collect events of the previous window while they are sent in the current one.
+        std::vector<std::vector<Event>> Mailboxes[2];
+        WindowReport Reports[2]; ///< Indexed by parity of window
+        Sptr<VirtualClock> Clock; ///< Shared by engines of the worker's bridges
+        Counters Stats;
+        u64 NowMs;
+        u64 LastChangeMs;
+        u64 SentMinMs; ///< Earliest event sent to other workers in the current window
+        u32 Slot; ///< Parity of the current window
+    };
+
+    Report Run(const u64 maxDurationMs, const bool stopWhenStable);
+    void CreateEngine(const u32 bridge);
+    void RunWorker(const u32 workerIdx, const u64 deadlineMs, Barrier* barrier);
+    bool NextWindow(const u32 slot, const u64 deadlineMs, u64& endMs) const noexcept;
+    void CollectMail(const u32 workerIdx, const u32 slot);
+    void Transmit(const u32 bridge, const u16 portNo, ByteStreamH data);
+    void CountFdbFlush(const u32 bridge) noexcept;
+    void Process(Worker& worker, const Event& event);
+    void UpdateSignature(Worker& worker, const u32 bridge);
+    Counters TotalCounters() const noexcept;
+    u32 CountRoots() const;
+    void SetLinkUp(const u32 linkIdx, const bool up);
+
+    Topology _topology;
+    Config _config;
+    std::vector<Uptr<Worker>> _workers;
+    std::vector<BridgeNode> _bridges;
+    std::vector<bool> _linkUp;
+    std::vector<bool> _hostPortUp;
+    u64 _lookaheadMs;
+    u64 _nowMs;
+    u64 _lastChangeMs;
+    bool _stopWhenStable; ///< Set for the whole run, before workers are started
+};
+
+inline u64 Network::NowMs() const noexcept {
+    return _nowMs;
+}
+
+inline u32 Network::WorkerCount() const noexcept {
+    return static_cast<u32>(_workers.size());
+}
+
+inline bool Network::BridgeUp(const u32 bridge) const noexcept {
+    return (bridge < _bridges.size()) && _bridges[bridge].Up;
+}
+
+inline const Topology& Network::TopologyInstance() const noexcept {
+    return _topology;
+}
+
+inline const Engine& Network::EngineInstance(const u32 bridge) const noexcept {
+    return *_bridges[bridge].Engine;
+}
+
+} // namespace Sim
+} // namespace Stp
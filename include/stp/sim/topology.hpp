@@ -0,0 +1,122 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "stp/lib.hpp"
+
+// C++ Standard Library
+#include <string>
+#include <vector>
+
+namespace Stp {
+namespace Sim {
+
+/**
+ * @brief The Link struct represents point-to-point link between ports of two bridges
+ */
+struct Link {
+    u32 BridgeA;
+    u16 PortA;
+    u32 BridgeB;
+    u16 PortB;
+    u32 DelayMs; ///< One-way propagation delay
+    u32 SpeedMb; ///< Speed of both ports in Megabits [Mb]
+    double Loss; ///< Probability of losing single BPDU in range [0, 1]
+};
+
+/**
+ * @brief The HostPort struct represents port of bridge connected to end station, which does not
+ *        run spanning tree protocol
+ */
+struct HostPort {
+    u32 Bridge;
+    u16 Port;
+    u32 SpeedMb;
+};
+
+/**
+ * @brief The Topology class describes bridges and links between them. Bridges are identified
+ *        by index in range [0, BridgeCount()) and their ports are numbered from 1.
+ */
+class Topology {
+public:
+    /// @brief Maximum number of ports which might be encoded in the Port Identifier
+    static constexpr u16 MaxPortsPerBridge = 4095;
+
+    explicit Topology(const u32 bridgeCount);
+
+    /**
+     * @brief Connect adds link between next free ports of both bridges
+     * @return Result::Success if link has been added, otherwise Result::Fail
+     */
+    Result Connect(const u32 bridgeA, const u32 bridgeB);
+    /**
+     * @brief AttachHost adds host port on next free port of the bridge
+     * @return Result::Success if port has been added, otherwise Result::Fail
+     */
+    Result AttachHost(const u32 bridge);
+
+    u32 BridgeCount() const noexcept;
+    u16 PortCount(const u32 bridge) const noexcept;
+    const std::vector<Link>& Links() const noexcept;
+    std::vector<Link>& GetLinks() noexcept;
+    const std::vector<HostPort>& HostPorts() const noexcept;
+    const std::string& Name() const noexcept;
+
+    /**
+     * @brief SetLinkParams sets the same delay, speed and loss on all links
+     */
+    void SetLinkParams(const u32 delayMs, const u32 speedMb, const double loss) noexcept;
+
+    static Topology Ring(const u32 bridgeCount);
+    static Topology FullMesh(const u32 bridgeCount);
+    /**
+     * @brief FatTree builds k-ary fat-tree of (5 * k^2 / 4) switches without hosts
+     * @param k number of ports of single switch, has to be even
+     */
+    static Topology FatTree(const u32 k);
+    /**
+     * @brief Random builds connected random graph: random spanning tree with additional random
+     *        links up to requested average degree
+     */
+    static Topology Random(const u32 bridgeCount, const u32 averageDegree, const u64 seed);
+
+private:
+    u32 _bridgeCount;
+    std::vector<u16> _portCount;
+    std::vector<Link> _links;
+    std::vector<HostPort> _hostPorts;
+    std::string _name;
+};
+
+inline u32 Topology::BridgeCount() const noexcept {
+    return _bridgeCount;
+}
+
+inline u16 Topology::PortCount(const u32 bridge) const noexcept {
+    return _portCount[bridge];
+}
+
+inline const std::vector<Link>& Topology::Links() const noexcept {
+    return _links;
+}
+
+inline std::vector<Link>& Topology::GetLinks() noexcept {
+    return _links;
+}
+
+inline const std::vector<HostPort>& Topology::HostPorts() const noexcept {
+    return _hostPorts;
+}
+
+inline const std::string& Topology::Name() const noexcept {
+    return _name;
+}
+
+} // namespace Sim
+} // namespace Stp
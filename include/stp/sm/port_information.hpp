@@ -26,6 +26,11 @@ protected:
     __virtual void ReceiveAction(Machine& machine);
     __virtual bool GoToCurrent(Machine& machine);
     __virtual void CurrentUctExecute(Machine& machine);
+    /// @brief Global transition (!portEnabled && (infoIs != Disabled)), BEGIN is handled by
+    ///        BeginState
+    __virtual bool GoToDisabledFromAnyState(Machine& machine);
+    /// @return true if the machine has moved to DISABLED state by the global transition
+    __virtual bool DisabledGlobalExecute(Machine& machine);
 };
 
 class BeginState : public PimState {
@@ -55,6 +55,11 @@ class PrsMachine : public Machine {
 public:
     PrsMachine(BridgeH bridge, PortH port);
     std::string Name() override;
+    /**
+     * @brief SkipInitBridge starts the machine in ROLE_SELECTION, so the port added to the
+     *        bridge together with many others does not reset roles of all ports on its own
+     */
+    void SkipInitBridge() noexcept;
 };
 
 inline PrsMachine::PrsMachine(BridgeH bridge, PortH port)
@@ -65,6 +70,10 @@ inline std::string PrsMachine::Name() {
     return "PRS";
 }
 
+inline void PrsMachine::SkipInitBridge() noexcept {
+    ChangeState(RoleSelectionState::Instance());
+}
+
 inline std::string BeginState::Name() {
     return "BEGIN";
 }
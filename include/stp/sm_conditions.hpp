@@ -17,35 +17,67 @@ namespace SmConditions {
 
 bool AdminEdge(Port& port) noexcept;
 bool AutoEdge(Port& port) noexcept;
-u16 EdgeDelay(const Port& port) noexcept;
-u16 ForwardDelay(const Port& port) noexcept;
+u32 EdgeDelay(const Port& port) noexcept;
+u32 ForwardDelay(const Port& port) noexcept;
 enum Port::RcvdInfo RcvInfo(Port& port) noexcept;
 bool ReRooted(Bridge& bridge, const Port& port) noexcept;
 bool RstpVersion(Bridge& bridge) noexcept;
+bool RxBpduCacheable(const Port& port) noexcept;
+bool RxFastPathAllowed(const Port& port) noexcept;
 bool StpVersion(Bridge& bridge) noexcept;
 
 inline bool AdminEdge(Port& port) noexcept {
-    return port.adminEdge;
+    return port.AdminEdge();
 }
 
 inline bool AutoEdge(Port& port) noexcept {
-    return port.autoEdge;
+    return port.AutoEdge();
 }
 
-inline u16 EdgeDelay(const Port& port) noexcept {
-    return port.operPointToPointMAC ? PerfParams::MigrateTime() : SmParams::MaxAge(port);
+inline u32 EdgeDelay(const Port& port) noexcept {
+    return port.OperPointToPointMAC() ? PerfParams::MigrateTime() : SmParams::MaxAge(port);
 }
 
-inline u16 ForwardDelay(const Port& port) noexcept {
+inline u32 ForwardDelay(const Port& port) noexcept {
     return port.SendRstp() ? PerfParams::HelloTime(port) : SmParams::FwdDelay(port);
 }
 
 inline bool RstpVersion(Bridge& bridge) noexcept {
-    return bridge.ForceProtocolVersion >= 2;
+    return bridge.ForceProtocolVersion() >= BridgeConfig::ProtocolVersion::Rstp;
+}
+
+/// @brief Checks if the received BPDU carries nothing but information which the repeated-BPDU
+///        fast path is able to apply, i.e. no topology change and no proposal
+inline bool RxBpduCacheable(const Port& port) noexcept {
+    if (Bpdu::Type::Tcn == port.RxBpdu().BpduType()) {
+        return false;
+    }
+
+    return not (port.RxBpdu().TcFlag() || port.RxBpdu().TcAckFlag()
+                || port.RxBpdu().ProposalFlag());
+}
+
+/// @brief Checks if the port is in steady state in which repeated BPDU may skip the full
+///        decode path and the Port Receive and Port Information state machines
+inline bool RxFastPathAllowed(const Port& port) noexcept {
+    if (not port.RxFastPath()) {
+        return false;
+    }
+    else if (not port.PortEnabled()) {
+        return false;
+    }
+    else if (Port::Info::Received != port.InfoIs()) {
+        return false;
+    }
+    else if (port.RcvdBpdu() || port.RcvdMsg()) {
+        return false;
+    }
+
+    return true;
 }
 
 inline bool StpVersion(Bridge& bridge) noexcept {
-    return bridge.ForceProtocolVersion < 2;
+    return bridge.ForceProtocolVersion() < BridgeConfig::ProtocolVersion::Rstp;
 }
 
 } // namespace SmConditions
@@ -12,15 +12,15 @@
 namespace Stp {
 namespace SmParams {
 
-u16 FwdDelay(const Port& port) noexcept;
-u16 MaxAge(const Port& port) noexcept;
+u32 FwdDelay(const Port& port) noexcept;
+u32 MaxAge(const Port& port) noexcept;
 
-inline u16 FwdDelay(const Port& port) noexcept {
+inline u32 FwdDelay(const Port& port) noexcept {
     return port.DesignatedTimes().ForwardDelay();
 }
 
-inline u16 MaxAge(const Port& port) noexcept {
-    return port.DesignatedTimes().HelloTime();
+inline u32 MaxAge(const Port& port) noexcept {
+    return port.DesignatedTimes().MaxAge();
 }
 
 } // namespace SmParams
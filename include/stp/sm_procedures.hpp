@@ -22,13 +22,14 @@ void DisableForwarding(Bridge& bridge, const Port& port) noexcept;
 void DisableLearning(Bridge& bridge, const Port& port) noexcept;
 void EnableForwarding(Bridge& bridge, const Port& port) noexcept;
 void EnableLearning(Bridge& bridge, const Port& port) noexcept;
-void FlushFdb(Bridge& bridge, const Port& port) noexcept;
-u16 MaxAge(const Port& port) noexcept;
+void FlushFdb(Bridge& bridge, Port& port) noexcept;
+u32 MaxAge(const Port& port) noexcept;
 void NewTcWhile(const Bridge& bridge, Port& port) noexcept;
 void RecordAgreement(Bridge& bridge, Port& port) noexcept;
 void RecordDispute(Port& port) noexcept;
 void RecordPriority(Port& port) noexcept;
 void RecordProposal(Port& port) noexcept;
+void RecordRepeatedBpdu(Port& port) noexcept;
 void RecordTimes(Port& port) noexcept;
 bool RootPort(Port& port) noexcept;
 void SetReRootTree(Bridge& bridge) noexcept;
@@ -42,10 +43,21 @@ void TxTcn(Bridge& bridge, Port& port);
 void UpdtBpduVersion(Port& port) noexcept;
 void UpdtRcvdInfoWhile(Port& port) noexcept;
 void UpdtRoleDisabledTree(Bridge& bridge) noexcept;
-void UpdtRolesTree(Bridge& bridge) noexcept;
+/**
+ * @brief UpdtRolesTree (17.21.25)
+ * @param installFailover takes the root priority vector from the failover plan instead of
+ *        comparing vectors of all ports, see FailoverApplies()
+ */
+void UpdtRolesTree(Bridge& bridge, const bool installFailover = false) noexcept;
+/// @return true if the root port covered by the failover plan has lost its information and no
+///         other port requests reselection, so the plan is still valid
+bool FailoverApplies(const Bridge& bridge) noexcept;
+/// @brief UpdtFailoverPlan chooses the port which would replace the current root port, roles of
+///        other ports are left to UpdtRolesTree()
+void UpdtFailoverPlan(Bridge& bridge) noexcept;
 
 inline bool AdminEdge(Port& port) noexcept {
-    return port.adminEdge;
+    return port.AdminEdge();
 }
 
 inline bool DesignatedPort(Port& port) noexcept {
@@ -0,0 +1,199 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "bpdu.hpp"
+#include "bridge.hpp"
+#include "engine_stats.hpp"
+#include "lib.hpp"
+#include "port.hpp"
+
+// C++ Standard Library
+#include <string>
+#include <type_traits>
+
+namespace Stp {
+
+/**
+ * @brief The StateImage class mirrors state of the bridge, its ports and their state machines
+ *        into memory-mapped file, so the RSTP started again (e.g. after upgrade) continues from
+ *        that state instead of reconverging the network from BEGIN. The file keeps two slots:
+ *        the image is written into the inactive one, which becomes active once it is complete,
+ *        so the file always holds the last complete image, even if the process dies while
+ *        writing. Records have fixed layout, which is versioned by LayoutVersion.
+ * @note Only POSIX systems are supported, elsewhere mapping of the file fails
+ */
+class StateImage {
+public:
+    static constexpr u32 Magic = 0x49505453; ///< "STPI"
+    /// @brief Incremented on every incompatible change of records below
+    static constexpr u32 LayoutVersion = 1;
+    /// @brief Value of active slot of the file without complete image
+    static constexpr u32 NoSlot = 0xFFFFFFFF;
+
+    struct PriorityVectorRecord {
+        Bpdu::BridgeIdHandler RootBridgeId;
+        Bpdu::BridgeIdHandler DesignatedBridgeId;
+        u32 RootPathCost;
+        Bpdu::PortIdHandler DesignatedPortId;
+        u8 Reserved[2];
+    };
+
+    /// @brief In milliseconds
+    struct TimesRecord {
+        u32 MessageAge;
+        u32 MaxAge;
+        u32 ForwardDelay;
+        u32 HelloTime;
+    };
+
+    struct BridgeRecord {
+        u64 Address;
+        Bpdu::BridgeIdHandler BridgeId;
+        Bpdu::PortIdHandler RootPortId;
+        u8 ForceProtocolVersion;
+        u8 TxHoldCount;
+        u32 AgeingTime;
+        u32 Reserved;
+        PriorityVectorRecord BridgePriority;
+        PriorityVectorRecord RootPriority;
+        TimesRecord BridgeTimes;
+        TimesRecord RootTimes;
+    };
+
+    /// @brief Variables of the port (17.19), its timers (17.17) and states of its machines
+    struct PortRecord {
+        u16 PortNo;
+        u16 FastHelloTime;
+        Bpdu::PortIdHandler PortId;
+        u8 InfoIs;
+        u8 RcvdInfo;
+        u8 Role;
+        u8 SelectedRole;
+        u8 TxCount;
+        u8 Reserved;
+        /// @brief Identifier of current state of every machine, indexed by MachineType
+        u8 States[MachineTypeCount];
+        u8 Reserved2[2];
+        u32 PathCost;
+        u32 AgeingTime;
+        /// @brief Bits of flags of the port, see state_image.cpp for their positions
+        u64 Flags;
+        PriorityVectorRecord DesignatedPriority;
+        PriorityVectorRecord MsgPriority;
+        PriorityVectorRecord PortPriority;
+        TimesRecord DesignatedTimes;
+        TimesRecord MsgTimes;
+        TimesRecord PortTimes;
+        u32 EdgeDelayWhile;
+        u32 FdWhile;
+        u32 HelloWhen;
+        u32 MdelayWhile;
+        u32 RbWhile;
+        u32 RcvdInfoWhile;
+        u32 RrWhile;
+        u32 TcWhile;
+    };
+
+    /// @brief Every slot starts with the header, records of ports follow it
+    struct SlotHeader {
+        u64 Generation;
+        /// @brief Time of the clock of the RSTP at writing, in milliseconds
+        u64 TimeMs;
+        u32 PortCount;
+        u32 Reserved;
+        BridgeRecord Bridge;
+    };
+
+    static_assert(std::is_trivially_copyable<PortRecord>::value, "Records are copied as bytes");
+    static_assert(std::is_trivially_copyable<SlotHeader>::value, "Records are copied as bytes");
+
+    StateImage() noexcept;
+    ~StateImage();
+
+    StateImage(const StateImage&) = delete;
+    StateImage& operator=(const StateImage&) = delete;
+
+    /**
+     * @brief Create maps the file for writing. Compatible file which is big enough is reused
+     *        together with its last image, otherwise the new file replaces it once its first
+     *        image is committed.
+     * @param portCapacity number of ports which fit into every slot
+     * @return Result::Success if the file has been mapped, otherwise Result::Fail
+     */
+    Result Create(const std::string& path, const u32 portCapacity);
+    /**
+     * @brief Open maps the file written by the previous run for reading
+     * @return Result::Success if the file exists and has compatible layout, otherwise
+     *         Result::Fail
+     */
+    Result Open(const std::string& path);
+    /// @return true if the file is mapped
+    bool IsMapped() const noexcept;
+    u32 PortCapacity() const noexcept;
+
+    /// @return Slot of the last complete image, nullptr if there is none
+    const SlotHeader* ActiveSlot() const noexcept;
+    const PortRecord* Ports(const SlotHeader& slot) const noexcept;
+    /// @return Slot which might be overwritten, as it does not keep the last complete image
+    SlotHeader& InactiveSlot() noexcept;
+    PortRecord* GetPorts(SlotHeader& slot) noexcept;
+    /// @brief Commit makes the slot written after InactiveSlot() the active one
+    void Commit(SlotHeader& slot) noexcept;
+
+    static void SaveBridge(const Bridge& bridge, BridgeRecord& record) noexcept;
+    static void RestoreBridge(const BridgeRecord& record, Bridge& bridge) noexcept;
+    /// @note States of machines are saved by the engine, which owns them
+    static void SavePort(const Port& port, PortRecord& record) noexcept;
+    /**
+     * @brief RestorePort restores variables of the port saved by SavePort()
+     * @param elapsedMs time elapsed since the image has been written, which timers are
+     *        advanced by
+     */
+    static void RestorePort(const PortRecord& record, const u32 elapsedMs, Port& port) noexcept;
+
+private:
+    struct Header {
+        u32 Magic;
+        u32 LayoutVersion;
+        u32 SlotHeaderSize;
+        u32 PortRecordSize;
+        u32 PortCapacity;
+        u32 ActiveSlot;
+    };
+
+    /// @return Size of the file which keeps two slots of given capacity
+    static std::size_t FileSize(const u32 portCapacity) noexcept;
+    std::size_t SlotOffset(const u32 slot) const noexcept;
+    Header& GetHeader() const noexcept;
+    /// @return true if the mapped file has layout written by this version
+    bool IsCompatible() const noexcept;
+    Result Map(const std::string& path, const bool writable, const bool create,
+               const u32 portCapacity);
+    void Unmap() noexcept;
+
+    u8* _data;
+    std::size_t _size;
+    /// @brief The file replaced by the mapped one on the first commit, empty if there is none
+    std::string _replacedPath;
+    std::string _mappedPath;
+};
+
+inline bool StateImage::IsMapped() const noexcept {
+    return nullptr != _data;
+}
+
+inline u32 StateImage::PortCapacity() const noexcept {
+    return _data ? GetHeader().PortCapacity : 0;
+}
+
+inline StateImage::Header& StateImage::GetHeader() const noexcept {
+    return *reinterpret_cast<Header*>(_data);
+}
+
+} // namespace Stp
@@ -8,12 +8,14 @@
 
 // This project's headers
 #include "bridge.hpp"
+#include "engine_stats.hpp"
 #include "port.hpp"
 #include "specifiers.hpp"
 
 // C++ Standard Library
 #include <memory>
 #include <string>
+#include <tuple>
 
 namespace Stp {
 
@@ -31,15 +33,43 @@ public:
 protected:
     virtual ~State() = default;
     __virtual void ChangeState(Machine& machine, State& newState);
+    /**
+     * @brief Guard passes through condition of transition evaluated by the state, so it is
+     *        counted together with its outcome
+     * @return The condition
+     */
+    static bool Guard(Machine& machine, const bool condition) noexcept;
 };
 
 class Machine {
 public:
+    /**
+     * @brief Machine runs on the port of the bridge
+     * @note The caller keeps the bridge and the port alive as long as the machine, so ten
+     *       machines of every port do not share ownership of them
+     */
     explicit Machine(BridgeH bridge, PortH port, State& initState);
-    void Run();
+    /**
+     * @brief Run executes current state once
+     * @return true if machine has moved to another state, otherwise false
+     */
+    bool Run();
     virtual std::string Name() = 0;
     __virtual Bridge& BridgeInstance() const noexcept;
     Port& PortInstance() const noexcept;
+    State& CurrentState() const noexcept;
+    /**
+     * @brief RestoreState puts the machine into the state saved by the previous run of the RSTP,
+     *        without executing actions of the state
+     */
+    void RestoreState(State& state) noexcept;
+#ifdef STP_ENGINE_STATS
+    /**
+     * @brief AttachCounters starts counting executions and transitions of the machine
+     * @param counters owned by the caller, which has to outlive the machine
+     */
+    void AttachCounters(MachineCounters* counters) noexcept;
+#endif
 
 protected:
     friend class State;
@@ -49,19 +79,35 @@ protected:
      * @param state
      */
     void ChangeState(State& newState);
-    State& CurrentState() const noexcept;
+#ifdef STP_ENGINE_STATS
+    void RecordGuard(const bool met) noexcept;
+#endif
 
 private:
     /// @todo static member because all ports working on single Bridge instance
-    BridgeH _bridge;
-    PortH _port;
+    Bridge* _bridge;
+    Port* _port;
     State* _state;
+#ifdef STP_ENGINE_STATS
+    MachineCounters* _counters{ nullptr };
+#endif
 };
 
 using MachineH = Uptr<Machine>;
 
-inline void Machine::Run() {
+inline bool Machine::Run() {
+#ifdef STP_ENGINE_STATS
+    const u64 start = ReadCycles();
+#endif
+    const State* const previousState = _state;
     _state->Execute(*this);
+    const bool changed = previousState != _state;
+#ifdef STP_ENGINE_STATS
+    if (_counters) {
+        _counters->RecordExecution(ReadCycles() - start, changed);
+    }
+#endif
+    return changed;
 }
 
 inline Bridge& Machine::BridgeInstance() const noexcept {
@@ -72,12 +118,39 @@ inline Port& Machine::PortInstance() const noexcept {
     return *_port;
 }
 
+#ifdef STP_ENGINE_STATS
+inline void Machine::AttachCounters(MachineCounters* counters) noexcept {
+    _counters = counters;
+}
+#endif
+
 inline void Machine::ChangeState(State& newState) {
     _state = &newState;
 }
 
+#ifdef STP_ENGINE_STATS
+inline void Machine::RecordGuard(const bool met) noexcept {
+    if (_counters) {
+        _counters->RecordGuard(met);
+    }
+}
+#endif
+
 inline State& Machine::CurrentState() const noexcept {
     return *_state;
 }
 
+inline void Machine::RestoreState(State& state) noexcept {
+    _state = &state;
+}
+
+inline bool State::Guard(Machine& machine, const bool condition) noexcept {
+#ifdef STP_ENGINE_STATS
+    machine.RecordGuard(condition);
+#else
+    std::ignore = machine;
+#endif
+    return condition;
+}
+
 } // namespace Stp
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "clock.hpp"
 #include "logger.hpp"
 
 namespace Stp {
@@ -49,15 +50,21 @@ protected:
 using OutInterfaceH = Sptr<OutInterface>;
 
 struct System {
-    System(OutInterfaceH outInterface, LoggingSystem::LoggerH logger);
+    /**
+     * @param clock source of time which drives the STP, by default the wall time. The virtual
+     *        clock allows to run the STP faster than real time (e.g. in simulation or tests).
+     */
+    System(OutInterfaceH outInterface, LoggingSystem::LoggerH logger,
+           ClockH clock = std::make_shared<SystemClock>());
     OutInterfaceH OutInterface;
     LoggingSystem::LoggerH Logger;
+    ClockH Clock;
 };
 
 using SystemH = Sptr<System>;
 
-inline System::System(OutInterfaceH outInterface, LoggingSystem::LoggerH logger)
-    : OutInterface{ outInterface }, Logger{ logger } {
+inline System::System(OutInterfaceH outInterface, LoggingSystem::LoggerH logger, ClockH clock)
+    : OutInterface{ outInterface }, Logger{ logger }, Clock{ clock } {
 }
 
 } // namespace Stp
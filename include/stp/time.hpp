@@ -11,8 +11,13 @@
 
 namespace Stp {
 
+/**
+ * @brief The Time class keeps timer parameters (17.19.18) in milliseconds. BPDUs carry them in
+ *        units of 1/256 second (9.3.1), they are converted on reception and transmission.
+ */
 class Time {
 public:
+    /// @brief In seconds (Table 17-1)
     enum class RecommendedValue : u16 {
         MigrateTime = 3,
         BridgeHelloTime = 2,
@@ -20,10 +25,24 @@ public:
         BridgeForwardDelay = 15
     };
 
-    Time(const u16 msgAge = 0,
-         const u16 maxAge = static_cast<u16>(+RecommendedValue::BridgeMaxAge),
-         const u16 fwdDelay = static_cast<u16>(+RecommendedValue::BridgeForwardDelay),
-         const u16 helloTime = static_cast<u16>(+RecommendedValue::BridgeHelloTime)) noexcept;
+    static constexpr u32 MsPerSecond = 1000;
+    static constexpr u32 BpduUnitsPerSecond = 256;
+    /// @brief Interval of ticks of Port Timers machine when no port uses fast hello
+    static constexpr u32 DefaultTickIntervalMs = MsPerSecond;
+    /// @brief Range of hello time of ports in fast hello mode
+    static constexpr u32 MinFastHelloTimeMs = 10;
+    static constexpr u32 MaxFastHelloTimeMs = MsPerSecond - 1;
+
+    static constexpr u32 FromSeconds(const u32 seconds) noexcept;
+    /// @return Time in units of 1/256 second, rounded to the nearest one
+    static constexpr u16 ToBpduUnits(const u32 ms) noexcept;
+    /// @return Time in milliseconds, rounded to the nearest one
+    static constexpr u32 FromBpduUnits(const u16 units) noexcept;
+
+    Time(const u32 msgAge = 0,
+         const u32 maxAge = FromSeconds(+RecommendedValue::BridgeMaxAge),
+         const u32 fwdDelay = FromSeconds(+RecommendedValue::BridgeForwardDelay),
+         const u32 helloTime = FromSeconds(+RecommendedValue::BridgeHelloTime)) noexcept;
     Time(const Time&) noexcept = default;
     Time(Time&&) = default;
 
@@ -34,25 +53,28 @@ public:
 
     bool operator==(const Time& comparedTo) const noexcept;
 
-    u16 MessageAge() const noexcept;
-    void SetMessageAge(const u16 value) noexcept;
+    u32 MessageAge() const noexcept;
+    void SetMessageAge(const u32 value) noexcept;
 
-    u16 MaxAge() const noexcept;
-    void SetMaxAge(const u16 value) noexcept;
+    u32 MaxAge() const noexcept;
+    void SetMaxAge(const u32 value) noexcept;
 
-    u16 ForwardDelay() const noexcept;
-    void SetForwardDelay(const u16 value) noexcept;
+    u32 ForwardDelay() const noexcept;
+    void SetForwardDelay(const u32 value) noexcept;
 
-    u16 HelloTime() const noexcept;
-    void SetHelloTime(const u16 value) noexcept;
+    u32 HelloTime() const noexcept;
+    void SetHelloTime(const u32 value) noexcept;
 
 private:
-    u16 _msgAge;
-    u16 _maxAge;
-    u16 _fwdDelay;
-    u16 _helloTime;
+    u32 _msgAge;
+    u32 _maxAge;
+    u32 _fwdDelay;
+    u32 _helloTime;
 };
 
+/**
+ * @brief The SmTimers class keeps timers of the port (17.17) in milliseconds
+ */
 class SmTimers {
 public:
     SmTimers() noexcept;
@@ -64,62 +86,75 @@ public:
     SmTimers& operator=(const SmTimers&) noexcept = default;
     SmTimers& operator=(SmTimers&&) = default;
 
-    SmTimers& operator--() noexcept;
+    /// @brief Advance decrements every running timer by elapsed time, stopping at zero
+    SmTimers& Advance(const u32 elapsedMs) noexcept;
 
-    u16 EdgeDelayWhile() const noexcept;
-    void SetEdgeDelayWhile(const u16 value) noexcept;
+    u32 EdgeDelayWhile() const noexcept;
+    void SetEdgeDelayWhile(const u32 value) noexcept;
 
-    u16 FdWhile() const noexcept;
-    void SetFdWhile(const u16 value) noexcept;
+    u32 FdWhile() const noexcept;
+    void SetFdWhile(const u32 value) noexcept;
 
-    u16 HelloWhen() const noexcept;
-    void SetHelloWhen(const u16 value) noexcept;
+    u32 HelloWhen() const noexcept;
+    void SetHelloWhen(const u32 value) noexcept;
 
-    u16 MdelayWhile() const noexcept;
-    void SetMdelayWhile(const u16 value) noexcept;
+    u32 MdelayWhile() const noexcept;
+    void SetMdelayWhile(const u32 value) noexcept;
 
-    u16 RbWhile() const noexcept;
-    void SetRbWhile(const u16 value) noexcept;
+    u32 RbWhile() const noexcept;
+    void SetRbWhile(const u32 value) noexcept;
 
-    u16 RcvdInfoWhile() const noexcept;
-    void SetRcvdInfoWhile(const u16 value) noexcept;
+    u32 RcvdInfoWhile() const noexcept;
+    void SetRcvdInfoWhile(const u32 value) noexcept;
 
-    u16 RrWhile() const noexcept;
-    void SetRrWhile(const u16 value) noexcept;
+    u32 RrWhile() const noexcept;
+    void SetRrWhile(const u32 value) noexcept;
 
-    u16 TcWhile() const noexcept;
-    void SetTcWhile(const u16 value) noexcept;
+    u32 TcWhile() const noexcept;
+    void SetTcWhile(const u32 value) noexcept;
 
-    static bool TimedOut(const u16 value) noexcept;
+    static bool TimedOut(const u32 value) noexcept;
 
 private:
     /// @brief 17.17.1
-    u16 _edgeDelayWhile;
+    u32 _edgeDelayWhile;
 
     /// @brief 17.17.2
-    u16 _fdWhile;
+    u32 _fdWhile;
 
     /// @brief 17.17.3
-    u16 _helloWhen;
+    u32 _helloWhen;
 
     /// @brief 17.17.4
-    u16 _mdelayWhile;
+    u32 _mdelayWhile;
 
     /// @brief 17.17.5
-    u16 _rbWhile;
+    u32 _rbWhile;
 
     /// @brief 17.17.6
-    u16 _rcvdInfoWhile;
+    u32 _rcvdInfoWhile;
 
     /// @brief 17.17.7
-    u16 _rrWhile;
+    u32 _rrWhile;
 
     /// @brief 17.17.8
-    u16 _tcWhile;
+    u32 _tcWhile;
 };
 
-inline Time::Time(const u16 msgAge, const u16 maxAge,
-                  const u16 fwdDelay, const u16 helloTime) noexcept
+constexpr u32 Time::FromSeconds(const u32 seconds) noexcept {
+    return seconds * MsPerSecond;
+}
+
+constexpr u16 Time::ToBpduUnits(const u32 ms) noexcept {
+    return static_cast<u16>((ms * BpduUnitsPerSecond + MsPerSecond / 2) / MsPerSecond);
+}
+
+constexpr u32 Time::FromBpduUnits(const u16 units) noexcept {
+    return (units * MsPerSecond + BpduUnitsPerSecond / 2) / BpduUnitsPerSecond;
+}
+
+inline Time::Time(const u32 msgAge, const u32 maxAge,
+                  const u32 fwdDelay, const u32 helloTime) noexcept
     : _msgAge{ msgAge }, _maxAge{ maxAge }, _fwdDelay{ fwdDelay }, _helloTime{ helloTime } {
     // Nothing more to do
 }
@@ -131,42 +166,42 @@ inline bool Time::operator==(const Time& comparedTo) const noexcept {
             && _helloTime == comparedTo._helloTime;
 }
 
-inline u16 Time::MessageAge() const noexcept { return _msgAge; }
-inline void Time::SetMessageAge(const u16 value) noexcept { _msgAge = value; }
+inline u32 Time::MessageAge() const noexcept { return _msgAge; }
+inline void Time::SetMessageAge(const u32 value) noexcept { _msgAge = value; }
 
-inline u16 Time::MaxAge() const noexcept { return _maxAge; }
-inline void Time::SetMaxAge(const u16 value) noexcept { _maxAge = value; }
+inline u32 Time::MaxAge() const noexcept { return _maxAge; }
+inline void Time::SetMaxAge(const u32 value) noexcept { _maxAge = value; }
 
-inline u16 Time::ForwardDelay() const noexcept { return _fwdDelay; }
-inline void Time::SetForwardDelay(const u16 value) noexcept { _fwdDelay = value; }
+inline u32 Time::ForwardDelay() const noexcept { return _fwdDelay; }
+inline void Time::SetForwardDelay(const u32 value) noexcept { _fwdDelay = value; }
 
-inline u16 Time::HelloTime() const noexcept { return _helloTime; }
-inline void Time::SetHelloTime(const u16 value) noexcept { _helloTime = value; }
+inline u32 Time::HelloTime() const noexcept { return _helloTime; }
+inline void Time::SetHelloTime(const u32 value) noexcept { _helloTime = value; }
 
-inline u16 SmTimers::EdgeDelayWhile() const noexcept { return _edgeDelayWhile; }
-inline void SmTimers::SetEdgeDelayWhile(const u16 value) noexcept { _edgeDelayWhile = value; }
+inline u32 SmTimers::EdgeDelayWhile() const noexcept { return _edgeDelayWhile; }
+inline void SmTimers::SetEdgeDelayWhile(const u32 value) noexcept { _edgeDelayWhile = value; }
 
-inline u16 SmTimers::FdWhile() const noexcept { return _fdWhile; }
-inline void SmTimers::SetFdWhile(const u16 value) noexcept { _fdWhile = value; }
+inline u32 SmTimers::FdWhile() const noexcept { return _fdWhile; }
+inline void SmTimers::SetFdWhile(const u32 value) noexcept { _fdWhile = value; }
 
-inline u16 SmTimers::HelloWhen() const noexcept { return _helloWhen; }
-inline void SmTimers::SetHelloWhen(const u16 value) noexcept { _helloWhen = value; }
+inline u32 SmTimers::HelloWhen() const noexcept { return _helloWhen; }
+inline void SmTimers::SetHelloWhen(const u32 value) noexcept { _helloWhen = value; }
 
-inline u16 SmTimers::MdelayWhile() const noexcept { return _mdelayWhile; }
-inline void SmTimers::SetMdelayWhile(const u16 value) noexcept { _mdelayWhile = value; }
+inline u32 SmTimers::MdelayWhile() const noexcept { return _mdelayWhile; }
+inline void SmTimers::SetMdelayWhile(const u32 value) noexcept { _mdelayWhile = value; }
 
-inline u16 SmTimers::RbWhile() const noexcept { return _rbWhile; }
-inline void SmTimers::SetRbWhile(const u16 value) noexcept { _rbWhile = value; }
+inline u32 SmTimers::RbWhile() const noexcept { return _rbWhile; }
+inline void SmTimers::SetRbWhile(const u32 value) noexcept { _rbWhile = value; }
 
-inline u16 SmTimers::RcvdInfoWhile() const noexcept { return _rcvdInfoWhile; }
-inline void SmTimers::SetRcvdInfoWhile(const u16 value) noexcept { _rcvdInfoWhile = value; }
+inline u32 SmTimers::RcvdInfoWhile() const noexcept { return _rcvdInfoWhile; }
+inline void SmTimers::SetRcvdInfoWhile(const u32 value) noexcept { _rcvdInfoWhile = value; }
 
-inline u16 SmTimers::RrWhile() const noexcept { return _rrWhile; }
-inline void SmTimers::SetRrWhile(const u16 value) noexcept { _rrWhile = value; }
+inline u32 SmTimers::RrWhile() const noexcept { return _rrWhile; }
+inline void SmTimers::SetRrWhile(const u32 value) noexcept { _rrWhile = value; }
 
-inline u16 SmTimers::TcWhile() const noexcept { return _tcWhile; }
-inline void SmTimers::SetTcWhile(const u16 value) noexcept { _tcWhile = value; }
+inline u32 SmTimers::TcWhile() const noexcept { return _tcWhile; }
+inline void SmTimers::SetTcWhile(const u32 value) noexcept { _tcWhile = value; }
 
-inline bool SmTimers::TimedOut(const u16 value) noexcept { return 0 == value; }
+inline bool SmTimers::TimedOut(const u32 value) noexcept { return 0 == value; }
 
 } // namespace Stp
@@ -0,0 +1,180 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include "bpdu.hpp"
+#include "clock.hpp"
+#include "lib.hpp"
+#include "port.hpp"
+#include "time.hpp"
+
+// C++ Standard Library
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Stp {
+
+class Machine;
+class State;
+
+/**
+ * @brief The TraceEvent enum represents kind of event recorded by the tracer
+ */
+enum class TraceEvent : u8 {
+    StateChange, ///< State machine of the port has moved to another state
+    BpduRx, ///< BPDU has been passed to the enabled port
+    BpduTx, ///< BPDU has been sent out through the port
+    TimerExpiry, ///< Timer of the port has reached zero on the tick
+    HardwareCall ///< Bridge has called the system to change forwarding database or port
+};
+
+/**
+ * @brief The TraceTimer enum represents timers of 17.17
+ */
+enum class TraceTimer : u8 {
+    EdgeDelayWhile,
+    FdWhile,
+    HelloWhen,
+    MdelayWhile,
+    RbWhile,
+    RcvdInfoWhile,
+    RrWhile,
+    TcWhile
+};
+
+/**
+ * @brief The TraceHardwareCall enum represents calls of OutInterface
+ */
+enum class TraceHardwareCall : u8 {
+    FlushFdb,
+    SetForwarding,
+    SetLearning,
+    SendOutBpdu
+};
+
+const char* TraceTimerName(const TraceTimer timer) noexcept;
+const char* TraceHardwareCallName(const TraceHardwareCall call) noexcept;
+
+/**
+ * @brief The TraceRecord struct is single event in the trace buffer. Names of machines and
+ *        states are interned by the tracer, so the record keeps only their identifiers.
+ */
+struct TraceRecord {
+    /// @brief Time of the clock of the bridge
+    u64 TimeNs;
+    u16 PortNo;
+    TraceEvent Event;
+    /// @brief BPDU type, TraceTimer or TraceHardwareCall
+    u8 Kind;
+    /// @brief Name of machine, BPDU flags or enable argument of hardware call
+    u16 Subject;
+    u16 OldState;
+    u16 NewState;
+};
+
+static_assert(sizeof(TraceRecord) <= 24, "Trace record should stay compact");
+
+/**
+ * @brief The Tracer class records events of the RSTP into a ring buffer of fixed capacity,
+ *        which keeps the newest events. The buffer might be exported as Chrome Trace Event
+ *        JSON, which is opened by chrome://tracing and Perfetto UI: every port is shown as
+ *        process and every state machine, BPDUs, timers and hardware calls as its threads.
+ *        Events are recorded by the RSTP thread only, while tracing might be started, stopped
+ *        and exported from any thread. Disabled tracer costs single relaxed load per event.
+ */
+class Tracer {
+public:
+    explicit Tracer(ClockH clock) noexcept;
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Start discards recorded events and starts recording
+     * @param capacity number of the newest events kept by the buffer
+     * @param stateSpans exports states of machines as spans with duration, instead of instant
+     *        events of transitions
+     * @return Result::Success if tracing has started, Result::Fail if capacity is zero
+     */
+    Result Start(const u32 capacity, const bool stateSpans);
+    /// @brief Stop stops recording, but keeps recorded events for export
+    void Stop() noexcept;
+    bool Enabled() const noexcept;
+
+    void RecordStateChange(Machine& machine, State& oldState, State& newState);
+    void RecordReceive(const Port& port, const Bpdu& bpdu) noexcept;
+    void RecordTransmit(const Port& port, const Bpdu& bpdu) noexcept;
+    /// @brief Records timers which have reached zero since the previous value
+    void RecordTimerExpiries(const Port& port, const SmTimers& previous,
+                             const SmTimers& current) noexcept;
+    void RecordHardwareCall(const TraceHardwareCall call, const u16 portNo,
+                            const bool enable = false) noexcept;
+
+    /// @return Number of events recorded since start, including overwritten ones
+    u64 Recorded() const;
+    /// @brief Copies recorded events from the oldest one
+    std::vector<TraceRecord> Records() const;
+    /// @brief Writes recorded events in Chrome Trace Event format
+    void WriteChromeTrace(std::ostream& out) const;
+
+private:
+    /// @brief Has to be called under the mutex
+    std::vector<TraceRecord> CopyRecords() const;
+    void Append(const TraceRecord& record) noexcept;
+    void RecordBpdu(const TraceEvent event, const Port& port, const Bpdu& bpdu) noexcept;
+    void RecordTimerExpiry(const u16 portNo, const TraceTimer timer, const u32 previous,
+                           const u32 current) noexcept;
+    u64 NowNs() const noexcept;
+    /// @brief Has to be called under the mutex
+    template <typename Named>
+    u16 Intern(const void* key, Named& named);
+
+    ClockH _clock;
+    std::atomic<bool> _enabled;
+    mutable std::mutex _mtx;
+    std::vector<TraceRecord> _records;
+    std::size_t _capacity;
+    /// @brief Position of the oldest event if the buffer is full
+    std::size_t _next;
+    u64 _recorded;
+    bool _stateSpans;
+    std::unordered_map<const void*, u16> _nameIds;
+    std::vector<std::string> _names;
+};
+
+using TracerH = Sptr<Tracer>;
+
+inline bool Tracer::Enabled() const noexcept {
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+inline void Tracer::RecordReceive(const Port& port, const Bpdu& bpdu) noexcept {
+    if (Enabled()) {
+        RecordBpdu(TraceEvent::BpduRx, port, bpdu);
+    }
+}
+
+inline void Tracer::RecordTransmit(const Port& port, const Bpdu& bpdu) noexcept {
+    if (Enabled()) {
+        RecordBpdu(TraceEvent::BpduTx, port, bpdu);
+    }
+}
+
+inline void Tracer::RecordHardwareCall(const TraceHardwareCall call, const u16 portNo,
+                                       const bool enable) noexcept {
+    if (Enabled()) {
+        Append(TraceRecord{ NowNs(), portNo, TraceEvent::HardwareCall, static_cast<u8>(call),
+                            static_cast<u16>(enable), 0, 0 });
+    }
+}
+
+} // namespace Stp
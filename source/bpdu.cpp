@@ -17,21 +17,14 @@
 namespace Stp {
 
 Bpdu::Bpdu() noexcept
-    : _data{ }, _portRole { PortRole::Disabled }, _rootId{ } {
+    : _data{ }, _size{ Size::Max }, _portRole { PortRole::Disabled }, _rootId{ }, _bridgeId{ },
+      _portId{ } {
     _data.Fields.BpduType = +Type::Invalid;
 }
 
-Bpdu::Bpdu(const Bpdu& copyFrom) noexcept
-    : _size{ copyFrom._size } {
-    _data.Fields.BpduType = copyFrom._data.Fields.BpduType;
-    std::memcpy(reinterpret_cast<void*>(&_data),
-                reinterpret_cast<const void*>(&copyFrom._data), sizeof _data);
-}
-
 Result Bpdu::Encode(ByteStream& output) noexcept {
     BpduProtocolIdFieldHandler bpduDataProtocolId;
     BpduPathCostFieldHandler bpduDataPathCost;
-    BpduTimeFieldHandler bpduDataTime;
     u8 size;
 
     switch(static_cast<Type>(_data.Fields.BpduType)) {
@@ -49,35 +42,38 @@ Result Bpdu::Encode(ByteStream& output) noexcept {
         return Result::Fail;
     }
 
+    /// @note Decoded fields are not laid out as on the wire, so each field is written at its
+    /// own offset rather than copied from the memory of the data unit
+    output.assign(size, 0x00);
+
     ConvertEndianessProtocolIdToBpduData(_data.Fields.ProtocolIdentifier,
                                          bpduDataProtocolId);
     std::copy_n(bpduDataProtocolId.begin(), bpduDataProtocolId.size(),
-                &_data.encodedStream[+FieldOffset::ProtocolIdentifier]);
-
-    ConvertEndianessPathCostToBpduData(_data.Fields.RootPathCost, bpduDataPathCost);
-    std::copy_n(bpduDataPathCost.begin(), bpduDataPathCost.size(),
-                &_data.encodedStream[+FieldOffset::RootPathCost]);
+                &output[+FieldOffset::ProtocolIdentifier]);
+    output[+FieldOffset::ProtocolVersionIdentifier] = _data.Fields.ProtocolVersionIdentifier;
+    output[+FieldOffset::BpduType] = _data.Fields.BpduType;
 
-    ConvertEndianessTimeToBpduData(_data.Fields.MessageAge, bpduDataTime);
-    std::copy_n(bpduDataTime.begin(), bpduDataTime.size(),
-                &_data.encodedStream[+FieldOffset::MessageAge]);
+    if (static_cast<Type>(_data.Fields.BpduType) == Type::Tcn) {
+        return Result::Success;
+    }
 
-    ConvertEndianessTimeToBpduData(_data.Fields.MaxAge, bpduDataTime);
-    std::copy_n(bpduDataTime.begin(), bpduDataTime.size(),
-                &_data.encodedStream[+FieldOffset::MaxAge]);
+    output[+FieldOffset::Flags] = _data.Fields.Flags;
+    std::copy_n(_rootId.cbegin(), _rootId.size(), &output[+FieldOffset::RootIdentifier]);
 
-    ConvertEndianessTimeToBpduData(_data.Fields.HelloTime, bpduDataTime);
-    std::copy_n(bpduDataTime.begin(), bpduDataTime.size(),
-                &_data.encodedStream[+FieldOffset::HelloTime]);
+    ConvertEndianessPathCostToBpduData(_data.Fields.RootPathCost, bpduDataPathCost);
+    std::copy_n(bpduDataPathCost.begin(), bpduDataPathCost.size(),
+                &output[+FieldOffset::RootPathCost]);
 
-    ConvertEndianessTimeToBpduData(_data.Fields.ForwardDelay, bpduDataTime);
-    std::copy_n(bpduDataTime.begin(), bpduDataTime.size(),
-                &_data.encodedStream[+FieldOffset::ForwardDelay]);
+    std::copy_n(_bridgeId.cbegin(), _bridgeId.size(), &output[+FieldOffset::BridgeIdentifier]);
+    std::copy_n(_portId.cbegin(), _portId.size(), &output[+FieldOffset::PortIdentifier]);
 
-    output.resize(size);
-    std::copy_n(&_data.encodedStream[0], size, output.begin());
+    EncodeTime(_data.Fields.MessageAge, FieldOffset::MessageAge, output);
+    EncodeTime(_data.Fields.MaxAge, FieldOffset::MaxAge, output);
+    EncodeTime(_data.Fields.HelloTime, FieldOffset::HelloTime, output);
+    EncodeTime(_data.Fields.ForwardDelay, FieldOffset::ForwardDelay, output);
 
     if (static_cast<Type>(_data.Fields.BpduType) == Type::Rst) {
+        output[+FieldOffset::Version1Length] = _data.Fields.Version1Length;
         /// @todo Refactor it!
         output.push_back(0x00); output.push_back(0x00); output.push_back(0x00);
     }
@@ -86,45 +82,84 @@ Result Bpdu::Encode(ByteStream& output) noexcept {
 }
 
 Result Bpdu::Decode(const ByteStream& input) noexcept {
-    ByteStream::size_type streamSize = input.size();
+    const ByteStream::size_type streamSize = input.size();
+
+    if (not IsValidSize(streamSize)) {
+        _data.Fields.BpduType = +Type::Invalid;
+        return Result::Fail;
+    }
 
     _data.Fields.ProtocolIdentifier = ConvertEndianessBpduDataToProtocolId({{
                                                                                 input[+FieldOffset::ProtocolIdentifier],
                                                                                 input[+FieldOffset::ProtocolIdentifier + 1]
                                                                             }});
 
-    if (not IsValidSize(streamSize)
-            || not IsValidProtocolId(_data.Fields.ProtocolIdentifier)
+    if (not IsValidProtocolId(_data.Fields.ProtocolIdentifier)
             || not IsValidBpduType(input[+FieldOffset::BpduType])) {
         _data.Fields.BpduType = +Type::Invalid;
         return Result::Fail;
     }
 
     _size = static_cast<enum Size>(streamSize);
-    std::copy_n(input.begin(), streamSize, &_data.encodedStream[0]);
-
-    _data.Fields.MessageAge = ConvertEndianessBpduDataToTime({{
-                                                                  _data.encodedStream[+FieldOffset::MessageAge],
-                                                                  _data.encodedStream[+FieldOffset::MessageAge + 1]
-                                                              }});
-
-    _data.Fields.MaxAge = ConvertEndianessBpduDataToTime({{
-                                                              _data.encodedStream[+FieldOffset::MaxAge],
-                                                              _data.encodedStream[+FieldOffset::MaxAge + 1]
-                                                          }});
-
-    // Checking if the received BPDU is not received by port which it transmitted, is outside
-    if ((not (Type::Config == _data.Fields.BpduType && Size::Config <= _size
-              && _data.Fields.MessageAge < _data.Fields.MaxAge))
-            && (not (Type::Tcn == _data.Fields.BpduType && Size::Tcn == _size))
-            && (not (Type::Rst == _data.Fields.BpduType && Size::Rst <= _size))) {
+    _data.Fields.ProtocolVersionIdentifier = input[+FieldOffset::ProtocolVersionIdentifier];
+    _data.Fields.BpduType = input[+FieldOffset::BpduType];
+
+    /// @note 9.3.4 Validation of received BPDUs
+    if (Type::Tcn == _data.Fields.BpduType) {
+        _data.Fields.Flags = 0;
+        _portRole = PortRole::Unknown;
+
+        return Result::Success;
+    }
+
+    if ((Type::Config == _data.Fields.BpduType && _size < Size::Config)
+            || (Type::Rst == _data.Fields.BpduType && _size < Size::Rst)) {
         _data.Fields.BpduType = +Type::Invalid;
         return Result::Fail;
     }
 
+    _data.Fields.Flags = input[+FieldOffset::Flags];
+    _data.Fields.MessageAge = DecodeTime(input, FieldOffset::MessageAge);
+    _data.Fields.MaxAge = DecodeTime(input, FieldOffset::MaxAge);
+
+    if (Type::Config == _data.Fields.BpduType
+            && not (_data.Fields.MessageAge < _data.Fields.MaxAge)) {
+        _data.Fields.BpduType = +Type::Invalid;
+        return Result::Fail;
+    }
+
+    std::copy_n(&input[+FieldOffset::RootIdentifier], +FieldSize::RootIdentifier,
+                _rootId.begin());
+
+    _data.Fields.RootPathCost =
+            ConvertEndianessBpduDataToPathCost({{
+                                                    input[+FieldOffset::RootPathCost],
+                                                    input[+FieldOffset::RootPathCost + 1],
+                                                    input[+FieldOffset::RootPathCost + 2],
+                                                    input[+FieldOffset::RootPathCost + 3]
+                                                }});
+
+    std::copy_n(&input[+FieldOffset::BridgeIdentifier], +FieldSize::BridgeIdentifier,
+                _bridgeId.begin());
+    std::copy_n(&input[+FieldOffset::PortIdentifier], +FieldSize::PortIdentifier,
+                _portId.begin());
+
+    _data.Fields.HelloTime = DecodeTime(input, FieldOffset::HelloTime);
+    _data.Fields.ForwardDelay = DecodeTime(input, FieldOffset::ForwardDelay);
+
+    if (Type::Config == _data.Fields.BpduType) {
+        /// @note A Configuration BPDU explicitly conveys a Designated Port Role
+        _data.Fields.Version1Length = 0;
+        _portRole = PortRole::Designated;
+
+        return Result::Success;
+    }
+
+    _data.Fields.Version1Length = input[+FieldOffset::Version1Length];
+
     const EncodedPortRole encodedPortRole =
             static_cast<EncodedPortRole>(
-                (_data.Fields.Flags >> static_cast<u8>(OffsetFlag::PortRole)) & 0x03
+                (_data.Fields.Flags >> static_cast<u8>(OffsetFlag::PortRole)) & +FlagMask::PortRole
                 );
 
     switch (encodedPortRole) {
@@ -138,39 +173,12 @@ Result Bpdu::Decode(const ByteStream& input) noexcept {
         _portRole = PortRole::Root;
         break;
     default:
-        /// @todo Check if this state is fine for state machine
-        _portRole = PortRole::Unknown;
         /// @note If the Unknown value of the Port Role parameter is received, the state
         /// machines will effectively treat the RST BPDU as if it were a Configuration BPDU.
+        _portRole = PortRole::Designated;
         _data.Fields.BpduType = +Type::Config;
     }
 
-    std::copy_n(&_data.encodedStream[+FieldOffset::RootIdentifier],
-            +FieldSize::RootIdentifier, _rootId.begin());
-
-    _data.Fields.RootPathCost =
-            ConvertEndianessBpduDataToPathCost({{
-                                                    _data.encodedStream[+FieldOffset::RootPathCost],
-                                                    _data.encodedStream[+FieldOffset::RootPathCost + 1],
-                                                    _data.encodedStream[+FieldOffset::RootPathCost + 2],
-                                                    _data.encodedStream[+FieldOffset::RootPathCost + 3]
-                                                }});
-
-    std::copy_n(&_data.encodedStream[+FieldOffset::BridgeIdentifier],
-            +FieldSize::BridgeIdentifier, _bridgeId.begin());
-
-    _data.Fields.HelloTime =
-            ConvertEndianessBpduDataToTime({{
-                                                _data.encodedStream[+FieldOffset::HelloTime],
-                                                _data.encodedStream[+FieldOffset::HelloTime + 1]
-                                            }});
-
-    _data.Fields.ForwardDelay =
-            ConvertEndianessBpduDataToTime({{
-                                                _data.encodedStream[+FieldOffset::ForwardDelay],
-                                                _data.encodedStream[+FieldOffset::ForwardDelay + 1]
-                                            }});
-
     return Result::Success;
 }
 
@@ -192,22 +200,31 @@ void Bpdu::SetPortRoleFlag(const PortRole value) noexcept {
         portRoleToEncode = EncodedPortRole::Unknown;
     }
 
+    _portRole = value;
+    _data.Fields.Flags &= ~(+FlagMask::PortRole << static_cast<u8>(OffsetFlag::PortRole));
     _data.Fields.Flags |= (static_cast<u8>(portRoleToEncode) << static_cast<u8>(OffsetFlag::PortRole));
 }
 
 void Bpdu::SetRootIdentifier(const Bpdu::BridgeIdHandler& value) noexcept {
-    std::copy_n(value.cbegin(), +FieldSize::BridgeIdentifier,
-                &_data.encodedStream[+FieldOffset::RootIdentifier]);
+    _rootId = value;
 }
 
 void Bpdu::SetBridgeIdentifier(const Bpdu::BridgeIdHandler& value) noexcept {
-    std::copy_n(value.cbegin(), +FieldSize::BridgeIdentifier,
-                &_data.encodedStream[+FieldOffset::BridgeIdentifier]);
+    _bridgeId = value;
 }
 
 void Bpdu::SetPortIdentifier(const Bpdu::PortIdHandler& value) noexcept {
-    std::copy_n(value.cbegin(), +FieldSize::PortIdentifier,
-                &_data.encodedStream[+FieldOffset::PortIdentifier]);
+    _portId = value;
+}
+
+u16 Bpdu::DecodeTime(const ByteStream& input, const FieldOffset offset) noexcept {
+    return ConvertEndianessBpduDataToTime({{ input[+offset], input[+offset + 1] }});
+}
+
+void Bpdu::EncodeTime(const u16 time, const FieldOffset offset, ByteStream& output) noexcept {
+    BpduTimeFieldHandler bpduDataTime;
+    ConvertEndianessTimeToBpduData(time, bpduDataTime);
+    std::copy_n(bpduDataTime.begin(), bpduDataTime.size(), &output[+offset]);
 }
 
 u16 Bpdu::ConvertEndianessBpduDataToProtocolId(const Bpdu::BpduProtocolIdFieldHandler& bpduData) noexcept {
@@ -244,15 +261,16 @@ void Bpdu::ConvertEndianessPathCostToBpduData(const u32 pathCost,
 }
 
 u16 Bpdu::ConvertEndianessBpduDataToTime(const BpduTimeFieldHandler& bpduData) noexcept {
-    u16 value = bpduData[0];
-    value += bpduData[1] * +ShiftOctet::CpuLeastSignificant2nd;
+    // Whole seconds go first, followed by 1/256 fractions of second (9.2.8)
+    u16 value = static_cast<u16>(bpduData[0] * +ShiftOctet::CpuLeastSignificant2nd);
+    value += bpduData[1];
 
     return value;
 }
 
 void Bpdu::ConvertEndianessTimeToBpduData(const u16 time, BpduTimeFieldHandler& bpduData) noexcept {
-    bpduData[0] = static_cast<u8>(time);
-    bpduData[1] = static_cast<u8>(time / +ShiftOctet::CpuLeastSignificant2nd);
+    bpduData[0] = static_cast<u8>(time / +ShiftOctet::CpuLeastSignificant2nd);
+    bpduData[1] = static_cast<u8>(time);
 }
 
 bool Bpdu::IsValidBpduType(const u8 type) noexcept {
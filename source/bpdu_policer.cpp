@@ -0,0 +1,191 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/bpdu_policer.hpp"
+
+// C++ Standard Library
+#include <algorithm>
+
+namespace Stp {
+
+constexpr u32 BpduPolicer::_kPageSize;
+constexpr u32 BpduPolicer::_kPageCount;
+
+namespace {
+
+constexpr s64 kNsPerSecond = 1000000000;
+
+} // namespace
+
+Result BpduPolicerConfig::Validate() const noexcept {
+    if (0 == Rate) {
+        return (0 == ErrDisableRate) ? Result::Success : Result::Fail;
+    }
+
+    if ((0 == Burst) || (Rate > kNsPerSecond)) {
+        return Result::Fail;
+    }
+
+    return ((0 == ErrDisableRate) || ((ErrDisableRate > Rate) && (ErrDisableRate <= kNsPerSecond)))
+            ? Result::Success : Result::Fail;
+}
+
+BpduPolicer::BpduPolicer() noexcept
+    : _limits{ }, _mtxLimits{ } {
+    for (auto& page : _pages) {
+        page.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+BpduPolicer::~BpduPolicer() {
+    for (auto& page : _pages) {
+        delete[] page.load(std::memory_order_relaxed);
+    }
+}
+
+Result BpduPolicer::Configure(const BpduPolicerConfig& config) {
+    if (Failed(config.Validate())) {
+        return Result::Fail;
+    }
+
+    Limits limits{};
+    limits.Config = config;
+    if (config.Rate) {
+        limits.PassedIntervalNs = kNsPerSecond / config.Rate;
+        limits.PassedToleranceNs = limits.PassedIntervalNs * (config.Burst - 1);
+    }
+
+    if (config.ErrDisableRate) {
+        limits.OfferedIntervalNs = kNsPerSecond / config.ErrDisableRate;
+        limits.OfferedToleranceNs = limits.OfferedIntervalNs * (config.Burst - 1);
+    }
+
+    std::lock_guard<std::mutex> limitsGuard{ _mtxLimits };
+    _limits.Store(limits);
+
+    return Result::Success;
+}
+
+BpduPolicerConfig BpduPolicer::Config() const noexcept {
+    return _limits.Load().Config;
+}
+
+void BpduPolicer::AddPort(const u16 portNo) {
+    std::atomic<Bucket*>& page = _pages[portNo / _kPageSize];
+    Bucket* buckets = page.load(std::memory_order_acquire);
+    if (buckets) {
+        return;
+    }
+
+    Bucket* const allocated = new Bucket[_kPageSize];
+    for (u32 idx = 0; idx < _kPageSize; ++idx) {
+        allocated[idx].PassedTat.store(0, std::memory_order_relaxed);
+        allocated[idx].OfferedTat.store(0, std::memory_order_relaxed);
+        allocated[idx].Dropped.store(0, std::memory_order_relaxed);
+        allocated[idx].ErrDisabled.store(false, std::memory_order_relaxed);
+        for (auto& dropped : allocated[idx].DecodeDropped) {
+            dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Another thread might have allocated the page meanwhile
+    if (not page.compare_exchange_strong(buckets, allocated, std::memory_order_acq_rel)) {
+        delete[] allocated;
+    }
+}
+
+BpduPolicer::Verdict BpduPolicer::Police(const u16 portNo, const Clock::Duration time) noexcept {
+    const Limits limits = _limits.Load();
+    if (0 == limits.PassedIntervalNs) {
+        return Verdict::Pass;
+    }
+
+    Bucket* const found = FindBucket(portNo);
+    if (not found) {
+        return Verdict::Pass;
+    }
+
+    Bucket& bucket = *found;
+    const s64 nowNs = time.count();
+    Verdict verdict = Verdict::Pass;
+    if (bucket.ErrDisabled.load(std::memory_order_relaxed)) {
+        verdict = Verdict::Drop;
+    }
+    else if (limits.OfferedIntervalNs
+             && not Conform(bucket.OfferedTat, nowNs, limits.OfferedIntervalNs,
+                            limits.OfferedToleranceNs)) {
+        // The port is disabled by the RSTP later, so others have to drop its BPDUs meanwhile
+        verdict = bucket.ErrDisabled.exchange(true, std::memory_order_relaxed)
+                ? Verdict::Drop : Verdict::ErrDisable;
+    }
+    else if (not Conform(bucket.PassedTat, nowNs, limits.PassedIntervalNs,
+                         limits.PassedToleranceNs)) {
+        verdict = Verdict::Drop;
+    }
+
+    if (Verdict::Pass != verdict) {
+        bucket.Dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return verdict;
+}
+
+u64 BpduPolicer::Dropped(const u16 portNo) const noexcept {
+    const Bucket* const bucket = FindBucket(portNo);
+    return bucket ? bucket->Dropped.load(std::memory_order_relaxed) : 0;
+}
+
+bool BpduPolicer::ErrDisabled(const u16 portNo) const noexcept {
+    const Bucket* const bucket = FindBucket(portNo);
+    return bucket && bucket->ErrDisabled.load(std::memory_order_relaxed);
+}
+
+void BpduPolicer::ClearErrDisabled(const u16 portNo) noexcept {
+    Bucket* const bucket = FindBucket(portNo);
+    if (bucket) {
+        // The port starts with full buckets, as if it has been silent
+        bucket->OfferedTat.store(0, std::memory_order_relaxed);
+        bucket->PassedTat.store(0, std::memory_order_relaxed);
+        bucket->ErrDisabled.store(false, std::memory_order_relaxed);
+    }
+}
+
+void BpduPolicer::CountDecodeDrop(const u16 portNo, const BpduDropReason reason) noexcept {
+    Bucket* const bucket = FindBucket(portNo);
+    if (bucket) {
+        bucket->DecodeDropped[static_cast<u8>(reason)].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+u64 BpduPolicer::DecodeDropped(const u16 portNo, const BpduDropReason reason) const noexcept {
+    const Bucket* const bucket = FindBucket(portNo);
+    return bucket ? bucket->DecodeDropped[static_cast<u8>(reason)].load(std::memory_order_relaxed)
+                  : 0;
+}
+
+bool BpduPolicer::Conform(std::atomic<s64>& tat, const s64 nowNs, const s64 intervalNs,
+                          const s64 toleranceNs) noexcept {
+    s64 current = tat.load(std::memory_order_relaxed);
+    while (true) {
+        const s64 arrival = std::max(current, nowNs);
+        if (arrival - nowNs > toleranceNs) {
+            return false;
+        }
+
+        if (tat.compare_exchange_weak(current, arrival + intervalNs,
+                                      std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+BpduPolicer::Bucket* BpduPolicer::FindBucket(const u16 portNo) const noexcept {
+    Bucket* const buckets = _pages[portNo / _kPageSize].load(std::memory_order_acquire);
+    return buckets ? &buckets[portNo % _kPageSize] : nullptr;
+}
+
+} // namespace Stp
@@ -8,6 +8,7 @@
 #include "stp/bridge.hpp"
 
 // C++ Standard Library
+#include <algorithm>
 #include <utility>
 
 namespace Stp {
@@ -17,8 +18,15 @@ Bridge::Bridge(SystemH system) noexcept
       _bridgePriority{ },
       _bridgeTimes{ }, _rootPortId{ },
       _rootPriority{ },
-      _rootTimes{ }, _addr{ },
+      _rootTimes{ }, _forceProtocolVersion{ BridgeConfig::ProtocolVersion::Rstp },
+      _txHoldCount{ Port::RecommendedValue::TransmitHoldCount },
+      _ageingTime{ Time::FromSeconds(BridgeConfig::DefaultAgeingTime) },
+      _tickIntervalMs{ Time::DefaultTickIntervalMs }, _roleSelectionDeferred{ false },
+      _treeChanged{ false },
+      _addr{ },
       _system{ system },
+      _latencyTracker{ std::make_shared<LatencyTracker>(system->Clock) },
+      _tracer{ std::make_shared<Tracer>(system->Clock) },
       _systemLoggingManager { system->Logger } {
     _bridgeId.SetPriority(+PriorityVector::RecommendedBridgePriority::Value);
     _bridgeId.SetExtension(Bridge::ExtensionDefaultValue);
@@ -29,28 +37,56 @@ Bridge::Bridge(SystemH system) noexcept
 }
 
 void Bridge::AddPort(const u16 portNo) {
-    if (_ports.find(portNo) != _ports.end()) {
+    if (GetPort(portNo)) {
         return;
     }
 
-    _ports.emplace(std::make_pair(portNo, std::make_shared<Port>()));
+    AddPort(portNo, std::make_shared<Port>());
+}
+
+void Bridge::AddPort(const u16 portNo, PortH port) {
+    const auto position = FindPosition(portNo);
+    if ((_ports.end() != position) && (portNo == position->first)) {
+        return;
+    }
+
+    _ports.emplace(position, portNo, std::move(port));
 }
 
 void Bridge::RemovePort(const u16 portNo) {
-    _ports.erase(portNo);
+    const auto position = FindPosition(portNo);
+    if ((_ports.end() != position) && (portNo == position->first)) {
+        _ports.erase(position);
+    }
 }
 
-PortH Bridge::GetPort(const u16 portNo) {
-    auto findIt { _ports.find(portNo) };
-    if (_ports.end() == findIt) {
+PortH Bridge::GetPort(const u16 portNo) const {
+    const auto position = FindPosition(portNo);
+    if ((_ports.end() == position) || (portNo != position->first)) {
         return PortH{};
     }
 
-    return findIt->second;
+    return position->second;
 }
 
-std::map<u16, PortH>& Bridge::GetAllPorts() {
+const Bridge::PortList& Bridge::AllPorts() const noexcept {
     return _ports;
 }
 
+Bridge::PortList& Bridge::GetAllPorts() {
+    return _ports;
+}
+
+Bridge::PortList::const_iterator Bridge::FindPosition(const u16 portNo) const noexcept {
+    // Ports are mostly added in order of their numbers, so the last one is checked first
+    if (_ports.empty() || (_ports.back().first < portNo)) {
+        return _ports.cend();
+    }
+
+    return std::lower_bound(_ports.cbegin(), _ports.cend(), portNo,
+                            [](const PortList::value_type& port, const u16 number) {
+        return port.first < number;
+    });
+}
+
 } // namespace Rstp
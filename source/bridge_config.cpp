@@ -0,0 +1,81 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/bridge_config.hpp"
+
+namespace Stp {
+
+constexpr u32 BridgeConfig::DefaultAgeingTime;
+
+namespace {
+
+constexpr bool InRange(const u32 value, const u32 min, const u32 max) noexcept {
+    return (value >= min) && (value <= max);
+}
+
+} // namespace
+
+Result BridgeConfig::Validate() const noexcept {
+    if ((Priority % +PriorityVector::RecommendedBridgePriority::Step) != 0) {
+        return Result::Fail;
+    }
+
+    if (Priority > 15 * +PriorityVector::RecommendedBridgePriority::Step) {
+        return Result::Fail;
+    }
+
+    // Table 17-1
+    if (not (InRange(HelloTime, 1, 2) && InRange(MaxAge, 6, 40) && InRange(ForwardDelay, 4, 30)
+             && InRange(TxHoldCount, 1, 10))) {
+        return Result::Fail;
+    }
+
+    // 17.14
+    if ((2 * (ForwardDelay - 1) < MaxAge) || (MaxAge < 2 * (HelloTime + 1))) {
+        return Result::Fail;
+    }
+
+    if ((ProtocolVersion::Stp != ForceProtocolVersion)
+            && (ProtocolVersion::Rstp != ForceProtocolVersion)) {
+        return Result::Fail;
+    }
+
+    // Table 7-5
+    if (not InRange(AgeingTime, 10, 1000000)) {
+        return Result::Fail;
+    }
+
+    return Result::Success;
+}
+
+namespace PortConfig {
+
+Result ValidatePriority(const u32 priority) noexcept {
+    if ((priority % +PriorityVector::RecommendedPortPriority::Step) != 0) {
+        return Result::Fail;
+    }
+
+    return priority <= 15u * +PriorityVector::RecommendedPortPriority::Step ? Result::Success
+                                                                            : Result::Fail;
+}
+
+Result ValidatePathCost(const u32 pathCost) noexcept {
+    return InRange(pathCost, 1, 200000000) ? Result::Success : Result::Fail;
+}
+
+Result ValidateFastHelloTime(const u32 helloTimeMs) noexcept {
+    if (0 == helloTimeMs) {
+        return Result::Success;
+    }
+
+    return InRange(helloTimeMs, Time::MinFastHelloTimeMs, Time::MaxFastHelloTimeMs)
+            ? Result::Success : Result::Fail;
+}
+
+} // namespace PortConfig
+
+} // namespace Stp
@@ -32,11 +32,11 @@ void BeginState::Execute(Machine& machine) {
         return;
     }
 
-    if (GoToEdge(machine)) {
+    if (Guard(machine, GoToEdge(machine))) {
         EdgeAction(machine);
         ChangeState(machine, EdgeState::Instance());
     }
-    else {
+    else if (Guard(machine, not SmConditions::AdminEdge(machine.PortInstance()))) {
         NotEdgeAction(machine);
         ChangeState(machine, NotEdgeState::Instance());
     }
@@ -58,7 +58,7 @@ State& EdgeState::Instance() {
 void EdgeState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToNotEdge(machine)) {
+    if (Guard(machine, GoToNotEdge(machine))) {
         NotEdgeAction(machine);
         ChangeState(machine, NotEdgeState::Instance());
     }
@@ -86,7 +86,7 @@ State& NotEdgeState::Instance() {
 void NotEdgeState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToEdge(machine)) {
+    if (Guard(machine, GoToEdge(machine))) {
         EdgeAction(machine);
         ChangeState(machine, EdgeState::Instance());
     }
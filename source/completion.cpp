@@ -0,0 +1,50 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/completion.hpp"
+
+namespace Stp {
+
+CompletionGroup::CompletionGroup() noexcept
+    : _pending{ 0 }, _failed{ 0 } {
+    // Nothing more to do
+}
+
+void CompletionGroup::Expect() noexcept {
+    _pending.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CompletionGroup::Complete(const Result result) {
+    // The waiter might destroy the group as soon as it sees no pending commands, so they are
+    // counted down under the mutex and the group is not touched once it has been released
+    std::lock_guard<std::mutex> doneGuard{ _mtx };
+    if (Stp::Failed(result)) {
+        _failed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (1 == _pending.fetch_sub(1, std::memory_order_acq_rel)) {
+        _done.notify_all();
+    }
+}
+
+Result CompletionGroup::Wait() {
+    std::unique_lock<std::mutex> doneGuard{ _mtx };
+    _done.wait(doneGuard, [this]() { return 0 == Pending(); });
+
+    return 0 == Failed() ? Result::Success : Result::Fail;
+}
+
+Result CompletionGroup::WaitFor(const std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> doneGuard{ _mtx };
+    if (not _done.wait_for(doneGuard, timeout, [this]() { return 0 == Pending(); })) {
+        return Result::Fail;
+    }
+
+    return 0 == Failed() ? Result::Success : Result::Fail;
+}
+
+} // namespace Stp
@@ -0,0 +1,1302 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/engine.hpp"
+// Dependencies
+#include "stp/sm_conditions.hpp"
+#include "stp/sm_procedures.hpp"
+#include "stp/sm/port_timers.hpp"
+#include "stp/sm/port_receive.hpp"
+#include "stp/sm/port_protocol_migration.hpp"
+#include "stp/sm/bridge_detection.hpp"
+#include "stp/sm/port_transmit.hpp"
+#include "stp/sm/port_information.hpp"
+#include "stp/sm/port_role_selection.hpp"
+#include "stp/sm/port_role_transitions.hpp"
+#include "stp/sm/port_state_transition.hpp"
+#include "stp/sm/topology_change.hpp"
+
+// C++ Standard Library
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace Stp {
+
+namespace {
+
+/// @brief Machines keep raw pointer to the port, so they get it without sharing ownership
+PortH Unowned(Port& port) noexcept {
+    return PortH{ PortH{ }, &port };
+}
+
+/// @brief Writes state of the port to its snapshot, except of its number
+void SavePortSnapshot(const Port& port, PortSnapshot& portSnapshot) noexcept {
+    portSnapshot.Role = port.Role();
+    portSnapshot.InfoIs = port.InfoIs();
+    portSnapshot.Enabled = port.PortEnabled();
+    portSnapshot.Learning = port.Learning();
+    portSnapshot.Forwarding = port.Forwarding();
+    portSnapshot.OperEdge = port.OperEdge();
+    portSnapshot.SendRstp = port.SendRstp();
+    portSnapshot.AdminEdge = port.AdminEdge();
+    portSnapshot.AutoEdge = port.AutoEdge();
+    portSnapshot.PointToPoint = port.OperPointToPointMAC();
+    portSnapshot.FastHelloTime = port.FastHelloTime();
+    portSnapshot.PortIdentifier = port.PortId();
+    portSnapshot.PathCost = port.PortPathCost().Value();
+    portSnapshot.PortPriority = port.PortPriority();
+    portSnapshot.DesignatedPriority = port.DesignatedPriority();
+    portSnapshot.PortTimes = port.PortTimes();
+    portSnapshot.Timers = port.GetSmTimersInstance();
+}
+
+/**
+ * @brief KnownStates lists states of the machine in order of their identifiers kept by the
+ *        state image. New states have to be appended, so images written by previous releases
+ *        remain readable.
+ */
+const std::vector<State*>& KnownStates(const u8 machineType) {
+    static const std::vector<State*> states[MachineTypeCount] = {
+        {
+            &PortTimers::BeginState::Instance(),
+            &PortTimers::OneSecondState::Instance(),
+            &PortTimers::TickState::Instance()
+        },
+        {
+            &PortReceive::BeginState::Instance(),
+            &PortReceive::DiscardState::Instance(),
+            &PortReceive::ReceiveState::Instance()
+        },
+        {
+            &PortProtocolMigration::BeginState::Instance(),
+            &PortProtocolMigration::CheckingRstpState::Instance(),
+            &PortProtocolMigration::SensingState::Instance(),
+            &PortProtocolMigration::SelectingStpState::Instance()
+        },
+        {
+            &BridgeDetection::BeginState::Instance(),
+            &BridgeDetection::EdgeState::Instance(),
+            &BridgeDetection::NotEdgeState::Instance()
+        },
+        {
+            &PortTransmit::BeginState::Instance(),
+            &PortTransmit::TransmitInitState::Instance(),
+            &PortTransmit::TransmitPeriodicState::Instance(),
+            &PortTransmit::TransmitConfigState::Instance(),
+            &PortTransmit::TransmitTcnState::Instance(),
+            &PortTransmit::TransmitRstpState::Instance(),
+            &PortTransmit::IdleState::Instance()
+        },
+        {
+            &PortInformation::BeginState::Instance(),
+            &PortInformation::DisabledState::Instance(),
+            &PortInformation::AgedState::Instance(),
+            &PortInformation::UpdateState::Instance(),
+            &PortInformation::SuperiorDesignatedState::Instance(),
+            &PortInformation::RepeatedDesignatedState::Instance(),
+            &PortInformation::InferiorDesignatedState::Instance(),
+            &PortInformation::NotDesignatedState::Instance(),
+            &PortInformation::OtherState::Instance(),
+            &PortInformation::CurrentState::Instance(),
+            &PortInformation::ReceiveState::Instance()
+        },
+        {
+            &PortRoleSelection::BeginState::Instance(),
+            &PortRoleSelection::InitBridgeState::Instance(),
+            &PortRoleSelection::RoleSelectionState::Instance()
+        },
+        {
+            &PortRoleTransitions::BeginState::Instance(),
+            &PortRoleTransitions::InitPortState::Instance(),
+            &PortRoleTransitions::DisablePortState::Instance(),
+            &PortRoleTransitions::DisabledPortState::Instance(),
+            &PortRoleTransitions::RootProposedState::Instance(),
+            &PortRoleTransitions::RootAgreedState::Instance(),
+            &PortRoleTransitions::ReRootState::Instance(),
+            &PortRoleTransitions::RootForwardState::Instance(),
+            &PortRoleTransitions::RootLearnState::Instance(),
+            &PortRoleTransitions::ReRootedState::Instance(),
+            &PortRoleTransitions::RootPortState::Instance(),
+            &PortRoleTransitions::DesignatedProposeState::Instance(),
+            &PortRoleTransitions::DesignatedSyncedState::Instance(),
+            &PortRoleTransitions::DesignatedRetiredState::Instance(),
+            &PortRoleTransitions::DesignatedForwardState::Instance(),
+            &PortRoleTransitions::DesignatedLearnState::Instance(),
+            &PortRoleTransitions::DesignatedDiscardState::Instance(),
+            &PortRoleTransitions::DesignatedPortState::Instance(),
+            &PortRoleTransitions::AlternateProposedState::Instance(),
+            &PortRoleTransitions::AlternateAgreedState::Instance(),
+            &PortRoleTransitions::BlockPortState::Instance(),
+            &PortRoleTransitions::BackupPortState::Instance(),
+            &PortRoleTransitions::AlternatePortState::Instance()
+        },
+        {
+            &PortStateTransition::BeginState::Instance(),
+            &PortStateTransition::DiscardingState::Instance(),
+            &PortStateTransition::LearningState::Instance(),
+            &PortStateTransition::ForwardingState::Instance()
+        },
+        {
+            &TopologyChange::BeginState::Instance(),
+            &TopologyChange::InactiveState::Instance(),
+            &TopologyChange::LearningState::Instance(),
+            &TopologyChange::DetectedState::Instance(),
+            &TopologyChange::NotifiedTcnState::Instance(),
+            &TopologyChange::NotifiedTcState::Instance(),
+            &TopologyChange::PropagatingState::Instance(),
+            &TopologyChange::AcknowledgedState::Instance(),
+            &TopologyChange::ActiveState::Instance()
+        }
+    };
+
+    return states[machineType];
+}
+
+} // namespace
+
+/**
+ * @brief The StateMachine::Slab struct keeps everything what belongs to the single port.
+ *        Machines are declared in order of their execution.
+ */
+struct StateMachine::Slab {
+    explicit Slab(BridgeH bridge);
+    /// @return Machines indexed by MachineType
+    std::array<Machine*, MachineTypeCount> Machines() noexcept;
+
+    Port PortData;
+    SeqLock<PortStats> Snapshot;
+    /// @brief Version of the publication which has last changed the port
+    u64 ChangedVersion;
+#ifdef STP_ENGINE_STATS
+    PortMachineCounters Counters;
+#endif
+    PortTimers::PtiMachine Pti;
+    PortReceive::PrxMachine Prx;
+    PortProtocolMigration::PpmMachine Ppm;
+    BridgeDetection::BdmMachine Bdm;
+    PortTransmit::PtxMachine Ptx;
+    PortInformation::PimMachine Pim;
+    PortRoleSelection::PrsMachine Prs;
+    PortRoleTransitions::PrtMachine Prt;
+    PortStateTransition::PstMachine Pst;
+    TopologyChange::TcmMachine Tcm;
+};
+
+StateMachine::Slab::Slab(BridgeH bridge)
+    : PortData{ }, Snapshot{ }, ChangedVersion{ 0 },
+#ifdef STP_ENGINE_STATS
+      Counters{ },
+#endif
+      Pti{ bridge, Unowned(PortData) },
+      Prx{ bridge, Unowned(PortData) }, Ppm{ bridge, Unowned(PortData) },
+      Bdm{ bridge, Unowned(PortData) }, Ptx{ bridge, Unowned(PortData) },
+      Pim{ bridge, Unowned(PortData) }, Prs{ bridge, Unowned(PortData) },
+      Prt{ bridge, Unowned(PortData) }, Pst{ bridge, Unowned(PortData) },
+      Tcm{ bridge, Unowned(PortData) } {
+    // Nothing more to do
+}
+
+std::array<Machine*, MachineTypeCount> StateMachine::Slab::Machines() noexcept {
+    return { { &Pti, &Prx, &Ppm, &Bdm, &Ptx, &Pim, &Prs, &Prt, &Pst, &Tcm } };
+}
+
+StateMachine::StateMachine(BridgeH bridge)
+    : _slab{ std::make_shared<Slab>(bridge) } {
+#ifdef STP_ENGINE_STATS
+    const auto machines = _slab->Machines();
+    for (u8 idx = 0; idx < MachineTypeCount; ++idx) {
+        machines[idx]->AttachCounters(&_slab->Counters[idx]);
+    }
+#endif
+}
+
+void StateMachine::SkipInitBridge() noexcept {
+    _slab->Prs.SkipInitBridge();
+}
+
+bool StateMachine::TickEvent() {
+    Slab& slab = *_slab;
+    bool changed = slab.Pti.Run();
+    changed |= slab.Prx.Run();
+    changed |= slab.Ppm.Run();
+    changed |= slab.Bdm.Run();
+    changed |= slab.Ptx.Run();
+    changed |= slab.Pim.Run();
+    changed |= slab.Prs.Run();
+    changed |= slab.Prt.Run();
+    changed |= slab.Pst.Run();
+    changed |= slab.Tcm.Run();
+
+    return changed;
+}
+
+void StateMachine::ChangeOperEdge(const bool operEdge) noexcept {
+    _slab->PortData.SetOperEdge(operEdge);
+    _slab->Bdm.RestoreState(operEdge ? BridgeDetection::EdgeState::Instance()
+                                     : BridgeDetection::NotEdgeState::Instance());
+}
+
+void StateMachine::SaveState(StateImage::PortRecord& record) const noexcept {
+    StateImage::SavePort(_slab->PortData, record);
+    const auto machines = _slab->Machines();
+    for (u8 idx = 0; idx < MachineTypeCount; ++idx) {
+        const std::vector<State*>& states = KnownStates(idx);
+        const auto found = std::find(states.cbegin(), states.cend(),
+                                     &machines[idx]->CurrentState());
+        record.States[idx] = static_cast<u8>(std::distance(states.cbegin(), found));
+    }
+}
+
+bool StateMachine::KnowsStates(const StateImage::PortRecord& record) noexcept {
+    for (u8 idx = 0; idx < MachineTypeCount; ++idx) {
+        if (record.States[idx] >= KnownStates(idx).size()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void StateMachine::RestoreState(const StateImage::PortRecord& record,
+                                const u32 elapsedMs) noexcept {
+    StateImage::RestorePort(record, elapsedMs, _slab->PortData);
+    const auto machines = _slab->Machines();
+    for (u8 idx = 0; idx < MachineTypeCount; ++idx) {
+        machines[idx]->RestoreState(*KnownStates(idx)[record.States[idx]]);
+    }
+}
+
+PortH StateMachine::PortInstance() const noexcept {
+    return PortH{ _slab, &_slab->PortData };
+}
+
+Port& StateMachine::GetPortData() noexcept {
+    return _slab->PortData;
+}
+
+bool StateMachine::MarkChanged(const u64 version) noexcept {
+    if (version == _slab->ChangedVersion) {
+        return false;
+    }
+
+    _slab->ChangedVersion = version;
+
+    return true;
+}
+
+u16 StateMachine::PortNo() const noexcept {
+    return _slab->PortData.PortId().PortNum();
+}
+
+const SeqLock<PortStats>& StateMachine::StatsSnapshot() const noexcept {
+    return _slab->Snapshot;
+}
+
+SeqLock<PortStats>& StateMachine::GetStatsSnapshot() noexcept {
+    return _slab->Snapshot;
+}
+
+#ifdef STP_ENGINE_STATS
+const PortMachineCounters& StateMachine::Counters() const noexcept {
+    return _slab->Counters;
+}
+#endif
+
+std::size_t StateMachine::SlabSize() noexcept {
+    return sizeof(Slab);
+}
+
+Engine::Engine(const Mac& bridgeAddr, SystemH system)
+    : _bridge{ std::make_shared<Bridge>(system) }, _runningStateMachines{ },
+      _mtxRunningStateMachines{ }, _rxFastPathHits{ 0 }, _rxFastPathMisses{ 0 },
+      _snapshotVersion{ 0 }, _portChanges{ }, _portChangesFloor{ 0 },
+      _allPortsChangedVersion{ 0 }, _changedPortCount{ 0 }, _changed{ false },
+      _changedPorts{ }, _stateImage{ }, _stateImagePath{ }, _activeImageVersion{ 0 },
+      _inactiveImageVersion{ 0 }, _replicationChannel{ }, _replicationEncoder{ },
+      _replicatedPorts{ }, _replicatedVersion{ 0 }, _replicationFrame{ } {
+    _bridge->SetAddress(bridgeAddr);
+    _bridge->GetBridgeIdentifier().SetAddress(bridgeAddr);
+    _bridge->GetBridgePriority().SetRootBridgeId(_bridge->BridgeIdentifier());
+    _bridge->GetBridgePriority().GetRootPathCost().SetPathCost(0);
+    _bridge->GetBridgePriority().SetDesignatedBridgeId(_bridge->BridgeIdentifier());
+    _bridge->SetRootPriority(_bridge->BridgePriority());
+    _bridge->SetBegin(true);
+    MarkAllChanged();
+    PublishSnapshot();
+}
+
+Result Engine::AddPort(const u16 portNo, const u32 speed, const bool enabled) {
+    if (_bridge->GetPort(portNo)) {
+        return Result::Fail;
+    }
+
+    StartPort(PortSpec{ portNo, speed, enabled });
+    PublishSnapshot();
+
+    return Result::Success;
+}
+
+Result Engine::RemovePort(const u16 portNo) {
+    if (not _bridge->GetPort(portNo)) {
+        return Result::Fail;
+    }
+
+    StopPort(portNo);
+    UpdateTickInterval();
+    PublishSnapshot();
+
+    return Result::Success;
+}
+
+Result Engine::AddPorts(const std::vector<PortSpec>& ports) {
+    // Ports are added in ascending order, so every one is inserted at the end of lists
+    std::vector<PortSpec> sortedPorts{ ports };
+    std::sort(sortedPorts.begin(), sortedPorts.end(),
+              [](const PortSpec& lhs, const PortSpec& rhs) {
+        return lhs.PortNo < rhs.PortNo;
+    });
+
+    for (auto it = sortedPorts.cbegin(); it != sortedPorts.cend(); ++it) {
+        if (_bridge->GetPort(it->PortNo)
+                || ((it != sortedPorts.cbegin()) && (std::prev(it)->PortNo == it->PortNo))) {
+            return Result::Fail;
+        }
+    }
+
+    for (const PortSpec& spec : sortedPorts) {
+        StartPort(spec).SkipInitBridge();
+    }
+
+    // Added ports leave their initial states first, then roles of all ports are selected once
+    // instead of once per added port
+    _bridge->SetRoleSelectionDeferred(true);
+    Evaluate();
+    _bridge->SetRoleSelectionDeferred(false);
+    Evaluate();
+
+    return Result::Success;
+}
+
+Result Engine::RemovePorts(const std::vector<u16>& portNos) {
+    std::vector<u16> sortedPortNos{ portNos };
+    std::sort(sortedPortNos.begin(), sortedPortNos.end());
+    for (auto it = sortedPortNos.cbegin(); it != sortedPortNos.cend(); ++it) {
+        if (not _bridge->GetPort(*it)
+                || ((it != sortedPortNos.cbegin()) && (*std::prev(it) == *it))) {
+            return Result::Fail;
+        }
+    }
+
+    for (const u16 portNo : sortedPortNos) {
+        StopPort(portNo);
+    }
+
+    UpdateTickInterval();
+    // Removed ports might have been the root port or designated for the others
+    if (not _bridge->AllPorts().empty()) {
+        Reselect(*_bridge->AllPorts().begin()->second);
+    }
+
+    Evaluate();
+
+    return Result::Success;
+}
+
+Result Engine::SetPortEnabled(const u16 portNo, const bool enabled) {
+    PortH port = _bridge->GetPort(portNo);
+    if (not port) {
+        return Result::Fail;
+    }
+
+    if (port->PortEnabled() != enabled) {
+        port->SetPortEnabled(enabled);
+        MarkChanged(portNo);
+        Evaluate();
+    }
+
+    return Result::Success;
+}
+
+Result Engine::SetPortsEnabled(const std::vector<u16>& portNos, const bool enabled) {
+    for (const u16 portNo : portNos) {
+        if (not _bridge->GetPort(portNo)) {
+            return Result::Fail;
+        }
+    }
+
+    bool changed = false;
+    for (const u16 portNo : portNos) {
+        PortH port = _bridge->GetPort(portNo);
+        if (port->PortEnabled() != enabled) {
+            port->SetPortEnabled(enabled);
+            MarkChanged(portNo);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        Evaluate();
+    }
+
+    return Result::Success;
+}
+
+Result Engine::SetPortAdminEdge(const u16 portNo, const bool adminEdge) {
+    StateMachine* const sm = FindStateMachine(portNo);
+    if (not sm) {
+        return Result::Fail;
+    }
+
+    PortH port = sm->PortInstance();
+    if (port->AdminEdge() == adminEdge) {
+        return Result::Success;
+    }
+
+    port->SetAdminEdge(adminEdge);
+    MarkChanged(*sm);
+    // Edge port detected by autoEdge stays the one until it receives BPDU
+    if (adminEdge || not port->AutoEdge()) {
+        sm->ChangeOperEdge(adminEdge);
+    }
+
+    Evaluate();
+
+    return Result::Success;
+}
+
+Result Engine::SetPortAutoEdge(const u16 portNo, const bool autoEdge) {
+    StateMachine* const sm = FindStateMachine(portNo);
+    if (not sm) {
+        return Result::Fail;
+    }
+
+    PortH port = sm->PortInstance();
+    if (port->AutoEdge() == autoEdge) {
+        return Result::Success;
+    }
+
+    port->SetAutoEdge(autoEdge);
+    MarkChanged(*sm);
+    if (not autoEdge && not port->AdminEdge()) {
+        sm->ChangeOperEdge(false);
+    }
+
+    // Enabled detection might declare the port edge port at once, if edgeDelayWhile has expired
+    Evaluate();
+
+    return Result::Success;
+}
+
+Result Engine::SetPortPointToPoint(const u16 portNo, const bool pointToPoint) {
+    PortH port = _bridge->GetPort(portNo);
+    if (not port) {
+        return Result::Fail;
+    }
+
+    if (port->OperPointToPointMAC() != pointToPoint) {
+        port->SetOperPointToPointMAC(pointToPoint);
+        MarkChanged(portNo);
+        Evaluate();
+    }
+
+    return Result::Success;
+}
+
+Result Engine::SetPortPriority(const u16 portNo, const u32 priority) {
+    PortH port = _bridge->GetPort(portNo);
+    if (not port || Failed(PortConfig::ValidatePriority(priority))) {
+        return Result::Fail;
+    }
+
+    port->GetPortId().SetPriority(static_cast<u8>(priority));
+    Reselect(*port);
+
+    return Result::Success;
+}
+
+Result Engine::SetPortPathCost(const u16 portNo, const u32 pathCost) {
+    PortH port = _bridge->GetPort(portNo);
+    if (not port || Failed(PortConfig::ValidatePathCost(pathCost))) {
+        return Result::Fail;
+    }
+
+    port->GetPortPathCost().SetPathCost(pathCost);
+    Reselect(*port);
+
+    return Result::Success;
+}
+
+Result Engine::SetBridgeConfig(const BridgeConfig& config) {
+    if (Failed(config.Validate())) {
+        return Result::Fail;
+    }
+
+    const bool versionChanged = config.ForceProtocolVersion != _bridge->ForceProtocolVersion();
+    const bool txHoldCountChanged = config.TxHoldCount != _bridge->TxHoldCount();
+
+    _bridge->GetBridgeIdentifier().SetPriority(config.Priority);
+    _bridge->GetBridgePriority().SetRootBridgeId(_bridge->BridgeIdentifier());
+    _bridge->GetBridgePriority().SetDesignatedBridgeId(_bridge->BridgeIdentifier());
+    _bridge->GetBridgeTimes().SetHelloTime(Time::FromSeconds(config.HelloTime));
+    _bridge->GetBridgeTimes().SetMaxAge(Time::FromSeconds(config.MaxAge));
+    _bridge->GetBridgeTimes().SetForwardDelay(Time::FromSeconds(config.ForwardDelay));
+    _bridge->SetTxHoldCount(config.TxHoldCount);
+    _bridge->SetForceProtocolVersion(config.ForceProtocolVersion);
+    _bridge->SetAgeingTime(Time::FromSeconds(config.AgeingTime));
+    MarkAllChanged();
+
+    for (auto& bridgePort : _bridge->GetAllPorts()) {
+        Port& port = *bridgePort.second;
+        Reselect(port);
+        if (versionChanged) {
+            // 17.13.4, Port Protocol Migration machine selects protocol of the port again
+            port.SetMcheck(true);
+        }
+
+        if (txHoldCountChanged) {
+            // 17.13.12
+            port.SetTxCount(0);
+        }
+    }
+
+    Evaluate();
+
+    return Result::Success;
+}
+
+void Engine::GetBridgeConfig(BridgeConfig& config) const noexcept {
+    config.Priority = _bridge->BridgeIdentifier().Priority();
+    config.HelloTime = static_cast<u16>(_bridge->BridgeTimes().HelloTime() / Time::MsPerSecond);
+    config.MaxAge = static_cast<u16>(_bridge->BridgeTimes().MaxAge() / Time::MsPerSecond);
+    config.ForwardDelay = static_cast<u16>(_bridge->BridgeTimes().ForwardDelay()
+                                           / Time::MsPerSecond);
+    config.TxHoldCount = _bridge->TxHoldCount();
+    config.ForceProtocolVersion = _bridge->ForceProtocolVersion();
+    config.AgeingTime = _bridge->AgeingTime() / Time::MsPerSecond;
+}
+
+Result Engine::SetPortFastHello(const u16 portNo, const u32 helloTimeMs) {
+    PortH port = _bridge->GetPort(portNo);
+    if (not port || Failed(PortConfig::ValidateFastHelloTime(helloTimeMs))) {
+        return Result::Fail;
+    }
+
+    port->SetFastHelloTime(static_cast<u16>(helloTimeMs));
+    // Designated times of the port are updated by reselection, while the first BPDU advertising
+    // them is not delayed by hello time used so far
+    Reselect(*port);
+    port->SmTimersInstance().SetHelloWhen(0);
+    UpdateTickInterval();
+
+    return Result::Success;
+}
+
+Result Engine::ProcessBpdu(const u16 rxPortNo, const ByteStream& data) {
+    return ProcessBpdu(rxPortNo, data, _bridge->Now());
+}
+
+Result Engine::ProcessBpdu(const u16 rxPortNo, const ByteStream& data,
+                           const Clock::Duration ingressTime) {
+    StateMachine* const sm = FindStateMachine(rxPortNo);
+    if (not sm) {
+        // Received BPDU data from not register port in STP process
+        return Result::Fail;
+    }
+
+    // Received BPDU changes at least counters of the port
+    MarkChanged(*sm);
+    Port& port = sm->GetPortData();
+
+    if (TryRxFastPath(port, port.RxFingerprint().Matches(data), ingressTime)) {
+        return Result::Success;
+    }
+
+    Bpdu bpdu{};
+    BpduDropReason reason = BpduDropReason::Malformed;
+    if (Failed(DecodeBpdu(data, rxPortNo, _bridge->Address().ConvertToInteger(), bpdu, reason))) {
+        port.GetStats().CountDrop(reason);
+        return Result::Fail;
+    }
+
+    CountRx(port, bpdu);
+    if (not port.RcvdBpdu()) {
+        // Latency of BPDUs overwritten before consumption is measured from the oldest one
+        port.SetRxIngressTime(ingressTime);
+    }
+
+    port.SetRxBpdu(bpdu);
+    port.SetRcvdBpdu(true);
+    port.GetRxFingerprint().Assign(data);
+
+    return Result::Success;
+}
+
+Result Engine::ProcessDecodedBpdu(const u16 rxPortNo, const Bpdu& bpdu,
+                                  const BpduFingerprint& fingerprint,
+                                  const Clock::Duration ingressTime) {
+    StateMachine* const sm = FindStateMachine(rxPortNo);
+    if (not sm) {
+        // Received BPDU data from not register port in STP process
+        return Result::Fail;
+    }
+
+    // Received BPDU changes at least counters of the port
+    MarkChanged(*sm);
+    Port& port = sm->GetPortData();
+
+    if (TryRxFastPath(port, port.RxFingerprint() == fingerprint, ingressTime)) {
+        return Result::Success;
+    }
+
+    CountRx(port, bpdu);
+    if (not port.RcvdBpdu()) {
+        port.SetRxIngressTime(ingressTime);
+    }
+
+    port.SetRxBpdu(bpdu);
+    port.SetRcvdBpdu(true);
+    port.GetRxFingerprint() = fingerprint;
+
+    return Result::Success;
+}
+
+void Engine::Tick() {
+    for (auto& port : _bridge->GetAllPorts()) {
+        port.second->SetTick(true);
+    }
+
+    Evaluate();
+}
+
+void Engine::Evaluate() {
+    // State machines are evaluated until all of them are stable, as transitions made by one
+    // machine might enable transitions of the others
+    bool changed = true;
+    for (u8 pass = 0; changed && (pass < _kMaxEvaluationPasses); ++pass) {
+        changed = false;
+        for (auto& sm : _runningStateMachines) {
+            if (sm.TickEvent()) {
+                MarkChanged(sm);
+                changed = true;
+            }
+        }
+    }
+
+    if (_bridge->TreeChanged()) {
+        _bridge->SetTreeChanged(false);
+        MarkAllChanged();
+    }
+
+    if (_bridge->Failover().RootPortNo != _bridge->RootPortId().PortNum()) {
+        SmProcedures::UpdtFailoverPlan(*_bridge);
+        _changed = true;
+    }
+
+    PublishStats();
+    PublishSnapshot();
+}
+
+void Engine::SetLogSeverity(const LoggingSystem::Logger::LogSeverity logSeverity) {
+    _bridge->SetSystemLogSeverity(logSeverity);
+}
+
+void Engine::GetRxFastPathCounters(u64& hits, u64& misses) const noexcept {
+    hits = _rxFastPathHits.load(std::memory_order_relaxed);
+    misses = _rxFastPathMisses.load(std::memory_order_relaxed);
+}
+
+Result Engine::GetStats(EngineStats& stats) const {
+    stats.Ports.clear();
+#ifdef STP_ENGINE_STATS
+    std::lock_guard<std::mutex> portsGuard{ _mtxRunningStateMachines };
+    for (const auto& sm : _runningStateMachines) {
+        EngineStats::PortStats& portStats = stats.Ports[sm.PortNo()];
+        for (u8 idx = 0; idx < MachineTypeCount; ++idx) {
+            const MachineCounters& counters = sm.Counters()[idx];
+            portStats[idx].Executions = counters.Executions();
+            portStats[idx].Transitions = counters.Transitions();
+            portStats[idx].GuardEvaluations = counters.GuardEvaluations();
+            portStats[idx].GuardHits = counters.GuardHits();
+            portStats[idx].Cycles = counters.Cycles();
+        }
+    }
+
+    return Result::Success;
+#else
+    return Result::Fail;
+#endif
+}
+
+Result Engine::GetPortStats(const u16 portNo, PortStats& stats) const {
+    std::lock_guard<std::mutex> portsGuard{ _mtxRunningStateMachines };
+    const StateMachine* const sm = FindStateMachine(portNo);
+    if (not sm) {
+        return Result::Fail;
+    }
+
+    stats = sm->StatsSnapshot().Load();
+
+    return Result::Success;
+}
+
+void Engine::GetAllPortStats(std::map<u16, PortStats>& stats) const {
+    stats.clear();
+    std::lock_guard<std::mutex> portsGuard{ _mtxRunningStateMachines };
+    for (const auto& sm : _runningStateMachines) {
+        stats.emplace_hint(stats.end(), sm.PortNo(), sm.StatsSnapshot().Load());
+    }
+}
+
+void Engine::GetLatencyReport(LatencyReport& report) const {
+    _bridge->LatencyTrackerInstance().Read(report);
+}
+
+Result Engine::StartTrace(const u32 capacity, const bool stateSpans) {
+    return _bridge->GetTracer().Start(capacity, stateSpans);
+}
+
+void Engine::StopTrace() noexcept {
+    _bridge->GetTracer().Stop();
+}
+
+void Engine::WriteTrace(std::ostream& out) const {
+    _bridge->TracerInstance().WriteChromeTrace(out);
+}
+
+Result Engine::StartStateImage(const std::string& path) {
+    auto stateImage = std::make_unique<StateImage>();
+    if (Failed(stateImage->Create(path, static_cast<u32>(_bridge->AllPorts().size())))) {
+        return Result::Fail;
+    }
+
+    _stateImage = std::move(stateImage);
+    _stateImagePath = path;
+    _activeImageVersion = 0;
+    _inactiveImageVersion = 0;
+    SaveStateImage();
+
+    return Result::Success;
+}
+
+void Engine::StopStateImage() noexcept {
+    _stateImage.reset();
+    _stateImagePath.clear();
+}
+
+Result Engine::RestoreStateImage(const std::string& path) {
+    StateImage stateImage{};
+    if (Failed(stateImage.Open(path))) {
+        return Result::Fail;
+    }
+
+    const StateImage::SlotHeader* slot = stateImage.ActiveSlot();
+    const u64 nowMs = static_cast<u64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                           _bridge->Now()).count());
+    if ((not slot) || (slot->TimeMs > nowMs)
+            || (not CanRestore(slot->Bridge, stateImage.Ports(*slot), slot->PortCount))) {
+        return Result::Fail;
+    }
+
+    const u32 elapsedMs = static_cast<u32>(std::min<u64>(nowMs - slot->TimeMs,
+                                                         std::numeric_limits<u32>::max()));
+    RestorePorts(slot->Bridge, stateImage.Ports(*slot), slot->PortCount, elapsedMs);
+
+    return Result::Success;
+}
+
+Result Engine::StartReplication(const std::string& path) {
+    auto channel = std::make_unique<ReplicationChannel>();
+    if (Failed(channel->Listen(path))) {
+        return Result::Fail;
+    }
+
+    _replicationChannel = std::move(channel);
+    _replicationEncoder.Reset();
+    _replicatedVersion = 0;
+
+    return Result::Success;
+}
+
+void Engine::StopReplication() noexcept {
+    _replicationChannel.reset();
+}
+
+Result Engine::TakeOver(const Replica& replica, const u32 elapsedMs) {
+    const u32 portCount = static_cast<u32>(replica.Ports().size());
+    if ((not replica.IsSynced())
+            || (not CanRestore(replica.Bridge(), replica.Ports().data(), portCount))) {
+        return Result::Fail;
+    }
+
+    RestorePorts(replica.Bridge(), replica.Ports().data(), portCount, elapsedMs);
+
+    return Result::Success;
+}
+
+Result Engine::DecodeBpdu(const ByteStream& data, const u16 rxPortNo, const u64 bridgeAddr,
+                          Bpdu& bpdu) noexcept {
+    BpduDropReason reason = BpduDropReason::Malformed;
+    return DecodeBpdu(data, rxPortNo, bridgeAddr, bpdu, reason);
+}
+
+Result Engine::DecodeBpdu(const ByteStream& data, const u16 rxPortNo, const u64 bridgeAddr,
+                          Bpdu& bpdu, BpduDropReason& reason) noexcept {
+    if (Failed(bpdu.Decode(data))) {
+        reason = BpduDropReason::Malformed;
+        return Result::Fail;
+    }
+
+    if (Bpdu::Type::Config == bpdu.BpduType()) {
+        if ((PortId{ bpdu.PortIdentifier() }.PortNum() == rxPortNo)
+                                        &&
+            (BridgeId{ bpdu.BridgeIdentifier() }.Address().ConvertToInteger() == bridgeAddr)) {
+            // BPDU has been received by port which originally transmitted it...
+            // so it's invalid BPDU
+            reason = BpduDropReason::Looped;
+            return Result::Fail;
+        }
+    }
+
+    return Result::Success;
+}
+
+bool Engine::TryRxFastPath(Port& port, const bool repeated,
+                           const Clock::Duration ingressTime) noexcept {
+    if (repeated && SmConditions::RxFastPathAllowed(port)) {
+        // The same BPDU as the previous one, which has been already recognized as repeated
+        // designated information, so only timers need to be refreshed
+        SmProcedures::RecordRepeatedBpdu(port);
+        port.SetRxIngressTime(ingressTime);
+        _bridge->GetLatencyTracker().RecordReceive(port);
+        port.ClearRxIngressTime();
+        CountRx(port, port.RxBpdu());
+        _rxFastPathHits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    _rxFastPathMisses.fetch_add(1, std::memory_order_relaxed);
+    port.SetRxFastPath(false);
+    port.GetRxFingerprint().Clear();
+
+    return false;
+}
+
+void Engine::CountRx(Port& port, const Bpdu& bpdu) noexcept {
+    if (not port.PortEnabled()) {
+        // Port receive machine discards it
+        port.GetStats().CountDrop(BpduDropReason::PortDisabled);
+        return;
+    }
+
+    port.GetStats().CountRx(bpdu);
+    _bridge->GetTracer().RecordReceive(port, bpdu);
+}
+
+void Engine::PublishStats() noexcept {
+    const u64 nowMs = static_cast<u64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                           _bridge->Now()).count());
+    if (_allPortsChangedVersion > _snapshotVersion) {
+        for (auto& sm : _runningStateMachines) {
+            PublishStats(sm, nowMs);
+        }
+
+        return;
+    }
+
+    // Ports changed since the last publication are at the end of the list
+    for (auto it = _portChanges.crbegin();
+         (it != _portChanges.crend()) && (it->Version > _snapshotVersion); ++it) {
+        StateMachine* const sm = FindStateMachine(it->PortNo);
+        if (sm) {
+            PublishStats(*sm, nowMs);
+        }
+    }
+}
+
+void Engine::PublishStats(StateMachine& sm, const u64 nowMs) noexcept {
+    Port& port = sm.GetPortData();
+    PortStats& stats = port.GetStats();
+    if (port.Role() != stats.Role) {
+        stats.Role = port.Role();
+        ++stats.RoleChanges;
+        stats.LastRoleChangeMs = nowMs;
+    }
+
+    if ((port.Learning() != stats.Learning) || (port.Forwarding() != stats.Forwarding)) {
+        stats.Learning = port.Learning();
+        stats.Forwarding = port.Forwarding();
+        ++stats.StateChanges;
+        stats.LastStateChangeMs = nowMs;
+    }
+
+    sm.GetStatsSnapshot().Store(stats);
+}
+
+StateMachine& Engine::StartPort(const PortSpec& spec) {
+    StateMachine stateMachine{ _bridge };
+    PortH newPort = stateMachine.PortInstance();
+    _bridge->AddPort(spec.PortNo, newPort);
+    newPort->SetPortEnabled(spec.Enabled);
+    newPort->GetPortPathCost().SetPathCost(PathCost::SpeedMbToPathCostValue(spec.Speed));
+    newPort->GetPortId().SetPortNum(spec.PortNo);
+    newPort->GetPortId().SetPriority(+PriorityVector::RecommendedPortPriority::Value);
+
+    const auto position = FindPosition(spec.PortNo);
+    StateMachine* started = nullptr;
+    {
+        std::lock_guard<std::mutex> portsGuard{ _mtxRunningStateMachines };
+        started = &*_runningStateMachines.insert(position, std::move(stateMachine));
+    }
+
+    MarkChanged(*started);
+
+    return *started;
+}
+
+void Engine::StopPort(const u16 portNo) {
+    {
+        std::lock_guard<std::mutex> portsGuard{ _mtxRunningStateMachines };
+        _runningStateMachines.erase(FindPosition(portNo));
+    }
+
+    _bridge->RemovePort(portNo);
+    // The removed port is listed, so readers erase its record
+    _changed = true;
+    if (_allPortsChangedVersion <= _snapshotVersion) {
+        _portChanges.push_back(PortChange{ _snapshotVersion + 1, portNo });
+        ++_changedPortCount;
+    }
+}
+
+std::vector<StateMachine>::iterator Engine::FindPosition(const u16 portNo) noexcept {
+    // Ports are mostly added in order of their numbers, so the last one is checked first
+    if (_runningStateMachines.empty() || (_runningStateMachines.back().PortNo() < portNo)) {
+        return _runningStateMachines.end();
+    }
+
+    return std::lower_bound(_runningStateMachines.begin(), _runningStateMachines.end(), portNo,
+                            [](const StateMachine& sm, const u16 number) {
+        return sm.PortNo() < number;
+    });
+}
+
+StateMachine* Engine::FindStateMachine(const u16 portNo) noexcept {
+    const auto position = FindPosition(portNo);
+    return ((_runningStateMachines.end() != position) && (portNo == position->PortNo()))
+            ? &*position : nullptr;
+}
+
+const StateMachine* Engine::FindStateMachine(const u16 portNo) const noexcept {
+    return const_cast<Engine*>(this)->FindStateMachine(portNo);
+}
+
+void Engine::UpdateTickInterval() noexcept {
+    u32 tickIntervalMs = Time::DefaultTickIntervalMs;
+    for (const auto& port : _bridge->AllPorts()) {
+        if (port.second->FastHelloTime()) {
+            tickIntervalMs = std::min<u32>(tickIntervalMs, port.second->FastHelloTime());
+        }
+    }
+
+    _bridge->SetTickIntervalMs(tickIntervalMs);
+}
+
+void Engine::Reselect(Port& port) {
+    port.SetReselect(true);
+    port.SetSelected(false);
+    MarkChanged(port.PortId().PortNum());
+}
+
+void Engine::MarkChanged(const u16 portNo) {
+    if (_allPortsChangedVersion > _snapshotVersion) {
+        _changed = true;
+        return;
+    }
+
+    StateMachine* const sm = FindStateMachine(portNo);
+    if (sm) {
+        MarkChanged(*sm);
+    }
+}
+
+void Engine::MarkChanged(StateMachine& sm) {
+    _changed = true;
+    const u64 version = _snapshotVersion + 1;
+    if ((_allPortsChangedVersion == version) || not sm.MarkChanged(version)) {
+        return;
+    }
+
+    // Records of most of the ports are written faster all together than looked up one by one
+    if (++_changedPortCount > _runningStateMachines.size() / 4) {
+        MarkAllChanged();
+        return;
+    }
+
+    _portChanges.push_back(PortChange{ version, sm.PortNo() });
+}
+
+void Engine::MarkAllChanged() noexcept {
+    _changed = true;
+    _allPortsChangedVersion = _snapshotVersion + 1;
+    while (not _portChanges.empty() && (_portChanges.back().Version > _snapshotVersion)) {
+        _portChanges.pop_back();
+    }
+}
+
+bool Engine::CollectChangedPorts(const u64 baseline, std::vector<u16>& portNos) const {
+    if ((0 == baseline) || (baseline < _portChangesFloor)
+            || (baseline < _allPortsChangedVersion)) {
+        return false;
+    }
+
+    portNos.clear();
+    for (auto it = _portChanges.crbegin(); (it != _portChanges.crend()) && (it->Version > baseline);
+         ++it) {
+        portNos.push_back(it->PortNo);
+    }
+
+    std::sort(portNos.begin(), portNos.end());
+    portNos.erase(std::unique(portNos.begin(), portNos.end()), portNos.end());
+
+    return true;
+}
+
+template <typename Record, typename SaveRecord>
+u32 Engine::UpdateRecords(Record* records, u32 count, const std::vector<u16>& portNos,
+                          SaveRecord save) {
+    const auto lowerBound = [records, &count](const u16 portNo) {
+        return std::lower_bound(records, records + count, portNo,
+                                [](const Record& record, const u16 number) {
+            return record.PortNo < number;
+        });
+    };
+
+    // Records of removed ports are erased first, so records never outnumber current ports
+    for (const u16 portNo : portNos) {
+        Record* const position = lowerBound(portNo);
+        if ((position != records + count) && (portNo == position->PortNo)
+                && not FindStateMachine(portNo)) {
+            std::move(position + 1, records + count, position);
+            --count;
+        }
+    }
+
+    for (const u16 portNo : portNos) {
+        StateMachine* const sm = FindStateMachine(portNo);
+        if (not sm) {
+            continue;
+        }
+
+        Record* const position = lowerBound(portNo);
+        if ((position == records + count) || (portNo != position->PortNo)) {
+            std::move_backward(position, records + count, records + count + 1);
+            ++count;
+        }
+
+        position->PortNo = portNo;
+        save(*sm, *position);
+    }
+
+    return count;
+}
+
+void Engine::PublishSnapshot() {
+    if (not _changed) {
+        return;
+    }
+
+    const u64 version = ++_snapshotVersion;
+    _changed = false;
+    _changedPortCount = 0;
+    // Snapshot which is not read anymore keeps capacity of its ports, so publication does not
+    // allocate once the number of ports has settled. Only ports changed since it has been
+    // published are written again.
+    Uptr<BridgeSnapshot> snapshot = _snapshot.Reuse();
+    if (not snapshot) {
+        snapshot = std::make_unique<BridgeSnapshot>();
+    }
+
+    const auto savePort = [](StateMachine& sm, PortSnapshot& portSnapshot) {
+        SavePortSnapshot(sm.GetPortData(), portSnapshot);
+    };
+    const u32 portCount = static_cast<u32>(_runningStateMachines.size());
+    if (CollectChangedPorts(snapshot->Version, _changedPorts)) {
+        const u32 count = static_cast<u32>(snapshot->Ports.size());
+        snapshot->Ports.resize(std::max(count, portCount));
+        snapshot->Ports.resize(UpdateRecords(snapshot->Ports.data(), count, _changedPorts,
+                                             savePort));
+    }
+    else {
+        snapshot->Ports.resize(portCount);
+        // Ports are kept in order of their numbers
+        auto portSnapshot = snapshot->Ports.begin();
+        for (auto& sm : _runningStateMachines) {
+            portSnapshot->PortNo = sm.PortNo();
+            savePort(sm, *portSnapshot);
+            ++portSnapshot;
+        }
+    }
+
+    snapshot->Version = version;
+    snapshot->TimeMs = static_cast<u64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                            _bridge->Now()).count());
+    snapshot->BridgeIdentifier = _bridge->BridgeIdentifier();
+    snapshot->RootPriority = _bridge->RootPriority();
+    snapshot->RootPortId = _bridge->RootPortId();
+    snapshot->RootTimes = _bridge->RootTimes();
+    const FailoverPlan& plan = _bridge->Failover();
+    // The plan is refreshed by Evaluate(), so it might be outdated after adding or removing ports
+    const bool planValid = (0 != plan.RootPortNo)
+            && (plan.RootPortNo == _bridge->RootPortId().PortNum());
+    snapshot->BackupRootPortNo = planValid ? plan.BackupPortId.PortNum() : 0;
+    snapshot->BridgeTimes = _bridge->BridgeTimes();
+    GetBridgeConfig(snapshot->Config);
+
+    _snapshot.Publish(std::move(snapshot));
+    // The image mirrors every published state
+    if (_stateImage) {
+        SaveStateImage();
+    }
+
+    if (_replicationChannel) {
+        Replicate();
+    }
+
+    if (version > _portChangesFloor + _kKeptPublications) {
+        _portChangesFloor = version - _kKeptPublications;
+        const auto kept = std::find_if(_portChanges.cbegin(), _portChanges.cend(),
+                                       [this](const PortChange& change) {
+            return change.Version > _portChangesFloor;
+        });
+        _portChanges.erase(_portChanges.cbegin(), kept);
+    }
+}
+
+void Engine::SaveStateImage() {
+    const u32 portCount = static_cast<u32>(_bridge->AllPorts().size());
+    if (portCount > _stateImage->PortCapacity()) {
+        // Capacity is doubled, so adding of ports one by one does not copy the file every time
+        if (Failed(_stateImage->Create(_stateImagePath, 2 * portCount))) {
+            StopStateImage();
+            return;
+        }
+
+        _activeImageVersion = 0;
+        _inactiveImageVersion = 0;
+    }
+
+    // The inactive slot keeps the image committed before the active one, so only ports changed
+    // since then are written
+    StateImage::SlotHeader& slot = _stateImage->InactiveSlot();
+    StateImage::PortRecord* const records = _stateImage->GetPorts(slot);
+    if (CollectChangedPorts(_inactiveImageVersion, _changedPorts)) {
+        slot.PortCount = UpdateRecords(records, slot.PortCount, _changedPorts,
+                                       [](StateMachine& sm, StateImage::PortRecord& record) {
+            sm.SaveState(record);
+        });
+    }
+    else {
+        SavePorts(records);
+        slot.PortCount = portCount;
+    }
+
+    slot.TimeMs = static_cast<u64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       _bridge->Now()).count());
+    slot.Reserved = 0;
+    StateImage::SaveBridge(*_bridge, slot.Bridge);
+    _stateImage->Commit(slot);
+    _inactiveImageVersion = _activeImageVersion;
+    _activeImageVersion = _snapshotVersion;
+}
+
+void Engine::SavePorts(StateImage::PortRecord* records) const noexcept {
+    for (const auto& sm : _runningStateMachines) {
+        records->PortNo = sm.PortNo();
+        sm.SaveState(*records);
+        ++records;
+    }
+}
+
+void Engine::RestorePorts(const StateImage::BridgeRecord& bridge,
+                          const StateImage::PortRecord* records, const u32 portCount,
+                          const u32 elapsedMs) {
+    StateImage::RestoreBridge(bridge, *_bridge);
+    MarkAllChanged();
+    for (u32 idx = 0; idx < portCount; ++idx) {
+        StartPort(PortSpec{ records[idx].PortNo, 0, false }).RestoreState(records[idx],
+                                                                           elapsedMs);
+    }
+
+    UpdateTickInterval();
+    PublishStats();
+    PublishSnapshot();
+}
+
+bool Engine::CanRestore(const StateImage::BridgeRecord& bridge,
+                        const StateImage::PortRecord* records,
+                        const u32 portCount) const noexcept {
+    if ((not _bridge->AllPorts().empty())
+            || (bridge.Address != _bridge->Address().ConvertToInteger())) {
+        return false;
+    }
+
+    // Records are checked as a whole first, so the bridge is never restored partially
+    for (u32 idx = 0; idx < portCount; ++idx) {
+        if ((not StateMachine::KnowsStates(records[idx]))
+                || ((idx > 0) && (records[idx - 1].PortNo >= records[idx].PortNo))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Engine::Replicate() {
+    if (_replicationChannel->AcceptStandby()) {
+        _replicationEncoder.Reset();
+    }
+
+    if (not _replicationChannel->IsConnected()) {
+        return;
+    }
+
+    StateImage::BridgeRecord bridge{};
+    StateImage::SaveBridge(*_bridge, bridge);
+    const u64 nowMs = static_cast<u64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                           _bridge->Now()).count());
+    // Timers run down by the tick, so they are not sent while they only run down
+    if (CollectChangedPorts(_replicatedVersion, _changedPorts)) {
+        // Records are updated in place, so there has to be room for every current port
+        const u32 count = static_cast<u32>(_replicatedPorts.size());
+        _replicatedPorts.resize(std::max<size_t>(count, _runningStateMachines.size()));
+        const u32 updatedCount = UpdateRecords(_replicatedPorts.data(), count, _changedPorts,
+                                               [](StateMachine& sm,
+                                                  StateImage::PortRecord& record) {
+            sm.SaveState(record);
+        });
+        _replicatedPorts.resize(updatedCount);
+        _replicationEncoder.Encode(bridge, _replicatedPorts, _changedPorts, nowMs,
+                                   _bridge->TickIntervalMs(), _replicationFrame);
+    }
+    else {
+        _replicatedPorts.resize(_runningStateMachines.size());
+        SavePorts(_replicatedPorts.data());
+        _replicationEncoder.Encode(bridge, _replicatedPorts, nowMs, _bridge->TickIntervalMs(),
+                                   _replicationFrame);
+    }
+
+    _replicatedVersion = _snapshotVersion;
+    if (Failed(_replicationChannel->Send(_replicationFrame))) {
+        _replicationEncoder.Reset();
+    }
+}
+
+} // namespace Stp
@@ -0,0 +1,66 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/engine_stats.hpp"
+
+namespace Stp {
+
+const char* MachineTypeName(const MachineType type) noexcept {
+    switch (type) {
+    case MachineType::Pti:
+        return "PortTimers";
+    case MachineType::Prx:
+        return "PortReceive";
+    case MachineType::Ppm:
+        return "PortProtocolMigration";
+    case MachineType::Bdm:
+        return "BridgeDetection";
+    case MachineType::Ptx:
+        return "PortTransmit";
+    case MachineType::Pim:
+        return "PortInformation";
+    case MachineType::Prs:
+        return "PortRoleSelection";
+    case MachineType::Prt:
+        return "PortRoleTransitions";
+    case MachineType::Pst:
+        return "PortStateTransition";
+    case MachineType::Tcm:
+        return "TopologyChange";
+    default:
+        return "Unknown";
+    }
+}
+
+double MachineStats::GuardHitRate() const noexcept {
+    if (0 == GuardEvaluations) {
+        return 0.0;
+    }
+
+    return static_cast<double>(GuardHits) / static_cast<double>(GuardEvaluations);
+}
+
+MachineStats& MachineStats::operator+=(const MachineStats& other) noexcept {
+    Executions += other.Executions;
+    Transitions += other.Transitions;
+    GuardEvaluations += other.GuardEvaluations;
+    GuardHits += other.GuardHits;
+    Cycles += other.Cycles;
+
+    return *this;
+}
+
+MachineStats EngineStats::Total(const MachineType type) const noexcept {
+    MachineStats total{};
+    for (const auto& port : Ports) {
+        total += port.second[static_cast<u8>(type)];
+    }
+
+    return total;
+}
+
+} // namespace Stp
@@ -0,0 +1,113 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/latency_histogram.hpp"
+
+// C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace Stp {
+
+constexpr u8 LatencyHistogram::SubBucketBits;
+constexpr u16 LatencyHistogram::SubBucketCount;
+constexpr u16 LatencyHistogram::BucketCount;
+
+LatencyDistribution::LatencyDistribution(std::vector<u64>&& buckets, const u64 sumUs,
+                                         const u64 maxUs)
+    : _buckets{ std::move(buckets) }, _count{ 0 }, _sumUs{ sumUs }, _maxUs{ maxUs } {
+    for (const u64 count : _buckets) {
+        _count += count;
+    }
+}
+
+double LatencyDistribution::MeanUs() const noexcept {
+    if (0 == _count) {
+        return 0.0;
+    }
+
+    return static_cast<double>(_sumUs) / static_cast<double>(_count);
+}
+
+u64 LatencyDistribution::PercentileUs(const double percentile) const noexcept {
+    if (0 == _count) {
+        return 0;
+    }
+
+    const u64 rank = std::max<u64>(1, static_cast<u64>(
+                                          std::ceil(percentile / 100.0 * _count)));
+    u64 seen = 0;
+    for (u16 idx = 0; idx < _buckets.size(); ++idx) {
+        seen += _buckets[idx];
+        if (seen >= rank) {
+            // The greatest sample has been recorded exactly
+            return std::min(LatencyHistogram::BucketUpperBound(idx), _maxUs);
+        }
+    }
+
+    return _maxUs;
+}
+
+void LatencyDistribution::WriteJson(std::ostream& out) const {
+    out << "{\"count\":" << _count << ",\"mean_us\":" << MeanUs()
+        << ",\"p50_us\":" << PercentileUs(50.0) << ",\"p90_us\":" << PercentileUs(90.0)
+        << ",\"p99_us\":" << PercentileUs(99.0) << ",\"p999_us\":" << PercentileUs(99.9)
+        << ",\"max_us\":" << _maxUs << ",\"buckets\":[";
+    bool first = true;
+    for (u16 idx = 0; idx < _buckets.size(); ++idx) {
+        if (0 == _buckets[idx]) {
+            continue;
+        }
+
+        out << (first ? "" : ",") << "{\"from_us\":" << LatencyHistogram::BucketLowerBound(idx)
+            << ",\"to_us\":" << LatencyHistogram::BucketUpperBound(idx)
+            << ",\"count\":" << _buckets[idx] << "}";
+        first = false;
+    }
+
+    out << "]}";
+}
+
+LatencyHistogram::LatencyHistogram() noexcept
+    : _sumUs{ 0 }, _maxUs{ 0 } {
+    for (auto& bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencyDistribution LatencyHistogram::Read() const {
+    std::vector<u64> buckets(BucketCount);
+    for (u16 idx = 0; idx < BucketCount; ++idx) {
+        buckets[idx] = _buckets[idx].load(std::memory_order_relaxed);
+    }
+
+    return LatencyDistribution{ std::move(buckets), _sumUs.load(std::memory_order_relaxed),
+                                _maxUs.load(std::memory_order_relaxed) };
+}
+
+u64 LatencyHistogram::BucketLowerBound(const u16 index) noexcept {
+    if (index < 2 * SubBucketCount) {
+        return index;
+    }
+
+    const u8 shift = static_cast<u8>((index - 2 * SubBucketCount) / SubBucketCount + 1);
+    const u64 subBucket = (index - 2 * SubBucketCount) % SubBucketCount + SubBucketCount;
+
+    return subBucket << shift;
+}
+
+u64 LatencyHistogram::BucketUpperBound(const u16 index) noexcept {
+    if (BucketCount - 1 == index) {
+        return std::numeric_limits<u64>::max();
+    }
+
+    return BucketLowerBound(index + 1) - 1;
+}
+
+} // namespace Stp
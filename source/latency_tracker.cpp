@@ -0,0 +1,100 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/latency_tracker.hpp"
+
+namespace Stp {
+
+constexpr std::chrono::seconds LatencyTracker::MaxForwardingLatency;
+
+const char* LatencyStageName(const LatencyStage stage) noexcept {
+    switch (stage) {
+    case LatencyStage::Receive:
+        return "receive";
+    case LatencyStage::Transmit:
+        return "transmit";
+    case LatencyStage::Forwarding:
+        return "forwarding";
+    default:
+        return "unknown";
+    }
+}
+
+void LatencyReport::WriteJson(std::ostream& out) const {
+    out << "{";
+    for (u8 idx = 0; idx < LatencyStageCount; ++idx) {
+        out << (idx ? "," : "") << "\"" << LatencyStageName(static_cast<LatencyStage>(idx))
+            << "\":";
+        _stages[idx].WriteJson(out);
+    }
+
+    out << "}";
+}
+
+LatencyTracker::LatencyTracker(ClockH clock) noexcept
+    : _clock{ clock }, _transmitSince{ }, _forwardingSince{ }, _transmitPending{ false },
+      _forwardingPending{ false } {
+    // Nothing more to do
+}
+
+void LatencyTracker::RecordRcvdInfo(Port& port) noexcept {
+    if (not port.RxIngressTimed()) {
+        return;
+    }
+
+    switch (port.RcvdInfo()) {
+    case Port::RcvdInfo::SuperiorDesignatedInfo:
+    case Port::RcvdInfo::InferiorDesignatedInfo:
+    case Port::RcvdInfo::InferiorRootAlternateInfo:
+        if (not _transmitPending) {
+            _transmitPending = true;
+            _transmitSince = port.RxIngressTime();
+        }
+
+        if ((not _forwardingPending)
+                || (_clock->Now() - _forwardingSince > MaxForwardingLatency)) {
+            _forwardingPending = true;
+            _forwardingSince = port.RxIngressTime();
+        }
+
+        break;
+    default:
+        break; // Nothing new, so no reaction is expected
+    }
+
+    port.ClearRxIngressTime();
+}
+
+void LatencyTracker::RecordForwarding() noexcept {
+    if (not _forwardingPending) {
+        return;
+    }
+
+    _forwardingPending = false;
+    const Clock::Duration elapsed = _clock->Now() - _forwardingSince;
+    if (elapsed <= MaxForwardingLatency) {
+        Histogram(LatencyStage::Forwarding).Record(ElapsedUs(_forwardingSince));
+    }
+}
+
+void LatencyTracker::Read(LatencyReport& report) const {
+    for (u8 idx = 0; idx < LatencyStageCount; ++idx) {
+        report.GetStage(static_cast<LatencyStage>(idx)) = _histograms[idx].Read();
+    }
+}
+
+u64 LatencyTracker::ElapsedUs(const Clock::Duration since) const noexcept {
+    const Clock::Duration elapsed = _clock->Now() - since;
+    if (elapsed.count() < 0) {
+        return 0;
+    }
+
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                elapsed).count());
+}
+
+} // namespace Stp
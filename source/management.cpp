@@ -7,79 +7,108 @@
 // This project's headers
 #include "stp/management.hpp"
 // Dependencies
-#include "stp/state_machine.hpp"
-#include "stp/sm/port_timers.hpp"
-#include "stp/sm/port_receive.hpp"
-#include "stp/sm/port_protocol_migration.hpp"
-#include "stp/sm/bridge_detection.hpp"
-#include "stp/sm/port_transmit.hpp"
-#include "stp/sm/port_information.hpp"
-#include "stp/sm/port_role_selection.hpp"
-#include "stp/sm/port_role_transitions.hpp"
-#include "stp/sm/port_state_transition.hpp"
-#include "stp/sm/topology_change.hpp"
+#include "stp/budgeted_queue.hpp"
+#include "stp/engine.hpp"
+#include "stp/scheduler.hpp"
 
 // C++ Standard Library
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <future>
-#include <map>
-#include <queue>
-#include <thread>
+#include <tuple>
 #include <utility>
 
 using namespace Stp;
 
-class StateMachine {
-public:
-    StateMachine(BridgeH bridge, PortH port)
-        : _machines {
-              std::make_unique<PortTimers::PtiMachine>(bridge, port),
-              std::make_unique<PortReceive::PrxMachine>(bridge, port),
-              std::make_unique<PortProtocolMigration::PpmMachine>(bridge, port),
-              std::make_unique<BridgeDetection::BdmMachine>(bridge, port),
-              std::make_unique<PortTransmit::PtxMachine>(bridge, port),
-              std::make_unique<PortInformation::PimMachine>(bridge, port),
-              std::make_unique<PortRoleSelection::PrsMachine>(bridge, port),
-              std::make_unique<PortRoleTransitions::PrtMachine>(bridge, port),
-              std::make_unique<PortStateTransition::PstMachine>(bridge, port),
-              std::make_unique<TopologyChange::TcmMachine>(bridge, port)
-          } {
-        // Nothing more to do
-    }
-
-    void TickEvent() {
-        static u8 idx;
-        for (idx = 0; idx < _kMaxMachines; ++idx) {
-            _machines[idx]->Run();
-        }
-    }
+namespace {
 
-private:
-    static constexpr u8 _kMaxMachines = 10;
-    MachineH _machines[_kMaxMachines];
-};
+// The RSTP thread is woken up by every submitted request, so requests are processed at this
+// interval only if the thread has been busy meanwhile
+constexpr std::chrono::milliseconds kProcessRequestInterval{ 250 };
+/// @brief Time for which requests are processed at once, before the thread looks for due ticks
+constexpr std::chrono::milliseconds kRequestSliceBudget{ 5 };
+/// @brief The primary sends state at least on every tick, so silence for three ticks means it
+///        has hung
+constexpr u32 kStandbySilenceTimeoutMs = 3 * Time::DefaultTickIntervalMs;
+
+} // namespace
 
 class StpManager {
 public:
     static StpManager& Instance();
     Result StpBegin(Mac bridgeAddr, SystemH system);
-    void SubmitRequest(Uptr<Command> req);
+    /// @brief Keeps state received from the primary, then takes it over and runs as StpBegin()
+    Result StpStandby(Mac bridgeAddr, SystemH system, const std::string& path);
+    /// @param completion group notified once the request has been performed, might be nullptr
+    void SubmitRequest(Uptr<Command> req, CompletionGroup* completion = nullptr);
+    void GetRxFastPathCounters(u64& hits, u64& misses) const noexcept;
+    Result GetEngineStats(EngineStats& stats) const;
+    Result GetPortStats(const u16 portNo, PortStats& stats) const;
+    Result GetAllPortStats(std::map<u16, PortStats>& stats) const;
+    Result GetLatencyReport(LatencyReport& report) const;
+    Result GetRequestStats(RequestStats& stats) const;
+    Result StartTrace(const u32 capacity, const bool stateSpans);
+    Result StopTrace();
+    Result ExportTrace(std::ostream& out) const;
+    Result GetBridgeSnapshot(BridgeSnapshot& snapshot) const;
+    Result GetPortSnapshot(const u16 portNo, PortSnapshot& snapshot) const;
+    Result GetBridgeConfig(BridgeConfig& config) const;
+    void SetBridgeAddress(const Mac& bridgeAddr) noexcept;
+    u64 BridgeAddress() const noexcept;
+    void SetClock(Clock* clock) noexcept;
+    /// @return Time of the clock of the RSTP, Clock::Duration::min() if it has not started yet
+    Clock::Duration Now() const noexcept;
+    void SetIngressDecode(const bool enable) noexcept;
+    bool IngressDecode() const noexcept;
+    BpduPolicer& Policer() noexcept;
 
 protected:
     StpManager() = default;
 
 private:
-    void AddPortHandle(AddPortReq& req);
-    void RemovePortHandle(RemovePortReq& req);
-    void ProcessBpduHandle(ProcessBpduReq& req);
-    void SetLogSeverity(SetLogSeverityReq& req);
+    Result AddPortHandle(AddPortReq& req);
+    Result RemovePortHandle(RemovePortReq& req);
+    Result ProcessBpduHandle(ProcessBpduReq& req);
+    Result ProcessDecodedBpduHandle(ProcessDecodedBpduReq& req);
+    Result SetLogSeverity(SetLogSeverityReq& req);
+    Result SetPortAttributeHandle(SetPortAttributeReq& req);
+    Result SetBridgeConfigHandle(SetBridgeConfigReq& req);
+    Result SetPortsEnabledHandle(SetPortsEnabledReq& req);
+    Result AddPortsHandle(AddPortsReq& req);
+    Result RemovePortsHandle(RemovePortsReq& req);
+    Result StateImageHandle(StateImageReq& req);
+    void AddPolicerStats(const u16 portNo, PortStats& stats) const noexcept;
+    /// @brief Allocates buckets of the policer for all ports of the engine
+    void AddPolicedPorts();
+    /// @brief Runs the engine until the end of the process
+    Result Run(SystemH system);
     void RunStateMachine();
-    void ProcessRequest();
-    BridgeH _bridge;
-    std::queue<Uptr<Command>> _userRequests;
-    std::mutex _mtxUserRequests;
-    std::map<u16, StateMachine> _runningStateMachines;
+    /// @return true if requests are left, since the deadline has been reached
+    bool ProcessRequest(const Clock& clock, const Clock::Duration deadline);
+    Result HandleRequest(Command& req);
+    /// @brief Runs state machines at the time and again after interval of ticks of the engine
+    void ScheduleStateMachine(Scheduler& scheduler, const Clock::Duration time);
+    /// @brief Processes requests at the time and again after interval of processing of requests
+    void ScheduleRequests(Scheduler& scheduler, const Clock::Duration time);
+    void AccountTick(const Clock::Duration lateness) noexcept;
+    EngineH _engine;
+    std::atomic<bool> _engineReady{ false };
+    BudgetedQueue<Uptr<Command>> _userRequests;
+    /// @brief Notified by every submitted request, so the RSTP thread picks it up at once
+    Wakeup _requestSubmitted;
+    /// @brief Written and read only by the RSTP thread
+    Scheduler::TaskId _requestsTask{ 0 };
+    /// @brief Written and read only by the RSTP thread
+    Clock::Duration _nextTickTime{ Clock::Duration::max() };
+    std::atomic<u64> _ticks{ 0 };
+    std::atomic<u64> _tickOverruns{ 0 };
+    std::atomic<u64> _maxTickLatenessNs{ 0 };
+    std::atomic<u64> _bridgeAddr{ 0 };
+    std::atomic<Clock*> _clock{ nullptr }; ///< Owned by the system passed to StpBegin()
+    std::atomic<bool> _ingressDecode{ false };
+    BpduPolicer _policer;
 };
 
 StpManager& StpManager::Instance() {
@@ -88,182 +117,830 @@ StpManager& StpManager::Instance() {
 }
 
 Result StpManager::StpBegin(Mac bridgeAddr, SystemH system) {
-    _bridge = std::make_shared<Bridge>(system);
-    _bridge->SetAddress(bridgeAddr);
-    _bridge->GetBridgeIdentifier().SetAddress(bridgeAddr);
-    _bridge->GetBridgePriority().GetRootPathCost().SetPathCost(0);
-    _bridge->GetBridgePriority().SetDesignatedBridgeId(_bridge->BridgeIdentifier());
-    _bridge->SetRootPriority(_bridge->BridgePriority());
-    _bridge->SetBegin(true);
-
-    using namespace std::chrono_literals;
-    using MiliSec = std::chrono::milliseconds;
-    std::chrono::milliseconds sleepTime {};
-    constexpr MiliSec kSleepTime250ms { 250 };
-    constexpr u16 kMaxSleepCounterToRunStateMachine = { 4 }; // 4 * 250ms = 1s interval for run SM
-    u16 sleepCounter250ms = {};
-    std::chrono::milliseconds startProcessReq {};
-    std::chrono::duration<s64, std::milli> elapsedTimeForProcessReq {};
-    auto now = []() {
-        auto actualTime = std::chrono::high_resolution_clock::now();
-        return std::chrono::time_point_cast<std::chrono::milliseconds>(actualTime).time_since_epoch();
-    };
-
-    while (true) {
-        ++sleepCounter250ms;
-        if (kMaxSleepCounterToRunStateMachine == sleepCounter250ms) {
-            RunStateMachine();
-            sleepCounter250ms = 0;
-        }
+    _engine = std::make_unique<Engine>(bridgeAddr, system);
+
+    return Run(system);
+}
 
-        startProcessReq = now();
-        ProcessRequest();
-        elapsedTimeForProcessReq = now() - startProcessReq;
-        sleepTime = kSleepTime250ms - elapsedTimeForProcessReq;
-        if (sleepTime.count() > 0) {
-            std::this_thread::sleep_for(sleepTime);
+Result StpManager::StpStandby(Mac bridgeAddr, SystemH system, const std::string& path) {
+    Replica replica{};
+    ReplicationChannel channel{};
+    ByteStream frame{};
+    Clock::Duration lastFrameTime = system->Clock->Now();
+    bool reconnect = true;
+    while (reconnect && not Failed(channel.Connect(path))) {
+        reconnect = false;
+        while (not Failed(channel.Receive(frame, kStandbySilenceTimeoutMs))) {
+            if (Failed(replica.Apply(frame))) {
+                // The primary sends whole state again to the standby which connects again
+                reconnect = true;
+                break;
+            }
+
+            lastFrameTime = system->Clock->Now();
         }
     }
 
+    channel.Close();
+    _engine = std::make_unique<Engine>(bridgeAddr, system);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                system->Clock->Now() - lastFrameTime);
+    // If nothing has been received, ports are added by the user as after cold start
+    std::ignore = _engine->TakeOver(replica, static_cast<u32>(elapsed.count()));
+    AddPolicedPorts();
+
+    return Run(system);
+}
+
+Result StpManager::Run(SystemH system) {
+    _engineReady.store(true, std::memory_order_release);
+
+    Scheduler scheduler{ system->Clock };
+    const Clock::Duration start = system->Clock->Now();
+    // State machines are scheduled first, so they run before requests due at the same time
+    ScheduleStateMachine(scheduler, start + std::chrono::milliseconds{ _engine->TickIntervalMs() });
+    ScheduleRequests(scheduler, start + kProcessRequestInterval);
+    scheduler.SetWakeup(_requestSubmitted, [this, &scheduler]() {
+        // Requests are processed now instead of at their scheduled time
+        scheduler.Cancel(_requestsTask);
+        ScheduleRequests(scheduler, scheduler.ClockInstance().Now());
+    });
+
+    while (scheduler.RunNext()) {
+        // Scheduler waits for the next task on its own
+    }
+
     return Result::Success;
 }
 
-void StpManager::SubmitRequest(Uptr<Command> req) {
-    std::lock_guard<std::mutex> requestsGuard{ _mtxUserRequests };
-    _userRequests.push(std::move(req));
+void StpManager::SubmitRequest(Uptr<Command> req, CompletionGroup* completion) {
+    req->SetCompletion(completion);
+    _userRequests.Push(std::move(req));
+    _requestSubmitted.Notify();
 }
 
-inline void StpManager::RunStateMachine() {
-    for (auto& sm : _runningStateMachines) {
-        sm.second.TickEvent();
+void StpManager::GetRxFastPathCounters(u64& hits, u64& misses) const noexcept {
+    hits = 0;
+    misses = 0;
+    if (_engineReady.load(std::memory_order_acquire)) {
+        _engine->GetRxFastPathCounters(hits, misses);
     }
 }
 
-void StpManager::ProcessRequest() {
-    Uptr<Command> req{}; // Represents single client request to perform
-    std::unique_lock<std::mutex> requestsGuard{ _mtxUserRequests, std::defer_lock };
+Result StpManager::GetEngineStats(EngineStats& stats) const {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
 
-    while (true) {
-        requestsGuard.lock();
-        if (_userRequests.empty()) {
-            requestsGuard.unlock();
-            return;
-        }
+    return _engine->GetStats(stats);
+}
 
-        req.reset(_userRequests.front().release());
-        _userRequests.pop();
-        requestsGuard.unlock();
+Result StpManager::GetRequestStats(RequestStats& stats) const {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
 
-        switch (req->Id()) {
-        case RequestId::AddPort:
-            StpManager::AddPortHandle(dynamic_cast<AddPortReq&>(*req));
-            break;
-        case RequestId::RemovePort:
-            StpManager::RemovePortHandle(dynamic_cast<RemovePortReq&>(*req));
-            break;
-        case RequestId::ProcessBpdu:
-            StpManager::ProcessBpduHandle(dynamic_cast<ProcessBpduReq&>(*req));
-            break;
-        case RequestId::SetLogSeverity:
-            StpManager::SetLogSeverity(dynamic_cast<SetLogSeverityReq&>(*req));
-            break;
-        default:
-            break; // Unhandled user request
-        }
+    stats.QueueDepth = _userRequests.Depth();
+    stats.QueueHighWater = _userRequests.HighWater();
+    stats.Processed = _userRequests.Handled();
+    stats.DeferredSlices = _userRequests.Deferred();
+    stats.Ticks = _ticks.load(std::memory_order_relaxed);
+    stats.TickOverruns = _tickOverruns.load(std::memory_order_relaxed);
+    stats.MaxTickLatenessUs = _maxTickLatenessNs.load(std::memory_order_relaxed) / 1000;
+
+    return Result::Success;
+}
+
+Result StpManager::GetPortStats(const u16 portNo, PortStats& stats) const {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
+
+    if (Failed(_engine->GetPortStats(portNo, stats))) {
+        return Result::Fail;
+    }
 
-        req.reset();
+    AddPolicerStats(portNo, stats);
+
+    return Result::Success;
+}
+
+Result StpManager::GetAllPortStats(std::map<u16, PortStats>& stats) const {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
+
+    _engine->GetAllPortStats(stats);
+    for (auto& portStats : stats) {
+        AddPolicerStats(portStats.first, portStats.second);
     }
+
+    return Result::Success;
 }
 
-void StpManager::AddPortHandle(AddPortReq& req) {
-    if (_bridge->GetPort(req.GetPortNo())) {
-        return;
+Result StpManager::GetLatencyReport(LatencyReport& report) const {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
+
+    _engine->GetLatencyReport(report);
+
+    return Result::Success;
+}
+
+Result StpManager::StartTrace(const u32 capacity, const bool stateSpans) {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
+
+    return _engine->StartTrace(capacity, stateSpans);
+}
+
+Result StpManager::StopTrace() {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
+
+    _engine->StopTrace();
+
+    return Result::Success;
+}
+
+Result StpManager::ExportTrace(std::ostream& out) const {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
     }
 
-    _bridge->AddPort(req.GetPortNo());
-    PortH newPort = _bridge->GetPort(req.GetPortNo());
-    newPort->SetPortEnabled(req.GetPortEnabled());
-    newPort->GetPortPathCost().SetPathCost(PathCost::SpeedMbToPathCostValue(req.GetPortSpeed()));
-    newPort->GetPortId().SetPortNum(req.GetPortNo());
-    newPort->GetPortId().SetPriority(+PriorityVector::RecommendedPortPriority::Value);
-    _runningStateMachines.insert(std::make_pair(req.GetPortNo(),
-                                                StateMachine{ _bridge, newPort }));
+    _engine->WriteTrace(out);
+
+    return Result::Success;
 }
 
-void StpManager::RemovePortHandle(RemovePortReq& req) {
-    _runningStateMachines.erase(req.GetPortNo());
-    _bridge->RemovePort(req.GetPortNo());
+Result StpManager::GetBridgeSnapshot(BridgeSnapshot& snapshot) const {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
+
+    snapshot = *_engine->ReadSnapshot();
+
+    return Result::Success;
 }
 
-void StpManager::ProcessBpduHandle(ProcessBpduReq& req) {
-    PortH port = _bridge->GetPort(req.GetRxPortNo());
+Result StpManager::GetPortSnapshot(const u16 portNo, PortSnapshot& snapshot) const {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
+
+    const auto bridgeSnapshot = _engine->ReadSnapshot();
+    const PortSnapshot* const port = bridgeSnapshot->FindPort(portNo);
     if (not port) {
-        // Received BPDU data from not register port in STP process
-        return;
+        return Result::Fail;
     }
 
-    Bpdu bpdu{};
-    if (Failed(bpdu.Decode(req.GetBpduData()))) {
-        return;
+    snapshot = *port;
+
+    return Result::Success;
+}
+
+Result StpManager::GetBridgeConfig(BridgeConfig& config) const {
+    if (not _engineReady.load(std::memory_order_acquire)) {
+        return Result::Fail;
+    }
+
+    config = _engine->ReadSnapshot()->Config;
+
+    return Result::Success;
+}
+
+void StpManager::SetClock(Clock* clock) noexcept {
+    _clock.store(clock, std::memory_order_release);
+}
+
+Clock::Duration StpManager::Now() const noexcept {
+    const Clock* const clock = _clock.load(std::memory_order_acquire);
+    return clock ? clock->Now() : Clock::Duration::min();
+}
+
+void StpManager::SetBridgeAddress(const Mac& bridgeAddr) noexcept {
+    _bridgeAddr.store(bridgeAddr.ConvertToInteger(), std::memory_order_release);
+}
+
+u64 StpManager::BridgeAddress() const noexcept {
+    return _bridgeAddr.load(std::memory_order_acquire);
+}
+
+void StpManager::SetIngressDecode(const bool enable) noexcept {
+    _ingressDecode.store(enable, std::memory_order_relaxed);
+}
+
+bool StpManager::IngressDecode() const noexcept {
+    return _ingressDecode.load(std::memory_order_relaxed);
+}
+
+BpduPolicer& StpManager::Policer() noexcept {
+    return _policer;
+}
+
+void StpManager::AddPolicerStats(const u16 portNo, PortStats& stats) const noexcept {
+    // BPDUs are policed before they reach the RSTP, so the policer counts them on its own
+    stats.Dropped[static_cast<u8>(BpduDropReason::Policed)] = _policer.Dropped(portNo);
+    // BPDUs which fail to decode on ingress are counted together with ones decoded by the RSTP
+    for (const BpduDropReason reason : { BpduDropReason::Malformed, BpduDropReason::Looped }) {
+        stats.Dropped[static_cast<u8>(reason)] += _policer.DecodeDropped(portNo, reason);
     }
+    stats.ErrDisabled = _policer.ErrDisabled(portNo);
+}
+
+void StpManager::AddPolicedPorts() {
+    for (const PortSnapshot& port : _engine->ReadSnapshot()->Ports) {
+        _policer.AddPort(port.PortNo);
+    }
+}
+
+inline void StpManager::RunStateMachine() {
+    _engine->Tick();
+}
 
-    if (Bpdu::Type::Config == bpdu.BpduType()) {
-        if ((PortId{ bpdu.PortIdentifier() }.PortNum() == req.GetRxPortNo())
-                                        &&
-            (BridgeId{ bpdu.BridgeIdentifier() }.Address() == _bridge->Address())) {
-            // BPDU has been received by port which originally transmitted it...
-            // so it's invalid BPDU
+void StpManager::ScheduleStateMachine(Scheduler& scheduler, const Clock::Duration time) {
+    _nextTickTime = time;
+    // Interval is read after every tick, since fast hello might be configured meanwhile
+    scheduler.ScheduleAt(time, [this, &scheduler, time]() {
+        AccountTick(scheduler.ClockInstance().Now() - time);
+        RunStateMachine();
+        // Ticks which are late run one after another, so timers count all of them
+        ScheduleStateMachine(scheduler,
+                             time + std::chrono::milliseconds{ _engine->TickIntervalMs() });
+    });
+}
+
+void StpManager::ScheduleRequests(Scheduler& scheduler, const Clock::Duration time) {
+    _requestsTask = scheduler.ScheduleAt(time, [this, &scheduler, time]() {
+        const Clock& clock = scheduler.ClockInstance();
+        const Clock::Duration now = clock.Now();
+        // The slice ends before the tick which is due, so requests never delay it
+        if (ProcessRequest(clock, std::min(now + kRequestSliceBudget, _nextTickTime))) {
+            // The tick which is due has earlier time, so it runs before the next slice
+            ScheduleRequests(scheduler, std::max(clock.Now(), time));
             return;
         }
+
+        ScheduleRequests(scheduler, time + kProcessRequestInterval);
+    });
+}
+
+void StpManager::AccountTick(const Clock::Duration lateness) noexcept {
+    _ticks.fetch_add(1, std::memory_order_relaxed);
+    // The tick which runs later than the next one was due has been overrun
+    if (lateness >= std::chrono::milliseconds{ _engine->TickIntervalMs() }) {
+        _tickOverruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const u64 latenessNs = static_cast<u64>(std::max(lateness, Clock::Duration::zero()).count());
+
+    if (latenessNs > _maxTickLatenessNs.load(std::memory_order_relaxed)) {
+        _maxTickLatenessNs.store(latenessNs, std::memory_order_relaxed);
+    }
+}
+
+bool StpManager::ProcessRequest(const Clock& clock, const Clock::Duration deadline) {
+    return _userRequests.Drain(clock, deadline, [this](Uptr<Command> req) {
+        req->Complete(HandleRequest(*req));
+    });
+}
+
+Result StpManager::HandleRequest(Command& req) {
+    switch (req.Id()) {
+    case RequestId::AddPort:
+        return StpManager::AddPortHandle(dynamic_cast<AddPortReq&>(req));
+    case RequestId::RemovePort:
+        return StpManager::RemovePortHandle(dynamic_cast<RemovePortReq&>(req));
+    case RequestId::ProcessBpdu:
+        return StpManager::ProcessBpduHandle(dynamic_cast<ProcessBpduReq&>(req));
+    case RequestId::ProcessDecodedBpdu:
+        return StpManager::ProcessDecodedBpduHandle(dynamic_cast<ProcessDecodedBpduReq&>(req));
+    case RequestId::SetLogSeverity:
+        return StpManager::SetLogSeverity(dynamic_cast<SetLogSeverityReq&>(req));
+    case RequestId::SetPortAttribute:
+        return StpManager::SetPortAttributeHandle(dynamic_cast<SetPortAttributeReq&>(req));
+    case RequestId::SetBridgeConfig:
+        return StpManager::SetBridgeConfigHandle(dynamic_cast<SetBridgeConfigReq&>(req));
+    case RequestId::SetPortsEnabled:
+        return StpManager::SetPortsEnabledHandle(dynamic_cast<SetPortsEnabledReq&>(req));
+    case RequestId::AddPorts:
+        return StpManager::AddPortsHandle(dynamic_cast<AddPortsReq&>(req));
+    case RequestId::RemovePorts:
+        return StpManager::RemovePortsHandle(dynamic_cast<RemovePortsReq&>(req));
+    case RequestId::RestoreStateImage:
+    case RequestId::StartStateImage:
+    case RequestId::StartReplication:
+        return StpManager::StateImageHandle(dynamic_cast<StateImageReq&>(req));
+    default:
+        break; // Unhandled user request
+    }
+
+    return Result::Fail;
+}
+
+Result StpManager::AddPortHandle(AddPortReq& req) {
+    if (Failed(_engine->AddPort(req.GetPortNo(), req.GetPortSpeed(), req.GetPortEnabled()))) {
+        return Result::Fail;
+    }
+
+    _policer.AddPort(req.GetPortNo());
+
+    return Result::Success;
+}
+
+Result StpManager::RemovePortHandle(RemovePortReq& req) {
+    return _engine->RemovePort(req.GetPortNo());
+}
+
+Result StpManager::ProcessBpduHandle(ProcessBpduReq& req) {
+    return _engine->ProcessBpdu(req.GetRxPortNo(), req.GetBpduData(), req.GetIngressTime());
+}
+
+Result StpManager::ProcessDecodedBpduHandle(ProcessDecodedBpduReq& req) {
+    return _engine->ProcessDecodedBpdu(req.GetRxPortNo(), req.GetBpdu(), req.GetFingerprint(),
+                                       req.GetIngressTime());
+}
+
+inline Result StpManager::SetLogSeverity(SetLogSeverityReq& req) {
+    _engine->SetLogSeverity(req.GetLogSeverity());
+    return Result::Success;
+}
+
+Result StpManager::SetPortAttributeHandle(SetPortAttributeReq& req) {
+    switch (req.GetAttribute()) {
+    case PortAttribute::AdminEdge:
+        return _engine->SetPortAdminEdge(req.GetPortNo(), 0 != req.GetValue());
+    case PortAttribute::AutoEdge:
+        return _engine->SetPortAutoEdge(req.GetPortNo(), 0 != req.GetValue());
+    case PortAttribute::PointToPoint:
+        return _engine->SetPortPointToPoint(req.GetPortNo(), 0 != req.GetValue());
+    case PortAttribute::Priority:
+        return _engine->SetPortPriority(req.GetPortNo(), req.GetValue());
+    case PortAttribute::PathCost:
+        return _engine->SetPortPathCost(req.GetPortNo(), req.GetValue());
+    case PortAttribute::FastHelloTime:
+        return _engine->SetPortFastHello(req.GetPortNo(), req.GetValue());
+    default:
+        return Result::Fail;
+    }
+}
+
+Result StpManager::SetBridgeConfigHandle(SetBridgeConfigReq& req) {
+    return _engine->SetBridgeConfig(req.GetConfig());
+}
+
+Result StpManager::SetPortsEnabledHandle(SetPortsEnabledReq& req) {
+    return _engine->SetPortsEnabled(req.GetPortNos(), req.GetEnabled());
+}
+
+Result StpManager::AddPortsHandle(AddPortsReq& req) {
+    if (Failed(_engine->AddPorts(req.GetPorts()))) {
+        return Result::Fail;
     }
 
-    port->SetRxBpdu(bpdu);
-    port->SetRcvdBpdu(true);
+    for (const PortSpec& spec : req.GetPorts()) {
+        _policer.AddPort(spec.PortNo);
+    }
+
+    return Result::Success;
+}
+
+Result StpManager::RemovePortsHandle(RemovePortsReq& req) {
+    return _engine->RemovePorts(req.GetPortNos());
 }
 
-inline void StpManager::SetLogSeverity(SetLogSeverityReq& req) {
-    _bridge->SetSystemLogSeverity(req.GetLogSeverity());
+Result StpManager::StateImageHandle(StateImageReq& req) {
+    switch (req.Id()) {
+    case RequestId::RestoreStateImage:
+        if (Failed(_engine->RestoreStateImage(req.GetPath()))) {
+            return Result::Fail;
+        }
+
+        AddPolicedPorts();
+        return Result::Success;
+    case RequestId::StartReplication:
+        return _engine->StartReplication(req.GetPath());
+    default:
+        return _engine->StartStateImage(req.GetPath());
+    }
 }
 
 namespace Stp {
 
+namespace {
+
+/// @brief Starts the RSTP thread, which might be started only once
+Result RunInBackground(const Mac& bridgeAddr, SystemH system, std::function<Result()> run) {
+    static std::unique_ptr<std::future<Result>> runnableStp;
+
+    if (not runnableStp) {
+        StpManager::Instance().SetBridgeAddress(bridgeAddr);
+        StpManager::Instance().SetClock(system->Clock.get());
+        runnableStp.reset(new std::future<Result>{
+                              std::async(std::launch::async, std::move(run))
+                          });
+    }
+    else {
+        return  Result::Fail;
+    }
+
+    return Result::Success;
+}
+
+/// @brief Ports enabled by the user pass BPDUs again, even if they have been err-disabled
+void ClearErrDisabled(const std::vector<u16>& portNos, const bool enabled) noexcept {
+    if (not enabled) {
+        return;
+    }
+
+    for (const u16 portNo : portNos) {
+        StpManager::Instance().Policer().ClearErrDisabled(portNo);
+    }
+}
+
+Result SubmitBpdu(const u16 rxPortNo, ByteStreamH bpdu, CompletionGroup* completion) {
+    StpManager& manager = StpManager::Instance();
+    const Clock::Duration ingressTime = manager.Now();
+    // BPDUs are policed before queuing, so the RSTP handles bounded number of them however many
+    // are offered. Until the RSTP has started, they just wait in the queue.
+    if (Clock::Duration::min() != ingressTime) {
+        switch (manager.Policer().Police(rxPortNo, ingressTime)) {
+        case BpduPolicer::Verdict::ErrDisable:
+            manager.SubmitRequest(std::make_unique<SetPortsEnabledReq>(
+                                      std::vector<u16>{ rxPortNo }, false));
+            return Result::Fail;
+        case BpduPolicer::Verdict::Drop:
+            return Result::Fail;
+        default:
+            break;
+        }
+    }
+
+    if (not manager.IngressDecode()) {
+        manager.SubmitRequest(std::make_unique<ProcessBpduReq>(rxPortNo, bpdu, ingressTime),
+                              completion);
+        return Result::Success;
+    }
+
+    Bpdu decodedBpdu{};
+    BpduDropReason reason = BpduDropReason::Malformed;
+    if (Failed(Engine::DecodeBpdu(*bpdu, rxPortNo, manager.BridgeAddress(), decodedBpdu,
+                                  reason))) {
+        // Statistics of ports are written only by the RSTP thread, so the drop is counted
+        // aside and merged on read, as dropped by the policer
+        manager.Policer().CountDecodeDrop(rxPortNo, reason);
+        return Result::Fail;
+    }
+
+    BpduFingerprint fingerprint{};
+    fingerprint.Assign(*bpdu);
+    manager.SubmitRequest(std::make_unique<ProcessDecodedBpduReq>(rxPortNo, decodedBpdu,
+                                                                  fingerprint, ingressTime),
+                          completion);
+    return Result::Success;
+}
+
+} // namespace
+
 Result Management::AddPort(const u16 portNo, const u32 speed, const bool enabled) {
     StpManager::Instance().SubmitRequest(
                 std::make_unique<AddPortReq>(AddPortReq{portNo, speed, enabled}));
     return Result::Success;
 }
 
+Result Management::AddPort(const u16 portNo, const u32 speed, const bool enabled,
+                           CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<AddPortReq>(AddPortReq{portNo, speed, enabled}), &completion);
+    return Result::Success;
+}
+
 Result Management::RemovePort(const u16 portNo) {
     StpManager::Instance().SubmitRequest(std::make_unique<RemovePortReq>(RemovePortReq{ portNo }));
     return Result::Success;
 }
 
+Result Management::RemovePort(const u16 portNo, CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(std::make_unique<RemovePortReq>(RemovePortReq{ portNo }),
+                                         &completion);
+    return Result::Success;
+}
+
+Result Management::AddPorts(const std::vector<PortSpec>& ports) {
+    StpManager::Instance().SubmitRequest(std::make_unique<AddPortsReq>(ports));
+    return Result::Success;
+}
+
+Result Management::AddPorts(const std::vector<PortSpec>& ports, CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(std::make_unique<AddPortsReq>(ports), &completion);
+    return Result::Success;
+}
+
+Result Management::RemovePorts(const std::vector<u16>& portNos) {
+    StpManager::Instance().SubmitRequest(std::make_unique<RemovePortsReq>(portNos));
+    return Result::Success;
+}
+
+Result Management::RemovePorts(const std::vector<u16>& portNos, CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(std::make_unique<RemovePortsReq>(portNos), &completion);
+    return Result::Success;
+}
+
+Result Management::RestoreStateImage(const std::string& path) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<StateImageReq>(RequestId::RestoreStateImage, path));
+    return Result::Success;
+}
+
+Result Management::RestoreStateImage(const std::string& path, CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<StateImageReq>(RequestId::RestoreStateImage, path), &completion);
+    return Result::Success;
+}
+
+Result Management::StartStateImage(const std::string& path) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<StateImageReq>(RequestId::StartStateImage, path));
+    return Result::Success;
+}
+
+Result Management::StartStateImage(const std::string& path, CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<StateImageReq>(RequestId::StartStateImage, path), &completion);
+    return Result::Success;
+}
+
+Result Management::StartReplication(const std::string& path) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<StateImageReq>(RequestId::StartReplication, path));
+    return Result::Success;
+}
+
+Result Management::StartReplication(const std::string& path, CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<StateImageReq>(RequestId::StartReplication, path), &completion);
+    return Result::Success;
+}
+
 Result Management::ProcessBpdu(const u16 rxPortNo, ByteStreamH bpdu) {
+    return SubmitBpdu(rxPortNo, bpdu, nullptr);
+}
+
+Result Management::ProcessBpdu(const u16 rxPortNo, ByteStreamH bpdu,
+                               CompletionGroup& completion) {
+    return SubmitBpdu(rxPortNo, bpdu, &completion);
+}
+
+Result Management::SetPortEnabled(const u16 portNo, const bool enabled) {
+    ClearErrDisabled({ portNo }, enabled);
     StpManager::Instance().SubmitRequest(
-                std::make_unique<ProcessBpduReq>(ProcessBpduReq{ rxPortNo, bpdu }));
+                std::make_unique<SetPortsEnabledReq>(std::vector<u16>{ portNo }, enabled));
     return Result::Success;
 }
 
-Result Management::SetLogSeverity(const LoggingSystem::Logger::LogSeverity logSeverity) {
+Result Management::SetPortEnabled(const u16 portNo, const bool enabled,
+                                  CompletionGroup& completion) {
+    ClearErrDisabled({ portNo }, enabled);
     StpManager::Instance().SubmitRequest(
-                std::make_unique<SetLogSeverityReq>(SetLogSeverityReq{ logSeverity }));
+                std::make_unique<SetPortsEnabledReq>(std::vector<u16>{ portNo }, enabled),
+                &completion);
     return Result::Success;
 }
 
-Result Management::RunStp(Mac bridgeAddr, SystemH system) {
-    static std::unique_ptr<std::future<Result>> runnableStp;
+Result Management::SetPortsEnabled(const std::vector<u16>& portNos, const bool enabled) {
+    ClearErrDisabled(portNos, enabled);
+    StpManager::Instance().SubmitRequest(std::make_unique<SetPortsEnabledReq>(portNos, enabled));
+    return Result::Success;
+}
 
-    if (not runnableStp) {
-        runnableStp.reset(new std::future<Result>{
-                              std::async(std::launch::async, &StpManager::StpBegin,
-                              &StpManager::Instance(), bridgeAddr, system)
-                          });
+Result Management::SetPortsEnabled(const std::vector<u16>& portNos, const bool enabled,
+                                   CompletionGroup& completion) {
+    ClearErrDisabled(portNos, enabled);
+    StpManager::Instance().SubmitRequest(std::make_unique<SetPortsEnabledReq>(portNos, enabled),
+                                         &completion);
+    return Result::Success;
+}
+
+Result Management::SetPortAdminEdge(const u16 portNo, const bool adminEdge) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::AdminEdge, adminEdge));
+    return Result::Success;
+}
+
+Result Management::SetPortAdminEdge(const u16 portNo, const bool adminEdge,
+                                    CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::AdminEdge, adminEdge),
+                &completion);
+    return Result::Success;
+}
+
+Result Management::SetPortAutoEdge(const u16 portNo, const bool autoEdge) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::AutoEdge, autoEdge));
+    return Result::Success;
+}
+
+Result Management::SetPortAutoEdge(const u16 portNo, const bool autoEdge,
+                                   CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::AutoEdge, autoEdge),
+                &completion);
+    return Result::Success;
+}
+
+Result Management::SetPortPointToPoint(const u16 portNo, const bool pointToPoint) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::PointToPoint,
+                                                      pointToPoint));
+    return Result::Success;
+}
+
+Result Management::SetPortPointToPoint(const u16 portNo, const bool pointToPoint,
+                                       CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::PointToPoint,
+                                                      pointToPoint),
+                &completion);
+    return Result::Success;
+}
+
+Result Management::SetPortPriority(const u16 portNo, const u32 priority) {
+    if (Failed(PortConfig::ValidatePriority(priority))) {
+        return Result::Fail;
     }
-    else {
-        return  Result::Fail;
+
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::Priority, priority));
+    return Result::Success;
+}
+
+Result Management::SetPortPriority(const u16 portNo, const u32 priority,
+                                   CompletionGroup& completion) {
+    if (Failed(PortConfig::ValidatePriority(priority))) {
+        return Result::Fail;
+    }
+
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::Priority, priority),
+                &completion);
+    return Result::Success;
+}
+
+Result Management::SetPortPathCost(const u16 portNo, const u32 pathCost) {
+    if (Failed(PortConfig::ValidatePathCost(pathCost))) {
+        return Result::Fail;
+    }
+
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::PathCost, pathCost));
+    return Result::Success;
+}
+
+Result Management::SetPortPathCost(const u16 portNo, const u32 pathCost,
+                                   CompletionGroup& completion) {
+    if (Failed(PortConfig::ValidatePathCost(pathCost))) {
+        return Result::Fail;
+    }
+
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::PathCost, pathCost),
+                &completion);
+    return Result::Success;
+}
+
+Result Management::SetPortFastHello(const u16 portNo, const u32 helloTimeMs) {
+    if (Failed(PortConfig::ValidateFastHelloTime(helloTimeMs))) {
+        return Result::Fail;
+    }
+
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::FastHelloTime,
+                                                      helloTimeMs));
+    return Result::Success;
+}
+
+Result Management::SetPortFastHello(const u16 portNo, const u32 helloTimeMs,
+                                    CompletionGroup& completion) {
+    if (Failed(PortConfig::ValidateFastHelloTime(helloTimeMs))) {
+        return Result::Fail;
+    }
+
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetPortAttributeReq>(portNo, PortAttribute::FastHelloTime,
+                                                      helloTimeMs), &completion);
+    return Result::Success;
+}
+
+Result Management::SetBridgeConfig(const BridgeConfig& config) {
+    if (Failed(config.Validate())) {
+        return Result::Fail;
     }
 
+    StpManager::Instance().SubmitRequest(std::make_unique<SetBridgeConfigReq>(config));
+    return Result::Success;
+}
+
+Result Management::SetBridgeConfig(const BridgeConfig& config, CompletionGroup& completion) {
+    if (Failed(config.Validate())) {
+        return Result::Fail;
+    }
+
+    StpManager::Instance().SubmitRequest(std::make_unique<SetBridgeConfigReq>(config),
+                                         &completion);
+    return Result::Success;
+}
+
+Result Management::GetBridgeConfig(BridgeConfig& config) {
+    return StpManager::Instance().GetBridgeConfig(config);
+}
+
+Result Management::SetIngressDecode(const bool enable) {
+    StpManager::Instance().SetIngressDecode(enable);
+    return Result::Success;
+}
+
+Result Management::SetBpduPolicer(const BpduPolicerConfig& config) {
+    return StpManager::Instance().Policer().Configure(config);
+}
+
+Result Management::GetBpduPolicer(BpduPolicerConfig& config) {
+    config = StpManager::Instance().Policer().Config();
+    return Result::Success;
+}
+
+Result Management::SetLogSeverity(const LoggingSystem::Logger::LogSeverity logSeverity) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetLogSeverityReq>(SetLogSeverityReq{ logSeverity }));
+    return Result::Success;
+}
+
+Result Management::SetLogSeverity(const LoggingSystem::Logger::LogSeverity logSeverity,
+                                  CompletionGroup& completion) {
+    StpManager::Instance().SubmitRequest(
+                std::make_unique<SetLogSeverityReq>(SetLogSeverityReq{ logSeverity }),
+                &completion);
     return Result::Success;
 }
 
+Result Management::GetRxFastPathCounters(u64& hits, u64& misses) {
+    StpManager::Instance().GetRxFastPathCounters(hits, misses);
+    return Result::Success;
+}
+
+Result Management::GetEngineStats(EngineStats& stats) {
+    return StpManager::Instance().GetEngineStats(stats);
+}
+
+Result Management::GetPortStats(const u16 portNo, PortStats& stats) {
+    return StpManager::Instance().GetPortStats(portNo, stats);
+}
+
+Result Management::GetAllPortStats(std::map<u16, PortStats>& stats) {
+    return StpManager::Instance().GetAllPortStats(stats);
+}
+
+Result Management::GetLatencyReport(LatencyReport& report) {
+    return StpManager::Instance().GetLatencyReport(report);
+}
+
+Result Management::GetRequestStats(RequestStats& stats) {
+    return StpManager::Instance().GetRequestStats(stats);
+}
+
+Result Management::StartTrace(const u32 capacity, const bool stateSpans) {
+    return StpManager::Instance().StartTrace(capacity, stateSpans);
+}
+
+Result Management::StopTrace() {
+    return StpManager::Instance().StopTrace();
+}
+
+Result Management::ExportTrace(std::ostream& out) {
+    return StpManager::Instance().ExportTrace(out);
+}
+
+Result Management::GetBridgeSnapshot(BridgeSnapshot& snapshot) {
+    return StpManager::Instance().GetBridgeSnapshot(snapshot);
+}
+
+Result Management::GetPortSnapshot(const u16 portNo, PortSnapshot& snapshot) {
+    return StpManager::Instance().GetPortSnapshot(portNo, snapshot);
+}
+
+Result Management::RunStp(Mac bridgeAddr, SystemH system) {
+    return RunInBackground(bridgeAddr, system, [bridgeAddr, system]() {
+        return StpManager::Instance().StpBegin(bridgeAddr, system);
+    });
+}
+
+Result Management::RunStandby(Mac bridgeAddr, SystemH system, const std::string& path) {
+    return RunInBackground(bridgeAddr, system, [bridgeAddr, system, path]() {
+        return StpManager::Instance().StpStandby(bridgeAddr, system, path);
+    });
+}
+
 } // namespace Stp
@@ -11,21 +11,25 @@
 namespace Stp {
 
 Port::Port() noexcept
-    : _ageingTime{ Bridge::AgeingTime }, _agree{ false }, _agreed{ false }, _dsgPriority{ },
-      _dsgTimes{ }, _disputed{ false }, _fdbFlush{ false }, _forward{ false },
-      _forwarding{ false }, _infoIs{ Info::Disabled }, _learn{ false }, _learning{ false },
-      _mcheck{ false }, _msgPriority{ }, _msgTimes{ }, _newInfo{ false }, _operEdge{ false },
-      _portEnabled{ false }, _portId{ }, _portPathCost{ }, _portPriority{ }, _portTimes{ },
-      _proposed{ false }, _proposing{ false }, _rcvdBpdu{ false }, _rcvdInfo{ RcvdInfo::OtherInfo },
-      _rcvdMsg{ false }, _rcvdRstp{ false }, _rcvdStp{ false }, _rcvdTc{ false },
-      _rcvdTcAck{ false }, _rcvdTcn{ false }, _reRoot{ false }, _reselect{ false },
-      _role{ PortRole::Disabled }, _selected{ false }, _selectedRole{ PortRole::Disabled },
+    : _dsgPriority{ }, _msgPriority{ }, _portPriority{ }, _dsgTimes{ }, _msgTimes{ },
+      _portTimes{ }, _smTimers{ }, _portPathCost{ }, _portId{ },
+      _ageingTime{ Time::FromSeconds(BridgeConfig::DefaultAgeingTime) }, _fastHelloTime{ 0 },
+      _txCountElapsedMs{ 0 }, _infoIs{ Info::Disabled },
+      _rcvdInfo{ RcvdInfo::OtherInfo }, _role{ PortRole::Disabled },
+      _selectedRole{ PortRole::Disabled }, _txCount{ +RecommendedValue::TransmitHoldCount },
+      _adminEdge{ false }, _agree{ false }, _agreed{ false }, _autoEdge{ true },
+      _disputed{ false }, _fdbFlush{ false }, _forward{ false }, _forwarding{ false },
+      _learn{ false }, _learning{ false }, _mcheck{ false }, _newInfo{ false },
+      _operEdge{ false }, _operPointToPointMAC{ false }, _portEnabled{ false },
+      _proposed{ false }, _proposing{ false }, _rcvdBpdu{ false }, _rcvdMsg{ false },
+      _rcvdRstp{ false }, _rcvdStp{ false }, _rcvdTc{ false }, _rcvdTcAck{ false },
+      _rcvdTcn{ false }, _reRoot{ false }, _reselect{ false }, _selected{ false },
       _sendRstp{ false }, _sync{ false }, _synced{ false }, _tcAck{ false }, _tcProp{ false },
-      _tick{ false }, _txCount{ +RecommendedValue::TransmitHoldCount }, _updtInfo{ false },
-      _rxBpdu{ }, _smTimers{  } {
-    _smTimers.SetEdgeDelayWhile(+Time::RecommendedValue::MigrateTime);
-    _smTimers.SetFdWhile(+Time::RecommendedValue::BridgeForwardDelay);
-    _smTimers.SetHelloWhen(+Time::RecommendedValue::BridgeHelloTime);
+      _tick{ false }, _updtInfo{ false }, _rxFastPath{ false }, _rxBpdu{ }, _rxFingerprint{ },
+      _rxIngressTime{ Clock::Duration::min() }, _stats{ } {
+    _smTimers.SetEdgeDelayWhile(Time::FromSeconds(+Time::RecommendedValue::MigrateTime));
+    _smTimers.SetFdWhile(Time::FromSeconds(+Time::RecommendedValue::BridgeForwardDelay));
+    _smTimers.SetHelloWhen(Time::FromSeconds(+Time::RecommendedValue::BridgeHelloTime));
 }
 
 } // namespace Rstp
@@ -70,6 +70,8 @@ void PimState::RepeatedDesignatedAction(Machine& machine) {
     SmProcedures::SetTcFlags(machine.PortInstance());
     SmProcedures::UpdtRcvdInfoWhile(machine.PortInstance());
     machine.PortInstance().SetRcvdMsg(false);
+    /// @note Next byte-identical BPDU may be handled without full decode
+    machine.PortInstance().SetRxFastPath(SmConditions::RxBpduCacheable(machine.PortInstance()));
 }
 
 void PimState::InferiorDesignatedAction(Machine& machine) {
@@ -93,6 +95,7 @@ void PimState::CurrentAction(Machine& machine) {
 
 void PimState::ReceiveAction(Machine& machine) {
     machine.PortInstance().SetRcvdInfo(SmConditions::RcvInfo(machine.PortInstance()));
+    machine.BridgeInstance().GetLatencyTracker().RecordRcvdInfo(machine.PortInstance());
 }
 
 bool PimState::GoToCurrent(Machine& machine) {
@@ -101,12 +104,31 @@ bool PimState::GoToCurrent(Machine& machine) {
 }
 
 void PimState::CurrentUctExecute(Machine& machine) {
-    if (GoToCurrent(machine)) {
+    if (Guard(machine, GoToCurrent(machine))) {
         CurrentAction(machine);
         ChangeState(machine, CurrentState::Instance());
     }
 }
 
+bool PimState::GoToDisabledFromAnyState(Machine& machine) {
+    if (machine.PortInstance().PortEnabled()) {
+        return false;
+    }
+
+    return Port::Info::Disabled != machine.PortInstance().InfoIs();
+}
+
+bool PimState::DisabledGlobalExecute(Machine& machine) {
+    if (not Guard(machine, GoToDisabledFromAnyState(machine))) {
+        return false;
+    }
+
+    DisabledAction(machine);
+    ChangeState(machine, DisabledState::Instance());
+
+    return true;
+}
+
 State& BeginState::Instance() {
     RETURN_STATE_SINGLETON_INSTANCE(BeginState);
 }
@@ -114,7 +136,7 @@ State& BeginState::Instance() {
 void BeginState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToDisabled(machine)) {
+    if (Guard(machine, GoToDisabled(machine))) {
         DisabledAction(machine);
         ChangeState(machine, DisabledState::Instance());
     }
@@ -125,14 +147,7 @@ bool BeginState::GoToDisabled(Machine& machine) {
         return true;
     }
 
-    if (machine.PortInstance().PortEnabled()) {
-        return false;
-    }
-    else if (Port::Info::Disabled == machine.PortInstance().InfoIs()) {
-        return false;
-    }
-
-    return true;
+    return GoToDisabledFromAnyState(machine);
 }
 
 State& DisabledState::Instance() {
@@ -142,7 +157,7 @@ State& DisabledState::Instance() {
 void DisabledState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToAged(machine)) {
+    if (Guard(machine, GoToAged(machine))) {
         AgedAction(machine);
         ChangeState(machine, AgedState::Instance());
     }
@@ -163,7 +178,11 @@ State& AgedState::Instance() {
 void AgedState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToUpdate(machine)) {
+    if (DisabledGlobalExecute(machine)) {
+        return;
+    }
+
+    if (Guard(machine, GoToUpdate(machine))) {
         UpdateAction(machine);
         ChangeState(machine, UpdateState::Instance());
     }
@@ -241,7 +260,20 @@ State& CurrentState::Instance() {
 void CurrentState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToReceive(machine)) {
+    // Other states either wait for the port to be enabled or move to CURRENT unconditionally
+    if (DisabledGlobalExecute(machine)) {
+        return;
+    }
+
+    if (Guard(machine, GoToUpdate(machine))) {
+        UpdateAction(machine);
+        ChangeState(machine, UpdateState::Instance());
+    }
+    else if (Guard(machine, GoToAged(machine))) {
+        AgedAction(machine);
+        ChangeState(machine, AgedState::Instance());
+    }
+    else if (Guard(machine, GoToReceive(machine))) {
         ReceiveAction(machine);
         ChangeState(machine, ReceiveState::Instance());
     }
@@ -293,23 +325,23 @@ State& ReceiveState::Instance() {
 void ReceiveState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToSuperiorDesignated(machine)) {
+    if (Guard(machine, GoToSuperiorDesignated(machine))) {
         SuperiorDesignatedAction(machine);
         ChangeState(machine, SuperiorDesignatedState::Instance());
     }
-    else if (GoToRepeatedDesignated(machine)) {
+    else if (Guard(machine, GoToRepeatedDesignated(machine))) {
         RepeatedDesignatedAction(machine);
         ChangeState(machine, RepeatedDesignatedState::Instance());
     }
-    else if (GoToInferiorDesignated(machine)) {
+    else if (Guard(machine, GoToInferiorDesignated(machine))) {
         InferiorDesignatedAction(machine);
         ChangeState(machine, InferiorDesignatedState::Instance());
     }
-    else if (GoToNotDesignated(machine)) {
+    else if (Guard(machine, GoToNotDesignated(machine))) {
         NotDesignatedAction(machine);
         ChangeState(machine, NotDesignatedState::Instance());
     }
-    else if (GoToOther(machine)) {
+    else if (Guard(machine, GoToOther(machine))) {
         OtherAction(machine);
         ChangeState(machine, OtherState::Instance());
     }
@@ -36,7 +36,7 @@ State& BeginState::Instance() {
 void BeginState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToCheckingRstp(machine)) {
+    if (Guard(machine, GoToCheckingRstp(machine))) {
         CheckingRstpAction(machine);
         ChangeState(machine, CheckingRstpState::Instance());
     }
@@ -53,11 +53,11 @@ State& CheckingRstpState::Instance() {
 void CheckingRstpState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToSensing(machine)) {
+    if (Guard(machine, GoToSensing(machine))) {
         SensingAction(machine);
         ChangeState(machine, SensingState::Instance());
     }
-    else if (GoToCheckingRstp(machine)) {
+    else if (Guard(machine, GoToCheckingRstp(machine))) {
         CheckingRstpAction(machine);
         // Leave it as current state
     }
@@ -85,11 +85,11 @@ State& SensingState::Instance() {
 void SensingState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToCheckingRstp(machine)) {
+    if (Guard(machine, GoToCheckingRstp(machine))) {
         CheckingRstpAction(machine);
         ChangeState(machine, CheckingRstpState::Instance());
     }
-    else if (GoToSelectingStp(machine)) {
+    else if (Guard(machine, GoToSelectingStp(machine))) {
         SelectingStpAction(machine);
         ChangeState(machine, SelectingStpState::Instance());
     }
@@ -135,7 +135,7 @@ State& SelectingStpState::Instance() {
 void SelectingStpState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToSensing(machine)) {
+    if (Guard(machine, GoToSensing(machine))) {
         SensingAction(machine);
         ChangeState(machine, SensingState::Instance());
     }
@@ -19,9 +19,11 @@ void PrxState::DiscardAction(Machine& machine) {
     machine.PortInstance().SetRcvdStp(false);
     machine.PortInstance().SetRcvdMsg(false);
     machine.PortInstance().SmTimersInstance().SetEdgeDelayWhile(PerfParams::MigrateTime());
+    machine.PortInstance().ClearRxIngressTime();
 }
 
 void PrxState::ReceiveAction(Machine& machine) {
+    machine.BridgeInstance().GetLatencyTracker().RecordReceive(machine.PortInstance());
     SmProcedures::UpdtBpduVersion(machine.PortInstance());
     machine.PortInstance().SetOperEdge(false);
     machine.PortInstance().SetRcvdBpdu(false);
@@ -36,7 +38,7 @@ State& BeginState::Instance() {
 void BeginState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToDiscard(machine)) {
+    if (Guard(machine, GoToDiscard(machine))) {
         DiscardAction(machine);
         ChangeState(machine, DiscardState::Instance());
     }
@@ -68,7 +70,7 @@ State& DiscardState::Instance() {
 void DiscardState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToReceive(machine)) {
+    if (Guard(machine, GoToReceive(machine))) {
         ReceiveAction(machine);
         ChangeState(machine, ReceiveState::Instance());
     }
@@ -93,7 +95,7 @@ State& ReceiveState::Instance() {
 void ReceiveState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToReceive(machine)) {
+    if (Guard(machine, GoToReceive(machine))) {
         ReceiveAction(machine);
         // Leave it as current state
     }
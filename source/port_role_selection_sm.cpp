@@ -17,8 +17,10 @@ void PrsState::InitBridgeAction(Machine& machine) {
 }
 
 void PrsState::RoleSelectionAction(Machine& machine) {
+    // Requests of reselection are cleared below, so validity of the plan is checked first
+    const bool installFailover = SmProcedures::FailoverApplies(machine.BridgeInstance());
     SmProcedures::ClearReselectTree(machine.BridgeInstance());
-    SmProcedures::UpdtRolesTree(machine.BridgeInstance());
+    SmProcedures::UpdtRolesTree(machine.BridgeInstance(), installFailover);
     SmProcedures::SetSelectedTree(machine.BridgeInstance());
 }
 
@@ -29,7 +31,7 @@ State& BeginState::Instance() {
 void BeginState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToInitBridge(machine)) {
+    if (Guard(machine, GoToInitBridge(machine))) {
         InitBridgeAction(machine);
         ChangeState(machine, InitBridgeState::Instance());
     }
@@ -46,7 +48,7 @@ State& InitBridgeState::Instance() {
 void InitBridgeState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToRoleSelection(machine)) {
+    if (Guard(machine, GoToRoleSelection(machine))) {
         RoleSelectionAction(machine);
         ChangeState(machine, RoleSelectionState::Instance());
     }
@@ -64,20 +66,18 @@ State& RoleSelectionState::Instance() {
 void RoleSelectionState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToRoleSelection(machine)) {
+    if (Guard(machine, GoToRoleSelection(machine))) {
         RoleSelectionAction(machine);
         // Leave it as the current state
     }
 }
 
 bool RoleSelectionState::GoToRoleSelection(Machine& machine) {
-    for (const auto& portMapIt : machine.BridgeInstance().GetAllPorts()) {
-        if (portMapIt.second->Reselect()) {
-            return true;;
-        }
-    }
-
-    return false;
+    // Every port runs its own instance of the machine within the same pass, so the port which
+    // has reselect set will select roles of the whole tree. Checking only own port keeps tick
+    // linear in the number of ports.
+    return machine.PortInstance().Reselect()
+           && not machine.BridgeInstance().RoleSelectionDeferred();
 }
 
 } // namespace PortTransmit
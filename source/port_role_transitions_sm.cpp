@@ -13,6 +13,9 @@
 #include "stp/sm_procedures.hpp"
 #include "stp/time.hpp"
 
+// C++ Standard Library
+#include <stdexcept>
+
 namespace Stp {
 namespace PortRoleTransitions {
 
@@ -30,7 +33,7 @@ void PrtState::InitPortAction(Machine& machine) {
 }
 
 void PrtState::DisablePortAction(Machine& machine) {
-    machine.PortInstance().SetRole(machine.PortInstance().SelectedRole());
+    machine.PortInstance().SetRole(PortRole::Disabled);
     machine.PortInstance().SetForward(false);
     machine.PortInstance().SetLearn(false);
 }
@@ -154,22 +157,29 @@ void PrtState::AlternatePortAction(Machine& machine) {
 }
 
 void PrtState::RootPortUctExecute(Machine& machine) {
-    RootPortAction(machine);
-    ChangeState(machine, RootPortState::Instance());
+    if (Guard(machine, true)) { // UCT
+        RootPortAction(machine);
+        ChangeState(machine, RootPortState::Instance());
+    }
 }
 
 void PrtState::DesignatedPortUctExecute(Machine& machine) {
-    DesignatedPortAction(machine);
-    ChangeState(machine, DesignatedPortState::Instance());
+    if (Guard(machine, true)) { // UCT
+        DesignatedPortAction(machine);
+        ChangeState(machine, DesignatedPortState::Instance());
+    }
 }
 
 void PrtState::AlternatePortUctExecute(Machine& machine) {
-    AlternatePortAction(machine);
-    ChangeState(machine, AlternatePortState::Instance());
+    if (Guard(machine, true)) { // UCT
+        AlternatePortAction(machine);
+        ChangeState(machine, AlternatePortState::Instance());
+    }
 }
 
 bool PrtState::ContinueExecute(Machine& machine) {
-    if (machine.PortInstance().Role() == machine.PortInstance().SelectedRole()) {
+    if (not Guard(machine,
+                  machine.PortInstance().Role() != machine.PortInstance().SelectedRole())) {
         return true;
     }
 
@@ -219,7 +229,7 @@ State& BeginState::Instance() {
 void BeginState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToInitPort(machine)) {
+    if (Guard(machine, GoToInitPort(machine))) {
         InitPortAction(machine);
         ChangeState(machine, InitPortState::Instance());
     }
@@ -236,7 +246,7 @@ State& InitPortState::Instance() {
 void InitPortState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToDisablePort(machine)) {
+    if (Guard(machine, GoToDisablePort(machine))) {
         DisablePortAction(machine);
         ChangeState(machine, DisablePortState::Instance());
     }
@@ -258,7 +268,7 @@ void DisablePortState::Execute(Machine& machine) {
         return;
     }
 
-    if (GoToDisabledPort(machine)) {
+    if (Guard(machine, GoToDisabledPort(machine))) {
         DisabledPortAction(machine);
         ChangeState(machine, DisabledPortState::Instance());
     }
@@ -289,7 +299,7 @@ void DisabledPortState::Execute(Machine& machine) {
         return;
     }
 
-    if (GoToDisabledPort(machine)) {
+    if (Guard(machine, GoToDisabledPort(machine))) {
         DisabledPortAction(machine);
         // Leave it as a current state
     }
@@ -413,31 +423,31 @@ void RootPortState::Execute(Machine& machine) {
         return;
     }
 
-    if (GoToRootProposed(machine)) {
+    if (Guard(machine, GoToRootProposed(machine))) {
         RootProposedAction(machine);
         ChangeState(machine, RootProposedState::Instance());
     }
-    else if (GoToRootAgreed(machine)) {
+    else if (Guard(machine, GoToRootAgreed(machine))) {
         RootAgreedAction(machine);
         ChangeState(machine, RootAgreedState::Instance());
     }
-    else if (GoToReRoot(machine)) {
+    else if (Guard(machine, GoToReRoot(machine))) {
         ReRootAction(machine);
         ChangeState(machine, ReRootState::Instance());
     }
-    else if (GoToRootForward(machine)) {
+    else if (Guard(machine, GoToRootForward(machine))) {
         RootForwardAction(machine);
         ChangeState(machine, RootForwardState::Instance());
     }
-    else if (GoToRootLearn(machine)) {
+    else if (Guard(machine, GoToRootLearn(machine))) {
         RootLearnAction(machine);
         ChangeState(machine, RootLearnState::Instance());
     }
-    else if (GoToReRooted(machine)) {
+    else if (Guard(machine, GoToReRooted(machine))) {
         ReRootedAction(machine);
         ChangeState(machine, ReRootedState::Instance());
     }
-    else if (GoToRootPort(machine)) {
+    else if (Guard(machine, GoToRootPort(machine))) {
         ReRootedAction(machine);
         // Leave it as a current state
     }
@@ -634,27 +644,27 @@ void DesignatedPortState::Execute(Machine& machine) {
         return;
     }
 
-    if (GoToDesignatedPropose(machine)) {
+    if (Guard(machine, GoToDesignatedPropose(machine))) {
         DesignatedProposeAction(machine);
         ChangeState(machine, DesignatedProposeState::Instance());
     }
-    else if (GoToDesignatedSynced(machine)) {
+    else if (Guard(machine, GoToDesignatedSynced(machine))) {
         DesignatedSyncedAction(machine);
         ChangeState(machine, DesignatedSyncedState::Instance());
     }
-    else if (GoToDesignatedRetired(machine)) {
+    else if (Guard(machine, GoToDesignatedRetired(machine))) {
         DesignatedRetiredAction(machine);
         ChangeState(machine, DesignatedRetiredState::Instance());
     }
-    else if (GoToDesignatedForward(machine)) {
+    else if (Guard(machine, GoToDesignatedForward(machine))) {
         DesignatedForwardAction(machine);
         ChangeState(machine, DesignatedForwardState::Instance());
     }
-    else if (GoToDesignatedLearn(machine)) {
+    else if (Guard(machine, GoToDesignatedLearn(machine))) {
         DesignatedLearnAction(machine);
         ChangeState(machine, DesignatedLearnState::Instance());
     }
-    else if (GoToDesignatedDiscard(machine)) {
+    else if (Guard(machine, GoToDesignatedDiscard(machine))) {
         DesignatedDiscardAction(machine);
         ChangeState(machine, DesignatedDiscardState::Instance());
     }
@@ -842,7 +852,7 @@ void BlockPortState::Execute(Machine& machine) {
         return;
     }
 
-    if (GoToAlternatePort(machine)) {
+    if (Guard(machine, GoToAlternatePort(machine))) {
         AlternatePortAction(machine);
         ChangeState(machine, AlternatePortState::Instance());
     }
@@ -887,19 +897,19 @@ void AlternatePortState::Execute(Machine& machine) {
         return;
     }
 
-    if (GoToAlternateProposed(machine)) {
+    if (Guard(machine, GoToAlternateProposed(machine))) {
         AlternateProposedAction(machine);
         ChangeState(machine, AlternateProposedState::Instance());
     }
-    else if (GoToAlternateAgreed(machine)) {
+    else if (Guard(machine, GoToAlternateAgreed(machine))) {
         AlternateAgreedAction(machine);
         ChangeState(machine, AlternateAgreedState::Instance());
     }
-    else if (GoToBackupPort(machine)) {
+    else if (Guard(machine, GoToBackupPort(machine))) {
         AlternateAgreedAction(machine);
         ChangeState(machine, AlternateAgreedState::Instance());
     }
-    else if (GoToAlternatePort(machine)) {
+    else if (Guard(machine, GoToAlternatePort(machine))) {
         AlternatePortAction(machine);
         // Leave it as a current state
     }
@@ -23,7 +23,7 @@ void PstState::LearningAction(Machine& machine) {
     SmProcedures::EnableLearning(machine.BridgeInstance(), machine.PortInstance());
     machine.PortInstance().SetLearning(true);
     // Exception: 17.19.1
-    machine.PortInstance().SetAgeingTime(Bridge::AgeingTime);
+    machine.PortInstance().SetAgeingTime(machine.BridgeInstance().AgeingTime());
 }
 
 void PstState::ForwardingAction(Machine &machine) {
@@ -38,7 +38,7 @@ State& BeginState::Instance() {
 void BeginState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToDiscarding(machine)) {
+    if (Guard(machine, GoToDiscarding(machine))) {
         DiscardingAction(machine);
         ChangeState(machine, DiscardingState::Instance());
     }
@@ -55,7 +55,7 @@ State& DiscardingState::Instance() {
 void DiscardingState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToLearning(machine)) {
+    if (Guard(machine, GoToLearning(machine))) {
         LearningAction(machine);
         ChangeState(machine, LearningState::Instance());
     }
@@ -72,11 +72,11 @@ State& LearningState::Instance() {
 void LearningState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToForwarding(machine)) {
+    if (Guard(machine, GoToForwarding(machine))) {
         ForwardingAction(machine);
         ChangeState(machine, ForwardingState::Instance());
     }
-    else if (GoToDiscarding(machine)) {
+    else if (Guard(machine, GoToDiscarding(machine))) {
         DiscardingAction(machine);
         ChangeState(machine, DiscardingState::Instance());
     }
@@ -97,7 +97,7 @@ State& ForwardingState::Instance() {
 void ForwardingState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToDiscarding(machine)) {
+    if (Guard(machine, GoToDiscarding(machine))) {
         DiscardingAction(machine);
         ChangeState(machine, DiscardingState::Instance());
     }
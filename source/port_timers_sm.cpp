@@ -6,6 +6,11 @@
 
 // This project's headers
 #include "stp/sm/port_timers.hpp"
+// Dependencies
+#include "stp/perf_params.hpp"
+
+// C++ Standard Library
+#include <algorithm>
 
 namespace Stp {
 namespace PortTimers {
@@ -15,9 +20,23 @@ void PtiTimers::OneSecondAction(Machine& machine) {
 }
 
 void PtiTimers::TickAction(Machine& machine) {
-    --machine.PortInstance().SmTimersInstance();
-    machine.PortInstance().DecTxCount();
-    machine.PortInstance().DecAgeingTime();
+    Port& port = machine.PortInstance();
+    const u32 elapsedMs = machine.BridgeInstance().TickIntervalMs();
+    Tracer& tracer = machine.BridgeInstance().GetTracer();
+    if (tracer.Enabled()) {
+        const SmTimers previous = port.SmTimersInstance();
+        port.SmTimersInstance().Advance(elapsedMs);
+        tracer.RecordTimerExpiries(port, previous, port.SmTimersInstance());
+    }
+    else {
+        port.SmTimersInstance().Advance(elapsedMs);
+    }
+
+    // txCount is decremented once per second (17.19.44), but port in fast hello mode has to
+    // transmit more than TxHoldCount BPDUs per second, so its limit applies per hello time
+    const u32 helloTime = std::max(PerfParams::HelloTime(port), Time::MinFastHelloTimeMs);
+    port.DecTxCount(elapsedMs, std::min(Time::MsPerSecond, helloTime));
+    port.DecAgeingTime(elapsedMs);
 }
 
 State& BeginState::Instance() {
@@ -27,7 +46,7 @@ State& BeginState::Instance() {
 void BeginState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToOneSecond(machine)) {
+    if (Guard(machine, GoToOneSecond(machine))) {
         OneSecondAction(machine);
         ChangeState(machine, OneSecondState::Instance());
     }
@@ -44,7 +63,7 @@ State& OneSecondState::Instance() {
 void OneSecondState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToTick(machine)) {
+    if (Guard(machine, GoToTick(machine))) {
         TickAction(machine);
         ChangeState(machine, TickState::Instance());
     }
@@ -61,7 +80,7 @@ State& TickState::Instance() {
 void TickState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToOneSecond(machine)) {
+    if (Guard(machine, GoToOneSecond(machine))) {
         OneSecondAction(machine);
         ChangeState(machine, OneSecondState::Instance());
     }
@@ -69,7 +69,7 @@ void PtxState::IdleAction(Machine& machine) {
 }
 
 void PtxState::IdleUctExecute(Machine& machine) {
-    if (GoToIdle(machine)) {
+    if (Guard(machine, GoToIdle(machine))) {
         IdleAction(machine);
         ChangeState(machine, IdleState::Instance());
     }
@@ -94,7 +94,7 @@ State& BeginState::Instance() {
 void BeginState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToTransmitInit(machine)) {
+    if (Guard(machine, GoToTransmitInit(machine))) {
         TransmitInitAction(machine);
         ChangeState(machine, TransmitInitState::Instance());
     }
@@ -156,19 +156,19 @@ State& IdleState::Instance() {
 void IdleState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToTransmitPeriodic(machine)) {
+    if (Guard(machine, GoToTransmitPeriodic(machine))) {
         TransmitPeriodicAction(machine);
         ChangeState(machine, TransmitPeriodicState::Instance());
     }
-    else if (GoToTransmitConfig(machine)) {
+    else if (Guard(machine, GoToTransmitConfig(machine))) {
         TransmitConfigAction(machine);
         ChangeState(machine, TransmitConfigState::Instance());
     }
-    else if (GoToTransmitTcn(machine)) {
+    else if (Guard(machine, GoToTransmitTcn(machine))) {
         TransmitTcnAction(machine);
         ChangeState(machine, TransmitTcnState::Instance());
     }
-    else if (GoToTransmitRstp(machine)) {
+    else if (Guard(machine, GoToTransmitRstp(machine))) {
         TransmitRstpAction(machine);
         ChangeState(machine, TransmitRstpState::Instance());
     }
@@ -198,7 +198,7 @@ bool IdleState::GoToTransmitConfig(Machine& machine) {
     else if (not SmProcedures::DesignatedPort(machine.PortInstance())) {
         return false;
     }
-    else if (not (machine.PortInstance().TxCount() < PerfParams::TxHoldCount())) {
+    else if (not (machine.PortInstance().TxCount() < PerfParams::TxHoldCount(machine.BridgeInstance()))) {
         return false;
     }
     else if (SmTimers::TimedOut(machine.PortInstance().SmTimersInstance().HelloWhen())) {
@@ -221,7 +221,7 @@ bool IdleState::GoToTransmitTcn(Machine& machine) {
     else if (not SmProcedures::RootPort(machine.PortInstance())) {
         return false;
     }
-    else if (not (machine.PortInstance().TxCount() < PerfParams::TxHoldCount())) {
+    else if (not (machine.PortInstance().TxCount() < PerfParams::TxHoldCount(machine.BridgeInstance()))) {
         return false;
     }
     else if (SmTimers::TimedOut(machine.PortInstance().SmTimersInstance().HelloWhen())) {
@@ -241,7 +241,7 @@ bool IdleState::GoToTransmitRstp(Machine& machine) {
     else if (not machine.PortInstance().NewInfo()) {
         return false;
     }
-    else if (not (machine.PortInstance().TxCount() < PerfParams::TxHoldCount())) {
+    else if (not (machine.PortInstance().TxCount() < PerfParams::TxHoldCount(machine.BridgeInstance()))) {
         return false;
     }
     else if (SmTimers::TimedOut(machine.PortInstance().SmTimersInstance().HelloWhen())) {
@@ -11,7 +11,7 @@ namespace Stp {
 
 PriorityVector::PriorityVector(const BridgeId& rootBridgeId, const PathCost& rootPathCost,
                                const BridgeId& designatedBridgeId, const PortId& designatedPortId) noexcept
-    : _rootBridgeId{ rootBridgeId }, _rootPathCost{ rootPathCost }, _bridgeId{ designatedBridgeId },
+    : _rootBridgeId{ rootBridgeId }, _bridgeId{ designatedBridgeId }, _rootPathCost{ rootPathCost },
       _portId{ designatedPortId } {
     // Nothing to do more
 }
@@ -39,11 +39,6 @@ bool PriorityVector::operator<(const PriorityVector& comparedTo) const noexcept
         return true;
     }
 
-    if ((_bridgeId.Address() == comparedTo._bridgeId.Address())
-            && (_portId.PortNum() == comparedTo._portId.PortNum())) {
-        return true;
-    }
-
     return false;
 }
 
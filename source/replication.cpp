@@ -0,0 +1,541 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/replication.hpp"
+
+// POSIX
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define STP_REPLICATION_SOCKET
+#endif
+
+// C Standard Library
+#include <cerrno>
+#include <cstring>
+
+// C++ Standard Library
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <tuple>
+
+namespace Stp {
+
+constexpr u32 Replica::Magic;
+constexpr std::size_t ReplicationChannel::_kMaxPendingBytes;
+
+namespace {
+
+using PortRecord = StateImage::PortRecord;
+
+/// @brief Fields of the record which run down with time, as PTI decrements them on every tick
+u32 PortRecord::* const kTimerFields[] = {
+    &PortRecord::AgeingTime,
+    &PortRecord::EdgeDelayWhile,
+    &PortRecord::FdWhile,
+    &PortRecord::HelloWhen,
+    &PortRecord::MdelayWhile,
+    &PortRecord::RbWhile,
+    &PortRecord::RcvdInfoWhile,
+    &PortRecord::RrWhile,
+    &PortRecord::TcWhile
+};
+
+void AdvanceTimers(PortRecord& record, const u64 elapsedMs) noexcept {
+    const u32 helloWhen = record.HelloWhen;
+    for (const auto field : kTimerFields) {
+        record.*field = (record.*field > elapsedMs) ? static_cast<u32>(record.*field - elapsedMs)
+                                                    : 0;
+    }
+
+    // Port Transmit machine starts helloWhen again whenever it expires (17.26.6), so ports do
+    // not have to be sent on every hello time. If the port does not, it is sent as changed.
+    const u32 helloTime = record.DesignatedTimes.HelloTime;
+    if ((helloWhen > 0) && (helloWhen <= elapsedMs) && (helloTime > 0)) {
+        record.HelloWhen = helloTime - static_cast<u32>((elapsedMs - helloWhen) % helloTime);
+    }
+}
+
+template <typename T>
+void Append(const T& value, ByteStream& data) {
+    const u8* const bytes = reinterpret_cast<const u8*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+/// @brief Frames are preceded by their length on the socket, which does not keep boundaries
+using FrameLength = u32;
+
+} // namespace
+
+Replica::Replica() noexcept
+    : _synced{ false }, _sequence{ 0 }, _timeMs{ 0 }, _bridge{ }, _ports{ }, _merged{ } {
+    // Nothing more to do
+}
+
+Result Replica::Apply(const ByteStream& frame) {
+    FrameHeader header{};
+    if (frame.size() < sizeof(header)) {
+        return Result::Fail;
+    }
+
+    std::memcpy(&header, frame.data(), sizeof(header));
+    const std::size_t size = sizeof(header) + (header.HasBridge ? sizeof(_bridge) : 0)
+            + std::size_t{ header.ChangedCount } * sizeof(PortRecord)
+            + std::size_t{ header.RemovedCount } * sizeof(u16);
+    const bool next = _synced && (header.Sequence == _sequence + 1) && (header.TimeMs >= _timeMs);
+    if ((Magic != header.Magic) || (StateImage::LayoutVersion != header.LayoutVersion)
+            || (size != frame.size()) || not (header.Full || next)
+            || (header.Full && (not header.HasBridge || (0 != header.RemovedCount)))) {
+        _synced = false;
+        return Result::Fail;
+    }
+
+    const u8* data = frame.data() + sizeof(header);
+    StateImage::BridgeRecord bridge = _bridge;
+    if (header.HasBridge) {
+        std::memcpy(&bridge, data, sizeof(bridge));
+        data += sizeof(bridge);
+    }
+
+    const u8* const changed = data;
+    const u8* const removed = changed + header.ChangedCount * sizeof(PortRecord);
+    const u64 elapsedMs = header.TimeMs - _timeMs;
+    // Unchanged and changed ports are merged in order of their numbers, and checked meanwhile
+    // as the replica is not modified by the rejected frame
+    _merged.clear();
+    std::size_t kept = 0;
+    u32 removedIdx = 0;
+    for (u32 changedIdx = 0; changedIdx <= header.ChangedCount; ++changedIdx) {
+        PortRecord record{};
+        u16 portNo = std::numeric_limits<u16>::max();
+        const bool last = (changedIdx == header.ChangedCount);
+        if (not last) {
+            std::memcpy(&record, changed + changedIdx * sizeof(PortRecord), sizeof(record));
+            portNo = record.PortNo;
+            if (not _merged.empty() && (_merged.back().PortNo >= portNo)) {
+                _synced = false;
+                return Result::Fail;
+            }
+        }
+
+        while (not header.Full && (kept < _ports.size())
+               && (last || (_ports[kept].PortNo <= portNo))) {
+            u16 removedPortNo = 0;
+            if (removedIdx < header.RemovedCount) {
+                std::memcpy(&removedPortNo, removed + removedIdx * sizeof(u16),
+                            sizeof(removedPortNo));
+            }
+
+            if ((removedIdx < header.RemovedCount) && (removedPortNo == _ports[kept].PortNo)) {
+                ++removedIdx;
+            }
+            else if (_ports[kept].PortNo != portNo) {
+                _merged.push_back(_ports[kept]);
+                AdvanceTimers(_merged.back(), elapsedMs);
+            }
+
+            ++kept;
+        }
+
+        if (not last) {
+            _merged.push_back(record);
+        }
+    }
+
+    // Every removed port has to be kept by the replica
+    if ((removedIdx != header.RemovedCount) || (header.PortCount != _merged.size())) {
+        _synced = false;
+        return Result::Fail;
+    }
+
+    _ports.swap(_merged);
+    _bridge = bridge;
+    _sequence = header.Sequence;
+    _timeMs = header.TimeMs;
+    _synced = true;
+
+    return Result::Success;
+}
+
+ReplicationEncoder::ReplicationEncoder() noexcept
+    : _full{ true }, _sequence{ 0 }, _timeMs{ 0 }, _bridge{ }, _sent{ }, _portNos{ },
+      _removed{ } {
+    // Nothing more to do
+}
+
+void ReplicationEncoder::Reset() noexcept {
+    _full = true;
+}
+
+void ReplicationEncoder::Encode(const StateImage::BridgeRecord& bridge,
+                                const std::vector<PortRecord>& ports, const u64 timeMs,
+                                const u32 toleranceMs, ByteStream& frame) {
+    Encode(bridge, ports, nullptr, timeMs, toleranceMs, frame);
+}
+
+void ReplicationEncoder::Encode(const StateImage::BridgeRecord& bridge,
+                                const std::vector<PortRecord>& ports,
+                                const std::vector<u16>& changedPortNos, const u64 timeMs,
+                                const u32 toleranceMs, ByteStream& frame) {
+    Encode(bridge, ports, &changedPortNos, timeMs, toleranceMs, frame);
+}
+
+void ReplicationEncoder::Encode(const StateImage::BridgeRecord& bridge,
+                                const std::vector<PortRecord>& ports,
+                                const std::vector<u16>* changedPortNos, const u64 timeMs,
+                                const u32 toleranceMs, ByteStream& frame) {
+    Replica::FrameHeader header{};
+    header.Magic = Replica::Magic;
+    header.LayoutVersion = StateImage::LayoutVersion;
+    header.Sequence = _sequence + 1;
+    header.TimeMs = std::max(timeMs, _timeMs);
+    header.PortCount = static_cast<u32>(ports.size());
+    header.Full = _full ? 1 : 0;
+    header.HasBridge = (_full || (0 != std::memcmp(&bridge, &_bridge, sizeof(bridge)))) ? 1 : 0;
+
+    frame.clear();
+    frame.resize(sizeof(header));
+    if (header.HasBridge) {
+        Append(bridge, frame);
+    }
+
+    _removed.clear();
+    if (_full) {
+        _sent.clear();
+        for (const PortRecord& record : ports) {
+            Append(record, frame);
+            _sent.push_back(SentPort{ record, header.TimeMs });
+        }
+
+        header.ChangedCount = static_cast<u32>(ports.size());
+    }
+    else {
+        if (not changedPortNos) {
+            // Ports which are not sent anymore have to be listed as well, as they are removed
+            _portNos.clear();
+            auto portIt = ports.cbegin();
+            auto sentIt = _sent.cbegin();
+            while ((portIt != ports.cend()) || (sentIt != _sent.cend())) {
+                const bool sentFirst = (portIt == ports.cend())
+                        || ((sentIt != _sent.cend()) && (sentIt->Record.PortNo < portIt->PortNo));
+                if (sentFirst) {
+                    _portNos.push_back((sentIt++)->Record.PortNo);
+                    continue;
+                }
+
+                if ((sentIt != _sent.cend()) && (sentIt->Record.PortNo == portIt->PortNo)) {
+                    ++sentIt;
+                }
+
+                _portNos.push_back((portIt++)->PortNo);
+            }
+
+            changedPortNos = &_portNos;
+        }
+
+        for (const u16 portNo : *changedPortNos) {
+            EncodePort(portNo, ports, toleranceMs, header, frame);
+        }
+    }
+
+    for (const u16 portNo : _removed) {
+        Append(portNo, frame);
+    }
+
+    header.RemovedCount = static_cast<u32>(_removed.size());
+    std::memcpy(frame.data(), &header, sizeof(header));
+    _bridge = bridge;
+    _sequence = header.Sequence;
+    _timeMs = header.TimeMs;
+    _full = false;
+}
+
+void ReplicationEncoder::EncodePort(const u16 portNo, const std::vector<PortRecord>& ports,
+                                    const u32 toleranceMs, Replica::FrameHeader& header,
+                                    ByteStream& frame) {
+    const auto current = std::lower_bound(ports.cbegin(), ports.cend(), portNo,
+                                          [](const PortRecord& record, const u16 number) {
+        return record.PortNo < number;
+    });
+    const auto sent = std::lower_bound(_sent.begin(), _sent.end(), portNo,
+                                       [](const SentPort& sentPort, const u16 number) {
+        return sentPort.Record.PortNo < number;
+    });
+    const bool exists = (current != ports.cend()) && (current->PortNo == portNo);
+    const bool known = (sent != _sent.end()) && (sent->Record.PortNo == portNo);
+    if (not exists) {
+        if (known) {
+            _removed.push_back(portNo);
+            _sent.erase(sent);
+        }
+
+        return;
+    }
+
+    if (not known) {
+        _sent.insert(sent, SentPort{ *current, header.TimeMs });
+    }
+    else {
+        // The standby advances timers of the port up to time of this frame
+        PortRecord standby = sent->Record;
+        AdvanceTimers(standby, header.TimeMs - sent->TimeMs);
+        if (not Differs(*current, standby, toleranceMs)) {
+            return;
+        }
+
+        sent->Record = *current;
+        sent->TimeMs = header.TimeMs;
+    }
+
+    Append(*current, frame);
+    ++header.ChangedCount;
+}
+
+bool ReplicationEncoder::Differs(const PortRecord& current, const PortRecord& standby,
+                                 const u32 toleranceMs) noexcept {
+    PortRecord compared = current;
+    for (const auto field : kTimerFields) {
+        const u32 difference = (current.*field > standby.*field)
+                ? current.*field - standby.*field : standby.*field - current.*field;
+        if (difference <= toleranceMs) {
+            compared.*field = standby.*field;
+        }
+    }
+
+    // txCount goes up with every BPDU sent and down every second, so it would send every port
+    // on every hello time. It only limits rate of BPDUs, so the standby might be one BPDU off.
+    if (std::max(current.TxCount, standby.TxCount) - std::min(current.TxCount, standby.TxCount)
+            <= 1) {
+        compared.TxCount = standby.TxCount;
+    }
+
+    return 0 != std::memcmp(&compared, &standby, sizeof(compared));
+}
+
+ReplicationChannel::ReplicationChannel() noexcept
+    : _listenFd{ -1 }, _fd{ -1 }, _listenPath{ }, _pending{ }, _received{ } {
+    // Nothing more to do
+}
+
+ReplicationChannel::~ReplicationChannel() {
+    Close();
+}
+
+Result ReplicationChannel::Listen(const std::string& path) {
+#ifdef STP_REPLICATION_SOCKET
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        return Result::Fail;
+    }
+
+    Close();
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    _listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listenFd < 0) {
+        return Result::Fail;
+    }
+
+    // The socket left by the process which has died is replaced
+    ::unlink(path.c_str());
+    if ((0 != ::bind(_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)))
+            || (0 != ::listen(_listenFd, 1))
+            || (0 != ::fcntl(_listenFd, F_SETFL, ::fcntl(_listenFd, F_GETFL) | O_NONBLOCK))) {
+        Close();
+        return Result::Fail;
+    }
+
+    _listenPath = path;
+
+    return Result::Success;
+#else
+    std::ignore = path;
+    return Result::Fail;
+#endif
+}
+
+bool ReplicationChannel::AcceptStandby() noexcept {
+#ifdef STP_REPLICATION_SOCKET
+    if (_listenFd < 0) {
+        return false;
+    }
+
+    const int fd = ::accept(_listenFd, nullptr, nullptr);
+    if (fd < 0) {
+        return false;
+    }
+
+    if (0 != ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK)) {
+        ::close(fd);
+        return false;
+    }
+
+#ifdef SO_NOSIGPIPE
+    const int noSigPipe = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+    Disconnect();
+    _fd = fd;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+Result ReplicationChannel::Send(const ByteStream& frame) noexcept {
+#ifdef STP_REPLICATION_SOCKET
+    if (_fd < 0) {
+        return Result::Fail;
+    }
+
+    if (_pending.size() + sizeof(FrameLength) + frame.size() > _kMaxPendingBytes) {
+        Disconnect();
+        return Result::Fail;
+    }
+
+    Append(static_cast<FrameLength>(frame.size()), _pending);
+    _pending.insert(_pending.end(), frame.cbegin(), frame.cend());
+#ifdef MSG_NOSIGNAL
+    constexpr int kFlags = MSG_NOSIGNAL;
+#else
+    constexpr int kFlags = 0;
+#endif
+    std::size_t sent = 0;
+    while (sent < _pending.size()) {
+        const ssize_t written = ::send(_fd, _pending.data() + sent, _pending.size() - sent,
+                                       kFlags);
+        if (written > 0) {
+            sent += static_cast<std::size_t>(written);
+        }
+        else if ((written < 0) && (EINTR == errno)) {
+            continue;
+        }
+        else if ((written < 0) && ((EAGAIN == errno) || (EWOULDBLOCK == errno))) {
+            break; // The rest is sent with the next frame
+        }
+        else {
+            Disconnect();
+            return Result::Fail;
+        }
+    }
+
+    _pending.erase(_pending.begin(), _pending.begin() + static_cast<std::ptrdiff_t>(sent));
+
+    return Result::Success;
+#else
+    std::ignore = frame;
+    return Result::Fail;
+#endif
+}
+
+Result ReplicationChannel::Connect(const std::string& path) {
+#ifdef STP_REPLICATION_SOCKET
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        return Result::Fail;
+    }
+
+    Close();
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    _fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_fd < 0) {
+        return Result::Fail;
+    }
+
+    if (0 != ::connect(_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address))) {
+        Close();
+        return Result::Fail;
+    }
+
+    return Result::Success;
+#else
+    std::ignore = path;
+    return Result::Fail;
+#endif
+}
+
+Result ReplicationChannel::Receive(ByteStream& frame, const u32 timeoutMs) {
+#ifdef STP_REPLICATION_SOCKET
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds{ timeoutMs };
+    while (_fd >= 0) {
+        FrameLength length = 0;
+        if (_received.size() >= sizeof(length)) {
+            std::memcpy(&length, _received.data(), sizeof(length));
+            if (_received.size() >= sizeof(length) + length) {
+                const auto begin = _received.cbegin() + sizeof(length);
+                frame.assign(begin, begin + length);
+                _received.erase(_received.cbegin(), begin + length);
+                return Result::Success;
+            }
+        }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - Clock::now()).count();
+        pollfd polled{ _fd, POLLIN, 0 };
+        const int ready = ::poll(&polled, 1, static_cast<int>(std::max<s64>(remaining, 0)));
+        if ((ready < 0) && (EINTR == errno)) {
+            continue;
+        }
+
+        if (ready <= 0) {
+            return Result::Fail;
+        }
+
+        u8 buffer[64 * 1024];
+        const ssize_t received = ::recv(_fd, buffer, sizeof(buffer), 0);
+        if ((received < 0) && (EINTR == errno)) {
+            continue;
+        }
+
+        if (received <= 0) {
+            // The primary has closed the connection
+            Close();
+            return Result::Fail;
+        }
+
+        _received.insert(_received.end(), buffer, buffer + received);
+    }
+
+    return Result::Fail;
+#else
+    std::ignore = frame;
+    std::ignore = timeoutMs;
+    return Result::Fail;
+#endif
+}
+
+void ReplicationChannel::Close() noexcept {
+    Disconnect();
+#ifdef STP_REPLICATION_SOCKET
+    if (_listenFd >= 0) {
+        ::close(_listenFd);
+        ::unlink(_listenPath.c_str());
+    }
+#endif
+    _listenFd = -1;
+    _listenPath.clear();
+}
+
+void ReplicationChannel::Disconnect() noexcept {
+#ifdef STP_REPLICATION_SOCKET
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+#endif
+    _fd = -1;
+    _pending.clear();
+    _received.clear();
+}
+
+} // namespace Stp
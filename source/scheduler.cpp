@@ -0,0 +1,121 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/scheduler.hpp"
+
+// C++ Standard Library
+#include <stdexcept>
+#include <utility>
+
+namespace Stp {
+
+Scheduler::Scheduler(ClockH clock)
+    : _clock{ clock }, _entries{ }, _tasks{ }, _seq{ 0 }, _nextTaskId{ 0 }, _wakeup{ nullptr },
+      _wakeupTask{ } {
+    if (nullptr == _clock) {
+        throw std::runtime_error("Handler for clock instance is null pointer");
+    }
+}
+
+Scheduler::TaskId Scheduler::ScheduleAt(const Clock::Duration time, Task task) {
+    const TaskId taskId = _nextTaskId++;
+    _tasks.emplace(taskId, ScheduledTask{ std::move(task), Clock::Duration::zero() });
+    Push(time, taskId);
+
+    return taskId;
+}
+
+Scheduler::TaskId Scheduler::ScheduleEvery(const Clock::Duration first,
+                                           const Clock::Duration period, Task task) {
+    if (period <= Clock::Duration::zero()) {
+        throw std::invalid_argument("Period of task has to be positive");
+    }
+
+    const TaskId taskId = _nextTaskId++;
+    _tasks.emplace(taskId, ScheduledTask{ std::move(task), period });
+    Push(first, taskId);
+
+    return taskId;
+}
+
+Result Scheduler::Cancel(const TaskId taskId) {
+    // Entry stays in the queue and it's dropped when it reaches the top
+    return (_tasks.erase(taskId) > 0) ? Result::Success : Result::Fail;
+}
+
+void Scheduler::SetWakeup(Wakeup& wakeup, Task task) {
+    _wakeup = &wakeup;
+    _wakeupTask = std::move(task);
+}
+
+bool Scheduler::RunNext() {
+    DropCancelled();
+    if (_entries.empty()) {
+        return false;
+    }
+
+    if (nullptr == _wakeup) {
+        _clock->WaitUntil(_entries.top().Time);
+    }
+    else if (_clock->WaitUntil(_entries.top().Time, *_wakeup)) {
+        // Task might schedule another ones earlier than the awaited one, so it's taken again
+        _wakeupTask();
+        return true;
+    }
+
+    const Entry entry = _entries.top();
+    _entries.pop();
+
+    auto task = _tasks.find(entry.Id);
+    if (Clock::Duration::zero() == task->second.Period) {
+        Task run{ std::move(task->second.Run) };
+        _tasks.erase(task);
+        run();
+    }
+    else {
+        Push(entry.Time + task->second.Period, entry.Id);
+        // Copy protects from invalidation if task schedules another ones
+        Task run{ task->second.Run };
+        run();
+    }
+
+    return true;
+}
+
+u64 Scheduler::RunUntil(const Clock::Duration time) {
+    u64 tasksRun = 0;
+    while (not Empty() && (NextTime() <= time)) {
+        RunNext();
+        ++tasksRun;
+    }
+
+    _clock->WaitUntil(time);
+
+    return tasksRun;
+}
+
+bool Scheduler::Empty() noexcept {
+    DropCancelled();
+    return _entries.empty();
+}
+
+Clock::Duration Scheduler::NextTime() noexcept {
+    DropCancelled();
+    return _entries.empty() ? Clock::Duration::max() : _entries.top().Time;
+}
+
+void Scheduler::Push(const Clock::Duration time, const TaskId taskId) {
+    _entries.push(Entry{ time, _seq++, taskId });
+}
+
+void Scheduler::DropCancelled() noexcept {
+    while (not _entries.empty() && (_tasks.end() == _tasks.find(_entries.top().Id))) {
+        _entries.pop();
+    }
+}
+
+} // namespace Stp
@@ -0,0 +1,451 @@
+// STP Convergence Benchmark
+#include "stp/sim/hash.hpp"
+#include "stp/sim/network.hpp"
+#include "stp/sim/topology.hpp"
+
+// C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Stp;
+using namespace Stp::Sim;
+
+namespace {
+
+/// @brief Bridge 0 has the lowest address, so it's the root when all priorities are equal
+constexpr u32 kBestBridge = 0;
+/// @brief Port going down is noticed by peers after its information ages out (3 * Hello Time),
+///        so faster flaps are not visible in the tree
+constexpr u32 kFlapCount = 5;
+constexpr u64 kFlapPeriodMs = 8000;
+constexpr u32 kStormRounds = 10;
+constexpr u64 kStormPeriodMs = 4000;
+
+struct Options {
+    std::vector<std::string> Topologies{ "ring", "random", "fattree" };
+    std::vector<u32> Sizes{ 16, 64 };
+    std::vector<std::string> Scenarios; ///< Empty means all of them
+    u32 Degree = 4;
+    u32 DelayMs = 1;
+    double Loss = 0.0;
+    u64 LimitMs = 600000;
+    std::string Output;
+    Config SimConfig;
+};
+
+/**
+ * @brief The Outcome struct keeps results of the measured part of the scenario
+ */
+struct Outcome {
+    std::string Status; ///< "ok", "failed" or "skipped"
+    std::string Note;
+    Report Measured;
+};
+
+/**
+ * @brief The Scenario struct describes single entry of the catalogue. Prepare modifies topology
+ *        and network before initial convergence, Trigger disturbs converged network and
+ *        measures its recovery.
+ */
+struct Scenario {
+    const char* Name;
+    const char* Description;
+    std::function<void(Topology&)> PrepareTopology;
+    std::function<Result(Network&)> PrepareNetwork;
+    std::function<Outcome(Network&, const Options&)> Trigger;
+};
+
+/**
+ * @brief Accumulate sums counters of consecutive runs
+ * @param elapsedMs time from start of the first run to start of the next one
+ * @note Convergence time is measured from start of the first run to the last change of the tree
+ */
+Report& Accumulate(Report& total, const Report& next, const u64 elapsedMs) {
+    total.Converged = next.Converged;
+    if (next.ConvergenceTimeMs > 0) {
+        total.ConvergenceTimeMs = elapsedMs + next.ConvergenceTimeMs;
+    }
+
+    total.BpdusSent += next.BpdusSent;
+    total.BpdusDelivered += next.BpdusDelivered;
+    total.BpdusLost += next.BpdusLost;
+    total.FdbFlushes += next.FdbFlushes;
+    total.Events += next.Events;
+    total.CpuTimeUs += next.CpuTimeUs;
+    total.RootCount = next.RootCount;
+
+    return total;
+}
+
+Outcome Measured(const Report& report) {
+    return Outcome{ report.Converged ? "ok" : "failed", "", report };
+}
+
+Outcome Failure(const std::string& note) {
+    return Outcome{ "failed", note, Report{} };
+}
+
+/// @brief Finds link attached to the root port of the bridge, which has to be converged
+bool FindRootPortLink(const Network& network, const u32 bridge, u32& linkIdx) {
+    for (const auto& port : network.EngineInstance(bridge).BridgeInstance().AllPorts()) {
+        if (PortRole::Root != port.second->Role()) {
+            continue;
+        }
+
+        const auto& links = network.TopologyInstance().Links();
+        for (linkIdx = 0; linkIdx < links.size(); ++linkIdx) {
+            const Link& link = links[linkIdx];
+            if (((link.BridgeA == bridge) && (link.PortA == port.first))
+                    || ((link.BridgeB == bridge) && (link.PortB == port.first))) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+Outcome RootBridgeFailure(Network& network, const Options& options) {
+    if (Failed(network.FailBridge(kBestBridge))) {
+        return Failure("cannot fail root bridge");
+    }
+
+    return Measured(network.RunUntilStable(options.LimitMs));
+}
+
+Outcome RootPortLinkDown(Network& network, const Options& options) {
+    // The last bridge is usually far away from the root in generated topologies
+    const u32 bridge = network.TopologyInstance().BridgeCount() - 1;
+    u32 linkIdx = 0;
+    if (not FindRootPortLink(network, bridge, linkIdx) || Failed(network.FailLink(linkIdx))) {
+        return Failure("bridge has no root port");
+    }
+
+    return Measured(network.RunUntilStable(options.LimitMs));
+}
+
+Outcome SuperiorBridgeInsertion(Network& network, const Options& options) {
+    if (Failed(network.RestoreBridge(kBestBridge))) {
+        return Failure("cannot insert bridge");
+    }
+
+    return Measured(network.RunUntilStable(options.LimitMs));
+}
+
+Outcome EdgePortFlap(Network& network, const Options& options) {
+    Report total{};
+    u64 elapsedMs = 0;
+    for (u32 flap = 0; flap < kFlapCount; ++flap) {
+        network.FailHostPort(0);
+        Accumulate(total, network.RunFor(kFlapPeriodMs / 2), elapsedMs);
+        elapsedMs += kFlapPeriodMs / 2;
+        network.RestoreHostPort(0);
+        Accumulate(total, network.RunFor(kFlapPeriodMs / 2), elapsedMs);
+        elapsedMs += kFlapPeriodMs / 2;
+    }
+
+    return Measured(Accumulate(total, network.RunUntilStable(options.LimitMs), elapsedMs));
+}
+
+/// @brief Forces STP on the upper half of bridges, so RSTP segment of the root meets STP segment
+Result ForceStpSegment(Network& network) {
+    BridgeConfig config{};
+    config.ForceProtocolVersion = BridgeConfig::ProtocolVersion::Stp;
+    const u32 bridgeCount = network.TopologyInstance().BridgeCount();
+    for (u32 bridge = bridgeCount / 2; bridge < bridgeCount; ++bridge) {
+        if (Failed(network.SetBridgeConfig(bridge, config))) {
+            return Result::Fail;
+        }
+    }
+
+    return Result::Success;
+}
+
+Outcome TcStorm(Network& network, const Options& options) {
+    const auto& links = network.TopologyInstance().Links();
+    if (links.empty()) {
+        return Failure("topology has no links");
+    }
+
+    // Every round flaps another link, each restored link which becomes forwarding causes
+    // topology change flooded through the whole tree
+    Report total{};
+    u64 elapsedMs = 0;
+    for (u32 round = 0; round < kStormRounds; ++round) {
+        const u32 linkIdx = static_cast<u32>(Mix64(options.SimConfig.Seed, round) % links.size());
+        network.FailLink(linkIdx);
+        Accumulate(total, network.RunFor(kStormPeriodMs), elapsedMs);
+        elapsedMs += kStormPeriodMs;
+        network.RestoreLink(linkIdx);
+        Accumulate(total, network.RunFor(kStormPeriodMs), elapsedMs);
+        elapsedMs += kStormPeriodMs;
+    }
+
+    return Measured(Accumulate(total, network.RunUntilStable(options.LimitMs), elapsedMs));
+}
+
+const std::vector<Scenario>& Catalogue() {
+    static const std::vector<Scenario> scenarios{
+        { "root_bridge_failure", "root bridge fails after convergence",
+          nullptr, nullptr, RootBridgeFailure },
+        { "root_port_link_down", "link of the root port of the last bridge goes down",
+          nullptr, nullptr, RootPortLinkDown },
+        { "superior_bridge_insertion", "bridge with the best identifier joins converged network",
+          nullptr, [](Network& network) { return network.FailBridge(kBestBridge); },
+          SuperiorBridgeInsertion },
+        { "edge_port_flap", "host port of the last bridge flaps repeatedly",
+          [](Topology& topology) { topology.AttachHost(topology.BridgeCount() - 1); },
+          nullptr, EdgePortFlap },
+        { "mixed_stp_rstp", "root port link of the last bridge goes down, the upper half of "
+          "bridges runs STP", nullptr, ForceStpSegment, RootPortLinkDown },
+        { "tc_storm", "links flap one by one, every flap causes topology change",
+          nullptr, nullptr, TcStorm }
+    };
+
+    return scenarios;
+}
+
+Topology BuildTopology(const std::string& kind, const u32 size, const Options& options) {
+    if ("ring" == kind) {
+        return Topology::Ring(size);
+    }
+    else if ("mesh" == kind) {
+        return Topology::FullMesh(size);
+    }
+    else if ("fattree" == kind) {
+        // The largest fat-tree of (5 * k^2 / 4) switches which does not exceed requested size
+        u32 k = 2 * static_cast<u32>(std::sqrt(static_cast<double>(size) / 5.0));
+        return Topology::FatTree(std::max<u32>(k, 2));
+    }
+    else if ("random" == kind) {
+        return Topology::Random(size, options.Degree, options.SimConfig.Seed);
+    }
+
+    throw std::invalid_argument("Unknown topology " + kind);
+}
+
+std::vector<std::string> SplitList(const char* value) {
+    std::vector<std::string> items;
+    std::stringstream stream{ value };
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (not item.empty()) {
+            items.push_back(item);
+        }
+    }
+
+    return items;
+}
+
+bool Selected(const Options& options, const char* scenario) {
+    if (options.Scenarios.empty()) {
+        return true;
+    }
+
+    for (const auto& name : options.Scenarios) {
+        if (name == scenario) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+struct Row {
+    std::string Scenario;
+    std::string Topology;
+    u32 Bridges;
+    u64 Links;
+    Outcome Measurement;
+};
+
+void PrintRow(const Row& row) {
+    const Report& report = row.Measurement.Measured;
+    std::cout << row.Scenario << " " << row.Topology << "/" << row.Bridges
+              << ": status=" << row.Measurement.Status;
+    if ("skipped" == row.Measurement.Status) {
+        std::cout << " (" << row.Measurement.Note << ")" << std::endl;
+        return;
+    }
+
+    std::cout << " time_ms=" << report.ConvergenceTimeMs
+              << " roots=" << report.RootCount
+              << " bpdus_sent=" << report.BpdusSent
+              << " bpdus_received=" << report.BpdusDelivered
+              << " fdb_flushes=" << report.FdbFlushes
+              << " cpu_us=" << report.CpuTimeUs << std::endl;
+}
+
+void WriteJson(std::ostream& out, const Options& options, const std::vector<Row>& rows) {
+    out << "{\n"
+        << "  \"config\": {\"seed\": " << options.SimConfig.Seed
+        << ", \"workers\": " << options.SimConfig.Workers
+        << ", \"fast_hello_ms\": " << options.SimConfig.FastHelloTimeMs
+        << ", \"delay_ms\": " << options.DelayMs
+        << ", \"loss\": " << options.Loss
+        << ", \"limit_ms\": " << options.LimitMs << "},\n"
+        << "  \"results\": [";
+
+    for (std::size_t idx = 0; idx < rows.size(); ++idx) {
+        const Row& row = rows[idx];
+        const Report& report = row.Measurement.Measured;
+        out << (idx ? ",\n" : "\n")
+            << "    {\"scenario\": \"" << row.Scenario << "\""
+            << ", \"topology\": \"" << row.Topology << "\""
+            << ", \"bridges\": " << row.Bridges
+            << ", \"links\": " << row.Links
+            << ", \"status\": \"" << row.Measurement.Status << "\""
+            << ", \"note\": \"" << row.Measurement.Note << "\""
+            << ", \"converged\": " << (report.Converged ? "true" : "false")
+            << ", \"convergence_time_ms\": " << report.ConvergenceTimeMs
+            << ", \"bpdus_sent\": " << report.BpdusSent
+            << ", \"bpdus_received\": " << report.BpdusDelivered
+            << ", \"bpdus_lost\": " << report.BpdusLost
+            << ", \"fdb_flushes\": " << report.FdbFlushes
+            << ", \"events\": " << report.Events
+            << ", \"roots\": " << report.RootCount
+            << ", \"cpu_time_us\": " << report.CpuTimeUs << "}";
+    }
+
+    out << "\n  ]\n}\n";
+}
+
+void PrintUsage(const char* name) {
+    std::cerr << "Usage: " << name << " [options]\n"
+              << "  --topologies LIST comma separated ring,mesh,fattree,random "
+                 "(default ring,random,fattree)\n"
+              << "  --sizes LIST      comma separated numbers of bridges (default 16,64)\n"
+              << "  --scenarios LIST  comma separated names of scenarios (default all)\n"
+              << "  --degree N        average degree of random topology (default 4)\n"
+              << "  --delay MS        one-way link delay (default 1)\n"
+              << "  --loss P          probability of losing BPDU on link (default 0)\n"
+              << "  --seed N          seed of tick phases, losses and random topology (default 1)\n"
+              << "  --limit MS        time limit of single measurement (default 600000)\n"
+              << "  --workers N       number of simulation threads (default 1)\n"
+              << "  --fast-hello MS   hello time of ports of links below one second (default off)\n"
+              << "  --output FILE     write results as JSON to the file\n"
+              << "Scenarios:\n";
+    for (const auto& scenario : Catalogue()) {
+        std::cerr << "  " << scenario.Name << ": " << scenario.Description << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options{};
+    for (int idx = 1; idx < argc; idx += 2) {
+        const char* option = argv[idx];
+        if (idx + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        const char* value = argv[idx + 1];
+        if (0 == std::strcmp(option, "--topologies")) {
+            options.Topologies = SplitList(value);
+        }
+        else if (0 == std::strcmp(option, "--sizes")) {
+            options.Sizes.clear();
+            for (const auto& size : SplitList(value)) {
+                options.Sizes.push_back(static_cast<u32>(std::strtoul(size.c_str(), nullptr, 10)));
+            }
+        }
+        else if (0 == std::strcmp(option, "--scenarios")) {
+            options.Scenarios = SplitList(value);
+        }
+        else if (0 == std::strcmp(option, "--degree")) {
+            options.Degree = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+        else if (0 == std::strcmp(option, "--delay")) {
+            options.DelayMs = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+        else if (0 == std::strcmp(option, "--loss")) {
+            options.Loss = std::strtod(value, nullptr);
+        }
+        else if (0 == std::strcmp(option, "--seed")) {
+            options.SimConfig.Seed = std::strtoull(value, nullptr, 10);
+        }
+        else if (0 == std::strcmp(option, "--limit")) {
+            options.LimitMs = std::strtoull(value, nullptr, 10);
+        }
+        else if (0 == std::strcmp(option, "--workers")) {
+            options.SimConfig.Workers = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+        else if (0 == std::strcmp(option, "--fast-hello")) {
+            options.SimConfig.FastHelloTimeMs = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+        else if (0 == std::strcmp(option, "--output")) {
+            options.Output = value;
+        }
+        else {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<Row> rows;
+    bool allPassed = true;
+    for (const auto& scenario : Catalogue()) {
+        if (not Selected(options, scenario.Name)) {
+            continue;
+        }
+
+        for (const auto& kind : options.Topologies) {
+            for (const u32 size : options.Sizes) {
+                Topology topology{ 0 };
+                try {
+                    topology = BuildTopology(kind, size, options);
+                }
+                catch (const std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    PrintUsage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                topology.SetLinkParams(options.DelayMs, 10000, options.Loss);
+                if (scenario.PrepareTopology) {
+                    scenario.PrepareTopology(topology);
+                }
+
+                Network network{ topology, options.SimConfig };
+                Row row{ scenario.Name, topology.Name(), topology.BridgeCount(),
+                         topology.Links().size(), Outcome{} };
+                if (scenario.PrepareNetwork && Failed(scenario.PrepareNetwork(network))) {
+                    row.Measurement = Failure("cannot prepare network");
+                }
+                else if (not network.RunUntilStable(options.LimitMs).Converged) {
+                    row.Measurement = Failure("initial convergence exceeded time limit");
+                }
+                else {
+                    row.Measurement = scenario.Trigger(network, options);
+                }
+
+                allPassed = allPassed && ("failed" != row.Measurement.Status);
+                PrintRow(row);
+                rows.push_back(row);
+            }
+        }
+    }
+
+    if (not options.Output.empty()) {
+        std::ofstream out{ options.Output };
+        if (not out) {
+            std::cerr << "Cannot open " << options.Output << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        WriteJson(out, options, rows);
+    }
+
+    return allPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,136 @@
+// STP Simulator
+#include "stp/sim/network.hpp"
+#include "stp/sim/topology.hpp"
+
+// C++ Standard Library
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace Stp;
+using namespace Stp::Sim;
+
+namespace {
+
+void PrintUsage(const char* name) {
+    std::cerr << "Usage: " << name << " <ring|mesh|fattree|random> <size> [options]\n"
+              << "  size            number of bridges (arity k for fattree)\n"
+              << "  --degree N      average degree of random topology (default 4)\n"
+              << "  --delay MS      one-way link delay (default 1)\n"
+              << "  --loss P        probability of losing BPDU on link (default 0)\n"
+              << "  --seed N        seed of tick phases, losses and random topology (default 1)\n"
+              << "  --limit MS      time limit of single measurement (default 600000)\n"
+              << "  --workers N     number of simulation threads (default 1)\n"
+              << "  --fail-link N   fail link N after initial convergence\n"
+              << "  --fail-bridge N fail bridge N after initial convergence\n";
+}
+
+void PrintReport(const std::string& phase, const Report& report) {
+    std::cout << phase
+              << ": converged=" << (report.Converged ? "yes" : "no")
+              << " time_ms=" << report.ConvergenceTimeMs
+              << " roots=" << report.RootCount
+              << " bpdus_sent=" << report.BpdusSent
+              << " bpdus_delivered=" << report.BpdusDelivered
+              << " bpdus_lost=" << report.BpdusLost
+              << " fdb_flushes=" << report.FdbFlushes
+              << " events=" << report.Events << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::string kind{ argv[1] };
+    const u32 size = static_cast<u32>(std::strtoul(argv[2], nullptr, 10));
+    u32 degree = 4;
+    u32 delayMs = 1;
+    double loss = 0.0;
+    u64 limitMs = 600000;
+    long failLink = -1;
+    long failBridge = -1;
+    Config config{};
+
+    for (int idx = 3; idx + 1 < argc; idx += 2) {
+        const char* option = argv[idx];
+        const char* value = argv[idx + 1];
+        if (0 == std::strcmp(option, "--degree")) {
+            degree = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+        else if (0 == std::strcmp(option, "--delay")) {
+            delayMs = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+        else if (0 == std::strcmp(option, "--loss")) {
+            loss = std::strtod(value, nullptr);
+        }
+        else if (0 == std::strcmp(option, "--seed")) {
+            config.Seed = std::strtoull(value, nullptr, 10);
+        }
+        else if (0 == std::strcmp(option, "--limit")) {
+            limitMs = std::strtoull(value, nullptr, 10);
+        }
+        else if (0 == std::strcmp(option, "--workers")) {
+            config.Workers = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+        else if (0 == std::strcmp(option, "--fail-link")) {
+            failLink = std::strtol(value, nullptr, 10);
+        }
+        else if (0 == std::strcmp(option, "--fail-bridge")) {
+            failBridge = std::strtol(value, nullptr, 10);
+        }
+        else {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    Topology topology{ 0 };
+    if ("ring" == kind) {
+        topology = Topology::Ring(size);
+    }
+    else if ("mesh" == kind) {
+        topology = Topology::FullMesh(size);
+    }
+    else if ("fattree" == kind) {
+        topology = Topology::FatTree(size);
+    }
+    else if ("random" == kind) {
+        topology = Topology::Random(size, degree, config.Seed);
+    }
+    else {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    topology.SetLinkParams(delayMs, 10000, loss);
+    std::cout << "topology=" << topology.Name() << " bridges=" << topology.BridgeCount()
+              << " links=" << topology.Links().size() << std::endl;
+
+    Network network{ topology, config };
+    PrintReport("initial", network.RunUntilStable(limitMs));
+
+    if (failLink >= 0) {
+        if (Failed(network.FailLink(static_cast<u32>(failLink)))) {
+            std::cerr << "Invalid link " << failLink << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        PrintReport("link-failure", network.RunUntilStable(limitMs));
+    }
+
+    if (failBridge >= 0) {
+        if (Failed(network.FailBridge(static_cast<u32>(failBridge)))) {
+            std::cerr << "Invalid bridge " << failBridge << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        PrintReport("bridge-failure", network.RunUntilStable(limitMs));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,596 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/sim/network.hpp"
+#include "stp/sim/hash.hpp"
+
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+// POSIX
+#include <time.h>
+
+namespace Stp {
+namespace Sim {
+
+namespace {
+
+constexpr u64 kNoEventMs = std::numeric_limits<u64>::max();
+
+class NullLogger : public LoggingSystem::Logger {
+public:
+    void operator<<(std::string&& msg) noexcept override { std::ignore = msg; }
+};
+
+/// @brief Locally administered MAC address, the lower index the better bridge identifier
+Mac BridgeAddress(const u32 bridge) noexcept {
+    const u64 addr = 0x020000000000ULL + bridge + 1;
+    return Mac{ Bpdu::BridgeSystemIdHandler{{
+                    static_cast<u8>(addr >> 40), static_cast<u8>(addr >> 32),
+                    static_cast<u8>(addr >> 24), static_cast<u8>(addr >> 16),
+                    static_cast<u8>(addr >> 8), static_cast<u8>(addr)
+                }} };
+}
+
+u64 ThreadCpuNs() noexcept {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<u64>(now.tv_sec) * 1000000000ULL + static_cast<u64>(now.tv_nsec);
+}
+
+u64 RootKey(const Bridge& bridge) noexcept {
+    const BridgeId& root = bridge.RootPriority().RootBridgeId();
+    return (static_cast<u64>(root.Priority()) << 48) | root.Address().ConvertToInteger();
+}
+
+} // namespace
+
+/**
+ * @brief The BridgeOutInterface class connects transmit path of the engine with the network
+ */
+class Network::BridgeOutInterface final : public OutInterface {
+public:
+    BridgeOutInterface(Network& network, const u32 bridge) noexcept
+        : _network{ network }, _bridge{ bridge } {}
+
+    Result FlushFdb(const u16 portNo) __noexcept override {
+        std::ignore = portNo;
+        _network.CountFdbFlush(_bridge);
+        return Result::Success;
+    }
+
+    Result SetForwarding(const u16 portNo, const bool enable) __noexcept override {
+        std::ignore = portNo;
+        std::ignore = enable;
+        return Result::Success;
+    }
+
+    Result SetLearning(const u16 portNo, const bool enable) __noexcept override {
+        std::ignore = portNo;
+        std::ignore = enable;
+        return Result::Success;
+    }
+
+    Result SendOutBpdu(const u16 portNo, ByteStreamH data) __noexcept override {
+        _network.Transmit(_bridge, portNo, data);
+        return Result::Success;
+    }
+
+private:
+    Network& _network;
+    u32 _bridge;
+};
+
+/**
+ * @brief The Barrier class synchronizes workers at the end of every window. Windows are short,
+ *        so waiting workers spin instead of sleeping on condition variable.
+ */
+class Network::Barrier {
+public:
+    explicit Barrier(const u32 parties) noexcept
+        : _parties{ parties }, _waiting{ 0 }, _generation{ 0 } {}
+
+    void Wait() noexcept {
+        const u64 generation = _generation.load(std::memory_order_acquire);
+        if (_waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == _parties) {
+            _waiting.store(0, std::memory_order_relaxed);
+            _generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+
+        while (_generation.load(std::memory_order_acquire) == generation) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    const u32 _parties;
+    std::atomic<u32> _waiting;
+    std::atomic<u64> _generation;
+};
+
+bool Network::Event::operator>(const Event& other) const noexcept {
+    return std::tie(TimeMs, Bridge, Kind, SrcBridge, SrcSeq, Port)
+            > std::tie(other.TimeMs, other.Bridge, other.Kind, other.SrcBridge, other.SrcSeq,
+                       other.Port);
+}
+
+Network::Counters& Network::Counters::operator+=(const Counters& other) noexcept {
+    BpdusSent += other.BpdusSent;
+    BpdusDelivered += other.BpdusDelivered;
+    BpdusLost += other.BpdusLost;
+    FdbFlushes += other.FdbFlushes;
+    Events += other.Events;
+    CpuNs += other.CpuNs;
+
+    return *this;
+}
+
+Network::Network(const Topology& topology, const Config& config)
+    : _topology{ topology }, _config{ config }, _workers{ }, _bridges(topology.BridgeCount()),
+      _linkUp(topology.Links().size(), true), _hostPortUp(topology.HostPorts().size(), true),
+      _lookaheadMs{ config.StableWindowMs }, _nowMs{ 0 }, _lastChangeMs{ 0 },
+      _stopWhenStable{ true } {
+    for (const Link& link : topology.Links()) {
+        if (0 == link.DelayMs) {
+            throw std::invalid_argument("Delay of link has to be at least 1 ms");
+        }
+
+        _lookaheadMs = std::min<u64>(_lookaheadMs, link.DelayMs);
+    }
+
+    _lookaheadMs = std::max<u64>(_lookaheadMs, 1);
+    const u32 workers = std::max<u32>(1, std::min(_config.Workers,
+                                                  std::max<u32>(1, topology.BridgeCount())));
+    for (u32 workerIdx = 0; workerIdx < workers; ++workerIdx) {
+        Uptr<Worker> worker = std::make_unique<Worker>();
+        worker->Mailboxes[0].resize(workers);
+        worker->Mailboxes[1].resize(workers);
+        worker->Clock = std::make_shared<VirtualClock>();
+        worker->Stats = Counters{ };
+        worker->NowMs = 0;
+        worker->LastChangeMs = 0;
+        worker->SentMinMs = kNoEventMs;
+        worker->Slot = 0;
+        _workers.push_back(std::move(worker));
+    }
+
+    for (u32 bridge = 0; bridge < _bridges.size(); ++bridge) {
+        BridgeNode& node = _bridges[bridge];
+        // Contiguous blocks of bridges keep neighbours of generated topologies together
+        node.Worker = static_cast<u32>(static_cast<u64>(bridge) * workers / _bridges.size());
+        node.PortLinks.resize(topology.PortCount(bridge));
+        node.PortTxSeq.resize(topology.PortCount(bridge), 0);
+        node.TxSeq = 0;
+        node.Signature = 0;
+        node.Up = true;
+    }
+
+    for (u32 linkIdx = 0; linkIdx < topology.Links().size(); ++linkIdx) {
+        const Link& link = topology.Links()[linkIdx];
+        _bridges[link.BridgeA].PortLinks[link.PortA - 1] = linkIdx;
+        _bridges[link.BridgeB].PortLinks[link.PortB - 1] = linkIdx;
+    }
+
+    for (u32 hostIdx = 0; hostIdx < topology.HostPorts().size(); ++hostIdx) {
+        const HostPort& host = topology.HostPorts()[hostIdx];
+        _bridges[host.Bridge].PortLinks[host.Port - 1] = _kHostPortFlag | hostIdx;
+    }
+
+    for (u32 bridge = 0; bridge < _bridges.size(); ++bridge) {
+        CreateEngine(bridge);
+    }
+
+    // Bridges are not synchronized, so each one ticks with its own phase
+    for (u32 bridge = 0; bridge < _bridges.size(); ++bridge) {
+        const u64 phaseMs = Mix64(_config.Seed, bridge) % Time::DefaultTickIntervalMs;
+        _workers[_bridges[bridge].Worker]->Events.push(
+                    Event{ phaseMs, bridge, EventKind::Tick, bridge, 0, 0, nullptr });
+    }
+}
+
+Network::~Network() = default;
+
+Report Network::RunUntilStable(const u64 maxDurationMs) {
+    return Run(maxDurationMs, true);
+}
+
+Report Network::RunFor(const u64 durationMs) {
+    return Run(durationMs, false);
+}
+
+Report Network::Run(const u64 maxDurationMs, const bool stopWhenStable) {
+    _stopWhenStable = stopWhenStable;
+    const u64 startMs = _nowMs;
+    const u64 deadlineMs = startMs + maxDurationMs;
+    const Counters startCounters = TotalCounters();
+
+    // Collects BPDUs sent in the last window of previous run or between runs
+    for (u32 workerIdx = 0; workerIdx < _workers.size(); ++workerIdx) {
+        CollectMail(workerIdx, 0);
+        CollectMail(workerIdx, 1);
+    }
+
+    // The first window reads reports of the "previous" one, which has parity 1
+    for (auto& worker : _workers) {
+        worker->NowMs = startMs;
+        worker->LastChangeMs = startMs;
+        worker->SentMinMs = kNoEventMs;
+        worker->Reports[1] = WindowReport{
+                worker->Events.empty() ? kNoEventMs : worker->Events.top().TimeMs, startMs };
+    }
+
+    if (1 == _workers.size()) {
+        RunWorker(0, deadlineMs, nullptr);
+    }
+    else {
+        Barrier barrier{ WorkerCount() };
+        std::vector<std::thread> threads;
+        for (u32 workerIdx = 1; workerIdx < _workers.size(); ++workerIdx) {
+            threads.emplace_back(&Network::RunWorker, this, workerIdx, deadlineMs, &barrier);
+        }
+
+        RunWorker(0, deadlineMs, &barrier);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    _lastChangeMs = startMs;
+    for (const auto& worker : _workers) {
+        _nowMs = std::max(_nowMs, worker->NowMs);
+        _lastChangeMs = std::max(_lastChangeMs, worker->LastChangeMs);
+    }
+
+    const bool converged = (_lastChangeMs + _config.StableWindowMs <= deadlineMs);
+    _nowMs = (stopWhenStable && converged)
+            ? std::max(_nowMs, _lastChangeMs + _config.StableWindowMs) : deadlineMs;
+    // Engines react on failures injected between runs at once, so BPDUs they send are stamped
+    // with the current time
+    for (auto& worker : _workers) {
+        worker->NowMs = _nowMs;
+        worker->Clock->WaitUntil(std::chrono::milliseconds{ _nowMs });
+    }
+
+    const Counters counters = TotalCounters();
+    Report report{};
+    report.Converged = converged;
+    report.ConvergenceTimeMs = _lastChangeMs - startMs;
+    report.BpdusSent = counters.BpdusSent - startCounters.BpdusSent;
+    report.BpdusDelivered = counters.BpdusDelivered - startCounters.BpdusDelivered;
+    report.BpdusLost = counters.BpdusLost - startCounters.BpdusLost;
+    report.FdbFlushes = counters.FdbFlushes - startCounters.FdbFlushes;
+    report.Events = counters.Events - startCounters.Events;
+    report.CpuTimeUs = (counters.CpuNs - startCounters.CpuNs) / 1000;
+    report.RootCount = CountRoots();
+
+    return report;
+}
+
+Result Network::FailLink(const u32 linkIdx) {
+    if ((linkIdx >= _linkUp.size()) || not _linkUp[linkIdx]) {
+        return Result::Fail;
+    }
+
+    SetLinkUp(linkIdx, false);
+
+    return Result::Success;
+}
+
+Result Network::RestoreLink(const u32 linkIdx) {
+    if ((linkIdx >= _linkUp.size()) || _linkUp[linkIdx]) {
+        return Result::Fail;
+    }
+
+    const Link& link = _topology.Links()[linkIdx];
+    if (not _bridges[link.BridgeA].Up || not _bridges[link.BridgeB].Up) {
+        return Result::Fail;
+    }
+
+    SetLinkUp(linkIdx, true);
+
+    return Result::Success;
+}
+
+Result Network::FailBridge(const u32 bridge) {
+    if ((bridge >= _bridges.size()) || not _bridges[bridge].Up) {
+        return Result::Fail;
+    }
+
+    for (const u32 linkIdx : _bridges[bridge].PortLinks) {
+        if (_linkUp[linkIdx]) {
+            SetLinkUp(linkIdx, false);
+        }
+    }
+
+    _bridges[bridge].Up = false;
+
+    return Result::Success;
+}
+
+Result Network::RestoreBridge(const u32 bridge) {
+    if ((bridge >= _bridges.size()) || _bridges[bridge].Up) {
+        return Result::Fail;
+    }
+
+    BridgeNode& node = _bridges[bridge];
+    CreateEngine(bridge);
+    node.Signature = 0;
+    node.Up = true;
+
+    for (const u32 linkIdx : node.PortLinks) {
+        if (linkIdx & _kHostPortFlag) {
+            continue;
+        }
+
+        const Link& link = _topology.Links()[linkIdx];
+        const u32 peer = (link.BridgeA == bridge) ? link.BridgeB : link.BridgeA;
+        if (not _linkUp[linkIdx] && _bridges[peer].Up) {
+            SetLinkUp(linkIdx, true);
+        }
+    }
+
+    return Result::Success;
+}
+
+Result Network::FailHostPort(const u32 hostIdx) {
+    if ((hostIdx >= _hostPortUp.size()) || not _hostPortUp[hostIdx]) {
+        return Result::Fail;
+    }
+
+    const HostPort& host = _topology.HostPorts()[hostIdx];
+    _hostPortUp[hostIdx] = false;
+    _bridges[host.Bridge].Engine->SetPortEnabled(host.Port, false);
+
+    return Result::Success;
+}
+
+Result Network::RestoreHostPort(const u32 hostIdx) {
+    if ((hostIdx >= _hostPortUp.size()) || _hostPortUp[hostIdx]) {
+        return Result::Fail;
+    }
+
+    const HostPort& host = _topology.HostPorts()[hostIdx];
+    _hostPortUp[hostIdx] = true;
+    _bridges[host.Bridge].Engine->SetPortEnabled(host.Port, true);
+
+    return Result::Success;
+}
+
+Result Network::SetBridgeConfig(const u32 bridge, const BridgeConfig& config) {
+    if (bridge >= _bridges.size()) {
+        return Result::Fail;
+    }
+
+    BridgeNode& node = _bridges[bridge];
+    if (Failed(node.Engine->SetBridgeConfig(config))) {
+        return Result::Fail;
+    }
+
+    node.Settings = config;
+
+    return Result::Success;
+}
+
+void Network::CreateEngine(const u32 bridge) {
+    BridgeNode& node = _bridges[bridge];
+    SystemH system = std::make_shared<System>(
+                std::make_shared<BridgeOutInterface>(*this, bridge),
+                std::make_shared<NullLogger>(), _workers[node.Worker]->Clock);
+    node.Engine = std::make_unique<Engine>(BridgeAddress(bridge), system);
+    node.Engine->SetBridgeConfig(node.Settings);
+
+    for (u16 portNo = 1; portNo <= node.PortLinks.size(); ++portNo) {
+        const u32 linkIdx = node.PortLinks[portNo - 1];
+        if (linkIdx & _kHostPortFlag) {
+            const u32 hostIdx = linkIdx & ~_kHostPortFlag;
+            node.Engine->AddPort(portNo, _topology.HostPorts()[hostIdx].SpeedMb,
+                                 _hostPortUp[hostIdx]);
+        }
+        else {
+            node.Engine->AddPort(portNo, _topology.Links()[linkIdx].SpeedMb, _linkUp[linkIdx]);
+            node.Engine->SetPortPointToPoint(portNo, _config.PointToPointLinks);
+            node.Engine->SetPortFastHello(portNo, _config.FastHelloTimeMs);
+        }
+    }
+}
+
+void Network::RunWorker(const u32 workerIdx, const u64 deadlineMs, Barrier* barrier) {
+    Worker& worker = *_workers[workerIdx];
+    const u64 cpuStartNs = ThreadCpuNs();
+    u64 endMs = 0;
+
+    for (u64 window = 0; ; ++window) {
+        // Every worker reads the same reports, so all of them agree on the window
+        const u32 previousSlot = static_cast<u32>((window + 1) % 2);
+        if (not NextWindow(previousSlot, deadlineMs, endMs)) {
+            break;
+        }
+
+        worker.Slot = static_cast<u32>(window % 2);
+        worker.SentMinMs = kNoEventMs;
+        CollectMail(workerIdx, previousSlot);
+
+        while (not worker.Events.empty() && (worker.Events.top().TimeMs < endMs)) {
+            const Event event = worker.Events.top();
+            worker.Events.pop();
+            worker.NowMs = event.TimeMs;
+            worker.Clock->WaitUntil(std::chrono::milliseconds{ worker.NowMs });
+            ++worker.Stats.Events;
+            Process(worker, event);
+        }
+
+        const u64 nextMs = worker.Events.empty() ? kNoEventMs : worker.Events.top().TimeMs;
+        worker.Reports[worker.Slot] = WindowReport{ std::min(nextMs, worker.SentMinMs),
+                                                    worker.LastChangeMs };
+        if (barrier) {
+            barrier->Wait();
+        }
+    }
+
+    worker.Stats.CpuNs += ThreadCpuNs() - cpuStartNs;
+}
+
+bool Network::NextWindow(const u32 slot, const u64 deadlineMs, u64& endMs) const noexcept {
+    u64 nextMs = kNoEventMs;
+    u64 lastChangeMs = 0;
+    for (const auto& worker : _workers) {
+        nextMs = std::min(nextMs, worker->Reports[slot].NextTimeMs);
+        lastChangeMs = std::max(lastChangeMs, worker->Reports[slot].LastChangeMs);
+    }
+
+    // Change within the window is not earlier than its start, so it moves the stable point
+    // beyond the window (lookahead never exceeds stable window) and cannot shorten the window
+    const u64 stableMs = _stopWhenStable ? lastChangeMs + _config.StableWindowMs : kNoEventMs;
+    if ((kNoEventMs == nextMs) || (nextMs > deadlineMs) || (nextMs >= stableMs)) {
+        return false;
+    }
+
+    endMs = std::min({ nextMs + _lookaheadMs, stableMs, deadlineMs + 1 });
+
+    return true;
+}
+
+void Network::CollectMail(const u32 workerIdx, const u32 slot) {
+    Worker& worker = *_workers[workerIdx];
+    for (auto& sender : _workers) {
+        auto& mailbox = sender->Mailboxes[slot][workerIdx];
+        for (auto& event : mailbox) {
+            worker.Events.push(std::move(event));
+        }
+
+        mailbox.clear();
+    }
+}
+
+void Network::Transmit(const u32 bridge, const u16 portNo, ByteStreamH data) {
+    BridgeNode& node = _bridges[bridge];
+    Worker& worker = *_workers[node.Worker];
+    ++worker.Stats.BpdusSent;
+    ++node.TxSeq;
+
+    const u32 linkIdx = node.PortLinks[portNo - 1];
+    if (linkIdx & _kHostPortFlag) {
+        // Hosts do not run spanning tree protocol
+        ++worker.Stats.BpdusLost;
+        return;
+    }
+
+    const Link& link = _topology.Links()[linkIdx];
+    // Each direction of link is owned by the sending bridge, so losses do not depend on order
+    // in which workers process bridges
+    const u64 portSeq = node.PortTxSeq[portNo - 1]++;
+    if (not _linkUp[linkIdx]
+            || ((link.Loss > 0.0)
+                && (UnitInterval(Mix64(Mix64(Mix64(_config.Seed, linkIdx), bridge), portSeq))
+                    < link.Loss))) {
+        ++worker.Stats.BpdusLost;
+        return;
+    }
+
+    const bool fromA = (link.BridgeA == bridge) && (link.PortA == portNo);
+    const u32 peer = fromA ? link.BridgeB : link.BridgeA;
+    const u16 peerPort = fromA ? link.PortB : link.PortA;
+    Event event{ worker.NowMs + link.DelayMs, peer, EventKind::Deliver, bridge, node.TxSeq,
+                 peerPort, data };
+    const u32 peerWorker = _bridges[peer].Worker;
+    if (peerWorker == node.Worker) {
+        worker.Events.push(std::move(event));
+    }
+    else {
+        worker.SentMinMs = std::min(worker.SentMinMs, event.TimeMs);
+        worker.Mailboxes[worker.Slot][peerWorker].push_back(std::move(event));
+    }
+}
+
+void Network::CountFdbFlush(const u32 bridge) noexcept {
+    ++_workers[_bridges[bridge].Worker]->Stats.FdbFlushes;
+}
+
+void Network::Process(Worker& worker, const Event& event) {
+    BridgeNode& node = _bridges[event.Bridge];
+
+    switch (event.Kind) {
+    case EventKind::Deliver:
+        if (not node.Up || not _linkUp[node.PortLinks[event.Port - 1]]) {
+            // Link went down while BPDU was on the wire
+            ++worker.Stats.BpdusLost;
+            return;
+        }
+
+        ++worker.Stats.BpdusDelivered;
+        node.Engine->ProcessBpdu(event.Port, *event.Data);
+        break;
+    case EventKind::Tick:
+        // Failed bridge keeps its tick phase, so it's the same when the bridge is restored
+        if (node.Up) {
+            node.Engine->Tick();
+            UpdateSignature(worker, event.Bridge);
+        }
+
+        worker.Events.push(Event{ event.TimeMs + node.Engine->TickIntervalMs(), event.Bridge,
+                                  EventKind::Tick, event.Bridge, 0, 0, nullptr });
+        break;
+    }
+}
+
+void Network::UpdateSignature(Worker& worker, const u32 bridge) {
+    BridgeNode& node = _bridges[bridge];
+    const Bridge& bridgeInstance = node.Engine->BridgeInstance();
+    u64 signature = RootKey(bridgeInstance);
+
+    for (const auto& port : bridgeInstance.AllPorts()) {
+        const u64 portState = (static_cast<u64>(port.first) << 16)
+                | (static_cast<u64>(port.second->Role()) << 8)
+                | (static_cast<u64>(port.second->Learning()) << 1)
+                | static_cast<u64>(port.second->Forwarding());
+        signature = Mix64(signature, portState);
+    }
+
+    if (signature != node.Signature) {
+        node.Signature = signature;
+        worker.LastChangeMs = std::max(worker.LastChangeMs, worker.NowMs);
+    }
+}
+
+Network::Counters Network::TotalCounters() const noexcept {
+    Counters total{ };
+    for (const auto& worker : _workers) {
+        total += worker->Stats;
+    }
+
+    return total;
+}
+
+u32 Network::CountRoots() const {
+    std::set<u64> roots;
+    for (const auto& node : _bridges) {
+        if (node.Up) {
+            roots.insert(RootKey(node.Engine->BridgeInstance()));
+        }
+    }
+
+    return static_cast<u32>(roots.size());
+}
+
+void Network::SetLinkUp(const u32 linkIdx, const bool up) {
+    const Link& link = _topology.Links()[linkIdx];
+    _linkUp[linkIdx] = up;
+    _bridges[link.BridgeA].Engine->SetPortEnabled(link.PortA, up);
+    _bridges[link.BridgeB].Engine->SetPortEnabled(link.PortB, up);
+}
+
+} // namespace Sim
+} // namespace Stp
@@ -0,0 +1,161 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/sim/topology.hpp"
+#include "stp/sim/hash.hpp"
+
+// C++ Standard Library
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace Stp {
+namespace Sim {
+
+Topology::Topology(const u32 bridgeCount)
+    : _bridgeCount{ bridgeCount }, _portCount(bridgeCount, 0), _links{ }, _hostPorts{ },
+      _name{ "custom" } {
+    // Nothing more to do
+}
+
+Result Topology::Connect(const u32 bridgeA, const u32 bridgeB) {
+    if ((bridgeA >= _bridgeCount) || (bridgeB >= _bridgeCount) || (bridgeA == bridgeB)) {
+        return Result::Fail;
+    }
+
+    if ((_portCount[bridgeA] >= MaxPortsPerBridge) || (_portCount[bridgeB] >= MaxPortsPerBridge)) {
+        return Result::Fail;
+    }
+
+    constexpr u32 kDefaultDelayMs = 1;
+    constexpr u32 kDefaultSpeedMb = 10000;
+    _links.push_back(Link{ bridgeA, ++_portCount[bridgeA], bridgeB, ++_portCount[bridgeB],
+                           kDefaultDelayMs, kDefaultSpeedMb, 0.0 });
+
+    return Result::Success;
+}
+
+Result Topology::AttachHost(const u32 bridge) {
+    if ((bridge >= _bridgeCount) || (_portCount[bridge] >= MaxPortsPerBridge)) {
+        return Result::Fail;
+    }
+
+    constexpr u32 kDefaultSpeedMb = 1000;
+    _hostPorts.push_back(HostPort{ bridge, ++_portCount[bridge], kDefaultSpeedMb });
+
+    return Result::Success;
+}
+
+void Topology::SetLinkParams(const u32 delayMs, const u32 speedMb, const double loss) noexcept {
+    for (auto& link : _links) {
+        link.DelayMs = delayMs;
+        link.SpeedMb = speedMb;
+        link.Loss = loss;
+    }
+}
+
+Topology Topology::Ring(const u32 bridgeCount) {
+    Topology topology{ bridgeCount };
+    topology._name = "ring";
+    for (u32 bridge = 0; (bridgeCount > 2) && (bridge < bridgeCount); ++bridge) {
+        topology.Connect(bridge, (bridge + 1) % bridgeCount);
+    }
+
+    if (2 == bridgeCount) {
+        topology.Connect(0, 1);
+    }
+
+    return topology;
+}
+
+Topology Topology::FullMesh(const u32 bridgeCount) {
+    if (bridgeCount > MaxPortsPerBridge + 1) {
+        throw std::invalid_argument("Too many bridges for full mesh");
+    }
+
+    Topology topology{ bridgeCount };
+    topology._name = "mesh";
+    for (u32 bridgeA = 0; bridgeA < bridgeCount; ++bridgeA) {
+        for (u32 bridgeB = bridgeA + 1; bridgeB < bridgeCount; ++bridgeB) {
+            topology.Connect(bridgeA, bridgeB);
+        }
+    }
+
+    return topology;
+}
+
+Topology Topology::FatTree(const u32 k) {
+    if ((k < 2) || (k % 2) || (k > MaxPortsPerBridge)) {
+        throw std::invalid_argument("Fat-tree arity has to be even number");
+    }
+
+    const u32 half = k / 2;
+    const u32 coreCount = half * half;
+    const u32 podSize = k; // half edge and half aggregation switches
+    Topology topology{ coreCount + k * podSize };
+    topology._name = "fattree";
+
+    // Core switches go first, so they get the lowest addresses and one of them becomes the root
+    for (u32 pod = 0; pod < k; ++pod) {
+        const u32 aggBase = coreCount + pod * podSize;
+        const u32 edgeBase = aggBase + half;
+        for (u32 agg = 0; agg < half; ++agg) {
+            for (u32 core = 0; core < half; ++core) {
+                topology.Connect(agg * half + core, aggBase + agg);
+            }
+
+            for (u32 edge = 0; edge < half; ++edge) {
+                topology.Connect(aggBase + agg, edgeBase + edge);
+            }
+        }
+    }
+
+    return topology;
+}
+
+Topology Topology::Random(const u32 bridgeCount, const u32 averageDegree, const u64 seed) {
+    Topology topology{ bridgeCount };
+    topology._name = "random";
+    std::set<std::pair<u32, u32>> connected;
+    u64 draw = 0;
+    auto next = [&draw, seed](const u64 range) {
+        return Mix64(seed, draw++) % range;
+    };
+    auto connect = [&topology, &connected](u32 bridgeA, u32 bridgeB) {
+        if (bridgeA > bridgeB) {
+            std::swap(bridgeA, bridgeB);
+        }
+
+        if (not connected.emplace(bridgeA, bridgeB).second) {
+            return false;
+        }
+
+        return not Failed(topology.Connect(bridgeA, bridgeB));
+    };
+
+    // Random spanning tree keeps the graph connected
+    for (u32 bridge = 1; bridge < bridgeCount; ++bridge) {
+        connect(bridge, static_cast<u32>(next(bridge)));
+    }
+
+    if (bridgeCount < 2) {
+        return topology;
+    }
+
+    const u64 maxLinks = static_cast<u64>(bridgeCount) * (bridgeCount - 1) / 2;
+    const u64 wantedLinks = std::min<u64>(maxLinks,
+                                          static_cast<u64>(bridgeCount) * averageDegree / 2);
+    u64 attempts = 0;
+    while ((topology._links.size() < wantedLinks) && (attempts++ < 16 * wantedLinks)) {
+        connect(static_cast<u32>(next(bridgeCount)), static_cast<u32>(next(bridgeCount)));
+    }
+
+    return topology;
+}
+
+} // namespace Sim
+} // namespace Stp
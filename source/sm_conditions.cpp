@@ -22,22 +22,23 @@ enum Port::RcvdInfo RcvInfo(Port& port) noexcept {
         port.GetMsgPriority().SetDesignatedBridgeId(BridgeId(port.RxBpdu().BridgeIdentifier()));
         port.GetMsgPriority().SetDesignatedPortId(PortId(port.RxBpdu().PortIdentifier()));
 
-        port.GetMsgTimes().SetMessageAge(port.RxBpdu().MessageAge());
-        port.GetMsgTimes().SetMaxAge(port.RxBpdu().MaxAge());
-        port.GetMsgTimes().SetHelloTime(port.RxBpdu().HelloTime());
-        port.GetMsgTimes().SetForwardDelay(port.RxBpdu().ForwardDelay());
+        port.GetMsgTimes().SetMessageAge(Time::FromBpduUnits(port.RxBpdu().MessageAge()));
+        port.GetMsgTimes().SetMaxAge(Time::FromBpduUnits(port.RxBpdu().MaxAge()));
+        port.GetMsgTimes().SetHelloTime(Time::FromBpduUnits(port.RxBpdu().HelloTime()));
+        port.GetMsgTimes().SetForwardDelay(Time::FromBpduUnits(port.RxBpdu().ForwardDelay()));
     }
 
     PortRole encodedPortRole = port.RxBpdu().PortRoleFlag();
     enum Port::RcvdInfo result = Port::RcvdInfo::OtherInfo;
 
-    /// @note A Configuration BPDU explicitly conveys a Designated Port Role.
-    if (encodedPortRole != PortRole::Designated) {
-        if (Bpdu::Type::Config == port.RxBpdu().BpduType()) {
-            if (port.RcvdBpdu()) {
-                encodedPortRole = PortRole::Designated;
-            }
-        }
+    /// @note A Configuration BPDU explicitly conveys a Designated Port Role. Port Receive
+    ///       machine has already cleared rcvdBpdu, so only type of the BPDU is checked.
+    if (+Bpdu::Type::Config == port.RxBpdu().BpduType()) {
+        encodedPortRole = PortRole::Designated;
+    }
+    else if (+Bpdu::Type::Tcn == port.RxBpdu().BpduType()) {
+        /// @note 17.21.8 e) TCN BPDU does not carry priority vector
+        return result;
     }
 
     switch (encodedPortRole) {
@@ -48,6 +49,16 @@ enum Port::RcvdInfo RcvInfo(Port& port) noexcept {
             break;
         }
 
+        /// @note 17.6 Message from the same designated port is superior even if it is worse
+        if ((port.MsgPriority().DesignatedBridgeId().Address()
+             == port.PortPriority().DesignatedBridgeId().Address())
+                && (port.MsgPriority().DesignatedPortId().PortNum()
+                    == port.PortPriority().DesignatedPortId().PortNum())
+                && not (port.MsgPriority() == port.PortPriority())) {
+            result = Port::RcvdInfo::SuperiorDesignatedInfo;
+            break;
+        }
+
         if (port.MsgPriority() == port.PortPriority()) {
             if (port.MsgTimes().ForwardDelay() != port.PortTimes().ForwardDelay()) {
                 result = Port::RcvdInfo::SuperiorDesignatedInfo; ///< 17.21.8 a2)
@@ -93,7 +104,7 @@ bool ReRooted(Bridge& bridge, const Port& port) noexcept {
         if (otherPortMapIt.second->PortId().PortNum() == port.PortId().PortNum()) {
             continue;
         }
-        else if (SmTimers::TimedOut(port.GetSmTimersInstance().RrWhile())) {
+        else if (SmTimers::TimedOut(otherPortMapIt.second->GetSmTimersInstance().RrWhile())) {
             continue;
         }
 
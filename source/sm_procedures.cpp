@@ -8,10 +8,12 @@
 #include "stp/sm_procedures.hpp"
 // Dependencies
 #include "stp/bpdu.hpp"
+#include "stp/perf_params.hpp"
 #include "stp/sm_conditions.hpp"
 #include "stp/time.hpp"
 
 // C++ Standard Library
+#include <algorithm>
 #include <iostream>
 
 struct RootPathPriority {
@@ -66,25 +68,32 @@ bool BetterOrSameInfo(Port& port, const Port::Info newInfoIs) noexcept {
 }
 
 void ClearReselectTree(Bridge& bridge) noexcept {
+    bridge.SetTreeChanged(true);
     for (auto& portMapIt : bridge.GetAllPorts()) {
         portMapIt.second->SetReselect(false);
     }
 }
 
-void FlushFdb(Bridge& bridge, const Port& port) noexcept {
+void FlushFdb(Bridge& bridge, Port& port) noexcept {
+    port.SetFdbFlush(true);
     if (Failed(bridge.FlushFdb(port.PortId().PortNum()))) {
         /// @todo Log failed action
+        return;
     }
+
+    // Entries are removed before the out interface returns, so the flag is reset at once.
+    // Otherwise TCM would never leave INACTIVE state.
+    port.SetFdbFlush(false);
 }
 
-u16 MaxAge(const Port& port) noexcept {
+u32 MaxAge(const Port& port) noexcept {
     return port.DesignatedTimes().MaxAge();
 }
 
 void NewTcWhile(const Bridge& bridge, Port& port) noexcept {
     if (0 == port.SmTimersInstance().TcWhile()) {
         if (port.SendRstp()) {
-            port.SmTimersInstance().SetTcWhile(port.PortTimes().HelloTime() + 1); // plus one second
+            port.SmTimersInstance().SetTcWhile(port.PortTimes().HelloTime() + Time::MsPerSecond);
             port.SetNewInfo(true);
         }
         else {
@@ -99,13 +108,10 @@ void RecordAgreement(Bridge& bridge, Port& port) noexcept {
     if (not SmConditions::RstpVersion(bridge)) {
         agreed = false;
     }
-    else if (not port.operPointToPointMAC) {
+    else if (not port.OperPointToPointMAC()) {
         agreed = false;
     }
-    else if (not port.RcvdBpdu()) {
-        agreed = false;
-    }
-    else if (not (Bpdu::Type::Config == port.RxBpdu().BpduType())) {
+    else if (not (Bpdu::Type::Rst == port.RxBpdu().BpduType())) {
         agreed = false;
     }
     else if (not port.RxBpdu().AgreementFlag()) {
@@ -123,10 +129,7 @@ void RecordAgreement(Bridge& bridge, Port& port) noexcept {
 
 
 void RecordDispute(Port& port) noexcept {
-    if (not port.RcvdBpdu()) {
-        return;
-    }
-    else if (Bpdu::Type::Rst == port.RxBpdu().BpduType()) {
+    if (not (Bpdu::Type::Rst == port.RxBpdu().BpduType())) {
         return;
     }
     else if (not port.RxBpdu().LearnigFlag()) {
@@ -142,7 +145,7 @@ void RecordPriority(Port& port) noexcept {
 }
 
 void RecordProposal(Port& port) noexcept {
-    if (not (Bpdu::Type::Config == port.RxBpdu().BpduType())) {
+    if (not (Bpdu::Type::Rst == port.RxBpdu().BpduType())) {
         return;
     }
     else if (not (PortRole::Designated == port.RxBpdu().PortRoleFlag())) {
@@ -155,16 +158,27 @@ void RecordProposal(Port& port) noexcept {
     port.SetProposed(true);
 }
 
+void RecordRepeatedBpdu(Port& port) noexcept {
+    // Same effect as the RECEIVE state of the Port Receive state machine followed by the
+    // REPEATED_DESIGNATED state of the Port Information state machine for BPDU without flags
+    UpdtBpduVersion(port);
+    port.SetOperEdge(false);
+    port.SmTimersInstance().SetEdgeDelayWhile(PerfParams::MigrateTime());
+    UpdtRcvdInfoWhile(port);
+}
+
 void RecordTimes(Port& port) noexcept {
     port.GetPortTimes().SetMessageAge(port.MsgTimes().MessageAge());
     port.GetPortTimes().SetMaxAge(port.MsgTimes().MaxAge());
     port.GetPortTimes().SetForwardDelay(port.MsgTimes().ForwardDelay());
-    // 1 is minimum compatability range value of Hello Time parameter
-    const u16 helloTime = port.MsgTimes().HelloTime() > 1 ? port.MsgTimes().HelloTime() : 1;
-    port.GetPortTimes().SetHelloTime(helloTime);
+    // 1 s is minimum compatability range value of Hello Time parameter, unless the port has been
+    // configured to exchange BPDUs faster
+    const u32 minHelloTime = port.FastHelloTime() ? Time::MinFastHelloTimeMs : Time::MsPerSecond;
+    port.GetPortTimes().SetHelloTime(std::max(port.MsgTimes().HelloTime(), minHelloTime));
 }
 
 void SetReRootTree(Bridge& bridge) noexcept {
+    bridge.SetTreeChanged(true);
     for (auto& portMapIt : bridge.GetAllPorts()) {
         portMapIt.second->SetReRoot(true);
     }
@@ -181,6 +195,7 @@ void SetSelectedTree(Bridge& bridge) noexcept {
     }
 
     if (not reselect) {
+        bridge.SetTreeChanged(true);
         for (auto& portMapIt : bridge.GetAllPorts()) {
             portMapIt.second->SetSelected(true);
         }
@@ -188,16 +203,13 @@ void SetSelectedTree(Bridge& bridge) noexcept {
 }
 
 void SetSyncTree(Bridge& bridge) noexcept {
+    bridge.SetTreeChanged(true);
     for (auto& portMapIt : bridge.GetAllPorts()) {
         portMapIt.second->SetSync(true);
     }
 }
 
 void SetTcFlags(Port& port) noexcept {
-    if (not port.RcvdBpdu()) {
-        return;
-    }
-
     switch (static_cast<Bpdu::Type>(port.RxBpdu().BpduType())) {
     case Bpdu::Type::Config:
     case Bpdu::Type::Rst: {
@@ -212,12 +224,7 @@ void SetTcFlags(Port& port) noexcept {
         break;
     }
     case Bpdu::Type::Tcn:
-        if (port.RcvdBpdu()) {
-            if (Bpdu::Type::Tcn == port.RxBpdu().BpduType()) {
-                port.SetRcvdTcn(true);
-            }
-        }
-
+        port.SetRcvdTcn(true);
         break;
     default:
         std::cerr << __PRETTY_FUNCTION__ << "Invalid BPDU type\n";
@@ -226,6 +233,7 @@ void SetTcFlags(Port& port) noexcept {
 }
 
 void SetTcPropTree(Bridge& bridge, const Port& port) noexcept {
+    bridge.SetTreeChanged(true);
     for (auto& portMapIt : bridge.GetAllPorts()) {
         Port& otherPort = *(portMapIt.second);
         if (otherPort.PortId().PortNum() != port.PortId().PortNum()) {
@@ -242,7 +250,6 @@ void TxConfig(Bridge& bridge, Port& port) {
 
     ByteStreamH bpduStream { std::make_shared<ByteStream>() };
     Bpdu bpdu;
-    u16 time;
 
     bpdu.SetProtocolIdentifier(static_cast<u16>(Bpdu::ProtocolIdentifier::Config));
     bpdu.SetProtocolVersionIdentifier(static_cast<u8>(Bpdu::ProtocolVersionIdentifier::Config));
@@ -261,28 +268,18 @@ void TxConfig(Bridge& bridge, Port& port) {
     bpdu.SetBridgeIdentifier(port.DesignatedPriority().DesignatedBridgeId().ConvertToBpduData());
     bpdu.SetPortIdentifier(port.DesignatedPriority().DesignatedPortId().ConvertToBpduData());
 
-    /// @todo We don't wanna convert endianess here - it is responsible of Bpdu class
-    time = static_cast<u8>(port.DesignatedTimes().HelloTime() / +ShiftOctet::CpuLeastSignificant1st);
-    time += static_cast<u8>(port.DesignatedTimes().HelloTime() / +ShiftOctet::CpuLeastSignificant2nd) * 0x100;
-    bpdu.SetHelloTime(time);
-
-    time = static_cast<u8>(port.DesignatedTimes().MaxAge() / +ShiftOctet::CpuLeastSignificant1st);
-    time += static_cast<u8>(port.DesignatedTimes().MaxAge() / +ShiftOctet::CpuLeastSignificant2nd) * 0x100;
-    bpdu.SetMaxAge(time);
-
-    time = static_cast<u8>(port.DesignatedTimes().MessageAge() / +ShiftOctet::CpuLeastSignificant1st);
-    time += static_cast<u8>(port.DesignatedTimes().MessageAge() / +ShiftOctet::CpuLeastSignificant2nd) * 0x100;
-    bpdu.SetMessageAge(time);
-
-    time = static_cast<u8>(port.DesignatedTimes().ForwardDelay() / +ShiftOctet::CpuLeastSignificant1st);
-    time += static_cast<u8>(port.DesignatedTimes().ForwardDelay() / +ShiftOctet::CpuLeastSignificant2nd) * 0x100;
-    bpdu.SetForwardDelay(time);
+    bpdu.SetHelloTime(Time::ToBpduUnits(port.DesignatedTimes().HelloTime()));
+    bpdu.SetMaxAge(Time::ToBpduUnits(port.DesignatedTimes().MaxAge()));
+    bpdu.SetMessageAge(Time::ToBpduUnits(port.DesignatedTimes().MessageAge()));
+    bpdu.SetForwardDelay(Time::ToBpduUnits(port.DesignatedTimes().ForwardDelay()));
 
     if (Failed(bpdu.Encode(*bpduStream))) {
         std::cerr << __PRETTY_FUNCTION__ << "Failed to encode BPDU unit data\n";
     }
     else {
         bridge.SendOutBpdu(port.PortId().PortNum(), bpduStream);
+        port.GetStats().CountTx(bpdu);
+        bridge.GetTracer().RecordTransmit(port, bpdu);
     }
 }
 
@@ -313,7 +310,7 @@ void TxRstp(Bridge& bridge, Port& port) {
     }
 
     if (port.Learning()) {
-        bpdu.LearnigFlag();
+        bpdu.SetLearnigFlag();
     }
 
     if (port.Forwarding()) {
@@ -325,10 +322,10 @@ void TxRstp(Bridge& bridge, Port& port) {
     bpdu.SetBridgeIdentifier(port.DesignatedPriority().DesignatedBridgeId().ConvertToBpduData());
     bpdu.SetPortIdentifier(port.DesignatedPriority().DesignatedPortId().ConvertToBpduData());
 
-    bpdu.SetHelloTime(port.DesignatedTimes().HelloTime());
-    bpdu.SetMaxAge(port.DesignatedTimes().MaxAge());
-    bpdu.SetMessageAge(port.DesignatedTimes().MessageAge());
-    bpdu.SetForwardDelay(port.DesignatedTimes().ForwardDelay());
+    bpdu.SetHelloTime(Time::ToBpduUnits(port.DesignatedTimes().HelloTime()));
+    bpdu.SetMaxAge(Time::ToBpduUnits(port.DesignatedTimes().MaxAge()));
+    bpdu.SetMessageAge(Time::ToBpduUnits(port.DesignatedTimes().MessageAge()));
+    bpdu.SetForwardDelay(Time::ToBpduUnits(port.DesignatedTimes().ForwardDelay()));
 
     bpdu.SetVersion1Length(+Bpdu::Version1Length::Rst);
 
@@ -337,6 +334,8 @@ void TxRstp(Bridge& bridge, Port& port) {
     }
     else {
         bridge.SendOutBpdu(port.PortId().PortNum(), bpduStream);
+        port.GetStats().CountTx(bpdu);
+        bridge.GetTracer().RecordTransmit(port, bpdu);
     }
 }
 
@@ -353,6 +352,8 @@ void TxTcn(Bridge& bridge, Port& port) {
     }
     else {
         bridge.SendOutBpdu(port.PortId().PortNum(), bpduStream);
+        port.GetStats().CountTx(bpdu);
+        bridge.GetTracer().RecordTransmit(port, bpdu);
     }
 }
 
@@ -368,8 +369,8 @@ void UpdtBpduVersion(Port& port) noexcept {
 }
 
 void UpdtRcvdInfoWhile(Port& port) noexcept {
-    u16 rcvdInfoWhile = {};
-    if ((port.PortTimes().MessageAge() + 1) <= port.PortTimes().MaxAge()) {
+    u32 rcvdInfoWhile = {};
+    if ((port.PortTimes().MessageAge() + Time::MsPerSecond) <= port.PortTimes().MaxAge()) {
         rcvdInfoWhile = 3 * port.PortTimes().HelloTime();
     }
 
@@ -377,21 +378,27 @@ void UpdtRcvdInfoWhile(Port& port) noexcept {
 }
 
 void UpdtRoleDisabledTree(Bridge& bridge) noexcept {
+    bridge.SetTreeChanged(true);
     for (auto& portMapIt : bridge.GetAllPorts()) {
         portMapIt.second->SetSelectedRole(PortRole::Disabled);
     }
 }
 
-static RootPathPriority UpdtRolesTreeHelpGetBestPriorityVector(Bridge& bridge) noexcept {
+/// @param excludedPortNo port which information is not taken into account, 0 to consider all
+static RootPathPriority UpdtRolesTreeHelpGetBestPriorityVector(Bridge& bridge,
+                                                               const u16 excludedPortNo) noexcept {
     // The Bridge’s root priority vector (rootPriority plus rootPortId; 17.18.6, 17.18.5), chosen
     // as the best of the set of priority vectors
+    PortId noRootPortId{ };
+    noRootPortId.SetPriority(0);
+    noRootPortId.SetPortNum(0);
     RootPathPriority bestRootPriorityVector {
-        bridge.RootPortId(), bridge.RootPriority(), bridge.RootTimes()
+        noRootPortId, bridge.BridgePriority(), bridge.BridgeTimes()
     };
 
     for (auto& portMapIt : bridge.GetAllPorts()) {
         Port& port = *(portMapIt.second);
-        if (not (Port::Info::Received == port.InfoIs())) {
+        if ((not (Port::Info::Received == port.InfoIs())) || (excludedPortNo == portMapIt.first)) {
             continue;
         }
 
@@ -456,27 +463,10 @@ static void UpdtRolesTreeHelpUpdatePortRoleAndPortPriority(Bridge& bridge) noexc
                 port.SetUpdtInfo(false);
             }
             else if (not (port.PortPriority() < port.DesignatedPriority())) {
-                bool reflected = false;
-
-                /// @todo Confirm that comparing components designatedBridgeId and designatedPortId
-                /// are fine without comparing their associated priorities
-                for (auto& portMapIt : bridge.GetAllPorts()) {
-                    Port& otherPort = *(portMapIt.second);
-                    if (otherPort.PortId().PortNum() == port.PortId().PortNum()) {
-                        continue;
-                    }
-                    else if (not (otherPort.PortPriority().DesignatedBridgeId()
-                                  == port.PortPriority().DesignatedBridgeId())) {
-                        continue;
-                    }
-                    else if (not (otherPort.PortPriority().DesignatedPortId()
-                                  == port.PortPriority().DesignatedPortId())) {
-                        continue;
-                    }
-
-                    reflected = true;
-                    break;
-                }
+                // The port priority vector reflects another port of this bridge, so both ports
+                // are attached to the same LAN
+                const bool reflected = (port.PortPriority().DesignatedBridgeId().Address()
+                                        == bridge.BridgeIdentifier().Address());
 
                 if (not reflected) {
                     // j)
@@ -501,15 +491,59 @@ static void UpdtRolesTreeHelpUpdatePortRoleAndPortPriority(Bridge& bridge) noexc
     }
 }
 
-void UpdtRolesTree(Bridge& bridge) noexcept {
+bool FailoverApplies(const Bridge& bridge) noexcept {
+    const FailoverPlan& plan = bridge.Failover();
+    if ((0 == plan.RootPortNo) || (plan.RootPortNo != bridge.RootPortId().PortNum())) {
+        return false;
+    }
+
+    bool rootPortLost = false;
+    for (const auto& portMapIt : bridge.AllPorts()) {
+        const Port& port = *(portMapIt.second);
+        if (plan.RootPortNo == portMapIt.first) {
+            rootPortLost = Port::Info::Received != port.InfoIs();
+        }
+        else if (port.Reselect()
+                 || ((not port.PortEnabled()) && (Port::Info::Disabled != port.InfoIs()))) {
+            // Information of other port has changed since the plan has been made or is going
+            // to be discarded, as many ports might be disabled at once
+            return false;
+        }
+    }
+
+    return rootPortLost;
+}
+
+void UpdtFailoverPlan(Bridge& bridge) noexcept {
+    FailoverPlan& plan = bridge.GetFailover();
+    plan.RootPortNo = bridge.RootPortId().PortNum();
+    if (0 == plan.RootPortNo) {
+        return;
+    }
+
+    const RootPathPriority backup = UpdtRolesTreeHelpGetBestPriorityVector(bridge,
+                                                                           plan.RootPortNo);
+    plan.BackupPortId = backup.portId;
+    plan.BackupPriority = backup.priorityVector;
+    plan.BackupTimes = backup.times;
+}
+
+void UpdtRolesTree(Bridge& bridge, const bool installFailover) noexcept {
     // The Bridge’s root priority vector (rootPriority plus rootPortId; 17.18.6, 17.18.5), chosen
-    // as the best of the set of priority vectors
-    RootPathPriority bestRootPriorityVector {
-        UpdtRolesTreeHelpGetBestPriorityVector(bridge)
-    };
+    // as the best of the set of priority vectors. On loss of the root port the best one of the
+    // remaining vectors is already known.
+    const FailoverPlan& plan = bridge.Failover();
+    RootPathPriority bestRootPriorityVector = installFailover
+            ? RootPathPriority{ plan.BackupPortId, plan.BackupPriority, plan.BackupTimes }
+            : UpdtRolesTreeHelpGetBestPriorityVector(bridge, 0);
+    // Engine refreshes the plan once state machines are stable, out of the path of failover
+    bridge.GetFailover().RootPortNo = 0;
+    bridge.SetTreeChanged(true);
 
     if (bestRootPriorityVector.priorityVector == bridge.BridgePriority()) {
         // c1) the chosen root priority vector is the bridge priority vector
+        bridge.SetRootPriority(bridge.BridgePriority());
+        bridge.SetRootPortId(bestRootPriorityVector.portId);
         bridge.SetRootTimes(bridge.BridgeTimes());
     }
     else {
@@ -519,7 +553,7 @@ void UpdtRolesTree(Bridge& bridge) noexcept {
         bridge.SetRootPortId(bestRootPriorityVector.portId);
 
         bridge.SetRootTimes(bestRootPriorityVector.times);
-        bridge.GetRootTimes().SetMessageAge(bridge.RootTimes().MessageAge() + 1);
+        bridge.GetRootTimes().SetMessageAge(bridge.RootTimes().MessageAge() + Time::MsPerSecond);
     }
 
     for (auto& portMapIt : bridge.GetAllPorts()) {
@@ -529,8 +563,11 @@ void UpdtRolesTree(Bridge& bridge) noexcept {
         port.GetDesignatedPriority().SetDesignatedBridgeId(bridge.BridgeIdentifier());
         port.GetDesignatedPriority().SetDesignatedPortId(port.PortId());
         port.SetDesignatedTimes(bridge.RootTimes());
-        // e)
-        port.GetDesignatedTimes().SetHelloTime(bridge.BridgeTimes().HelloTime());
+        // e), port in fast hello mode advertises its own hello time, so the peer expects BPDUs
+        // at the same rate
+        const u32 helloTime = port.FastHelloTime() ? port.FastHelloTime()
+                                                   : bridge.BridgeTimes().HelloTime();
+        port.GetDesignatedTimes().SetHelloTime(helloTime);
     }
 
     UpdtRolesTreeHelpUpdatePortRoleAndPortPriority(bridge);
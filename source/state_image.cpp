@@ -0,0 +1,398 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/state_image.hpp"
+
+// POSIX
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define STP_STATE_IMAGE_MMAP
+#endif
+
+// C Standard Library
+#include <cstdio>
+#include <cstring>
+
+// C++ Standard Library
+#include <atomic>
+#include <tuple>
+
+namespace Stp {
+
+constexpr u32 StateImage::Magic;
+constexpr u32 StateImage::LayoutVersion;
+constexpr u32 StateImage::NoSlot;
+
+namespace {
+
+/// @brief Slots start at cache line, so writing of one does not touch lines of the other
+constexpr std::size_t kAlignment = 64;
+
+constexpr std::size_t Align(const std::size_t size) noexcept {
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+struct PortFlag {
+    bool (Port::*Get)() const;
+    void (Port::*Set)(const bool);
+};
+
+/// @brief Index of the flag is its bit in PortRecord::Flags, so new flags have to be appended
+const PortFlag kPortFlags[] = {
+    { &Port::AdminEdge, &Port::SetAdminEdge },
+    { &Port::Agree, &Port::SetAgree },
+    { &Port::Agreed, &Port::SetAgreed },
+    { &Port::AutoEdge, &Port::SetAutoEdge },
+    { &Port::Disputed, &Port::SetDisputed },
+    { &Port::FdbFlush, &Port::SetFdbFlush },
+    { &Port::Forward, &Port::SetForward },
+    { &Port::Forwarding, &Port::SetForwarding },
+    { &Port::Learn, &Port::SetLearn },
+    { &Port::Learning, &Port::SetLearning },
+    { &Port::Mcheck, &Port::SetMcheck },
+    { &Port::NewInfo, &Port::SetNewInfo },
+    { &Port::OperEdge, &Port::SetOperEdge },
+    { &Port::OperPointToPointMAC, &Port::SetOperPointToPointMAC },
+    { &Port::PortEnabled, &Port::SetPortEnabled },
+    { &Port::Proposed, &Port::SetProposed },
+    { &Port::Proposing, &Port::SetProposing },
+    { &Port::RcvdBpdu, &Port::SetRcvdBpdu },
+    { &Port::RcvdMsg, &Port::SetRcvdMsg },
+    { &Port::RcvdRstp, &Port::SetRcvdRstp },
+    { &Port::RcvdStp, &Port::SetRcvdStp },
+    { &Port::RcvdTc, &Port::SetRcvdTc },
+    { &Port::RcvdTcAck, &Port::SetRcvdTcAck },
+    { &Port::RcvdTcn, &Port::SetRcvdTcn },
+    { &Port::ReRoot, &Port::SetReRoot },
+    { &Port::Reselect, &Port::SetReselect },
+    { &Port::Selected, &Port::SetSelected },
+    { &Port::SendRstp, &Port::SetSendRstp },
+    { &Port::Sync, &Port::SetSync },
+    { &Port::Synced, &Port::SetSynced },
+    { &Port::TcAck, &Port::SetTcAck },
+    { &Port::TcProp, &Port::SetTcProp },
+    { &Port::Tick, &Port::SetTick },
+    { &Port::UpdtInfo, &Port::SetUpdtInfo }
+};
+
+static_assert(sizeof(kPortFlags) / sizeof(kPortFlags[0]) <= 64, "Flags fit into 64 bits");
+
+void SavePriority(const PriorityVector& priority, StateImage::PriorityVectorRecord& record) {
+    record.RootBridgeId = priority.RootBridgeId().ConvertToBpduData();
+    record.DesignatedBridgeId = priority.DesignatedBridgeId().ConvertToBpduData();
+    record.RootPathCost = priority.RootPathCost().Value();
+    record.DesignatedPortId = priority.DesignatedPortId().ConvertToBpduData();
+    std::memset(record.Reserved, 0, sizeof(record.Reserved));
+}
+
+PriorityVector RestorePriority(const StateImage::PriorityVectorRecord& record) {
+    PathCost rootPathCost{};
+    rootPathCost.SetPathCost(record.RootPathCost);
+    return PriorityVector{ BridgeId{ record.RootBridgeId }, rootPathCost,
+                           BridgeId{ record.DesignatedBridgeId },
+                           PortId{ record.DesignatedPortId } };
+}
+
+void SaveTimes(const Time& times, StateImage::TimesRecord& record) {
+    record.MessageAge = times.MessageAge();
+    record.MaxAge = times.MaxAge();
+    record.ForwardDelay = times.ForwardDelay();
+    record.HelloTime = times.HelloTime();
+}
+
+Time RestoreTimes(const StateImage::TimesRecord& record) {
+    return Time{ record.MessageAge, record.MaxAge, record.ForwardDelay, record.HelloTime };
+}
+
+} // namespace
+
+StateImage::StateImage() noexcept
+    : _data{ nullptr }, _size{ 0 }, _replacedPath{ }, _mappedPath{ } {
+    // Nothing more to do
+}
+
+StateImage::~StateImage() {
+    Unmap();
+}
+
+Result StateImage::Create(const std::string& path, const u32 portCapacity) {
+    Unmap();
+    if ((not Failed(Map(path, true, false, 0))) && IsCompatible()
+            && (GetHeader().PortCapacity >= portCapacity)) {
+        return Result::Success;
+    }
+
+    Unmap();
+    // The last image is kept until the new file holds the complete one
+    const std::string newPath{ path + ".new" };
+    if (Failed(Map(newPath, true, true, portCapacity))) {
+        return Result::Fail;
+    }
+
+    Header& header = GetHeader();
+    header.LayoutVersion = LayoutVersion;
+    header.SlotHeaderSize = sizeof(SlotHeader);
+    header.PortRecordSize = sizeof(PortRecord);
+    header.PortCapacity = portCapacity;
+    header.ActiveSlot = NoSlot;
+    std::atomic_thread_fence(std::memory_order_release);
+    header.Magic = Magic;
+    _replacedPath = path;
+
+    return Result::Success;
+}
+
+Result StateImage::Open(const std::string& path) {
+    Unmap();
+    if (Failed(Map(path, false, false, 0))) {
+        return Result::Fail;
+    }
+
+    if (not IsCompatible()) {
+        Unmap();
+        return Result::Fail;
+    }
+
+    return Result::Success;
+}
+
+const StateImage::SlotHeader* StateImage::ActiveSlot() const noexcept {
+    const u32 slot = GetHeader().ActiveSlot;
+    if ((0 != slot) && (1 != slot)) {
+        return nullptr;
+    }
+
+    const SlotHeader* header = reinterpret_cast<const SlotHeader*>(_data + SlotOffset(slot));
+    return header->PortCount <= GetHeader().PortCapacity ? header : nullptr;
+}
+
+const StateImage::PortRecord* StateImage::Ports(const SlotHeader& slot) const noexcept {
+    return reinterpret_cast<const PortRecord*>(reinterpret_cast<const u8*>(&slot)
+                                               + Align(sizeof(SlotHeader)));
+}
+
+StateImage::SlotHeader& StateImage::InactiveSlot() noexcept {
+    const u32 slot = (0 == GetHeader().ActiveSlot) ? 1 : 0;
+    return *reinterpret_cast<SlotHeader*>(_data + SlotOffset(slot));
+}
+
+StateImage::PortRecord* StateImage::GetPorts(SlotHeader& slot) noexcept {
+    return reinterpret_cast<PortRecord*>(reinterpret_cast<u8*>(&slot)
+                                         + Align(sizeof(SlotHeader)));
+}
+
+void StateImage::Commit(SlotHeader& slot) noexcept {
+    const SlotHeader* active = ActiveSlot();
+    slot.Generation = active ? active->Generation + 1 : 1;
+    // Records of the slot are stored before it becomes active, so the process which dies in
+    // the meantime leaves the previous image active
+    std::atomic_thread_fence(std::memory_order_release);
+    GetHeader().ActiveSlot = (reinterpret_cast<u8*>(&slot) == _data + SlotOffset(0)) ? 0 : 1;
+    if (not _replacedPath.empty()) {
+        if (0 == std::rename(_mappedPath.c_str(), _replacedPath.c_str())) {
+            _mappedPath = _replacedPath;
+            _replacedPath.clear();
+        }
+    }
+}
+
+void StateImage::SaveBridge(const Bridge& bridge, BridgeRecord& record) noexcept {
+    record.Address = bridge.Address().ConvertToInteger();
+    record.BridgeId = bridge.BridgeIdentifier().ConvertToBpduData();
+    record.RootPortId = bridge.RootPortId().ConvertToBpduData();
+    record.ForceProtocolVersion = bridge.ForceProtocolVersion();
+    record.TxHoldCount = bridge.TxHoldCount();
+    record.AgeingTime = bridge.AgeingTime();
+    record.Reserved = 0;
+    SavePriority(bridge.BridgePriority(), record.BridgePriority);
+    SavePriority(bridge.RootPriority(), record.RootPriority);
+    SaveTimes(bridge.BridgeTimes(), record.BridgeTimes);
+    SaveTimes(bridge.RootTimes(), record.RootTimes);
+}
+
+void StateImage::RestoreBridge(const BridgeRecord& record, Bridge& bridge) noexcept {
+    bridge.SetBridgeIdentifier(BridgeId{ record.BridgeId });
+    bridge.SetRootPortId(PortId{ record.RootPortId });
+    bridge.SetForceProtocolVersion(record.ForceProtocolVersion);
+    bridge.SetTxHoldCount(record.TxHoldCount);
+    bridge.SetAgeingTime(record.AgeingTime);
+    bridge.SetBridgePriority(RestorePriority(record.BridgePriority));
+    bridge.SetRootPriority(RestorePriority(record.RootPriority));
+    bridge.SetBridgeTimes(RestoreTimes(record.BridgeTimes));
+    bridge.SetRootTimes(RestoreTimes(record.RootTimes));
+}
+
+void StateImage::SavePort(const Port& port, PortRecord& record) noexcept {
+    record.FastHelloTime = port.FastHelloTime();
+    record.PortId = port.PortId().ConvertToBpduData();
+    record.InfoIs = static_cast<u8>(port.InfoIs());
+    record.RcvdInfo = static_cast<u8>(port.RcvdInfo());
+    record.Role = static_cast<u8>(port.Role());
+    record.SelectedRole = static_cast<u8>(port.SelectedRole());
+    record.TxCount = port.TxCount();
+    record.Reserved = 0;
+    std::memset(record.Reserved2, 0, sizeof(record.Reserved2));
+    record.PathCost = port.PortPathCost().Value();
+    record.AgeingTime = port.AgeingTime();
+    record.Flags = 0;
+    for (u8 idx = 0; idx < sizeof(kPortFlags) / sizeof(kPortFlags[0]); ++idx) {
+        if ((port.*kPortFlags[idx].Get)()) {
+            record.Flags |= u64{ 1 } << idx;
+        }
+    }
+
+    SavePriority(port.DesignatedPriority(), record.DesignatedPriority);
+    SavePriority(port.MsgPriority(), record.MsgPriority);
+    SavePriority(port.PortPriority(), record.PortPriority);
+    SaveTimes(port.DesignatedTimes(), record.DesignatedTimes);
+    SaveTimes(port.MsgTimes(), record.MsgTimes);
+    SaveTimes(port.PortTimes(), record.PortTimes);
+    const SmTimers& timers = port.GetSmTimersInstance();
+    record.EdgeDelayWhile = timers.EdgeDelayWhile();
+    record.FdWhile = timers.FdWhile();
+    record.HelloWhen = timers.HelloWhen();
+    record.MdelayWhile = timers.MdelayWhile();
+    record.RbWhile = timers.RbWhile();
+    record.RcvdInfoWhile = timers.RcvdInfoWhile();
+    record.RrWhile = timers.RrWhile();
+    record.TcWhile = timers.TcWhile();
+}
+
+void StateImage::RestorePort(const PortRecord& record, const u32 elapsedMs,
+                             Port& port) noexcept {
+    port.SetFastHelloTime(record.FastHelloTime);
+    port.SetPortId(PortId{ record.PortId });
+    port.SetInfoIs(static_cast<Port::Info>(record.InfoIs));
+    port.SetRcvdInfo(static_cast<enum Port::RcvdInfo>(record.RcvdInfo));
+    port.SetRole(static_cast<PortRole>(record.Role));
+    port.SetSelectedRole(static_cast<PortRole>(record.SelectedRole));
+    port.SetTxCount(record.TxCount);
+    port.GetPortPathCost().SetPathCost(record.PathCost);
+    port.SetAgeingTime(record.AgeingTime);
+    for (u8 idx = 0; idx < sizeof(kPortFlags) / sizeof(kPortFlags[0]); ++idx) {
+        (port.*kPortFlags[idx].Set)(0 != (record.Flags & (u64{ 1 } << idx)));
+    }
+
+    // Received BPDU is not kept by the image, so BPDU which has not been handled before the
+    // image was written is dropped, as if it has been lost on the link
+    port.SetRcvdBpdu(false);
+    port.SetRcvdMsg(false);
+    port.SetDesignatedPriority(RestorePriority(record.DesignatedPriority));
+    port.SetMsgPriority(RestorePriority(record.MsgPriority));
+    port.SetPortPriority(RestorePriority(record.PortPriority));
+    port.SetDesignatedTimes(RestoreTimes(record.DesignatedTimes));
+    port.SetMsgTimes(RestoreTimes(record.MsgTimes));
+    port.SetPortTimes(RestoreTimes(record.PortTimes));
+    SmTimers& timers = port.SmTimersInstance();
+    timers.SetEdgeDelayWhile(record.EdgeDelayWhile);
+    timers.SetFdWhile(record.FdWhile);
+    timers.SetHelloWhen(record.HelloWhen);
+    timers.SetMdelayWhile(record.MdelayWhile);
+    timers.SetRbWhile(record.RbWhile);
+    timers.SetRcvdInfoWhile(record.RcvdInfoWhile);
+    timers.SetRrWhile(record.RrWhile);
+    timers.SetTcWhile(record.TcWhile);
+    timers.Advance(elapsedMs);
+
+    // Counters continue from the restored state, so restoring is not counted as its change
+    PortStats& stats = port.GetStats();
+    stats.Role = port.Role();
+    stats.Learning = port.Learning();
+    stats.Forwarding = port.Forwarding();
+}
+
+std::size_t StateImage::FileSize(const u32 portCapacity) noexcept {
+    return Align(sizeof(Header))
+            + 2 * Align(Align(sizeof(SlotHeader)) + portCapacity * sizeof(PortRecord));
+}
+
+std::size_t StateImage::SlotOffset(const u32 slot) const noexcept {
+    return Align(sizeof(Header))
+            + slot * Align(Align(sizeof(SlotHeader))
+                           + GetHeader().PortCapacity * sizeof(PortRecord));
+}
+
+bool StateImage::IsCompatible() const noexcept {
+    if (_size < sizeof(Header)) {
+        return false;
+    }
+
+    const Header& header = GetHeader();
+    return (Magic == header.Magic) && (LayoutVersion == header.LayoutVersion)
+            && (sizeof(SlotHeader) == header.SlotHeaderSize)
+            && (sizeof(PortRecord) == header.PortRecordSize)
+            && (_size >= FileSize(header.PortCapacity));
+}
+
+Result StateImage::Map(const std::string& path, const bool writable, const bool create,
+                       const u32 portCapacity) {
+#ifdef STP_STATE_IMAGE_MMAP
+    int flags = writable ? O_RDWR : O_RDONLY;
+    if (create) {
+        flags |= O_CREAT | O_TRUNC;
+    }
+
+    const int fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0) {
+        return Result::Fail;
+    }
+
+    std::size_t size = FileSize(portCapacity);
+    struct stat fileStat{};
+    if (create) {
+        if (0 != ::ftruncate(fd, static_cast<off_t>(size))) {
+            ::close(fd);
+            return Result::Fail;
+        }
+    }
+    else if (0 == ::fstat(fd, &fileStat)) {
+        size = static_cast<std::size_t>(fileStat.st_size);
+    }
+    else {
+        ::close(fd);
+        return Result::Fail;
+    }
+
+    void* data = (size > 0) ? ::mmap(nullptr, size, PROT_READ | (writable ? PROT_WRITE : 0),
+                                     MAP_SHARED, fd, 0)
+                            : MAP_FAILED;
+    // Mapping keeps the file open
+    ::close(fd);
+    if (MAP_FAILED == data) {
+        return Result::Fail;
+    }
+
+    _data = static_cast<u8*>(data);
+    _size = size;
+    _mappedPath = path;
+
+    return Result::Success;
+#else
+    std::ignore = path;
+    std::ignore = writable;
+    std::ignore = create;
+    std::ignore = portCapacity;
+    return Result::Fail;
+#endif
+}
+
+void StateImage::Unmap() noexcept {
+#ifdef STP_STATE_IMAGE_MMAP
+    if (_data) {
+        ::munmap(_data, _size);
+    }
+#endif
+    _data = nullptr;
+    _size = 0;
+    _replacedPath.clear();
+    _mappedPath.clear();
+}
+
+} // namespace Stp
@@ -7,15 +7,19 @@
 // This project's headers
 #include "stp/state_machine.hpp"
 
+// C++ Standard Library
+#include <stdexcept>
+
 namespace Stp {
 
 void State::ChangeState(Machine& machine, State& newState) {
     machine.BridgeInstance().SystemLogChangeState(machine.Name(), Name(), newState.Name());
+    machine.BridgeInstance().GetTracer().RecordStateChange(machine, *this, newState);
     machine.ChangeState(newState);
 }
 
 Machine::Machine(BridgeH bridge, PortH port, State& initState)
-    : _bridge{ bridge }, _port{ port }, _state{ &initState } {
+    : _bridge{ bridge.get() }, _port{ port.get() }, _state{ &initState } {
     if (nullptr == _bridge) {
         std::runtime_error("Handler for bridge instance is null pointer");
     }
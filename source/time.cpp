@@ -9,21 +9,35 @@
 
 namespace Stp {
 
+constexpr u32 Time::MsPerSecond;
+constexpr u32 Time::BpduUnitsPerSecond;
+constexpr u32 Time::DefaultTickIntervalMs;
+constexpr u32 Time::MinFastHelloTimeMs;
+constexpr u32 Time::MaxFastHelloTimeMs;
+
+namespace {
+
+inline void Elapse(u32& timer, const u32 elapsedMs) noexcept {
+    timer = timer > elapsedMs ? timer - elapsedMs : 0;
+}
+
+} // namespace
+
 SmTimers::SmTimers() noexcept
     : _edgeDelayWhile{ 0 }, _fdWhile{ 0 }, _helloWhen{ 0 }, _mdelayWhile{ 0 }, _rbWhile{ 0 },
       _rcvdInfoWhile{ 0 }, _rrWhile{ 0 }, _tcWhile{ 0 } {
     // Nothing more to do
 }
 
-SmTimers& SmTimers::operator--() noexcept {
-    dec(_helloWhen);
-    dec(_tcWhile);
-    dec(_fdWhile);
-    dec(_rcvdInfoWhile);
-    dec(_rrWhile);
-    dec(_rbWhile);
-    dec(_mdelayWhile);
-    dec(_edgeDelayWhile);
+SmTimers& SmTimers::Advance(const u32 elapsedMs) noexcept {
+    Elapse(_helloWhen, elapsedMs);
+    Elapse(_tcWhile, elapsedMs);
+    Elapse(_fdWhile, elapsedMs);
+    Elapse(_rcvdInfoWhile, elapsedMs);
+    Elapse(_rrWhile, elapsedMs);
+    Elapse(_rbWhile, elapsedMs);
+    Elapse(_mdelayWhile, elapsedMs);
+    Elapse(_edgeDelayWhile, elapsedMs);
 
     return *this;
 }
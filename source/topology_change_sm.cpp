@@ -17,11 +17,10 @@ namespace TopologyChange {
 void TcmState::InactiveAction(Machine& machine) {
     /// @todo Do we need really here to flush entries data base?
     SmProcedures::FlushFdb(machine.BridgeInstance(), machine.PortInstance());
-    machine.PortInstance().SetFdbFlush(true);
     machine.PortInstance().SmTimersInstance().SetTcWhile(0);
     machine.PortInstance().SetTcAck(false);
     // Exception: 17.19.1
-    machine.PortInstance().SetAgeingTime(Bridge::AgeingTime);
+    machine.PortInstance().SetAgeingTime(machine.BridgeInstance().AgeingTime());
     if (SmConditions::StpVersion(machine.BridgeInstance())) {
         machine.PortInstance().SetAgeingTime(SmParams::FwdDelay(machine.PortInstance()));
     }
@@ -57,10 +56,9 @@ void TcmState::NotifiedTcAction(Machine& machine) {
 void TcmState::PropagatingAction(Machine& machine) {
     SmProcedures::NewTcWhile(machine.BridgeInstance(), machine.PortInstance());
     SmProcedures::FlushFdb(machine.BridgeInstance(), machine.PortInstance());
-    machine.PortInstance().SetFdbFlush(true);
     machine.PortInstance().SetTcProp(false);
     // Exception: 17.19.1
-    machine.PortInstance().SetAgeingTime(Bridge::AgeingTime);
+    machine.PortInstance().SetAgeingTime(machine.BridgeInstance().AgeingTime());
     if (SmConditions::StpVersion(machine.BridgeInstance())) {
         machine.PortInstance().SetAgeingTime(SmParams::FwdDelay(machine.PortInstance()));
     }
@@ -77,7 +75,10 @@ void TcmState::ActiveAction(Machine& machine) {
 }
 
 void TcmState::ActiveUctExecute(Machine& machine) {
-    std::ignore = machine;
+    if (Guard(machine, true)) { // UCT
+        ActiveAction(machine);
+        ChangeState(machine, ActiveState::Instance());
+    }
 }
 
 State& BeginState::Instance() {
@@ -87,7 +88,7 @@ State& BeginState::Instance() {
 void BeginState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToInactive(machine)) {
+    if (Guard(machine, GoToInactive(machine))) {
         InactiveAction(machine);
         ChangeState(machine, InactiveState::Instance());
     }
@@ -104,7 +105,7 @@ State& InactiveState::Instance() {
 void InactiveState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToLearning(machine)) {
+    if (Guard(machine, GoToLearning(machine))) {
         LearningAction(machine);
         ChangeState(machine, LearningState::Instance());
     }
@@ -128,15 +129,15 @@ State& LearningState::Instance() {
 void LearningState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToDetected(machine)) {
+    if (Guard(machine, GoToDetected(machine))) {
         DetectedAction(machine);
         ChangeState(machine, DetectedState::Instance());
     }
-    else if (GoToInactive(machine)) {
+    else if (Guard(machine, GoToInactive(machine))) {
         InactiveAction(machine);
         ChangeState(machine, InactiveState::Instance());
     }
-    else if (GoToLearning(machine)) {
+    else if (Guard(machine, GoToLearning(machine))) {
         LearningAction(machine);
         // Leave it as a current state
     }
@@ -222,7 +223,7 @@ State& NotifiedTcnState::Instance() {
 void NotifiedTcnState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToNotifiedTc(machine)) {
+    if (Guard(machine, GoToNotifiedTc(machine))) {
         NotifiedTcAction(machine);
         ChangeState(machine, NotifiedTcState::Instance());
     }
@@ -267,23 +268,23 @@ State& ActiveState::Instance() {
 void ActiveState::Execute(Machine& machine) {
     machine.BridgeInstance().SystemLogEntryState(machine.Name(), Name());
 
-    if (GoToLearning(machine)) {
+    if (Guard(machine, GoToLearning(machine))) {
         LearningAction(machine);
         ChangeState(machine, LearningState::Instance());
     }
-    else if (GoToNotifiedTcn(machine)) {
+    else if (Guard(machine, GoToNotifiedTcn(machine))) {
         NotifiedTcnAction(machine);
         ChangeState(machine, NotifiedTcnState::Instance());
     }
-    else if (GoToNotifiedTc(machine)) {
+    else if (Guard(machine, GoToNotifiedTc(machine))) {
         NotifiedTcAction(machine);
         ChangeState(machine, NotifiedTcState::Instance());
     }
-    else if (GoToPropagating(machine)) {
+    else if (Guard(machine, GoToPropagating(machine))) {
         PropagatingAction(machine);
         ChangeState(machine, PropagatingState::Instance());
     }
-    else if (GoToAcknowledged(machine)) {
+    else if (Guard(machine, GoToAcknowledged(machine))) {
         AcknowledgeAction(machine);
         ChangeState(machine, AcknowledgedState::Instance());
     }
@@ -0,0 +1,334 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// This project's headers
+#include "stp/tracer.hpp"
+#include "stp/state_machine.hpp"
+
+// C++ Standard Library
+#include <chrono>
+#include <map>
+#include <typeinfo>
+
+namespace Stp {
+
+namespace {
+
+/// @brief Thread identifiers of ports' processes in exported trace
+constexpr u32 BpduTid = 1;
+constexpr u32 TimersTid = 2;
+constexpr u32 HardwareTid = 3;
+constexpr u32 MachineTidBase = 16;
+
+void WriteTimestampUs(std::ostream& out, const u64 timeNs) {
+    const u64 fraction = timeNs % 1000;
+    out << timeNs / 1000 << '.' << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "")
+        << fraction;
+}
+
+const char* BpduTypeName(const u8 type) noexcept {
+    switch (type) {
+    case +Bpdu::Type::Config:
+        return "Config";
+    case +Bpdu::Type::Tcn:
+        return "TCN";
+    case +Bpdu::Type::Rst:
+        return "RST";
+    default:
+        return "Invalid";
+    }
+}
+
+} // namespace
+
+const char* TraceTimerName(const TraceTimer timer) noexcept {
+    switch (timer) {
+    case TraceTimer::EdgeDelayWhile:
+        return "edgeDelayWhile";
+    case TraceTimer::FdWhile:
+        return "fdWhile";
+    case TraceTimer::HelloWhen:
+        return "helloWhen";
+    case TraceTimer::MdelayWhile:
+        return "mdelayWhile";
+    case TraceTimer::RbWhile:
+        return "rbWhile";
+    case TraceTimer::RcvdInfoWhile:
+        return "rcvdInfoWhile";
+    case TraceTimer::RrWhile:
+        return "rrWhile";
+    case TraceTimer::TcWhile:
+        return "tcWhile";
+    default:
+        return "unknown";
+    }
+}
+
+const char* TraceHardwareCallName(const TraceHardwareCall call) noexcept {
+    switch (call) {
+    case TraceHardwareCall::FlushFdb:
+        return "FlushFdb";
+    case TraceHardwareCall::SetForwarding:
+        return "SetForwarding";
+    case TraceHardwareCall::SetLearning:
+        return "SetLearning";
+    case TraceHardwareCall::SendOutBpdu:
+        return "SendOutBpdu";
+    default:
+        return "unknown";
+    }
+}
+
+Tracer::Tracer(ClockH clock) noexcept
+    : _clock{ clock }, _enabled{ false }, _capacity{ 0 }, _next{ 0 }, _recorded{ 0 },
+      _stateSpans{ false } {
+    // Nothing more to do
+}
+
+Result Tracer::Start(const u32 capacity, const bool stateSpans) {
+    if (0 == capacity) {
+        return Result::Fail;
+    }
+
+    std::lock_guard<std::mutex> traceGuard{ _mtx };
+    _records.clear();
+    _records.reserve(capacity);
+    _capacity = capacity;
+    _next = 0;
+    _recorded = 0;
+    _stateSpans = stateSpans;
+    _enabled.store(true, std::memory_order_relaxed);
+
+    return Result::Success;
+}
+
+void Tracer::Stop() noexcept {
+    _enabled.store(false, std::memory_order_relaxed);
+}
+
+template <typename Named>
+u16 Tracer::Intern(const void* key, Named& named) {
+    const auto found = _nameIds.find(key);
+    if (found != _nameIds.end()) {
+        return found->second;
+    }
+
+    const u16 id = static_cast<u16>(_names.size());
+    _names.push_back(named.Name());
+    _nameIds.emplace(key, id);
+
+    return id;
+}
+
+void Tracer::RecordStateChange(Machine& machine, State& oldState, State& newState) {
+    if (not Enabled()) {
+        return;
+    }
+
+    const u64 nowNs = NowNs();
+    u16 machineId = 0;
+    u16 oldStateId = 0;
+    u16 newStateId = 0;
+    {
+        // Every type of machine has the same name, while states are singletons
+        std::lock_guard<std::mutex> traceGuard{ _mtx };
+        machineId = Intern(&typeid(machine), machine);
+        oldStateId = Intern(&oldState, oldState);
+        newStateId = Intern(&newState, newState);
+    }
+
+    Append(TraceRecord{ nowNs, machine.PortInstance().PortId().PortNum(),
+                        TraceEvent::StateChange, 0, machineId, oldStateId, newStateId });
+}
+
+void Tracer::RecordTimerExpiries(const Port& port, const SmTimers& previous,
+                                 const SmTimers& current) noexcept {
+    if (not Enabled()) {
+        return;
+    }
+
+    const u16 portNo = port.PortId().PortNum();
+    RecordTimerExpiry(portNo, TraceTimer::EdgeDelayWhile, previous.EdgeDelayWhile(),
+                      current.EdgeDelayWhile());
+    RecordTimerExpiry(portNo, TraceTimer::FdWhile, previous.FdWhile(), current.FdWhile());
+    RecordTimerExpiry(portNo, TraceTimer::HelloWhen, previous.HelloWhen(), current.HelloWhen());
+    RecordTimerExpiry(portNo, TraceTimer::MdelayWhile, previous.MdelayWhile(),
+                      current.MdelayWhile());
+    RecordTimerExpiry(portNo, TraceTimer::RbWhile, previous.RbWhile(), current.RbWhile());
+    RecordTimerExpiry(portNo, TraceTimer::RcvdInfoWhile, previous.RcvdInfoWhile(),
+                      current.RcvdInfoWhile());
+    RecordTimerExpiry(portNo, TraceTimer::RrWhile, previous.RrWhile(), current.RrWhile());
+    RecordTimerExpiry(portNo, TraceTimer::TcWhile, previous.TcWhile(), current.TcWhile());
+}
+
+u64 Tracer::Recorded() const {
+    std::lock_guard<std::mutex> traceGuard{ _mtx };
+    return _recorded;
+}
+
+std::vector<TraceRecord> Tracer::Records() const {
+    std::lock_guard<std::mutex> traceGuard{ _mtx };
+    return CopyRecords();
+}
+
+std::vector<TraceRecord> Tracer::CopyRecords() const {
+    std::vector<TraceRecord> records{};
+    records.reserve(_records.size());
+    records.insert(records.end(), _records.begin() + static_cast<std::ptrdiff_t>(_next),
+                   _records.end());
+    records.insert(records.end(), _records.begin(),
+                   _records.begin() + static_cast<std::ptrdiff_t>(_next));
+
+    return records;
+}
+
+void Tracer::WriteChromeTrace(std::ostream& out) const {
+    std::vector<TraceRecord> records{};
+    std::vector<std::string> names{};
+    u64 recorded = 0;
+    bool stateSpans = false;
+    {
+        std::lock_guard<std::mutex> traceGuard{ _mtx };
+        records = CopyRecords();
+        names = _names;
+        recorded = _recorded;
+        stateSpans = _stateSpans;
+    }
+
+    // Names of threads indexed by port number (process) and thread identifier
+    std::map<u16, std::map<u32, std::string>> threads{};
+    bool first = true;
+    auto beginEvent = [&out, &first](const std::string& name, const char* category,
+                                     const char phase, const u64 timeNs, const u16 pid,
+                                     const u32 tid) {
+        out << (first ? "" : ",") << "\n{\"name\":\"" << name << "\",\"cat\":\"" << category
+            << "\",\"ph\":\"" << phase << "\",\"ts\":";
+        WriteTimestampUs(out, timeNs);
+        out << ",\"pid\":" << pid << ",\"tid\":" << tid;
+        if ('i' == phase) {
+            out << ",\"s\":\"t\"";
+        }
+
+        first = false;
+    };
+
+    struct OpenSpan {
+        u64 StartNs;
+        u16 State;
+    };
+    // Current states of machines indexed by port number and machine identifier
+    std::map<std::pair<u16, u16>, OpenSpan> openSpans{};
+    auto closeSpan = [&](const std::pair<u16, u16>& key, const OpenSpan& span,
+                         const u64 endNs) {
+        beginEvent(names[span.State], "state", 'X', span.StartNs, key.first,
+                   MachineTidBase + key.second);
+        out << ",\"dur\":";
+        WriteTimestampUs(out, endNs - span.StartNs);
+        out << "}";
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"recorded\":" << recorded
+        << ",\"overwritten\":" << recorded - records.size() << "},\"traceEvents\":[";
+    for (const TraceRecord& record : records) {
+        switch (record.Event) {
+        case TraceEvent::StateChange: {
+            const u32 tid = MachineTidBase + record.Subject;
+            threads[record.PortNo][tid] = names[record.Subject];
+            if (not stateSpans) {
+                beginEvent(names[record.OldState] + " -> " + names[record.NewState], "state",
+                           'i', record.TimeNs, record.PortNo, tid);
+                out << "}";
+                break;
+            }
+
+            const std::pair<u16, u16> key{ record.PortNo, record.Subject };
+            const auto open = openSpans.find(key);
+            if (open != openSpans.end()) {
+                closeSpan(key, open->second, record.TimeNs);
+            }
+
+            openSpans[key] = OpenSpan{ record.TimeNs, record.NewState };
+            break;
+        }
+        case TraceEvent::BpduRx:
+        case TraceEvent::BpduTx:
+            threads[record.PortNo][BpduTid] = "BPDU";
+            beginEvent(std::string{ TraceEvent::BpduRx == record.Event ? "Rx " : "Tx " }
+                       + BpduTypeName(record.Kind), "bpdu", 'i', record.TimeNs, record.PortNo,
+                       BpduTid);
+            out << ",\"args\":{\"flags\":" << record.Subject << "}}";
+            break;
+        case TraceEvent::TimerExpiry:
+            threads[record.PortNo][TimersTid] = "Timers";
+            beginEvent(std::string{ TraceTimerName(static_cast<TraceTimer>(record.Kind)) }
+                       + " expired", "timer", 'i', record.TimeNs, record.PortNo, TimersTid);
+            out << "}";
+            break;
+        case TraceEvent::HardwareCall:
+            threads[record.PortNo][HardwareTid] = "Hardware";
+            beginEvent(TraceHardwareCallName(static_cast<TraceHardwareCall>(record.Kind)),
+                       "hardware", 'i', record.TimeNs, record.PortNo, HardwareTid);
+            out << ",\"args\":{\"enable\":" << (record.Subject ? "true" : "false") << "}}";
+            break;
+        }
+    }
+
+    // States which have not been left yet last until the newest event
+    const u64 endNs = records.empty() ? 0 : records.back().TimeNs;
+    for (const auto& open : openSpans) {
+        closeSpan(open.first, open.second, endNs);
+    }
+
+    for (const auto& process : threads) {
+        out << (first ? "" : ",") << "\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":"
+            << process.first << ",\"args\":{\"name\":\"Port " << process.first << "\"}}";
+        first = false;
+        for (const auto& thread : process.second) {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << process.first
+                << ",\"tid\":" << thread.first << ",\"args\":{\"name\":\"" << thread.second
+                << "\"}}";
+        }
+    }
+
+    out << "\n]}\n";
+}
+
+void Tracer::Append(const TraceRecord& record) noexcept {
+    std::lock_guard<std::mutex> traceGuard{ _mtx };
+    if (0 == _capacity) {
+        return;
+    }
+
+    if (_records.size() < _capacity) {
+        _records.push_back(record);
+    }
+    else {
+        _records[_next] = record;
+        _next = (_next + 1) % _records.size();
+    }
+
+    ++_recorded;
+}
+
+void Tracer::RecordBpdu(const TraceEvent event, const Port& port, const Bpdu& bpdu) noexcept {
+    Append(TraceRecord{ NowNs(), port.PortId().PortNum(), event, bpdu.BpduType(),
+                        bpdu.Flags(), 0, 0 });
+}
+
+void Tracer::RecordTimerExpiry(const u16 portNo, const TraceTimer timer, const u32 previous,
+                               const u32 current) noexcept {
+    if ((0 != previous) && (0 == current)) {
+        Append(TraceRecord{ NowNs(), portNo, TraceEvent::TimerExpiry, static_cast<u8>(timer),
+                            0, 0, 0 });
+    }
+}
+
+u64 Tracer::NowNs() const noexcept {
+    const Clock::Duration now = _clock->Now();
+    return now.count() < 0 ? 0 : static_cast<u64>(now.count());
+}
+
+} // namespace Stp
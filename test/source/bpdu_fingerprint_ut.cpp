@@ -0,0 +1,91 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bpdu_fingerprint.hpp>
+#include <stp/sm_conditions.hpp>
+
+// GTest headers
+#include <gtest/gtest.h>
+
+using namespace Stp;
+
+class BpduFingerprintTest : public ::testing::Test {
+protected:
+    BpduFingerprintTest()
+        : _rstBpdu{
+              0x00, 0x00, 0x02, 0x02, 0x3c,
+              0x80, 0x01, 0x00, 0x1c, 0x0e, 0x87, 0x78, 0x00,
+              0x00, 0x00, 0x00, 0x04,
+              0x80, 0x01, 0x00, 0x1c, 0x0e, 0x87, 0x85, 0x00,
+              0x80, 0x04,
+              0x01, 0x00, 0x14, 0x00, 0x02, 0x00, 0x0f, 0x00,
+              0x00 } {}
+
+    Stp::ByteStream _rstBpdu;
+    Stp::BpduFingerprint _fingerprint;
+};
+
+TEST_F(BpduFingerprintTest, testMatches_withoutAssignedData_shouldNotMatch) {
+    EXPECT_FALSE(_fingerprint.Matches(_rstBpdu));
+}
+
+TEST_F(BpduFingerprintTest, testMatches_withTheSameData_shouldMatch) {
+    _fingerprint.Assign(_rstBpdu);
+
+    EXPECT_EQ(_fingerprint.Size(), +Stp::Bpdu::Size::Rst);
+    EXPECT_TRUE(_fingerprint.Matches(_rstBpdu));
+}
+
+TEST_F(BpduFingerprintTest, testMatches_withTrailingPadding_shouldMatch) {
+    _fingerprint.Assign(_rstBpdu);
+    _rstBpdu.insert(_rstBpdu.end(), { 0x00, 0x00, 0x00 });
+
+    EXPECT_TRUE(_fingerprint.Matches(_rstBpdu));
+}
+
+TEST_F(BpduFingerprintTest, testMatches_withChangedFlags_shouldNotMatch) {
+    _fingerprint.Assign(_rstBpdu);
+    _rstBpdu[+Stp::Bpdu::FieldOffset::Flags] |= 0x01; // Topology Change
+
+    EXPECT_FALSE(_fingerprint.Matches(_rstBpdu));
+}
+
+TEST_F(BpduFingerprintTest, testMatches_withTruncatedData_shouldNotMatch) {
+    _fingerprint.Assign(_rstBpdu);
+    _rstBpdu.resize(+Stp::Bpdu::Size::Config);
+
+    EXPECT_FALSE(_fingerprint.Matches(_rstBpdu));
+}
+
+TEST_F(BpduFingerprintTest, testMatches_afterClear_shouldNotMatch) {
+    _fingerprint.Assign(_rstBpdu);
+    _fingerprint.Clear();
+
+    EXPECT_FALSE(_fingerprint.Matches(_rstBpdu));
+}
+
+TEST_F(BpduFingerprintTest, testRxFastPathAllowed_withPendingReceivedBpdu_shouldNotAllow) {
+    Stp::Port port{};
+    port.SetPortEnabled(true);
+    port.SetInfoIs(Stp::Port::Info::Received);
+    port.SetRxFastPath(true);
+
+    EXPECT_TRUE(Stp::SmConditions::RxFastPathAllowed(port));
+
+    port.SetRcvdBpdu(true);
+
+    EXPECT_FALSE(Stp::SmConditions::RxFastPathAllowed(port));
+}
+
+TEST_F(BpduFingerprintTest, testRxFastPathAllowed_withNotReceivedInfo_shouldNotAllow) {
+    Stp::Port port{};
+    port.SetPortEnabled(true);
+    port.SetInfoIs(Stp::Port::Info::Mine);
+    port.SetRxFastPath(true);
+
+    EXPECT_FALSE(Stp::SmConditions::RxFastPathAllowed(port));
+}
@@ -0,0 +1,178 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bpdu_policer.hpp>
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Stp;
+
+namespace {
+
+using Verdict = BpduPolicer::Verdict;
+
+Clock::Duration Ms(const u32 value) {
+    return std::chrono::milliseconds{ value };
+}
+
+} // namespace
+
+TEST(BpduPolicerTest, testValidate_shouldRejectInconsistentLimits) {
+    EXPECT_EQ(Result::Success, (BpduPolicerConfig{ 0, 0, 0 }).Validate());
+    EXPECT_EQ(Result::Success, (BpduPolicerConfig{ 10, 5, 0 }).Validate());
+    EXPECT_EQ(Result::Success, (BpduPolicerConfig{ 10, 5, 100 }).Validate());
+    EXPECT_EQ(Result::Fail, (BpduPolicerConfig{ 10, 0, 0 }).Validate());
+    EXPECT_EQ(Result::Fail, (BpduPolicerConfig{ 10, 5, 10 }).Validate());
+    EXPECT_EQ(Result::Fail, (BpduPolicerConfig{ 0, 0, 100 }).Validate());
+
+    BpduPolicer sutPolicer{};
+    EXPECT_EQ(Result::Fail, sutPolicer.Configure(BpduPolicerConfig{ 10, 0, 0 }));
+    EXPECT_EQ(0u, sutPolicer.Config().Rate);
+}
+
+TEST(BpduPolicerTest, testPolice_shouldPassBurstThenRate) {
+    BpduPolicer sutPolicer{};
+    sutPolicer.AddPort(1);
+    sutPolicer.AddPort(2);
+    // Disabled policer passes everything
+    for (u32 idx = 0; idx < 100; ++idx) {
+        ASSERT_EQ(Verdict::Pass, sutPolicer.Police(1, Ms(0)));
+    }
+
+    ASSERT_EQ(Result::Success, sutPolicer.Configure(BpduPolicerConfig{ 10, 3, 0 }));
+    EXPECT_EQ(Verdict::Pass, sutPolicer.Police(1, Ms(1000)));
+    EXPECT_EQ(Verdict::Pass, sutPolicer.Police(1, Ms(1000)));
+    EXPECT_EQ(Verdict::Pass, sutPolicer.Police(1, Ms(1000)));
+    EXPECT_EQ(Verdict::Drop, sutPolicer.Police(1, Ms(1000)));
+    // Other ports have their own buckets
+    EXPECT_EQ(Verdict::Pass, sutPolicer.Police(2, Ms(1000)));
+
+    // One BPDU per 100 ms is passed afterwards
+    EXPECT_EQ(Verdict::Drop, sutPolicer.Police(1, Ms(1050)));
+    EXPECT_EQ(Verdict::Pass, sutPolicer.Police(1, Ms(1100)));
+    EXPECT_EQ(Verdict::Drop, sutPolicer.Police(1, Ms(1100)));
+
+    u32 passed = 0;
+    for (u32 timeMs = 2000; timeMs < 12000; ++timeMs) {
+        passed += (Verdict::Pass == sutPolicer.Police(1, Ms(timeMs))) ? 1 : 0;
+    }
+
+    EXPECT_EQ(3u + 100u - 1u, passed);
+    EXPECT_EQ(10000u - passed + 3u, sutPolicer.Dropped(1));
+    EXPECT_EQ(0u, sutPolicer.Dropped(2));
+}
+
+TEST(BpduPolicerTest, testPolice_stormAboveErrDisableRate_shouldErrDisablePortOnce) {
+    BpduPolicer sutPolicer{};
+    sutPolicer.AddPort(1);
+    ASSERT_EQ(Result::Success, sutPolicer.Configure(BpduPolicerConfig{ 10, 5, 50 }));
+
+    // Offered rate between the limits is only policed
+    u32 passed = 0;
+    for (u32 timeMs = 0; timeMs < 1000; timeMs += 25) {
+        const Verdict verdict = sutPolicer.Police(1, Ms(timeMs));
+        ASSERT_NE(Verdict::ErrDisable, verdict);
+        passed += (Verdict::Pass == verdict) ? 1 : 0;
+    }
+
+    EXPECT_EQ(14u, passed);
+    EXPECT_FALSE(sutPolicer.ErrDisabled(1));
+
+    u32 errDisabled = 0;
+    for (u32 idx = 0; idx < 100; ++idx) {
+        errDisabled += (Verdict::ErrDisable == sutPolicer.Police(1, Ms(2000))) ? 1 : 0;
+    }
+
+    EXPECT_EQ(1u, errDisabled);
+    EXPECT_TRUE(sutPolicer.ErrDisabled(1));
+    // Err-disabled port drops even the BPDU which conforms the rate
+    EXPECT_EQ(Verdict::Drop, sutPolicer.Police(1, Ms(60000)));
+
+    sutPolicer.ClearErrDisabled(1);
+    EXPECT_FALSE(sutPolicer.ErrDisabled(1));
+    EXPECT_EQ(Verdict::Pass, sutPolicer.Police(1, Ms(60000)));
+}
+
+TEST(BpduPolicerTest, testPolice_manyThreads_shouldPassBurstOnlyOnce) {
+    BpduPolicer sutPolicer{};
+    sutPolicer.AddPort(7);
+    ASSERT_EQ(Result::Success, sutPolicer.Configure(BpduPolicerConfig{ 1, 100, 0 }));
+
+    std::atomic<u32> passed{ 0 };
+    std::vector<std::thread> threads{};
+    for (u32 thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&sutPolicer, &passed]() {
+            for (u32 idx = 0; idx < 1000; ++idx) {
+                if (Verdict::Pass == sutPolicer.Police(7, Ms(5000))) {
+                    passed.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(100u, passed.load());
+    EXPECT_EQ(3900u, sutPolicer.Dropped(7));
+}
+
+TEST(BpduPolicerTest, testCountDecodeDrop_manyThreads_shouldCountPerPortAndReason) {
+    BpduPolicer sutPolicer{};
+    sutPolicer.AddPort(300);
+    sutPolicer.AddPort(301);
+    EXPECT_EQ(0u, sutPolicer.DecodeDropped(300, BpduDropReason::Malformed));
+
+    std::vector<std::thread> threads{};
+    for (u32 thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&sutPolicer]() {
+            for (u32 idx = 0; idx < 1000; ++idx) {
+                sutPolicer.CountDecodeDrop(300, BpduDropReason::Malformed);
+            }
+
+            sutPolicer.CountDecodeDrop(300, BpduDropReason::Looped);
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(4000u, sutPolicer.DecodeDropped(300, BpduDropReason::Malformed));
+    EXPECT_EQ(4u, sutPolicer.DecodeDropped(300, BpduDropReason::Looped));
+    EXPECT_EQ(0u, sutPolicer.DecodeDropped(301, BpduDropReason::Malformed));
+    // Drops of decoding are not counted as policed
+    EXPECT_EQ(0u, sutPolicer.Dropped(300));
+}
+
+TEST(BpduPolicerTest, testPolice_portNotAdded_shouldPassWithoutAccounting) {
+    BpduPolicer sutPolicer{};
+    ASSERT_EQ(Result::Success, sutPolicer.Configure(BpduPolicerConfig{ 10, 1, 0 }));
+    for (u32 idx = 0; idx < 10; ++idx) {
+        ASSERT_EQ(Verdict::Pass, sutPolicer.Police(1, Ms(1000)));
+    }
+
+    sutPolicer.CountDecodeDrop(1, BpduDropReason::Malformed);
+    EXPECT_EQ(0u, sutPolicer.Dropped(1));
+    EXPECT_EQ(0u, sutPolicer.DecodeDropped(1, BpduDropReason::Malformed));
+
+    // Buckets of the added port start full
+    sutPolicer.AddPort(1);
+    EXPECT_EQ(Verdict::Pass, sutPolicer.Police(1, Ms(1000)));
+    EXPECT_EQ(Verdict::Drop, sutPolicer.Police(1, Ms(1000)));
+    // Adding the port again keeps its bucket
+    sutPolicer.AddPort(1);
+    EXPECT_EQ(1u, sutPolicer.Dropped(1));
+}
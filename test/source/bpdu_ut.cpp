@@ -0,0 +1,91 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bpdu.hpp>
+#include <stp/time.hpp>
+
+// GTest headers
+#include <gtest/gtest.h>
+
+using namespace Stp;
+
+class BpduTest : public ::testing::Test {
+protected:
+    BpduTest()
+        : _rstBpdu{
+              0x00, 0x00, 0x02, 0x02, 0x3c,
+              0x80, 0x01, 0x00, 0x1c, 0x0e, 0x87, 0x78, 0x00,
+              0x00, 0x00, 0x00, 0x04,
+              0x80, 0x01, 0x00, 0x1c, 0x0e, 0x87, 0x85, 0x00,
+              0x80, 0x04,
+              0x01, 0x00, 0x14, 0x00, 0x02, 0x00, 0x0f, 0x00,
+              0x00 },
+          _tcnBpdu{ 0x00, 0x00, 0x00, 0x80 } {}
+
+    Stp::ByteStream _rstBpdu;
+    Stp::ByteStream _tcnBpdu;
+    Stp::Bpdu _bpdu;
+};
+
+TEST_F(BpduTest, testDecode_withRstBpdu_shouldDecodeAllFields) {
+    ASSERT_EQ(Result::Success, _bpdu.Decode(_rstBpdu));
+
+    EXPECT_TRUE(Bpdu::Type::Rst == _bpdu.BpduType());
+    EXPECT_EQ(PortRole::Designated, _bpdu.PortRoleFlag());
+    EXPECT_EQ(1, _bpdu.LearnigFlag());
+    EXPECT_EQ(1, _bpdu.ForwardingFlag());
+    EXPECT_EQ(0, _bpdu.TcFlag());
+    EXPECT_EQ(0x00000004u, _bpdu.RootPathCost());
+    EXPECT_EQ(0x78, _bpdu.RootIdentifier()[6]);
+    EXPECT_EQ(0x80, _bpdu.BridgeIdentifier()[0]);
+    EXPECT_EQ(0x85, _bpdu.BridgeIdentifier()[6]);
+    EXPECT_EQ(0x80, _bpdu.PortIdentifier()[0]);
+    EXPECT_EQ(0x04, _bpdu.PortIdentifier()[1]);
+    EXPECT_EQ(1 * Time::BpduUnitsPerSecond, _bpdu.MessageAge());
+    EXPECT_EQ(20 * Time::BpduUnitsPerSecond, _bpdu.MaxAge());
+    EXPECT_EQ(2 * Time::BpduUnitsPerSecond, _bpdu.HelloTime());
+    EXPECT_EQ(15 * Time::BpduUnitsPerSecond, _bpdu.ForwardDelay());
+}
+
+TEST_F(BpduTest, testEncode_withDecodedRstBpdu_shouldReproduceData) {
+    ASSERT_EQ(Result::Success, _bpdu.Decode(_rstBpdu));
+
+    ByteStream encoded;
+    ASSERT_EQ(Result::Success, _bpdu.Encode(encoded));
+
+    ASSERT_LE(_rstBpdu.size(), encoded.size());
+    EXPECT_TRUE(std::equal(_rstBpdu.cbegin(), _rstBpdu.cend(), encoded.cbegin()));
+}
+
+TEST_F(BpduTest, testDecode_withTcnBpdu_shouldKeepTcnType) {
+    ASSERT_EQ(Result::Success, _bpdu.Decode(_tcnBpdu));
+
+    EXPECT_TRUE(Bpdu::Type::Tcn == _bpdu.BpduType());
+}
+
+TEST_F(BpduTest, testDecode_withTooShortData_shouldFail) {
+    _rstBpdu.resize(2);
+
+    EXPECT_EQ(Result::Fail, _bpdu.Decode(_rstBpdu));
+    EXPECT_TRUE(Bpdu::Type::Invalid == _bpdu.BpduType());
+}
+
+TEST_F(BpduTest, testDecode_withTruncatedRstBpdu_shouldFail) {
+    _rstBpdu.resize(+Bpdu::Size::Rst - 1);
+
+    EXPECT_EQ(Result::Fail, _bpdu.Decode(_rstBpdu));
+}
+
+TEST_F(BpduTest, testCopy_withDecodedBpdu_shouldKeepIdentifiers) {
+    ASSERT_EQ(Result::Success, _bpdu.Decode(_rstBpdu));
+
+    const Bpdu copy{ _bpdu };
+
+    EXPECT_EQ(_bpdu.BridgeIdentifier(), copy.BridgeIdentifier());
+    EXPECT_EQ(_bpdu.PortIdentifier(), copy.PortIdentifier());
+    EXPECT_EQ(_bpdu.PortRoleFlag(), copy.PortRoleFlag());
+}
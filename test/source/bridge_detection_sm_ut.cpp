@@ -6,6 +6,8 @@
 
 // Tested project's headers
 #include <stp/sm/bridge_detection.hpp>
+#include <stp/perf_params.hpp>
+#include <stp/sm_conditions.hpp>
 // UT dependencies
 #include "sut_machine.hpp"
 #include <mock/bridge.hpp>
@@ -160,3 +162,17 @@ TEST_F(BridgeDetectionTest,
     EXPECT_STREQ(_sutMachine.CurrentState().Name().c_str(),
                  Stp::BridgeDetection::EdgeState::Instance().Name().c_str());
 }
+
+TEST(BdmConditionsTest, testEdgeDelay_shouldBeMigrateTimeOrMaxAgeOfDesignatedTimes) {
+    Stp::Port port{};
+    Stp::Time designatedTimes{};
+    designatedTimes.SetMaxAge(20000);
+    designatedTimes.SetHelloTime(2000);
+    designatedTimes.SetForwardDelay(15000);
+    port.SetDesignatedTimes(designatedTimes);
+
+    port.SetOperPointToPointMAC(false);
+    EXPECT_EQ(20000u, Stp::SmConditions::EdgeDelay(port));
+    port.SetOperPointToPointMAC(true);
+    EXPECT_EQ(Stp::PerfParams::MigrateTime(), Stp::SmConditions::EdgeDelay(port));
+}
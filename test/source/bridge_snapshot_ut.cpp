@@ -0,0 +1,302 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bridge.hpp>
+#include <stp/bridge_config.hpp>
+#include <stp/bridge_id.hpp>
+#include <stp/bridge_snapshot.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/port.hpp>
+#include <stp/port_id.hpp>
+#include <stp/rcu_cell.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Stp;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Pattern {
+    u64 Words[8] = { };
+};
+
+std::unique_ptr<Pattern> MakePattern(std::unique_ptr<Pattern> pattern, const u64 value) {
+    if (not pattern) {
+        pattern = std::make_unique<Pattern>();
+    }
+
+    for (u64& word : pattern->Words) {
+        word = value;
+    }
+
+    return pattern;
+}
+
+/// @brief Checks that the snapshot holds current state of every port of the bridge
+void ExpectCurrentPorts(const BridgeSnapshot& snapshot, const Bridge& bridge) {
+    ASSERT_EQ(bridge.AllPorts().size(), snapshot.Ports.size());
+    auto portSnapshot = snapshot.Ports.cbegin();
+    for (const auto& bridgePort : bridge.AllPorts()) {
+        const Port& port = *bridgePort.second;
+        EXPECT_EQ(bridgePort.first, portSnapshot->PortNo);
+        EXPECT_EQ(port.Role(), portSnapshot->Role);
+        EXPECT_EQ(port.PortEnabled(), portSnapshot->Enabled);
+        EXPECT_EQ(port.Forwarding(), portSnapshot->Forwarding);
+        EXPECT_EQ(port.PortPathCost().Value(), portSnapshot->PathCost);
+        EXPECT_EQ(port.DesignatedPriority(), portSnapshot->DesignatedPriority);
+        EXPECT_EQ(port.GetSmTimersInstance().FdWhile(), portSnapshot->Timers.FdWhile());
+        EXPECT_EQ(port.GetSmTimersInstance().RcvdInfoWhile(),
+                  portSnapshot->Timers.RcvdInfoWhile());
+        ++portSnapshot;
+    }
+}
+
+} // namespace
+
+TEST(RcuCellTest, testRead_whilePublishing_shouldNeverSeeReusedValue) {
+    RcuCell<Pattern> sutCell{};
+    sutCell.Publish(MakePattern(nullptr, 0));
+    std::atomic<bool> done{ false };
+    std::thread writer{ [&sutCell, &done]() {
+        for (u64 value = 1; value <= 200000; ++value) {
+            sutCell.Publish(MakePattern(sutCell.Reuse(), value));
+        }
+
+        done.store(true);
+    } };
+
+    u64 previous = 0;
+    while (not done.load()) {
+        const auto pattern = sutCell.Read();
+        const u64 first = pattern->Words[0];
+        // Value would be overwritten by the writer if it had been reclaimed too early
+        std::this_thread::yield();
+        for (const u64 word : pattern->Words) {
+            ASSERT_EQ(first, word);
+        }
+
+        EXPECT_LE(previous, first);
+        previous = first;
+    }
+
+    writer.join();
+    EXPECT_EQ(200000u, sutCell.Read()->Words[0]);
+}
+
+TEST(RcuCellTest, testPublish_whileValueIsRead_shouldDeferReclamation) {
+    RcuCell<Pattern> sutCell{};
+    EXPECT_EQ(nullptr, sutCell.Read().Get());
+
+    sutCell.Publish(MakePattern(nullptr, 1));
+    {
+        const auto pattern = sutCell.Read();
+        sutCell.Publish(MakePattern(nullptr, 2));
+        sutCell.Publish(MakePattern(nullptr, 3));
+        EXPECT_EQ(1u, pattern->Words[0]);
+        EXPECT_LE(1u, sutCell.Retired());
+        EXPECT_EQ(3u, sutCell.Read()->Words[0]);
+    }
+
+    sutCell.Publish(MakePattern(nullptr, 4));
+    EXPECT_EQ(0u, sutCell.Retired());
+    EXPECT_NE(nullptr, sutCell.Reuse());
+    EXPECT_EQ(nullptr, sutCell.Reuse());
+}
+
+class BridgeSnapshotTest : public ::testing::Test {
+protected:
+    BridgeSnapshotTest()
+        : _clock{ std::make_shared<VirtualClock>() },
+          _sutEngine{ Mac{}, MakeSutSystem(_clock) } {
+        _sutEngine.AddPort(2, 1000, true);
+        _sutEngine.AddPort(1, 100, true);
+    }
+
+    void Tick(const u32 ticks) {
+        for (u32 tick = 0; tick < ticks; ++tick) {
+            _clock->Advance(1s);
+            _sutEngine.Tick();
+        }
+    }
+
+    /// @brief Designated information of root bridge better than the tested one
+    ByteStream SuperiorBpdu(const u16 rootPriority = 0) const {
+        BridgeId rootId{};
+        rootId.SetPriority(rootPriority);
+        rootId.SetAddress(Mac{ Bpdu::BridgeSystemIdHandler{ { 0x00, 0x00, 0x00, 0x00, 0x00,
+                                                              0x01 } } });
+        PortId portId{};
+        portId.SetPortNum(1);
+        Bpdu bpdu{};
+        bpdu.SetProtocolVersionIdentifier(+Bpdu::ProtocolVersionIdentifier::Rst);
+        bpdu.SetBpduType(+Bpdu::Type::Rst);
+        bpdu.SetPortRoleFlag(PortRole::Designated);
+        bpdu.SetRootIdentifier(rootId.ConvertToBpduData());
+        bpdu.SetBridgeIdentifier(rootId.ConvertToBpduData());
+        bpdu.SetPortIdentifier(portId.ConvertToBpduData());
+        bpdu.SetMaxAge(20 * Time::BpduUnitsPerSecond);
+        bpdu.SetHelloTime(2 * Time::BpduUnitsPerSecond);
+        bpdu.SetForwardDelay(15 * Time::BpduUnitsPerSecond);
+
+        ByteStream data{};
+        bpdu.Encode(data);
+        return data;
+    }
+
+    Sptr<VirtualClock> _clock;
+    Engine _sutEngine;
+};
+
+TEST_F(BridgeSnapshotTest, testReadSnapshot_afterEvaluation_shouldReflectPorts) {
+    Tick(3);
+
+    const auto snapshot = _sutEngine.ReadSnapshot();
+    ASSERT_EQ(2u, snapshot->Ports.size());
+    EXPECT_EQ(1u, snapshot->Ports[0].PortNo);
+    EXPECT_EQ(2u, snapshot->Ports[1].PortNo);
+    EXPECT_EQ(3000u, snapshot->TimeMs);
+    EXPECT_EQ(_sutEngine.BridgeInstance().BridgeIdentifier(), snapshot->BridgeIdentifier);
+
+    const PortSnapshot* const port = snapshot->FindPort(1);
+    ASSERT_NE(nullptr, port);
+    EXPECT_EQ(PortRole::Designated, port->Role);
+    EXPECT_TRUE(port->Enabled);
+    EXPECT_EQ(PathCost::SpeedMbToPathCostValue(100), port->PathCost);
+    EXPECT_EQ(1u, port->PortIdentifier.PortNum());
+    EXPECT_EQ(nullptr, snapshot->FindPort(3));
+}
+
+TEST_F(BridgeSnapshotTest, testReadSnapshot_heldDuringEvaluation_shouldStayUnchanged) {
+    Tick(3);
+    const auto before = _sutEngine.ReadSnapshot();
+    const u64 version = before->Version;
+
+    ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(1, SuperiorBpdu()));
+    _sutEngine.Evaluate();
+
+    const auto after = _sutEngine.ReadSnapshot();
+    EXPECT_LT(version, after->Version);
+    EXPECT_EQ(version, before->Version);
+    EXPECT_EQ(PortRole::Designated, before->FindPort(1)->Role);
+    EXPECT_EQ(PortRole::Root, after->FindPort(1)->Role);
+    EXPECT_EQ(1u, after->RootPortId.PortNum());
+    EXPECT_EQ(0u, after->RootPriority.RootBridgeId().Priority());
+}
+
+TEST_F(BridgeSnapshotTest, testEvaluate_withoutChanges_shouldNotPublish) {
+    Tick(3);
+    const u64 version = _sutEngine.ReadSnapshot()->Version;
+
+    _sutEngine.Evaluate();
+    _sutEngine.Evaluate();
+
+    EXPECT_EQ(version, _sutEngine.ReadSnapshot()->Version);
+    EXPECT_EQ(3000u, _sutEngine.ReadSnapshot()->TimeMs);
+
+    Tick(1);
+
+    EXPECT_LT(version, _sutEngine.ReadSnapshot()->Version);
+}
+
+TEST_F(BridgeSnapshotTest, testReadSnapshot_afterChangesOfFewPorts_shouldHoldCurrentPorts) {
+    // Adding of ports one by one writes only records of added ports
+    for (const u16 portNo : { 10, 4, 12, 7, 5, 11, 3, 9, 6, 8 }) {
+        ASSERT_EQ(Result::Success, _sutEngine.AddPort(portNo, 1000, true));
+        ExpectCurrentPorts(*_sutEngine.ReadSnapshot(), _sutEngine.BridgeInstance());
+    }
+
+    Tick(3);
+    ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(1, SuperiorBpdu()));
+    _sutEngine.Evaluate();
+    ExpectCurrentPorts(*_sutEngine.ReadSnapshot(), _sutEngine.BridgeInstance());
+
+    // Repeated BPDU refreshes information of the root port only
+    for (u32 tick = 0; tick < 6; ++tick) {
+        Tick(1);
+        for (u32 repetition = 0; repetition < 2; ++repetition) {
+            ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(1, SuperiorBpdu()));
+            _sutEngine.Evaluate();
+            ExpectCurrentPorts(*_sutEngine.ReadSnapshot(), _sutEngine.BridgeInstance());
+        }
+    }
+
+    for (const u16 portNo : { 7, 12, 3 }) {
+        ASSERT_EQ(Result::Success, _sutEngine.RemovePort(portNo));
+        ExpectCurrentPorts(*_sutEngine.ReadSnapshot(), _sutEngine.BridgeInstance());
+    }
+
+    ASSERT_EQ(Result::Success, _sutEngine.AddPort(7, 100, false));
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortPathCost(5, 2000));
+    _sutEngine.Evaluate();
+    ExpectCurrentPorts(*_sutEngine.ReadSnapshot(), _sutEngine.BridgeInstance());
+    Tick(2);
+    ExpectCurrentPorts(*_sutEngine.ReadSnapshot(), _sutEngine.BridgeInstance());
+}
+
+TEST(BridgeConfigTest, testValidate_outOfRangeOrInconsistentParameters_shouldFail) {
+    BridgeConfig sutConfig{};
+    EXPECT_EQ(Result::Success, sutConfig.Validate());
+
+    sutConfig.Priority = 1000;
+    EXPECT_EQ(Result::Fail, sutConfig.Validate());
+    sutConfig = BridgeConfig{};
+    sutConfig.HelloTime = 3;
+    EXPECT_EQ(Result::Fail, sutConfig.Validate());
+    sutConfig = BridgeConfig{};
+    sutConfig.ForwardDelay = 4;
+    EXPECT_EQ(Result::Fail, sutConfig.Validate());
+    sutConfig = BridgeConfig{};
+    sutConfig.ForceProtocolVersion = 1;
+    EXPECT_EQ(Result::Fail, sutConfig.Validate());
+
+    EXPECT_EQ(Result::Success, PortConfig::ValidatePriority(240));
+    EXPECT_EQ(Result::Fail, PortConfig::ValidatePriority(100));
+    EXPECT_EQ(Result::Fail, PortConfig::ValidatePathCost(0));
+}
+
+TEST_F(BridgeSnapshotTest, testSetBridgeConfig_lowerPriority_shouldBecomeRoot) {
+    Tick(3);
+    ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(1, SuperiorBpdu(4096)));
+    _sutEngine.Evaluate();
+    ASSERT_EQ(PortRole::Root, _sutEngine.ReadSnapshot()->FindPort(1)->Role);
+
+    BridgeConfig config{};
+    config.Priority = 0;
+    ASSERT_EQ(Result::Success, _sutEngine.SetBridgeConfig(config));
+
+    const auto snapshot = _sutEngine.ReadSnapshot();
+    EXPECT_EQ(0u, snapshot->Config.Priority);
+    EXPECT_EQ(0u, snapshot->BridgeIdentifier.Priority());
+    EXPECT_EQ(snapshot->BridgeIdentifier, snapshot->RootPriority.RootBridgeId());
+    EXPECT_EQ(PortRole::Designated, snapshot->FindPort(1)->Role);
+}
+
+TEST_F(BridgeSnapshotTest, testSetBridgeConfig_forceStp_shouldStopSendingRstBpdus) {
+    Tick(3);
+    ASSERT_TRUE(_sutEngine.ReadSnapshot()->FindPort(1)->SendRstp);
+
+    BridgeConfig config{};
+    config.ForceProtocolVersion = BridgeConfig::ProtocolVersion::Stp;
+    EXPECT_EQ(Result::Fail, _sutEngine.SetPortPriority(1, 17));
+    ASSERT_EQ(Result::Success, _sutEngine.SetBridgeConfig(config));
+    Tick(1);
+
+    const auto snapshot = _sutEngine.ReadSnapshot();
+    EXPECT_EQ(BridgeConfig::ProtocolVersion::Stp, snapshot->Config.ForceProtocolVersion);
+    EXPECT_FALSE(snapshot->FindPort(1)->SendRstp);
+    EXPECT_FALSE(snapshot->FindPort(2)->SendRstp);
+}
@@ -0,0 +1,101 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/budgeted_queue.hpp>
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Stp;
+
+namespace {
+
+constexpr std::chrono::milliseconds kItemCost{ 1 };
+
+} // namespace
+
+TEST(BudgetedQueueTest, testDrain_shouldStopAtDeadlineAndKeepOrder) {
+    VirtualClock clock{};
+    BudgetedQueue<Uptr<u32>> sutQueue{};
+    for (u32 idx = 0; idx < 10; ++idx) {
+        sutQueue.Push(std::make_unique<u32>(idx));
+    }
+
+    std::vector<u32> handled{};
+    auto handle = [&clock, &handled](Uptr<u32> item) {
+        handled.push_back(*item);
+        clock.Advance(kItemCost);
+    };
+
+    EXPECT_TRUE(sutQueue.Drain(clock, clock.Now() + 4 * kItemCost, handle));
+    EXPECT_EQ(4u, handled.size());
+    EXPECT_EQ(6u, sutQueue.Depth());
+    EXPECT_EQ(1u, sutQueue.Deferred());
+
+    // The slice which starts after its deadline still makes progress
+    EXPECT_TRUE(sutQueue.Drain(clock, clock.Now() - kItemCost, handle));
+    EXPECT_EQ(5u, handled.size());
+
+    EXPECT_FALSE(sutQueue.Drain(clock, clock.Now() + 100 * kItemCost, handle));
+    ASSERT_EQ(10u, handled.size());
+    for (u32 idx = 0; idx < 10; ++idx) {
+        EXPECT_EQ(idx, handled[idx]);
+    }
+
+    EXPECT_EQ(0u, sutQueue.Depth());
+    EXPECT_EQ(10u, sutQueue.HighWater());
+    EXPECT_EQ(10u, sutQueue.Handled());
+    EXPECT_EQ(2u, sutQueue.Deferred());
+}
+
+TEST(BudgetedQueueTest, testDrain_lastItemAtDeadline_shouldNotCountDeferredSlice) {
+    VirtualClock clock{};
+    BudgetedQueue<u32> sutQueue{};
+    sutQueue.Push(1);
+    sutQueue.Push(2);
+
+    EXPECT_FALSE(sutQueue.Drain(clock, clock.Now() + 2 * kItemCost, [&clock](u32) {
+        clock.Advance(kItemCost);
+    }));
+    EXPECT_EQ(0u, sutQueue.Deferred());
+    EXPECT_FALSE(sutQueue.Drain(clock, clock.Now(), [](u32) {
+        FAIL() << "Empty queue must not handle anything";
+    }));
+}
+
+TEST(BudgetedQueueTest, testPush_manyThreads_shouldTrackHighWater) {
+    VirtualClock clock{};
+    BudgetedQueue<u32> sutQueue{};
+    std::vector<std::thread> threads{};
+    for (u32 thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&sutQueue]() {
+            for (u32 idx = 0; idx < 1000; ++idx) {
+                sutQueue.Push(idx);
+            }
+        });
+    }
+
+    u64 handled = 0;
+    while (handled < 4000) {
+        sutQueue.Drain(clock, clock.Now(), [&handled](u32) { ++handled; });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(4000u, sutQueue.Handled());
+    EXPECT_EQ(0u, sutQueue.Depth());
+    EXPECT_GE(sutQueue.HighWater(), 1u);
+    EXPECT_LE(sutQueue.HighWater(), 4000u);
+}
@@ -0,0 +1,80 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/completion.hpp>
+#include <stp/management.hpp>
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Stp;
+using namespace std::chrono_literals;
+
+TEST(CompletionGroupTest, testWait_withoutCommands_shouldNotBlock) {
+    CompletionGroup sutCompletion{};
+
+    EXPECT_EQ(Result::Success, sutCompletion.Wait());
+    EXPECT_EQ(0u, sutCompletion.Pending());
+}
+
+TEST(CompletionGroupTest, testWait_afterCommandsCompletedByOtherThread_shouldReportFailures) {
+    constexpr u32 kCommands = 10000;
+    CompletionGroup sutCompletion{};
+    std::vector<Uptr<Command>> commands{};
+    for (u32 idx = 0; idx < kCommands; ++idx) {
+        commands.push_back(std::make_unique<RemovePortReq>(static_cast<u16>(idx)));
+        commands.back()->SetCompletion(&sutCompletion);
+    }
+
+    ASSERT_EQ(kCommands, sutCompletion.Pending());
+    std::thread performer{ [&commands]() {
+        for (std::size_t idx = 0; idx < commands.size(); ++idx) {
+            commands[idx]->Complete(0 == idx % 100 ? Result::Fail : Result::Success);
+        }
+    } };
+
+    EXPECT_EQ(Result::Fail, sutCompletion.Wait());
+    EXPECT_EQ(0u, sutCompletion.Pending());
+    EXPECT_EQ(kCommands / 100, sutCompletion.Failed());
+    performer.join();
+}
+
+TEST(CompletionGroupTest, testComplete_calledTwice_shouldCountCommandOnce) {
+    CompletionGroup sutCompletion{};
+    RemovePortReq first{ 1 };
+    RemovePortReq second{ 2 };
+    first.SetCompletion(&sutCompletion);
+    second.SetCompletion(&sutCompletion);
+
+    first.Complete(Result::Success);
+    first.Complete(Result::Fail);
+    EXPECT_EQ(1u, sutCompletion.Pending());
+    EXPECT_EQ(Result::Fail, sutCompletion.WaitFor(10ms));
+
+    second.Complete(Result::Success);
+    EXPECT_EQ(Result::Success, sutCompletion.WaitFor(10ms));
+}
+
+TEST(CompletionGroupTest, testWait_groupDestroyedRightAfterWait_shouldNotBeTouchedByPerformer) {
+    for (u32 round = 0; round < 1000; ++round) {
+        auto sutCompletion = std::make_unique<CompletionGroup>();
+        RemovePortReq command{ 1 };
+        command.SetCompletion(sutCompletion.get());
+        std::thread performer{ [&command]() { command.Complete(Result::Success); } };
+
+        ASSERT_EQ(Result::Success, sutCompletion->Wait());
+        // Performer might still be inside Complete() if it has touched the group after release
+        sutCompletion.reset();
+        performer.join();
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/engine_stats.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+using namespace Stp;
+
+class EngineStatsTest : public ::testing::Test {
+protected:
+    EngineStatsTest()
+        : _clock{ std::make_shared<VirtualClock>() },
+          _sutEngine{ Mac{}, MakeSutSystem(_clock) } {
+        _sutEngine.AddPort(1, 1000, true);
+        _sutEngine.AddPort(2, 1000, true);
+    }
+
+    void Tick(const u32 ticks) {
+        for (u32 tick = 0; tick < ticks; ++tick) {
+            _clock->Advance(std::chrono::seconds{ 1 });
+            _sutEngine.Tick();
+        }
+    }
+
+    Sptr<VirtualClock> _clock;
+    Engine _sutEngine;
+};
+
+TEST_F(EngineStatsTest, testGetStats_afterTicks_shouldCountEveryMachineOfEveryPort) {
+    Tick(5);
+
+    EngineStats stats{};
+    ASSERT_EQ(Result::Success, _sutEngine.GetStats(stats));
+
+    ASSERT_EQ(2u, stats.Ports.size());
+    for (const auto& port : stats.Ports) {
+        for (u8 idx = 0; idx < MachineTypeCount; ++idx) {
+            const MachineStats& machine = port.second[idx];
+            EXPECT_LT(0u, machine.Executions) << MachineTypeName(static_cast<MachineType>(idx));
+            EXPECT_LE(machine.Transitions, machine.Executions);
+            // Every transition is made by at least one met condition
+            EXPECT_LE(machine.Transitions, machine.GuardHits);
+            EXPECT_LE(machine.GuardHits, machine.GuardEvaluations);
+        }
+
+        // Every tick moves port timers machine to its tick state and back
+        EXPECT_LE(5u, port.second[static_cast<u8>(MachineType::Pti)].Transitions);
+    }
+
+    const MachineStats total = stats.Total(MachineType::Prt);
+    EXPECT_EQ(stats.Ports.at(1)[static_cast<u8>(MachineType::Prt)].Executions
+              + stats.Ports.at(2)[static_cast<u8>(MachineType::Prt)].Executions,
+              total.Executions);
+    EXPECT_LT(0.0, total.GuardHitRate());
+}
+
+TEST_F(EngineStatsTest, testGetStats_afterRemovePort_shouldSkipRemovedPort) {
+    Tick(1);
+    ASSERT_EQ(Result::Success, _sutEngine.RemovePort(1));
+
+    EngineStats stats{};
+    ASSERT_EQ(Result::Success, _sutEngine.GetStats(stats));
+
+    ASSERT_EQ(1u, stats.Ports.size());
+    EXPECT_EQ(1u, stats.Ports.count(2));
+}
+
+TEST_F(EngineStatsTest, testGetStats_reselection_shouldCountReEntryOfRoleSelection) {
+    Tick(3);
+    EngineStats before{};
+    ASSERT_EQ(Result::Success, _sutEngine.GetStats(before));
+
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortPathCost(1, 2000));
+    Tick(1);
+    EngineStats after{};
+    ASSERT_EQ(Result::Success, _sutEngine.GetStats(after));
+
+    // ROLE_SELECTION is entered again, so its condition is met without transition
+    const MachineStats prsBefore = before.Total(MachineType::Prs);
+    const MachineStats prsAfter = after.Total(MachineType::Prs);
+    EXPECT_EQ(prsBefore.Transitions, prsAfter.Transitions);
+    EXPECT_EQ(prsBefore.GuardHits + 1, prsAfter.GuardHits);
+    EXPECT_LT(prsBefore.GuardEvaluations + 1, prsAfter.GuardEvaluations);
+}
+
+TEST_F(EngineStatsTest, testGuardHitRate_withoutExecutions_shouldBeZero) {
+    EXPECT_EQ(0.0, MachineStats{}.GuardHitRate());
+}
+
+TEST(MachineCountersTest, testAllocation_shouldStartEveryMachineAtCacheLine) {
+    // Counters of every port are allocated as the engine does
+    for (u32 port = 0; port < 64; ++port) {
+        const auto counters = std::make_shared<PortMachineCounters>();
+        for (const MachineCounters& machine : *counters) {
+            EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(&machine) % CacheLineSize);
+        }
+    }
+}
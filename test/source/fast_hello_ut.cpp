@@ -0,0 +1,130 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bpdu.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/time.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <chrono>
+
+using namespace Stp;
+
+TEST(TimeTest, testBpduUnits_shouldRoundToNearestUnit) {
+    EXPECT_EQ(2 * Time::BpduUnitsPerSecond, Time::ToBpduUnits(2000));
+    EXPECT_EQ(2000u, Time::FromBpduUnits(2 * Time::BpduUnitsPerSecond));
+    EXPECT_EQ(26u, Time::ToBpduUnits(100));
+    EXPECT_EQ(102u, Time::FromBpduUnits(26));
+    EXPECT_EQ(0u, Time::ToBpduUnits(1));
+}
+
+TEST(SmTimersTest, testAdvance_longerThanTimer_shouldStopAtZero) {
+    SmTimers sutTimers{};
+    sutTimers.SetRcvdInfoWhile(300);
+    sutTimers.SetHelloWhen(2000);
+
+    sutTimers.Advance(100);
+    EXPECT_EQ(200u, sutTimers.RcvdInfoWhile());
+    sutTimers.Advance(1000);
+    EXPECT_TRUE(SmTimers::TimedOut(sutTimers.RcvdInfoWhile()));
+    EXPECT_EQ(900u, sutTimers.HelloWhen());
+}
+
+class FastHelloTest : public ::testing::Test {
+protected:
+    FastHelloTest()
+        : _clock{ std::make_shared<VirtualClock>() },
+          _outInterface{ std::make_shared<CapturingOutInterface>() },
+          _sutEngine{ Mac{}, MakeSutSystem(_outInterface, _clock) } {
+        _sutEngine.AddPort(1, 1000, true);
+        _sutEngine.AddPort(2, 1000, true);
+    }
+
+    /// @brief Runs the engine as StpManager does, with ticks of its current interval
+    void RunFor(const u32 durationMs) {
+        for (u32 elapsedMs = 0; elapsedMs < durationMs; elapsedMs += _sutEngine.TickIntervalMs()) {
+            _clock->Advance(std::chrono::milliseconds{ _sutEngine.TickIntervalMs() });
+            _sutEngine.Tick();
+        }
+    }
+
+    /// @return Time from the last received BPDU until the port is not the root port anymore
+    u32 MeasureInfoAgeing(const u32 helloTimeMs) {
+        RunFor(3000);
+        _sutEngine.ProcessBpdu(1, RootBpdu(1, 0, helloTimeMs));
+        _sutEngine.Evaluate();
+        EXPECT_EQ(PortRole::Root, _sutEngine.ReadSnapshot()->FindPort(1)->Role);
+
+        u32 elapsedMs = 0;
+        while ((PortRole::Root == _sutEngine.ReadSnapshot()->FindPort(1)->Role)
+               && (elapsedMs < 60000)) {
+            RunFor(_sutEngine.TickIntervalMs());
+            elapsedMs += _sutEngine.TickIntervalMs();
+        }
+
+        return elapsedMs;
+    }
+
+    Sptr<VirtualClock> _clock;
+    Sptr<CapturingOutInterface> _outInterface;
+    Engine _sutEngine;
+};
+
+TEST_F(FastHelloTest, testSetPortFastHello_shouldTickAsOftenAsShortestHelloTime) {
+    EXPECT_EQ(Time::DefaultTickIntervalMs, _sutEngine.TickIntervalMs());
+    EXPECT_EQ(Result::Fail, _sutEngine.SetPortFastHello(1, 5));
+    EXPECT_EQ(Result::Fail, _sutEngine.SetPortFastHello(1, 1000));
+    EXPECT_EQ(Result::Fail, _sutEngine.SetPortFastHello(3, 100));
+
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortFastHello(1, 100));
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortFastHello(2, 250));
+    EXPECT_EQ(100u, _sutEngine.TickIntervalMs());
+
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortFastHello(1, 0));
+    EXPECT_EQ(250u, _sutEngine.TickIntervalMs());
+    ASSERT_EQ(Result::Success, _sutEngine.RemovePort(2));
+    EXPECT_EQ(Time::DefaultTickIntervalMs, _sutEngine.TickIntervalMs());
+}
+
+TEST_F(FastHelloTest, testTick_portInFastHelloMode_shouldTransmitWithShortHelloTime) {
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortFastHello(1, 100));
+    RunFor(3000);
+    _outInterface->Sent.clear();
+
+    RunFor(1000);
+
+    u32 sentByFastPort = 0;
+    for (const auto& sent : _outInterface->Sent) {
+        Bpdu bpdu{};
+        ASSERT_EQ(Result::Success, bpdu.Decode(*sent.Data));
+        if (1 == sent.PortNo) {
+            ++sentByFastPort;
+            EXPECT_EQ(Time::ToBpduUnits(100), bpdu.HelloTime());
+        }
+        else {
+            EXPECT_EQ(2 * Time::BpduUnitsPerSecond, bpdu.HelloTime());
+        }
+    }
+
+    EXPECT_EQ(10u, sentByFastPort);
+}
+
+TEST_F(FastHelloTest, testTick_lossOfBpdusOnFastHelloPort_shouldAgeInfoOutWithinThreeHellos) {
+    const u32 defaultAgeingMs = MeasureInfoAgeing(2000);
+    EXPECT_GE(defaultAgeingMs, 6000u);
+
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortFastHello(1, 100));
+    const u32 fastAgeingMs = MeasureInfoAgeing(100);
+    EXPECT_GE(fastAgeingMs, 300u);
+    EXPECT_LE(fastAgeingMs, 400u);
+}
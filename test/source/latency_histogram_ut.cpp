@@ -0,0 +1,157 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bridge_id.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/latency_histogram.hpp>
+#include <stp/latency_tracker.hpp>
+#include <stp/port_id.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <chrono>
+#include <sstream>
+
+using namespace Stp;
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogramTest, testBucketIndex_anyValue_shouldFallIntoItsBucketBounds) {
+    const u64 values[] = { 0, 1, 15, 16, 17, 31, 32, 1000, 999999, 1000000, 123456789,
+                           1ULL << 40, ~0ULL };
+    for (const u64 value : values) {
+        const u16 index = LatencyHistogram::BucketIndex(value);
+        ASSERT_LT(index, LatencyHistogram::BucketCount);
+        EXPECT_LE(LatencyHistogram::BucketLowerBound(index), value);
+        EXPECT_GE(LatencyHistogram::BucketUpperBound(index), value);
+        // Width of bucket is at most 1/8 of its lower bound
+        EXPECT_LE(LatencyHistogram::BucketUpperBound(index)
+                  - LatencyHistogram::BucketLowerBound(index),
+                  LatencyHistogram::BucketLowerBound(index) / 8);
+    }
+
+    EXPECT_EQ(LatencyHistogram::BucketCount - 1, LatencyHistogram::BucketIndex(~0ULL));
+}
+
+TEST(LatencyHistogramTest, testRead_afterRecords_shouldGivePercentilesWithinBucketError) {
+    LatencyHistogram sutHistogram{};
+    for (u64 valueUs = 1; valueUs <= 1000; ++valueUs) {
+        sutHistogram.Record(valueUs * 1000);
+    }
+
+    const LatencyDistribution distribution = sutHistogram.Read();
+
+    EXPECT_EQ(1000u, distribution.Count());
+    EXPECT_EQ(1000000u, distribution.MaxUs());
+    EXPECT_DOUBLE_EQ(500500.0, distribution.MeanUs());
+    EXPECT_NEAR(500000.0, static_cast<double>(distribution.PercentileUs(50.0)), 500000 / 8.0);
+    EXPECT_NEAR(990000.0, static_cast<double>(distribution.PercentileUs(99.0)), 990000 / 8.0);
+    EXPECT_EQ(1000000u, distribution.PercentileUs(100.0));
+}
+
+class LatencyTrackerTest : public ::testing::Test {
+protected:
+    LatencyTrackerTest()
+        : _clock{ std::make_shared<VirtualClock>() },
+          _sutEngine{ Mac{}, MakeSutSystem(_clock) } {
+        _sutEngine.AddPort(1, 1000, true);
+        _sutEngine.AddPort(2, 1000, true);
+        Tick(3);
+    }
+
+    void Tick(const u32 ticks) {
+        for (u32 tick = 0; tick < ticks; ++tick) {
+            _clock->Advance(1s);
+            _sutEngine.Tick();
+        }
+    }
+
+    /// @brief Designated information of root bridge better than the tested one
+    ByteStream SuperiorBpdu() const {
+        BridgeId rootId{};
+        rootId.SetPriority(0);
+        PortId portId{};
+        portId.SetPortNum(1);
+        Bpdu bpdu{};
+        bpdu.SetProtocolVersionIdentifier(+Bpdu::ProtocolVersionIdentifier::Rst);
+        bpdu.SetBpduType(+Bpdu::Type::Rst);
+        bpdu.SetPortRoleFlag(PortRole::Designated);
+        bpdu.SetRootIdentifier(rootId.ConvertToBpduData());
+        bpdu.SetBridgeIdentifier(rootId.ConvertToBpduData());
+        bpdu.SetPortIdentifier(portId.ConvertToBpduData());
+        bpdu.SetMaxAge(20 * Time::BpduUnitsPerSecond);
+        bpdu.SetHelloTime(2 * Time::BpduUnitsPerSecond);
+        bpdu.SetForwardDelay(15 * Time::BpduUnitsPerSecond);
+
+        ByteStream data{};
+        bpdu.Encode(data);
+        return data;
+    }
+
+    Sptr<VirtualClock> _clock;
+    Engine _sutEngine;
+};
+
+TEST_F(LatencyTrackerTest, testGetLatencyReport_afterSuperiorBpdu_shouldMeasureEveryStage) {
+    const Clock::Duration ingressTime = _clock->Now();
+    _clock->Advance(250ms);
+    ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(1, SuperiorBpdu(), ingressTime));
+    _clock->Advance(500ms);
+    _sutEngine.Evaluate();
+    Tick(40);
+
+    LatencyReport report{};
+    _sutEngine.GetLatencyReport(report);
+
+    const LatencyDistribution& receive = report.Stage(LatencyStage::Receive);
+    ASSERT_EQ(1u, receive.Count());
+    EXPECT_EQ(750000u, receive.MaxUs());
+    // New root information is propagated through the designated port at once
+    const LatencyDistribution& transmit = report.Stage(LatencyStage::Transmit);
+    ASSERT_EQ(1u, transmit.Count());
+    EXPECT_EQ(750000u, transmit.MaxUs());
+    const LatencyDistribution& forwarding = report.Stage(LatencyStage::Forwarding);
+    ASSERT_EQ(1u, forwarding.Count());
+    EXPECT_LE(750000u, forwarding.MaxUs());
+    EXPECT_GE(std::chrono::duration_cast<std::chrono::microseconds>(
+                  LatencyTracker::MaxForwardingLatency).count(),
+              static_cast<s64>(forwarding.MaxUs()));
+
+    std::ostringstream json{};
+    report.WriteJson(json);
+    EXPECT_NE(std::string::npos, json.str().find("\"forwarding\":{\"count\":1,"));
+}
+
+TEST_F(LatencyTrackerTest, testGetLatencyReport_afterRepeatedBpdus_shouldNotWaitForReaction) {
+    // Root bridge sends hello every two seconds, so its information never ages out
+    for (u32 hello = 0; hello < 20; ++hello) {
+        ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(1, SuperiorBpdu()));
+        Tick(2);
+    }
+
+    LatencyReport before{};
+    _sutEngine.GetLatencyReport(before);
+
+    for (u32 hello = 0; hello < 5; ++hello) {
+        ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(1, SuperiorBpdu()));
+        Tick(2);
+    }
+
+    LatencyReport after{};
+    _sutEngine.GetLatencyReport(after);
+
+    EXPECT_EQ(before.Stage(LatencyStage::Receive).Count() + 5,
+              after.Stage(LatencyStage::Receive).Count());
+    EXPECT_EQ(before.Stage(LatencyStage::Transmit).Count(),
+              after.Stage(LatencyStage::Transmit).Count());
+    EXPECT_EQ(before.Stage(LatencyStage::Forwarding).Count(),
+              after.Stage(LatencyStage::Forwarding).Count());
+}
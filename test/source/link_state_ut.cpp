@@ -0,0 +1,186 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bpdu.hpp>
+#include <stp/bridge_id.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/port_id.hpp>
+#include <stp/time.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <chrono>
+
+using namespace Stp;
+
+class LinkStateTest : public ::testing::Test {
+protected:
+    LinkStateTest()
+        : _clock{ std::make_shared<VirtualClock>() },
+          _sutEngine{ Mac{}, MakeSutSystem(_clock) } {
+        for (u16 portNo = 1; portNo <= 3; ++portNo) {
+            _sutEngine.AddPort(portNo, 1000, true);
+        }
+    }
+
+    void SetUp() override {
+        for (u32 tick = 0; tick < 3; ++tick) {
+            _clock->Advance(std::chrono::milliseconds{ _sutEngine.TickIntervalMs() });
+            _sutEngine.Tick();
+        }
+
+        // The root bridge is reached through ports 1 and 2, the first one is the root port
+        _sutEngine.ProcessBpdu(1, RootBpdu(1, _kRootPriority));
+        _sutEngine.ProcessBpdu(2, RootBpdu(2, _kRootPriority));
+        _sutEngine.Evaluate();
+        ASSERT_EQ(PortRole::Root, Role(1));
+        ASSERT_EQ(PortRole::Alternate, Role(2));
+    }
+
+    /// @return BPDU of the bridge below, which agrees to proposal of the designated port
+    static ByteStream AgreementBpdu() {
+        BridgeId rootId{};
+        rootId.SetPriority(_kRootPriority);
+        rootId.SetAddress(Mac{ Bpdu::BridgeSystemIdHandler{ { 0x00, 0x00, 0x00, 0x00, 0x00,
+                                                              0x01 } } });
+        BridgeId bridgeId{};
+        bridgeId.SetPriority(32768);
+        bridgeId.SetAddress(Mac{ Bpdu::BridgeSystemIdHandler{ { 0x00, 0x00, 0x00, 0x00, 0x00,
+                                                                0x02 } } });
+        PortId portId{};
+        portId.SetPortNum(1);
+        Bpdu bpdu{};
+        bpdu.SetProtocolVersionIdentifier(+Bpdu::ProtocolVersionIdentifier::Rst);
+        bpdu.SetBpduType(+Bpdu::Type::Rst);
+        bpdu.SetPortRoleFlag(PortRole::Root);
+        bpdu.SetAgreementFlag();
+        bpdu.SetRootIdentifier(rootId.ConvertToBpduData());
+        bpdu.SetRootPathCost(40000);
+        bpdu.SetBridgeIdentifier(bridgeId.ConvertToBpduData());
+        bpdu.SetPortIdentifier(portId.ConvertToBpduData());
+        bpdu.SetMaxAge(20 * Time::BpduUnitsPerSecond);
+        bpdu.SetHelloTime(2 * Time::BpduUnitsPerSecond);
+        bpdu.SetForwardDelay(15 * Time::BpduUnitsPerSecond);
+
+        ByteStream data{};
+        bpdu.Encode(data);
+        return data;
+    }
+
+    PortRole Role(const u16 portNo) const {
+        return _sutEngine.ReadSnapshot()->FindPort(portNo)->Role;
+    }
+
+    static constexpr u16 _kRootPriority = 4096;
+    Sptr<VirtualClock> _clock;
+    Engine _sutEngine;
+};
+
+TEST_F(LinkStateTest, testSetPortEnabled_rootPortDown_shouldReselectWithoutTick) {
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortEnabled(1, false));
+
+    const auto snapshot = _sutEngine.ReadSnapshot();
+    EXPECT_FALSE(snapshot->FindPort(1)->Enabled);
+    EXPECT_EQ(Port::Info::Disabled, snapshot->FindPort(1)->InfoIs);
+    EXPECT_EQ(PortRole::Disabled, snapshot->FindPort(1)->Role);
+    EXPECT_EQ(PortRole::Root, snapshot->FindPort(2)->Role);
+}
+
+TEST_F(LinkStateTest, testSetPortEnabled_rootPortDown_shouldInstallPrecomputedBackup) {
+    EXPECT_EQ(2u, _sutEngine.ReadSnapshot()->BackupRootPortNo);
+
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortEnabled(1, false));
+
+    const auto snapshot = _sutEngine.ReadSnapshot();
+    EXPECT_EQ(2u, snapshot->RootPortId.PortNum());
+    EXPECT_TRUE(snapshot->FindPort(2)->Forwarding);
+    EXPECT_EQ(PortRole::Designated, snapshot->FindPort(3)->Role);
+    EXPECT_EQ(snapshot->FindPort(2)->PathCost,
+              snapshot->FindPort(3)->DesignatedPriority.RootPathCost().Value());
+    // There is no other path to the root bridge anymore
+    EXPECT_EQ(0u, snapshot->BackupRootPortNo);
+}
+
+TEST_F(LinkStateTest, testSetPortEnabled_rootPortDownWithPendingInfo_shouldNotUseStaleBackup) {
+    // Better root bridge is announced on port 3 just before the root port goes down, so the
+    // precomputed backup is not the best choice anymore
+    _sutEngine.ProcessBpdu(3, RootBpdu(1, 0));
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortEnabled(1, false));
+
+    const auto snapshot = _sutEngine.ReadSnapshot();
+    EXPECT_EQ(3u, snapshot->RootPortId.PortNum());
+    EXPECT_EQ(0, snapshot->RootPriority.RootBridgeId().Priority());
+    EXPECT_EQ(PortRole::Designated, snapshot->FindPort(2)->Role);
+}
+
+TEST_F(LinkStateTest, testSetPortsEnabled_allPortsToRootDown_shouldBecomeRootAtOnce) {
+    EXPECT_EQ(Result::Fail, _sutEngine.SetPortsEnabled({ 1, 4 }, false));
+    EXPECT_EQ(PortRole::Root, Role(1));
+
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortsEnabled({ 1, 2 }, false));
+
+    const auto snapshot = _sutEngine.ReadSnapshot();
+    EXPECT_EQ(PortRole::Disabled, snapshot->FindPort(1)->Role);
+    EXPECT_EQ(PortRole::Disabled, snapshot->FindPort(2)->Role);
+    EXPECT_EQ(PortRole::Designated, snapshot->FindPort(3)->Role);
+    EXPECT_TRUE(snapshot->BridgeIdentifier == snapshot->RootPriority.RootBridgeId());
+
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortsEnabled({ 1, 2 }, true));
+    EXPECT_TRUE(_sutEngine.ReadSnapshot()->FindPort(1)->Enabled);
+}
+
+TEST_F(LinkStateTest, testSetPortAdminEdge_designatedPort_shouldForwardWithoutTick) {
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortAutoEdge(3, false));
+    ASSERT_EQ(PortRole::Designated, Role(3));
+    ASSERT_FALSE(_sutEngine.ReadSnapshot()->FindPort(3)->Forwarding);
+
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortAdminEdge(3, true));
+    EXPECT_TRUE(_sutEngine.ReadSnapshot()->FindPort(3)->OperEdge);
+    EXPECT_TRUE(_sutEngine.ReadSnapshot()->FindPort(3)->Forwarding);
+
+    // Without autoEdge the port stops being edge port as soon as it is not configured so
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortAdminEdge(3, false));
+    EXPECT_FALSE(_sutEngine.ReadSnapshot()->FindPort(3)->OperEdge);
+    EXPECT_EQ(Result::Fail, _sutEngine.SetPortAdminEdge(4, true));
+}
+
+TEST_F(LinkStateTest, testSetPortAutoEdge_disabledOnDetectedEdgePort_shouldClearOperEdge) {
+    // Port 3 receives no BPDUs, so it is detected as edge port once edgeDelayWhile expires
+    for (u32 tick = 0; (tick < 30) && not _sutEngine.ReadSnapshot()->FindPort(3)->OperEdge;
+         ++tick) {
+        _clock->Advance(std::chrono::milliseconds{ _sutEngine.TickIntervalMs() });
+        _sutEngine.ProcessBpdu(1, RootBpdu(1, _kRootPriority));
+        _sutEngine.Tick();
+    }
+
+    ASSERT_TRUE(_sutEngine.ReadSnapshot()->FindPort(3)->OperEdge);
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortAutoEdge(3, false));
+    EXPECT_FALSE(_sutEngine.ReadSnapshot()->FindPort(3)->OperEdge);
+}
+
+TEST_F(LinkStateTest, testSetPortPointToPoint_designatedPort_shouldForwardOnAgreementWithoutTick) {
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortAutoEdge(3, false));
+    ASSERT_EQ(PortRole::Designated, Role(3));
+
+    // Agreement is not taken from shared LAN
+    _sutEngine.ProcessBpdu(3, AgreementBpdu());
+    _sutEngine.Evaluate();
+    ASSERT_FALSE(_sutEngine.ReadSnapshot()->FindPort(3)->Forwarding);
+
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortPointToPoint(3, true));
+    EXPECT_TRUE(_sutEngine.ReadSnapshot()->FindPort(3)->PointToPoint);
+
+    _sutEngine.ProcessBpdu(3, AgreementBpdu());
+    _sutEngine.Evaluate();
+    EXPECT_TRUE(_sutEngine.ReadSnapshot()->FindPort(3)->Forwarding);
+    EXPECT_EQ(Result::Fail, _sutEngine.SetPortPointToPoint(4, true));
+}
@@ -66,3 +66,29 @@ TEST_F(PortInformationTest,
     EXPECT_STREQ(_sutMachine.CurrentState().Name().c_str(),
                  Stp::PortInformation::DisabledState::Instance().Name().c_str());
 }
+
+TEST_F(PortInformationTest,
+       testCurrentStateExecute_withSelectedAndUpdtInfo_shouldChangeStateOntoUpdateState) {
+    _port->SetPortEnabled(true);
+    _port->SetSelected(true);
+    _port->SetUpdtInfo(true);
+
+    _sutMachine.ChangeState(Stp::PortInformation::CurrentState::Instance());
+    _sutMachine.Run();
+
+    EXPECT_STREQ(_sutMachine.CurrentState().Name().c_str(),
+                 Stp::PortInformation::UpdateState::Instance().Name().c_str());
+}
+
+TEST_F(PortInformationTest,
+       testCurrentStateExecute_withExpiredReceivedInfo_shouldChangeStateOntoAgedState) {
+    _port->SetPortEnabled(true);
+    _port->SetInfoIs(Stp::Port::Info::Received);
+    _port->SmTimersInstance().SetRcvdInfoWhile(0);
+
+    _sutMachine.ChangeState(Stp::PortInformation::CurrentState::Instance());
+    _sutMachine.Run();
+
+    EXPECT_STREQ(_sutMachine.CurrentState().Name().c_str(),
+                 Stp::PortInformation::AgedState::Instance().Name().c_str());
+}
@@ -0,0 +1,86 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bridge_id.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/port_id.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <vector>
+
+using namespace Stp;
+
+TEST(PortProvisioningTest, testAddPorts_shouldEndInSameStateAsAddingOneByOne) {
+    constexpr u16 kPortCount = 64;
+    std::vector<PortSpec> ports{};
+    for (u16 portNo = kPortCount; portNo >= 1; --portNo) {
+        ports.push_back(PortSpec{ portNo, (portNo % 2) ? 1000u : 10000u, (portNo % 8) != 0 });
+    }
+
+    Engine bulkEngine{ Mac{}, MakeSutSystem(std::make_shared<VirtualClock>()) };
+    ASSERT_EQ(Result::Success, bulkEngine.AddPorts(ports));
+    Engine singleEngine{ Mac{}, MakeSutSystem(std::make_shared<VirtualClock>()) };
+    for (const PortSpec& spec : ports) {
+        ASSERT_EQ(Result::Success, singleEngine.AddPort(spec.PortNo, spec.Speed, spec.Enabled));
+    }
+
+    singleEngine.Evaluate();
+
+    const auto bulk = bulkEngine.ReadSnapshot();
+    const auto single = singleEngine.ReadSnapshot();
+    ASSERT_EQ(single->Ports.size(), bulk->Ports.size());
+    EXPECT_TRUE(single->RootPriority == bulk->RootPriority);
+    for (std::size_t idx = 0; idx < single->Ports.size(); ++idx) {
+        EXPECT_EQ(idx + 1, bulk->Ports[idx].PortNo);
+        EXPECT_EQ(single->Ports[idx].Role, bulk->Ports[idx].Role);
+        EXPECT_EQ(single->Ports[idx].InfoIs, bulk->Ports[idx].InfoIs);
+        EXPECT_EQ(single->Ports[idx].Enabled, bulk->Ports[idx].Enabled);
+        EXPECT_EQ(single->Ports[idx].PathCost, bulk->Ports[idx].PathCost);
+        EXPECT_TRUE(single->Ports[idx].DesignatedPriority == bulk->Ports[idx].DesignatedPriority);
+    }
+
+    EXPECT_EQ(PortRole::Designated, bulk->FindPort(1)->Role);
+    EXPECT_EQ(PortRole::Disabled, bulk->FindPort(8)->Role);
+}
+
+TEST(PortProvisioningTest, testAddPorts_existingOrRepeatedPort_shouldAddNone) {
+    Engine sutEngine{ Mac{}, MakeSutSystem(std::make_shared<VirtualClock>()) };
+    ASSERT_EQ(Result::Success, sutEngine.AddPort(3, 1000, true));
+
+    EXPECT_EQ(Result::Fail, sutEngine.AddPorts({ { 1, 1000, true }, { 3, 1000, true } }));
+    EXPECT_EQ(Result::Fail, sutEngine.AddPorts({ { 1, 1000, true }, { 1, 1000, true } }));
+    EXPECT_EQ(1u, sutEngine.ReadSnapshot()->Ports.size());
+
+    EXPECT_EQ(Result::Success, sutEngine.AddPorts({ { 2, 1000, true }, { 1, 1000, true } }));
+    EXPECT_EQ(3u, sutEngine.ReadSnapshot()->Ports.size());
+}
+
+TEST(PortProvisioningTest, testRemovePorts_rootPortRemoved_shouldReselectRemainingPorts) {
+    Engine sutEngine{ Mac{}, MakeSutSystem(std::make_shared<VirtualClock>()) };
+    ASSERT_EQ(Result::Success, sutEngine.AddPorts({ { 1, 1000, true }, { 2, 1000, true },
+                                                    { 3, 1000, true } }));
+    sutEngine.ProcessBpdu(1, RootBpdu(1));
+    sutEngine.Evaluate();
+    ASSERT_EQ(1u, sutEngine.ReadSnapshot()->RootPortId.PortNum());
+
+    EXPECT_EQ(Result::Fail, sutEngine.RemovePorts({ 1, 4 }));
+    EXPECT_EQ(Result::Fail, sutEngine.RemovePorts({ 1, 1 }));
+    EXPECT_EQ(3u, sutEngine.ReadSnapshot()->Ports.size());
+
+    ASSERT_EQ(Result::Success, sutEngine.RemovePorts({ 2, 1 }));
+
+    const auto snapshot = sutEngine.ReadSnapshot();
+    ASSERT_EQ(1u, snapshot->Ports.size());
+    EXPECT_EQ(PortRole::Designated, snapshot->FindPort(3)->Role);
+    EXPECT_TRUE(snapshot->BridgeIdentifier == snapshot->RootPriority.RootBridgeId());
+}
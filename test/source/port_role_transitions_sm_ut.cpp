@@ -0,0 +1,49 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/sm/port_role_transitions.hpp>
+// UT dependencies
+#include "sut_machine.hpp"
+#include <mock/logger.hpp>
+#include <mock/management.hpp>
+
+// GTest headers
+#include <gtest/gtest.h>
+
+using namespace Stp::PortRoleTransitions;
+
+class PortRoleTransitionsTest : public ::testing::Test {
+protected:
+    PortRoleTransitionsTest()
+        : _bridge{
+              std::make_shared<Stp::Bridge>(
+                  std::make_shared<Stp::System>(
+                      std::make_shared<Mock::OutInterface>(),
+                      std::make_shared<Mock::Logger>())) },
+          _port{ std::make_shared<Stp::Port>() },
+          _sutMachine{ _bridge, _port } {
+
+    }
+
+    Stp::BridgeH _bridge;
+    Stp::PortH _port;
+    SutMachine _sutMachine;
+};
+
+TEST_F(PortRoleTransitionsTest,
+       testInitPortStateExecute_withDesignatedRole_shouldChangeStateOntoDisablePortState) {
+    _port->SetRole(Stp::PortRole::Designated);
+    _port->SetSelectedRole(Stp::PortRole::Designated);
+
+    _sutMachine.ChangeState(InitPortState::Instance());
+    _sutMachine.Run();
+
+    EXPECT_STREQ(_sutMachine.CurrentState().Name().c_str(),
+                 DisablePortState::Instance().Name().c_str());
+    // 17.29.1, the role is set to DisabledPort rather than to the selected one
+    EXPECT_EQ(Stp::PortRole::Disabled, _port->Role());
+}
@@ -0,0 +1,178 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bridge_id.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/port_id.hpp>
+#include <stp/port_stats.hpp>
+#include <stp/seqlock.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Stp;
+
+namespace {
+
+/// @brief Every field has the same value, so torn read would be noticed
+struct Pattern {
+    u64 Words[16];
+};
+
+} // namespace
+
+class PortStatsTest : public ::testing::Test {
+protected:
+    static constexpr u16 _kPortNo = 1;
+
+    PortStatsTest()
+        : _clock{ std::make_shared<VirtualClock>() },
+          _out{ std::make_shared<CountingOutInterface>() },
+          _sutEngine{ Mac{}, MakeSutSystem(_out, _clock) } {
+        _sutEngine.AddPort(_kPortNo, 1000, true);
+    }
+
+    void Tick(const u32 ticks) {
+        for (u32 tick = 0; tick < ticks; ++tick) {
+            _clock->Advance(std::chrono::seconds{ 1 });
+            _sutEngine.Tick();
+        }
+    }
+
+    /// @brief Designated information of the bridge with the same identifier as the tested one
+    ByteStream EncodedBpdu(const Bpdu::Type type, const u16 portNo, const bool tc) const {
+        Bpdu bpdu{};
+        bpdu.SetBpduType(+type);
+        if (Bpdu::Type::Rst == type) {
+            bpdu.SetProtocolVersionIdentifier(+Bpdu::ProtocolVersionIdentifier::Rst);
+            bpdu.SetPortRoleFlag(PortRole::Designated);
+        }
+
+        if (tc) {
+            bpdu.SetTcFlag();
+        }
+
+        BridgeId bridgeId{};
+        bridgeId.SetAddress(Mac{});
+        PortId portId{};
+        portId.SetPortNum(portNo);
+        bpdu.SetRootIdentifier(bridgeId.ConvertToBpduData());
+        bpdu.SetBridgeIdentifier(bridgeId.ConvertToBpduData());
+        bpdu.SetPortIdentifier(portId.ConvertToBpduData());
+        bpdu.SetMaxAge(20 * Time::BpduUnitsPerSecond);
+        bpdu.SetHelloTime(2 * Time::BpduUnitsPerSecond);
+        bpdu.SetForwardDelay(15 * Time::BpduUnitsPerSecond);
+
+        ByteStream data{};
+        bpdu.Encode(data);
+        return data;
+    }
+
+    PortStats ReadStats() const {
+        PortStats stats{};
+        EXPECT_EQ(Result::Success, _sutEngine.GetPortStats(_kPortNo, stats));
+        return stats;
+    }
+
+    Sptr<VirtualClock> _clock;
+    Sptr<CountingOutInterface> _out;
+    Engine _sutEngine;
+};
+
+TEST_F(PortStatsTest, testGetPortStats_afterReceivedBpdus_shouldCountThemByType) {
+    ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(_kPortNo, EncodedBpdu(Bpdu::Type::Rst,
+                                                                           2, true)));
+    ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(_kPortNo, EncodedBpdu(Bpdu::Type::Config,
+                                                                           2, false)));
+    ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(_kPortNo, EncodedBpdu(Bpdu::Type::Tcn,
+                                                                           2, false)));
+
+    // Counters are published by evaluation of state machines
+    EXPECT_EQ(0u, ReadStats().RxRst);
+    _sutEngine.Evaluate();
+    const PortStats stats = ReadStats();
+
+    EXPECT_EQ(1u, stats.RxRst);
+    EXPECT_EQ(1u, stats.RxConfig);
+    EXPECT_EQ(1u, stats.RxTcn);
+    EXPECT_EQ(1u, stats.RxTc);
+}
+
+TEST_F(PortStatsTest, testGetPortStats_afterRejectedBpdus_shouldCountThemByReason) {
+    EXPECT_EQ(Result::Fail, _sutEngine.ProcessBpdu(_kPortNo, ByteStream{ 0x00 }));
+    EXPECT_EQ(Result::Fail, _sutEngine.ProcessBpdu(_kPortNo, EncodedBpdu(Bpdu::Type::Config,
+                                                                        _kPortNo, false)));
+    ASSERT_EQ(Result::Success, _sutEngine.SetPortEnabled(_kPortNo, false));
+    EXPECT_EQ(Result::Success, _sutEngine.ProcessBpdu(_kPortNo, EncodedBpdu(Bpdu::Type::Rst,
+                                                                           2, false)));
+    _sutEngine.Evaluate();
+    const PortStats stats = ReadStats();
+
+    EXPECT_EQ(1u, stats.DroppedBy(BpduDropReason::Malformed));
+    EXPECT_EQ(1u, stats.DroppedBy(BpduDropReason::Looped));
+    EXPECT_EQ(1u, stats.DroppedBy(BpduDropReason::PortDisabled));
+    EXPECT_EQ(0u, stats.RxConfig + stats.RxRst + stats.RxTcn);
+}
+
+TEST_F(PortStatsTest, testGetPortStats_afterTicks_shouldCountTransmittedBpdusAndRoleChange) {
+    Tick(3);
+    const PortStats stats = ReadStats();
+
+    EXPECT_EQ(_out->TxBpdus, stats.TxConfig + stats.TxRst + stats.TxTcn);
+    EXPECT_LT(0u, stats.TxRst);
+    EXPECT_EQ(PortRole::Designated, stats.Role);
+    EXPECT_EQ(1u, stats.RoleChanges);
+    EXPECT_EQ(1000u, stats.LastRoleChangeMs);
+}
+
+TEST_F(PortStatsTest, testGetPortStats_unknownPort_shouldFail) {
+    PortStats stats{};
+    EXPECT_EQ(Result::Fail, _sutEngine.GetPortStats(_kPortNo + 1, stats));
+
+    std::map<u16, PortStats> allStats{};
+    _sutEngine.GetAllPortStats(allStats);
+    EXPECT_EQ(1u, allStats.size());
+}
+
+TEST(SeqLockTest, testLoad_whileStoring_shouldNeverReturnTornValue) {
+    SeqLock<Pattern> sutSeqLock{};
+    std::atomic<bool> done{ false };
+    std::thread writer{ [&sutSeqLock, &done]() {
+        Pattern pattern{};
+        for (u64 value = 1; value <= 200000; ++value) {
+            for (u64& word : pattern.Words) {
+                word = value;
+            }
+
+            sutSeqLock.Store(pattern);
+        }
+
+        done.store(true);
+    } };
+
+    u64 previous = 0;
+    while (not done.load()) {
+        const Pattern pattern = sutSeqLock.Load();
+        for (const u64 word : pattern.Words) {
+            ASSERT_EQ(pattern.Words[0], word);
+        }
+
+        EXPECT_LE(previous, pattern.Words[0]);
+        previous = pattern.Words[0];
+    }
+
+    writer.join();
+    EXPECT_EQ(200000u, sutSeqLock.Load().Words[0]);
+}
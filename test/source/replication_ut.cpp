@@ -0,0 +1,353 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bridge.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/port.hpp>
+#include <stp/port_id.hpp>
+#include <stp/replication.hpp>
+#include <stp/state_image.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// POSIX
+#include <sys/wait.h>
+#include <unistd.h>
+
+// C Standard Library
+#include <cstdio>
+#include <cstring>
+
+// C++ Standard Library
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Stp;
+
+namespace {
+
+Replica::FrameHeader ReadHeader(const ByteStream& frame) {
+    Replica::FrameHeader header{};
+    std::memcpy(&header, frame.data(), sizeof(header));
+    return header;
+}
+
+StateImage::PortRecord MakeRecord(const u16 portNo, const u32 helloWhen) {
+    StateImage::PortRecord record{};
+    record.PortNo = portNo;
+    record.HelloWhen = helloWhen;
+    return record;
+}
+
+/// @brief Receives pending frames and checks the replica holds state of every port of the bridge
+void ExpectReplicatedPorts(ReplicationChannel& channel, Replica& replica, const Bridge& bridge,
+                           const u32 toleranceMs) {
+    ByteStream frame{};
+    while (not Failed(channel.Receive(frame, 0))) {
+        ASSERT_EQ(Result::Success, replica.Apply(frame));
+    }
+
+    ASSERT_EQ(bridge.AllPorts().size(), replica.Ports().size());
+    auto record = replica.Ports().cbegin();
+    for (const auto& bridgePort : bridge.AllPorts()) {
+        // States of machines are not kept by the port, so they are taken from the record
+        StateImage::PortRecord expected = *record;
+        StateImage::SavePort(*bridgePort.second, expected);
+        // Timers are replicated with precision of one tick and txCount might be one BPDU off
+        EXPECT_NEAR(expected.TxCount, record->TxCount, 1) << "Port " << bridgePort.first;
+        expected.TxCount = record->TxCount;
+        for (const auto field : { &StateImage::PortRecord::AgeingTime,
+                                  &StateImage::PortRecord::EdgeDelayWhile,
+                                  &StateImage::PortRecord::FdWhile,
+                                  &StateImage::PortRecord::HelloWhen,
+                                  &StateImage::PortRecord::MdelayWhile,
+                                  &StateImage::PortRecord::RbWhile,
+                                  &StateImage::PortRecord::RcvdInfoWhile,
+                                  &StateImage::PortRecord::RrWhile,
+                                  &StateImage::PortRecord::TcWhile }) {
+            EXPECT_NEAR(expected.*field, (*record).*field, toleranceMs)
+                    << "Port " << bridgePort.first;
+            expected.*field = (*record).*field;
+        }
+
+        EXPECT_EQ(bridgePort.first, record->PortNo);
+        EXPECT_EQ(0, std::memcmp(&expected, &*record, sizeof(expected)))
+                << "Port " << bridgePort.first;
+        ++record;
+    }
+}
+
+} // namespace
+
+class ReplicationTest : public ::testing::Test {
+protected:
+    ReplicationTest()
+        : _path{ ::testing::TempDir() + "stp_replication_ut.sock" },
+          _clock{ std::make_shared<VirtualClock>() },
+          _outInterface{ std::make_shared<CountingOutInterface>() },
+          _sutEngine{ Mac{}, MakeSutSystem(_outInterface, _clock) } {
+    }
+
+    ~ReplicationTest() override {
+        std::remove(_path.c_str());
+    }
+
+    std::string _path;
+    Sptr<VirtualClock> _clock;
+    Sptr<CountingOutInterface> _outInterface;
+    Engine _sutEngine;
+};
+
+TEST_F(ReplicationTest, testTakeOver_shouldContinueFromStreamedStateWithoutTouchingForwarding) {
+    constexpr u16 kPortCount = 16;
+    ASSERT_EQ(Result::Success, _sutEngine.StartReplication(_path));
+    ReplicationChannel standbyChannel{};
+    ASSERT_EQ(Result::Success, standbyChannel.Connect(_path));
+    std::vector<PortSpec> ports{};
+    for (u16 portNo = 1; portNo <= kPortCount; ++portNo) {
+        ports.push_back(PortSpec{ portNo, 1000, true });
+    }
+
+    ASSERT_EQ(Result::Success, _sutEngine.AddPorts(ports));
+    Converge(_sutEngine, *_clock, 40000, 2);
+
+    Replica replica{};
+    ByteStream frame{};
+    while (not Failed(standbyChannel.Receive(frame, 0))) {
+        ASSERT_EQ(Result::Success, replica.Apply(frame));
+    }
+
+    // In steady state only ports which receive BPDUs are sent, as their information is refreshed
+    u32 changedPorts = 0;
+    u32 frames = 0;
+    for (u32 tick = 0; tick < 10; ++tick) {
+        Converge(_sutEngine, *_clock, _sutEngine.TickIntervalMs(), 2);
+        while (not Failed(standbyChannel.Receive(frame, 0))) {
+            ASSERT_EQ(Result::Success, replica.Apply(frame));
+            changedPorts += ReadHeader(frame).ChangedCount;
+            ++frames;
+        }
+    }
+
+    ASSERT_EQ(10u, frames);
+    EXPECT_LE(changedPorts, frames);
+    ASSERT_TRUE(replica.IsSynced());
+    ASSERT_EQ(kPortCount, replica.Ports().size());
+
+    const auto before = _sutEngine.ReadSnapshot();
+    auto standbyOut = std::make_shared<CountingOutInterface>();
+    auto standbyClock = std::make_shared<VirtualClock>(_clock->Now());
+    Engine standbyEngine{ Mac{}, MakeSutSystem(standbyOut, standbyClock) };
+    ASSERT_EQ(Result::Success, standbyEngine.TakeOver(replica, 0));
+    EXPECT_EQ(Result::Fail, standbyEngine.TakeOver(replica, 0));
+
+    const auto after = standbyEngine.ReadSnapshot();
+    ASSERT_EQ(before->Ports.size(), after->Ports.size());
+    EXPECT_TRUE(before->RootPriority == after->RootPriority);
+    EXPECT_EQ(before->RootPortId.PortNum(), after->RootPortId.PortNum());
+    for (std::size_t idx = 0; idx < before->Ports.size(); ++idx) {
+        EXPECT_EQ(before->Ports[idx].Role, after->Ports[idx].Role);
+        EXPECT_EQ(before->Ports[idx].Forwarding, after->Ports[idx].Forwarding);
+        EXPECT_TRUE(before->Ports[idx].PortPriority == after->Ports[idx].PortPriority);
+        // Timers are replicated with precision of one tick
+        EXPECT_NEAR(before->Ports[idx].Timers.HelloWhen(), after->Ports[idx].Timers.HelloWhen(),
+                    _sutEngine.TickIntervalMs());
+        EXPECT_NEAR(before->Ports[idx].Timers.RcvdInfoWhile(),
+                    after->Ports[idx].Timers.RcvdInfoWhile(), _sutEngine.TickIntervalMs());
+    }
+
+    Converge(standbyEngine, *standbyClock, 10000, 2);
+    const auto converged = standbyEngine.ReadSnapshot();
+    EXPECT_EQ(PortRole::Root, converged->FindPort(1)->Role);
+    EXPECT_EQ(PortRole::Alternate, converged->FindPort(2)->Role);
+    EXPECT_TRUE(converged->FindPort(kPortCount)->Forwarding);
+    EXPECT_EQ(0u, standbyOut->Calls);
+}
+
+TEST_F(ReplicationTest, testReplicate_changesOfFewPorts_shouldKeepStandbyInSync) {
+    ASSERT_EQ(Result::Success, _sutEngine.StartReplication(_path));
+    ReplicationChannel standbyChannel{};
+    ASSERT_EQ(Result::Success, standbyChannel.Connect(_path));
+    Replica replica{};
+    // Adding of ports one by one compares only records of added ports
+    for (const u16 portNo : { 6, 2, 8, 1, 4, 7, 3, 5 }) {
+        ASSERT_EQ(Result::Success, _sutEngine.AddPort(portNo, 1000, true));
+        ExpectReplicatedPorts(standbyChannel, replica, _sutEngine.BridgeInstance(),
+                              _sutEngine.TickIntervalMs());
+    }
+
+    Converge(_sutEngine, *_clock, 5000, 2);
+    ExpectReplicatedPorts(standbyChannel, replica, _sutEngine.BridgeInstance(),
+                          _sutEngine.TickIntervalMs());
+
+    for (const u16 portNo : { 4, 8 }) {
+        ASSERT_EQ(Result::Success, _sutEngine.RemovePort(portNo));
+        ExpectReplicatedPorts(standbyChannel, replica, _sutEngine.BridgeInstance(),
+                              _sutEngine.TickIntervalMs());
+    }
+
+    ASSERT_EQ(Result::Success, _sutEngine.AddPort(4, 100, false));
+    ExpectReplicatedPorts(standbyChannel, replica, _sutEngine.BridgeInstance(),
+                          _sutEngine.TickIntervalMs());
+    Converge(_sutEngine, *_clock, 5000, 2);
+    ExpectReplicatedPorts(standbyChannel, replica, _sutEngine.BridgeInstance(),
+                          _sutEngine.TickIntervalMs());
+}
+
+TEST_F(ReplicationTest, testTakeOver_primaryProcessDies_shouldTakeOverItsState) {
+    int ready[2];
+    ASSERT_EQ(0, ::pipe(ready));
+    const pid_t primary = ::fork();
+    ASSERT_GE(primary, 0);
+    if (0 == primary) {
+        // The primary converges once the standby has connected, then dies
+        ::close(ready[1]);
+        if (Failed(_sutEngine.StartReplication(_path))
+                || Failed(_sutEngine.AddPorts({ { 1, 1000, true }, { 2, 1000, true },
+                                                { 3, 1000, true } }))) {
+            ::_exit(1);
+        }
+
+        char connected = 0;
+        if (1 != ::read(ready[0], &connected, 1)) {
+            ::_exit(1);
+        }
+
+        Converge(_sutEngine, *_clock, 40000, 2);
+        ::_exit(0);
+    }
+
+    ::close(ready[0]);
+    ReplicationChannel standbyChannel{};
+    for (u32 attempt = 0; Failed(standbyChannel.Connect(_path)) && (attempt < 5000); ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    ASSERT_TRUE(standbyChannel.IsConnected());
+    ASSERT_EQ(1, ::write(ready[1], "1", 1));
+    ::close(ready[1]);
+
+    Replica replica{};
+    ByteStream frame{};
+    while (not Failed(standbyChannel.Receive(frame, 10000))) {
+        ASSERT_EQ(Result::Success, replica.Apply(frame));
+    }
+
+    int status = 0;
+    ASSERT_EQ(primary, ::waitpid(primary, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+    EXPECT_FALSE(standbyChannel.IsConnected());
+
+    ASSERT_EQ(Result::Success, _sutEngine.TakeOver(replica, 0));
+    const auto snapshot = _sutEngine.ReadSnapshot();
+    ASSERT_EQ(3u, snapshot->Ports.size());
+    EXPECT_EQ(PortRole::Root, snapshot->FindPort(1)->Role);
+    EXPECT_EQ(PortRole::Alternate, snapshot->FindPort(2)->Role);
+    EXPECT_EQ(PortRole::Designated, snapshot->FindPort(3)->Role);
+    EXPECT_TRUE(snapshot->FindPort(1)->Forwarding);
+    EXPECT_TRUE(snapshot->FindPort(3)->Forwarding);
+    EXPECT_EQ(0u, _outInterface->Calls);
+}
+
+TEST(ReplicaTest, testApply_shouldFollowEncoderAndRejectLostFrame) {
+    ReplicationEncoder sutEncoder{};
+    Replica replica{};
+    StateImage::BridgeRecord bridge{};
+    ByteStream frame{};
+
+    sutEncoder.Encode(bridge, { MakeRecord(1, 2000), MakeRecord(2, 2000) }, 0, 10, frame);
+    EXPECT_TRUE(ReadHeader(frame).Full);
+    ASSERT_EQ(Result::Success, replica.Apply(frame));
+    ASSERT_EQ(2u, replica.Ports().size());
+
+    // Timers which only run down are not sent, the replica advances them
+    sutEncoder.Encode(bridge, { MakeRecord(1, 1500), MakeRecord(2, 2000) }, 500, 10, frame);
+    EXPECT_EQ(1u, ReadHeader(frame).ChangedCount);
+    EXPECT_FALSE(ReadHeader(frame).HasBridge);
+    ASSERT_EQ(Result::Success, replica.Apply(frame));
+    EXPECT_EQ(1500u, replica.Ports()[0].HelloWhen);
+    EXPECT_EQ(2000u, replica.Ports()[1].HelloWhen);
+
+    // Removed port
+    sutEncoder.Encode(bridge, { MakeRecord(2, 1500) }, 1000, 10, frame);
+    EXPECT_EQ(0u, ReadHeader(frame).ChangedCount);
+    EXPECT_EQ(1u, ReadHeader(frame).RemovedCount);
+    ASSERT_EQ(Result::Success, replica.Apply(frame));
+    ASSERT_EQ(1u, replica.Ports().size());
+    EXPECT_EQ(2u, replica.Ports()[0].PortNo);
+
+    // The lost frame breaks the stream until the next full frame
+    sutEncoder.Encode(bridge, { MakeRecord(2, 2000) }, 1500, 10, frame);
+    sutEncoder.Encode(bridge, { MakeRecord(2, 2000), MakeRecord(3, 0) }, 2000, 10, frame);
+    EXPECT_EQ(Result::Fail, replica.Apply(frame));
+    EXPECT_FALSE(replica.IsSynced());
+    EXPECT_EQ(1u, replica.Ports().size());
+
+    sutEncoder.Reset();
+    sutEncoder.Encode(bridge, { MakeRecord(2, 2000), MakeRecord(3, 0) }, 2500, 10, frame);
+    ASSERT_EQ(Result::Success, replica.Apply(frame));
+    EXPECT_TRUE(replica.IsSynced());
+    EXPECT_EQ(2u, replica.Ports().size());
+}
+
+TEST(ReplicaTest, testApply_changedPortsListed_shouldFollowEncoder) {
+    ReplicationEncoder sutEncoder{};
+    Replica replica{};
+    StateImage::BridgeRecord bridge{};
+    ByteStream frame{};
+
+    StateImage::PortRecord first = MakeRecord(1, 2000);
+    first.DesignatedTimes.HelloTime = 2000;
+    sutEncoder.Encode(bridge, { first, MakeRecord(2, 2000), MakeRecord(3, 2000) }, { 2 }, 0, 10,
+                      frame);
+    EXPECT_TRUE(ReadHeader(frame).Full);
+    EXPECT_EQ(3u, ReadHeader(frame).ChangedCount);
+    ASSERT_EQ(Result::Success, replica.Apply(frame));
+
+    // Only listed ports are compared
+    first.HelloWhen = 1000;
+    sutEncoder.Encode(bridge, { first, MakeRecord(2, 900), MakeRecord(3, 1500) }, { 2 }, 500, 10,
+                      frame);
+    EXPECT_EQ(1u, ReadHeader(frame).ChangedCount);
+    ASSERT_EQ(Result::Success, replica.Apply(frame));
+    EXPECT_EQ(1500u, replica.Ports()[0].HelloWhen);
+    EXPECT_EQ(900u, replica.Ports()[1].HelloWhen);
+
+    // Removed port is listed as well
+    sutEncoder.Encode(bridge, { first, MakeRecord(2, 400) }, { 3 }, 1000, 10, frame);
+    EXPECT_EQ(0u, ReadHeader(frame).ChangedCount);
+    EXPECT_EQ(1u, ReadHeader(frame).RemovedCount);
+    ASSERT_EQ(Result::Success, replica.Apply(frame));
+    ASSERT_EQ(2u, replica.Ports().size());
+
+    // The standby has advanced timers of the port on every frame, which the encoder does once,
+    // hello timer restarted by the Port Transmit machine included
+    first.HelloWhen = 1500;
+    sutEncoder.Encode(bridge, { first, MakeRecord(2, 0), MakeRecord(4, 0) }, { 1, 4 }, 2500, 10,
+                      frame);
+    EXPECT_EQ(1u, ReadHeader(frame).ChangedCount);
+    ASSERT_EQ(Result::Success, replica.Apply(frame));
+    ASSERT_EQ(3u, replica.Ports().size());
+    EXPECT_EQ(1500u, replica.Ports()[0].HelloWhen);
+    EXPECT_EQ(4u, replica.Ports()[2].PortNo);
+
+    // Every port is compared without the list
+    first.HelloWhen = 1000;
+    sutEncoder.Encode(bridge, { first, MakeRecord(2, 700) }, 3000, 10, frame);
+    EXPECT_EQ(1u, ReadHeader(frame).ChangedCount);
+    EXPECT_EQ(1u, ReadHeader(frame).RemovedCount);
+    ASSERT_EQ(Result::Success, replica.Apply(frame));
+    ASSERT_EQ(2u, replica.Ports().size());
+    EXPECT_EQ(700u, replica.Ports()[1].HelloWhen);
+}
@@ -0,0 +1,119 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/engine.hpp>
+#include <stp/scheduler.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Stp;
+using namespace std::chrono_literals;
+
+class SchedulerTest : public ::testing::Test {
+protected:
+    SchedulerTest()
+        : _clock{ std::make_shared<VirtualClock>() }, _sutScheduler{ _clock } {}
+
+    Sptr<VirtualClock> _clock;
+    Scheduler _sutScheduler;
+    std::vector<int> _trace;
+};
+
+TEST_F(SchedulerTest, testRunNext_withTasksScheduledAtSameTime_shouldKeepSchedulingOrder) {
+    _sutScheduler.ScheduleAt(2s, [this]() { _trace.push_back(3); });
+    _sutScheduler.ScheduleAt(1s, [this]() { _trace.push_back(1); });
+    _sutScheduler.ScheduleAt(1s, [this]() { _trace.push_back(2); });
+
+    while (_sutScheduler.RunNext()) {}
+
+    EXPECT_EQ((std::vector<int>{ 1, 2, 3 }), _trace);
+    EXPECT_EQ(Clock::Duration{ 2s }, _clock->Now());
+}
+
+TEST_F(SchedulerTest, testRunUntil_withPeriodicTask_shouldRunItWithoutDrift) {
+    _sutScheduler.ScheduleEvery(250ms, 250ms, [this]() {
+        _trace.push_back(static_cast<int>(
+                             std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 _clock->Now()).count()));
+    });
+
+    EXPECT_EQ(4u, _sutScheduler.RunUntil(1100ms));
+
+    EXPECT_EQ((std::vector<int>{ 250, 500, 750, 1000 }), _trace);
+    EXPECT_EQ(Clock::Duration{ 1100ms }, _clock->Now());
+    EXPECT_EQ(Clock::Duration{ 1250ms }, _sutScheduler.NextTime());
+}
+
+TEST_F(SchedulerTest, testCancel_withPeriodicTask_shouldNotRunItAnymore) {
+    Scheduler::TaskId taskId = _sutScheduler.ScheduleEvery(1s, 1s, [this]() {
+        _trace.push_back(0);
+    });
+    _sutScheduler.RunUntil(2s);
+
+    EXPECT_EQ(Result::Success, _sutScheduler.Cancel(taskId));
+    EXPECT_EQ(Result::Fail, _sutScheduler.Cancel(taskId));
+
+    EXPECT_TRUE(_sutScheduler.Empty());
+    EXPECT_EQ(0u, _sutScheduler.RunUntil(10s));
+    EXPECT_EQ(2u, _trace.size());
+}
+
+TEST_F(SchedulerTest, testRunUntil_withEngineTickedEverySecond_shouldNotWaitForWallTime) {
+    Engine engine{ Mac{}, MakeSutSystem(_clock) };
+    ASSERT_EQ(Result::Success, engine.AddPort(1, 1000, true));
+    _sutScheduler.ScheduleEvery(1s, 1s, [&engine]() { engine.Tick(); });
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    // Much longer than forward delay of the designated port without peer
+    _sutScheduler.RunUntil(1h);
+    const auto wallElapsed = std::chrono::steady_clock::now() - wallStart;
+
+    EXPECT_TRUE(engine.BridgeInstance().GetPort(1)->Forwarding());
+    EXPECT_LT(wallElapsed, 10s);
+}
+
+TEST_F(SchedulerTest, testRunNext_withNotifiedWakeup_shouldRunItsTaskBeforeWaiting) {
+    Wakeup wakeup{};
+    _sutScheduler.SetWakeup(wakeup, [this]() { _trace.push_back(0); });
+    _sutScheduler.ScheduleAt(1s, [this]() { _trace.push_back(1); });
+
+    wakeup.Notify();
+    wakeup.Notify();
+    ASSERT_TRUE(_sutScheduler.RunNext());
+    EXPECT_EQ((std::vector<int>{ 0 }), _trace);
+    EXPECT_EQ(Clock::Duration::zero(), _clock->Now());
+
+    // Notifications are not counted, so the awaited task runs next
+    ASSERT_TRUE(_sutScheduler.RunNext());
+    EXPECT_EQ((std::vector<int>{ 0, 1 }), _trace);
+    EXPECT_EQ(Clock::Duration{ 1s }, _clock->Now());
+}
+
+TEST(SystemClockTest, testWaitUntil_notifiedByAnotherThread_shouldStopWaitingAtOnce) {
+    SystemClock clock{};
+    Wakeup wakeup{};
+    const auto wallStart = std::chrono::steady_clock::now();
+    std::thread notifier{ [&wakeup]() {
+        std::this_thread::sleep_for(10ms);
+        wakeup.Notify();
+    } };
+
+    EXPECT_TRUE(clock.WaitUntil(clock.Now() + 1h, wakeup));
+    notifier.join();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - wallStart, 10s);
+    EXPECT_FALSE(clock.WaitUntil(clock.Now() + 1ms, wakeup));
+}
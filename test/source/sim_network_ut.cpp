@@ -0,0 +1,203 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/sim/network.hpp>
+#include <stp/sim/topology.hpp>
+
+// GTest headers
+#include <gtest/gtest.h>
+
+using namespace Stp;
+using namespace Stp::Sim;
+
+class SimNetworkTest : public ::testing::Test {
+protected:
+    static constexpr u64 _kLimitMs = 120000;
+
+    u32 CountRootPorts(const Network& network) const {
+        u32 rootPorts = 0;
+        const Topology& topology = network.TopologyInstance();
+        for (u32 bridge = 0; bridge < topology.BridgeCount(); ++bridge) {
+            for (const auto& port : network.EngineInstance(bridge).BridgeInstance().AllPorts()) {
+                if (PortRole::Root == port.second->Role()) {
+                    ++rootPorts;
+                }
+            }
+        }
+
+        return rootPorts;
+    }
+
+    /// @return Number of ports which are neither forwarding nor alternate or backup ones
+    u32 CountBlockedPorts(const Network& network) const {
+        u32 blockedPorts = 0;
+        const Topology& topology = network.TopologyInstance();
+        for (u32 bridge = 0; bridge < topology.BridgeCount(); ++bridge) {
+            for (const auto& port : network.EngineInstance(bridge).BridgeInstance().AllPorts()) {
+                const PortRole role = port.second->Role();
+                if ((PortRole::Root == role || PortRole::Designated == role)
+                        && not port.second->Forwarding()) {
+                    ++blockedPorts;
+                }
+            }
+        }
+
+        return blockedPorts;
+    }
+};
+
+TEST_F(SimNetworkTest, testTopology_ring_shouldConnectNeighbours) {
+    const Topology ring = Topology::Ring(5);
+
+    EXPECT_EQ(5u, ring.BridgeCount());
+    ASSERT_EQ(5u, ring.Links().size());
+    for (u32 bridge = 0; bridge < ring.BridgeCount(); ++bridge) {
+        EXPECT_EQ(2u, ring.PortCount(bridge));
+    }
+}
+
+TEST_F(SimNetworkTest, testRunUntilStable_ring_shouldElectSingleRoot) {
+    Network network{ Topology::Ring(6), Config{} };
+
+    const Report report = network.RunUntilStable(_kLimitMs);
+
+    EXPECT_TRUE(report.Converged);
+    EXPECT_EQ(1u, report.RootCount);
+    // Every bridge except the root has exactly one root port
+    EXPECT_EQ(5u, CountRootPorts(network));
+}
+
+TEST_F(SimNetworkTest, testRunUntilStable_pointToPointLinks_shouldConvergeFaster) {
+    Config config{};
+    config.PointToPointLinks = true;
+    Network rapidNetwork{ Topology::Ring(6), config };
+    Network slowNetwork{ Topology::Ring(6), Config{} };
+
+    const Report rapidReport = rapidNetwork.RunUntilStable(_kLimitMs);
+    const Report slowReport = slowNetwork.RunUntilStable(_kLimitMs);
+
+    ASSERT_TRUE(rapidReport.Converged);
+    ASSERT_TRUE(slowReport.Converged);
+    EXPECT_EQ(0u, CountBlockedPorts(rapidNetwork));
+    EXPECT_EQ(5u, CountRootPorts(rapidNetwork));
+    // Proposal and agreement do not wait for expiry of forward delay timers
+    EXPECT_LT(rapidReport.ConvergenceTimeMs, slowReport.ConvergenceTimeMs);
+}
+
+TEST_F(SimNetworkTest, testRunUntilStable_afterLinkFailure_shouldKeepSingleRoot) {
+    Network network{ Topology::FullMesh(4), Config{} };
+    ASSERT_TRUE(network.RunUntilStable(_kLimitMs).Converged);
+
+    ASSERT_EQ(Result::Success, network.FailLink(0));
+    const Report report = network.RunUntilStable(_kLimitMs);
+
+    EXPECT_TRUE(report.Converged);
+    EXPECT_EQ(1u, report.RootCount);
+    EXPECT_EQ(3u, CountRootPorts(network));
+}
+
+TEST_F(SimNetworkTest, testRunUntilStable_afterLinkFailure_shouldFlushFdb) {
+    Network network{ Topology::FullMesh(4), Config{} };
+    ASSERT_TRUE(network.RunUntilStable(_kLimitMs).Converged);
+
+    ASSERT_EQ(Result::Success, network.FailLink(0));
+    const Report report = network.RunUntilStable(_kLimitMs);
+
+    EXPECT_TRUE(report.Converged);
+    EXPECT_LT(0u, report.FdbFlushes);
+}
+
+TEST_F(SimNetworkTest, testRestoreBridge_withBestIdentifier_shouldBecomeRoot) {
+    Network network{ Topology::Ring(5), Config{} };
+    ASSERT_EQ(Result::Success, network.FailBridge(0));
+    ASSERT_TRUE(network.RunUntilStable(_kLimitMs).Converged);
+    EXPECT_EQ(3u, CountRootPorts(network));
+
+    ASSERT_EQ(Result::Success, network.RestoreBridge(0));
+    EXPECT_EQ(Result::Fail, network.RestoreBridge(0));
+    const Report report = network.RunUntilStable(_kLimitMs);
+
+    EXPECT_TRUE(report.Converged);
+    EXPECT_EQ(1u, report.RootCount);
+    EXPECT_EQ(4u, CountRootPorts(network));
+    for (const auto& port : network.EngineInstance(0).BridgeInstance().AllPorts()) {
+        EXPECT_EQ(PortRole::Designated, port.second->Role());
+    }
+}
+
+TEST_F(SimNetworkTest, testRunFor_withHostPort_shouldRunWholePeriod) {
+    Topology topology = Topology::Ring(4);
+    ASSERT_EQ(Result::Success, topology.AttachHost(3));
+    // Shared link of the host becomes edge after max age (17.20.4), so stability is awaited longer
+    Config config{};
+    config.StableWindowMs = 30000;
+    Network network{ topology, config };
+    ASSERT_TRUE(network.RunUntilStable(_kLimitMs).Converged);
+
+    const u64 startMs = network.NowMs();
+    const Report report = network.RunFor(_kLimitMs);
+
+    EXPECT_EQ(startMs + _kLimitMs, network.NowMs());
+    EXPECT_TRUE(report.Converged);
+    EXPECT_EQ(0u, report.ConvergenceTimeMs);
+    // BPDUs sent to host are never delivered
+    EXPECT_LT(0u, report.BpdusLost);
+    EXPECT_EQ(Result::Success, network.FailHostPort(0));
+    EXPECT_EQ(Result::Fail, network.FailHostPort(0));
+    EXPECT_EQ(Result::Success, network.RestoreHostPort(0));
+}
+
+TEST_F(SimNetworkTest, testRunUntilStable_sameSeed_shouldGiveSameResults) {
+    Config config{};
+    config.Seed = 7;
+    Network first{ Topology::Random(30, 3, config.Seed), config };
+    Network second{ Topology::Random(30, 3, config.Seed), config };
+
+    const Report firstReport = first.RunUntilStable(_kLimitMs);
+    const Report secondReport = second.RunUntilStable(_kLimitMs);
+
+    EXPECT_EQ(firstReport.ConvergenceTimeMs, secondReport.ConvergenceTimeMs);
+    EXPECT_EQ(firstReport.BpdusSent, secondReport.BpdusSent);
+    EXPECT_EQ(firstReport.Events, secondReport.Events);
+    EXPECT_EQ(first.NowMs(), second.NowMs());
+}
+
+TEST_F(SimNetworkTest, testRunUntilStable_manyWorkers_shouldGiveSameResultsAsSingleWorker) {
+    Topology topology = Topology::Random(60, 4, 3);
+    topology.SetLinkParams(2, 10000, 0.05);
+    Config config{};
+    Network single{ topology, config };
+    config.Workers = 4;
+    Network parallel{ topology, config };
+    ASSERT_EQ(4u, parallel.WorkerCount());
+
+    for (u32 phase = 0; phase < 2; ++phase) {
+        const Report singleReport = single.RunUntilStable(_kLimitMs);
+        const Report parallelReport = parallel.RunUntilStable(_kLimitMs);
+
+        EXPECT_EQ(singleReport.Converged, parallelReport.Converged);
+        EXPECT_EQ(singleReport.ConvergenceTimeMs, parallelReport.ConvergenceTimeMs);
+        EXPECT_EQ(singleReport.BpdusSent, parallelReport.BpdusSent);
+        EXPECT_EQ(singleReport.BpdusDelivered, parallelReport.BpdusDelivered);
+        EXPECT_EQ(singleReport.BpdusLost, parallelReport.BpdusLost);
+        EXPECT_EQ(singleReport.FdbFlushes, parallelReport.FdbFlushes);
+        EXPECT_EQ(singleReport.Events, parallelReport.Events);
+        EXPECT_EQ(single.NowMs(), parallel.NowMs());
+
+        for (u32 bridge = 0; bridge < topology.BridgeCount(); ++bridge) {
+            const Bridge& singleBridge = single.EngineInstance(bridge).BridgeInstance();
+            const Bridge& parallelBridge = parallel.EngineInstance(bridge).BridgeInstance();
+            EXPECT_TRUE(singleBridge.RootPriority() == parallelBridge.RootPriority());
+            for (const auto& port : singleBridge.AllPorts()) {
+                EXPECT_EQ(port.second->Role(), parallelBridge.GetPort(port.first)->Role());
+            }
+        }
+
+        ASSERT_EQ(Result::Success, single.FailBridge(phase));
+        ASSERT_EQ(Result::Success, parallel.FailBridge(phase));
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/sm_conditions.hpp>
+#include <stp/time.hpp>
+// UT dependencies
+#include "sut_bridge.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+using namespace Stp;
+
+namespace {
+
+/// @brief RST BPDU of the designated port which conveys its priority vector and times
+Bpdu DesignatedBpdu(const PriorityVector& priority, const Time& times) {
+    Bpdu bpdu{};
+    bpdu.SetBpduType(+Bpdu::Type::Rst);
+    bpdu.SetPortRoleFlag(PortRole::Designated);
+    bpdu.SetRootIdentifier(priority.RootBridgeId().ConvertToBpduData());
+    bpdu.SetRootPathCost(priority.RootPathCost().Value());
+    bpdu.SetBridgeIdentifier(priority.DesignatedBridgeId().ConvertToBpduData());
+    bpdu.SetPortIdentifier(priority.DesignatedPortId().ConvertToBpduData());
+    bpdu.SetMessageAge(Time::ToBpduUnits(times.MessageAge()));
+    bpdu.SetMaxAge(Time::ToBpduUnits(times.MaxAge()));
+    bpdu.SetHelloTime(Time::ToBpduUnits(times.HelloTime()));
+    bpdu.SetForwardDelay(Time::ToBpduUnits(times.ForwardDelay()));
+    return bpdu;
+}
+
+} // namespace
+
+class SmConditionsTest : public SutBridgeTest {};
+
+TEST_F(SmConditionsTest, testRcvInfo_withWorseInfoOfSameDesignatedPort_shouldBeSuperior) {
+    Port& port = AddRootPort(1);
+    // 17.6, the designated port replaces its own information, even if the new one is worse
+    const BridgeId worseRootId = MakeBridgeId(4096, 0x03);
+    port.SetRxBpdu(DesignatedBpdu(MakePriority(worseRootId, SutPortPathCost, _rootId, 1),
+                                  port.PortTimes()));
+
+    EXPECT_EQ(Port::RcvdInfo::SuperiorDesignatedInfo, SmConditions::RcvInfo(port));
+
+    port.SetRxBpdu(DesignatedBpdu(MakePriority(worseRootId, SutPortPathCost, _rootId, 2),
+                                  port.PortTimes()));
+
+    EXPECT_EQ(Port::RcvdInfo::InferiorDesignatedInfo, SmConditions::RcvInfo(port));
+}
+
+TEST_F(SmConditionsTest, testReRooted_shouldCheckRrWhileOfOtherPortsOnly) {
+    Port& port = AddPort(1);
+    AddPort(2);
+    Port& recentRootPort = AddPort(3);
+    // rrWhile of the port itself runs while it becomes the root port
+    port.SmTimersInstance().SetRrWhile(SmParams::FwdDelay(port));
+    recentRootPort.SmTimersInstance().SetRrWhile(SmParams::FwdDelay(recentRootPort));
+
+    EXPECT_FALSE(SmConditions::ReRooted(*_bridge, port));
+
+    recentRootPort.SmTimersInstance().SetRrWhile(0);
+
+    EXPECT_TRUE(SmConditions::ReRooted(*_bridge, port));
+}
+
+TEST_F(SmConditionsTest, testRcvInfo_withInfoOfOtherPortOfSameBridge_shouldBeInferior) {
+    Port& port = AddRootPort(1);
+    // Port identifiers are equal only if both their priorities and port numbers are equal
+    EXPECT_FALSE(MakePortId(1) == MakePortId(2));
+
+    port.SetRxBpdu(DesignatedBpdu(MakePriority(_rootId, 0, _rootId, 2), port.PortTimes()));
+
+    EXPECT_EQ(Port::RcvdInfo::InferiorDesignatedInfo, SmConditions::RcvInfo(port));
+
+    port.SetRxBpdu(DesignatedBpdu(MakePriority(_rootId, 0, _rootId, 1), port.PortTimes()));
+
+    EXPECT_EQ(Port::RcvdInfo::RepeatedDesignatedInfo, SmConditions::RcvInfo(port));
+}
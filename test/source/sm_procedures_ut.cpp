@@ -0,0 +1,136 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/sm_procedures.hpp>
+// UT dependencies
+#include "sut_bridge.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+using namespace Stp;
+
+class SmProceduresTest : public SutBridgeTest {};
+
+TEST_F(SmProceduresTest,
+       testUpdtRolesTree_withInfoReflectedByThisBridge_shouldSelectBackupRole) {
+    AddRootPort(1);
+    AddPort(2).SetInfoIs(Port::Info::Mine);
+    // Port 3 is attached to the LAN of the designated port 2. Information of port 2 has not been
+    // updated yet, so only the designated bridge tells that the information is reflected.
+    Port& backupPort = AddPort(3);
+    backupPort.SetInfoIs(Port::Info::Received);
+    backupPort.SetPortPriority(MakePriority(_rootId, SutPortPathCost,
+                                            _bridge->BridgeIdentifier(), 2));
+
+    SmProcedures::UpdtRolesTree(*_bridge);
+
+    EXPECT_EQ(1u, _bridge->RootPortId().PortNum());
+    EXPECT_EQ(PortRole::Root, _bridge->GetPort(1)->SelectedRole());
+    EXPECT_EQ(PortRole::Designated, _bridge->GetPort(2)->SelectedRole());
+    EXPECT_EQ(PortRole::Backup, backupPort.SelectedRole());
+    EXPECT_FALSE(backupPort.UpdtInfo());
+}
+
+TEST_F(SmProceduresTest,
+       testUpdtRolesTree_withNotWorseInfoOfOtherBridge_shouldSelectAlternateRole) {
+    AddRootPort(1);
+    Port& alternatePort = AddPort(2);
+    alternatePort.SetInfoIs(Port::Info::Received);
+    alternatePort.SetPortPriority(MakePriority(_rootId, SutPortPathCost,
+                                               MakeBridgeId(4096, 0x03), 1));
+
+    SmProcedures::UpdtRolesTree(*_bridge);
+
+    EXPECT_EQ(PortRole::Root, _bridge->GetPort(1)->SelectedRole());
+    EXPECT_EQ(PortRole::Alternate, alternatePort.SelectedRole());
+}
+
+TEST_F(SmProceduresTest, testRecordAgreement_withAgreementInRstBpdu_shouldSetAgreed) {
+    Port& port = AddPort(1);
+    port.SetOperPointToPointMAC(true);
+    port.SetProposing(true);
+    // Port Receive machine has already cleared rcvdBpdu, so only type of the BPDU is checked
+    Bpdu bpdu{};
+    bpdu.SetBpduType(+Bpdu::Type::Rst);
+    bpdu.SetAgreementFlag();
+    port.SetRxBpdu(bpdu);
+
+    SmProcedures::RecordAgreement(*_bridge, port);
+
+    EXPECT_TRUE(port.Agreed());
+    EXPECT_FALSE(port.Proposing());
+
+    // 17.21.9, Configuration BPDU never conveys the agreement
+    bpdu.SetBpduType(+Bpdu::Type::Config);
+    port.SetRxBpdu(bpdu);
+
+    SmProcedures::RecordAgreement(*_bridge, port);
+
+    EXPECT_FALSE(port.Agreed());
+}
+
+TEST_F(SmProceduresTest, testRecordProposal_withProposalOfDesignatedPort_shouldSetProposed) {
+    Port& port = AddPort(1);
+    Bpdu bpdu{};
+    bpdu.SetBpduType(+Bpdu::Type::Config);
+    bpdu.SetPortRoleFlag(PortRole::Designated);
+    bpdu.SetProposalFlag();
+    port.SetRxBpdu(bpdu);
+
+    // 17.21.11, only RST BPDU conveys the proposal
+    SmProcedures::RecordProposal(port);
+
+    EXPECT_FALSE(port.Proposed());
+
+    bpdu.SetBpduType(+Bpdu::Type::Rst);
+    port.SetRxBpdu(bpdu);
+
+    SmProcedures::RecordProposal(port);
+
+    EXPECT_TRUE(port.Proposed());
+}
+
+TEST_F(SmProceduresTest, testRecordDispute_withLearningFlagInRstBpdu_shouldSetAgreed) {
+    Port& port = AddPort(1);
+    port.SetProposing(true);
+    Bpdu bpdu{};
+    bpdu.SetBpduType(+Bpdu::Type::Config);
+    bpdu.SetLearnigFlag();
+    port.SetRxBpdu(bpdu);
+
+    // 17.21.10, flags of Configuration BPDU are not taken as the dispute
+    SmProcedures::RecordDispute(port);
+
+    EXPECT_FALSE(port.Agreed());
+    EXPECT_TRUE(port.Proposing());
+
+    bpdu.SetBpduType(+Bpdu::Type::Rst);
+    port.SetRxBpdu(bpdu);
+
+    SmProcedures::RecordDispute(port);
+
+    EXPECT_TRUE(port.Agreed());
+    EXPECT_FALSE(port.Proposing());
+}
+
+TEST_F(SmProceduresTest, testFlushFdb_withFlushedEntries_shouldResetFdbFlush) {
+    Port& port = AddPort(1);
+    EXPECT_CALL(*_outInterface, FlushFdb(1)).Times(::testing::Exactly(2))
+            .WillOnce(::testing::Return(Result::Success))
+            .WillOnce(::testing::Return(Result::Fail));
+
+    // Otherwise Topology Change machine would never leave INACTIVE state
+    SmProcedures::FlushFdb(*_bridge, port);
+
+    EXPECT_FALSE(port.FdbFlush());
+
+    // Entries which have not been removed are still to be flushed
+    SmProcedures::FlushFdb(*_bridge, port);
+
+    EXPECT_TRUE(port.FdbFlush());
+}
@@ -0,0 +1,189 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bpdu.hpp>
+#include <stp/bridge.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/port.hpp>
+#include <stp/port_id.hpp>
+#include <stp/state_image.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C Standard Library
+#include <cstdio>
+#include <cstring>
+
+// C++ Standard Library
+#include <chrono>
+#include <fstream>
+#include <string>
+
+using namespace Stp;
+
+namespace {
+
+/// @brief Checks that the active slot of the image holds current state of every port
+void ExpectMirroredPorts(const std::string& path, const Bridge& bridge) {
+    StateImage image{};
+    ASSERT_EQ(Result::Success, image.Open(path));
+    const StateImage::SlotHeader* const slot = image.ActiveSlot();
+    ASSERT_NE(nullptr, slot);
+    ASSERT_EQ(bridge.AllPorts().size(), slot->PortCount);
+    const StateImage::PortRecord* record = image.Ports(*slot);
+    for (const auto& bridgePort : bridge.AllPorts()) {
+        // States of machines are not kept by the port, so they are taken from the record
+        StateImage::PortRecord expected = *record;
+        StateImage::SavePort(*bridgePort.second, expected);
+        EXPECT_EQ(bridgePort.first, record->PortNo);
+        EXPECT_EQ(0, std::memcmp(&expected, record, sizeof(expected)))
+                << "Port " << bridgePort.first;
+        ++record;
+    }
+}
+
+} // namespace
+
+class StateImageTest : public ::testing::Test {
+protected:
+    StateImageTest()
+        : _path{ ::testing::TempDir() + "stp_state_image_ut.img" },
+          _clock{ std::make_shared<VirtualClock>() },
+          _outInterface{ std::make_shared<CountingOutInterface>() },
+          _sutEngine{ Mac{}, MakeSutSystem(_outInterface, _clock) } {
+        std::remove(_path.c_str());
+    }
+
+    ~StateImageTest() override {
+        std::remove(_path.c_str());
+    }
+
+    std::string _path;
+    Sptr<VirtualClock> _clock;
+    Sptr<CountingOutInterface> _outInterface;
+    Engine _sutEngine;
+};
+
+TEST_F(StateImageTest, testRestoreStateImage_shouldContinueWithoutTouchingForwarding) {
+    ASSERT_EQ(Result::Success, _sutEngine.StartStateImage(_path));
+    ASSERT_EQ(Result::Success, _sutEngine.AddPorts({ { 1, 1000, true }, { 2, 1000, true },
+                                                     { 3, 1000, true } }));
+    Converge(_sutEngine, *_clock, 40000);
+    const auto before = _sutEngine.ReadSnapshot();
+    ASSERT_EQ(PortRole::Root, before->FindPort(1)->Role);
+    ASSERT_TRUE(before->FindPort(1)->Forwarding);
+    ASSERT_TRUE(before->FindPort(3)->Forwarding);
+
+    // The RSTP is started again one second later
+    auto restartedClock = std::make_shared<VirtualClock>(_clock->Now()
+                                                         + std::chrono::seconds{ 1 });
+    auto restartedOut = std::make_shared<CountingOutInterface>();
+    Engine restartedEngine{ Mac{}, MakeSutSystem(restartedOut, restartedClock) };
+    ASSERT_EQ(Result::Success, restartedEngine.RestoreStateImage(_path));
+
+    const auto after = restartedEngine.ReadSnapshot();
+    ASSERT_EQ(before->Ports.size(), after->Ports.size());
+    EXPECT_TRUE(before->RootPriority == after->RootPriority);
+    EXPECT_EQ(before->RootPortId.PortNum(), after->RootPortId.PortNum());
+    for (std::size_t idx = 0; idx < before->Ports.size(); ++idx) {
+        EXPECT_EQ(before->Ports[idx].PortNo, after->Ports[idx].PortNo);
+        EXPECT_EQ(before->Ports[idx].Role, after->Ports[idx].Role);
+        EXPECT_EQ(before->Ports[idx].Forwarding, after->Ports[idx].Forwarding);
+        EXPECT_TRUE(before->Ports[idx].PortPriority == after->Ports[idx].PortPriority);
+    }
+
+    // Timers are advanced by time elapsed since the image has been written
+    EXPECT_EQ(before->FindPort(1)->Timers.RcvdInfoWhile() - 1000,
+              after->FindPort(1)->Timers.RcvdInfoWhile());
+
+    Converge(restartedEngine, *restartedClock, 10000);
+    const auto converged = restartedEngine.ReadSnapshot();
+    EXPECT_EQ(PortRole::Root, converged->FindPort(1)->Role);
+    EXPECT_EQ(PortRole::Alternate, converged->FindPort(2)->Role);
+    EXPECT_TRUE(converged->FindPort(1)->Forwarding);
+    EXPECT_TRUE(converged->FindPort(3)->Forwarding);
+    EXPECT_EQ(0u, restartedOut->Calls);
+}
+
+TEST_F(StateImageTest, testStartStateImage_changesOfFewPorts_shouldMirrorCurrentPorts) {
+    ASSERT_EQ(Result::Success, _sutEngine.StartStateImage(_path));
+    // Adding of ports one by one writes only records of added ports
+    for (const u16 portNo : { 6, 2, 8, 1, 4, 7, 3, 5 }) {
+        ASSERT_EQ(Result::Success, _sutEngine.AddPort(portNo, 1000, true));
+        ExpectMirroredPorts(_path, _sutEngine.BridgeInstance());
+    }
+
+    Converge(_sutEngine, *_clock, 5000);
+    ExpectMirroredPorts(_path, _sutEngine.BridgeInstance());
+
+    // Repeated BPDU refreshes information of the root port only
+    for (u32 tick = 0; tick < 3; ++tick) {
+        _clock->Advance(std::chrono::seconds{ 1 });
+        _sutEngine.Tick();
+        for (u32 repetition = 0; repetition < 2; ++repetition) {
+            ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(1, RootBpdu(1)));
+            _sutEngine.Evaluate();
+            ExpectMirroredPorts(_path, _sutEngine.BridgeInstance());
+        }
+    }
+
+    for (const u16 portNo : { 4, 8 }) {
+        ASSERT_EQ(Result::Success, _sutEngine.RemovePort(portNo));
+        ExpectMirroredPorts(_path, _sutEngine.BridgeInstance());
+    }
+
+    ASSERT_EQ(Result::Success, _sutEngine.AddPort(4, 100, false));
+    ExpectMirroredPorts(_path, _sutEngine.BridgeInstance());
+}
+
+TEST_F(StateImageTest, testRestoreStateImage_imageOfOtherBridgeOrUsedEngine_shouldFail) {
+    EXPECT_EQ(Result::Fail, _sutEngine.RestoreStateImage(_path));
+
+    ASSERT_EQ(Result::Success, _sutEngine.StartStateImage(_path));
+    ASSERT_EQ(Result::Success, _sutEngine.AddPort(1, 1000, true));
+    _sutEngine.StopStateImage();
+
+    Engine otherEngine{ Mac{ Bpdu::BridgeSystemIdHandler{ { 0x00, 0x00, 0x00, 0x00, 0x00,
+                                                            0x02 } } },
+                        MakeSutSystem(_outInterface, _clock) };
+    EXPECT_EQ(Result::Fail, otherEngine.RestoreStateImage(_path));
+    EXPECT_EQ(Result::Fail, _sutEngine.RestoreStateImage(_path));
+
+    // Image written later than now has been written before restart of the clock
+    Engine rebootedEngine{ Mac{},
+                           MakeSutSystem(_outInterface, std::make_shared<VirtualClock>()) };
+    _clock->Advance(std::chrono::seconds{ 1 });
+    ASSERT_EQ(Result::Success, _sutEngine.StartStateImage(_path));
+    EXPECT_EQ(Result::Fail, rebootedEngine.RestoreStateImage(_path));
+}
+
+TEST_F(StateImageTest, testOpen_incompatibleLayout_shouldFail) {
+    {
+        std::ofstream file{ _path, std::ios::binary };
+        const u32 header[] = { StateImage::Magic, StateImage::LayoutVersion + 1, 0, 0, 0, 0 };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    StateImage sutImage{};
+    EXPECT_EQ(Result::Fail, sutImage.Open(_path));
+
+    // The incompatible file is replaced once the first image is complete
+    ASSERT_EQ(Result::Success, sutImage.Create(_path, 4));
+    EXPECT_EQ(Result::Fail, StateImage{}.Open(_path));
+    StateImage::SlotHeader& slot = sutImage.InactiveSlot();
+    slot.PortCount = 0;
+    sutImage.Commit(slot);
+
+    StateImage readImage{};
+    ASSERT_EQ(Result::Success, readImage.Open(_path));
+    ASSERT_NE(nullptr, readImage.ActiveSlot());
+    EXPECT_EQ(1u, readImage.ActiveSlot()->Generation);
+}
@@ -0,0 +1,92 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include <stp/bridge.hpp>
+#include <stp/bridge_id.hpp>
+#include <stp/port.hpp>
+#include <stp/port_id.hpp>
+#include <stp/priority_vector.hpp>
+#include <stp/system.hpp>
+
+// UT dependencies
+#include <mock/logger.hpp>
+#include <mock/management.hpp>
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <memory>
+
+/// @brief Path cost of every port added by SutBridgeTest
+constexpr Stp::u32 SutPortPathCost = 20000;
+
+inline Stp::BridgeId MakeBridgeId(const Stp::u16 priority, const Stp::u8 addrLastOctet) {
+    Stp::BridgeId bridgeId{};
+    bridgeId.SetPriority(priority);
+    bridgeId.SetAddress(Stp::Mac{ Stp::Bpdu::BridgeSystemIdHandler{ { 0x00, 0x00, 0x00, 0x00,
+                                                                      0x00, addrLastOctet } } });
+    return bridgeId;
+}
+
+inline Stp::PortId MakePortId(const Stp::u16 portNo) {
+    using namespace Stp;
+    PortId portId{};
+    portId.SetPriority(+PriorityVector::RecommendedPortPriority::Value);
+    portId.SetPortNum(portNo);
+    return portId;
+}
+
+inline Stp::PriorityVector MakePriority(const Stp::BridgeId& rootId, const Stp::u32 rootPathCost,
+                                        const Stp::BridgeId& designatedId,
+                                        const Stp::u16 designatedPortNo) {
+    Stp::PathCost pathCost{};
+    pathCost.SetPathCost(rootPathCost);
+    return Stp::PriorityVector{ rootId, pathCost, designatedId, MakePortId(designatedPortNo) };
+}
+
+/**
+ * @brief The SutBridgeTest class keeps the bridge under test without state machines, so tests
+ *        might set variables of its ports and call procedures and conditions of 17.21 directly
+ */
+class SutBridgeTest : public ::testing::Test {
+protected:
+    SutBridgeTest()
+        : _outInterface{ std::make_shared<Mock::OutInterface>() },
+          _bridge{ std::make_shared<Stp::Bridge>(std::make_shared<Stp::System>(
+                                                     _outInterface,
+                                                     std::make_shared<Mock::Logger>())) },
+          _rootId{ MakeBridgeId(0, 0x01) } {
+        _bridge->SetBridgeIdentifier(MakeBridgeId(32768, 0x02));
+        _bridge->GetBridgePriority().SetRootBridgeId(_bridge->BridgeIdentifier());
+        _bridge->GetBridgePriority().SetDesignatedBridgeId(_bridge->BridgeIdentifier());
+    }
+
+    Stp::Port& AddPort(const Stp::u16 portNo) {
+        Stp::PortH port = std::make_shared<Stp::Port>();
+        port->SetPortId(MakePortId(portNo));
+        port->GetPortPathCost().SetPathCost(SutPortPathCost);
+        port->SetPortEnabled(true);
+        _bridge->AddPort(portNo, port);
+        return *port;
+    }
+
+    /// @brief Port receives information of the root bridge from its designated port
+    Stp::Port& AddRootPort(const Stp::u16 portNo) {
+        Stp::Port& port = AddPort(portNo);
+        port.SetInfoIs(Stp::Port::Info::Received);
+        port.SetPortPriority(MakePriority(_rootId, 0, _rootId, 1));
+        return port;
+    }
+
+    Stp::Sptr<Mock::OutInterface> _outInterface;
+    Stp::BridgeH _bridge;
+    /// @brief Identifier of the root bridge, better than the one of the bridge under test
+    Stp::BridgeId _rootId;
+};
@@ -0,0 +1,132 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+#pragma once
+
+// This project's headers
+#include <stp/bpdu.hpp>
+#include <stp/bridge_id.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/port_id.hpp>
+#include <stp/system.hpp>
+#include <stp/time.hpp>
+
+// UT dependencies
+#include <mock/logger.hpp>
+
+// C++ Standard Library
+#include <chrono>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief The CountingOutInterface class accepts every call of the engine under test and counts
+ *        them, so tests might check whether hardware has been touched
+ */
+class CountingOutInterface : public Stp::OutInterface {
+public:
+    Stp::Result FlushFdb(const Stp::u16) noexcept override {
+        ++Calls;
+        return Stp::Result::Success;
+    }
+
+    Stp::Result SetForwarding(const Stp::u16, const bool) noexcept override {
+        ++Calls;
+        return Stp::Result::Success;
+    }
+
+    Stp::Result SetLearning(const Stp::u16, const bool) noexcept override {
+        ++Calls;
+        return Stp::Result::Success;
+    }
+
+    Stp::Result SendOutBpdu(const Stp::u16, Stp::ByteStreamH) noexcept override {
+        ++TxBpdus;
+        return Stp::Result::Success;
+    }
+
+    /// @brief Number of calls which change forwarding state of hardware
+    Stp::u32 Calls = 0;
+    Stp::u64 TxBpdus = 0;
+};
+
+/**
+ * @brief The CapturingOutInterface class keeps also every transmitted BPDU
+ */
+class CapturingOutInterface : public CountingOutInterface {
+public:
+    Stp::Result SendOutBpdu(const Stp::u16 portNo, Stp::ByteStreamH data) noexcept override {
+        Sent.push_back({ portNo, data });
+        return CountingOutInterface::SendOutBpdu(portNo, data);
+    }
+
+    struct SentBpdu {
+        Stp::u16 PortNo;
+        Stp::ByteStreamH Data;
+    };
+
+    std::vector<SentBpdu> Sent;
+};
+
+/// @return System of the engine under test, which logs nothing
+inline Stp::SystemH MakeSutSystem(Stp::OutInterfaceH outInterface, Stp::ClockH clock) {
+    return std::make_shared<Stp::System>(outInterface, std::make_shared<Mock::Logger>(), clock);
+}
+
+/// @return System of the engine under test, which ignores hardware and logs nothing
+inline Stp::SystemH MakeSutSystem(Stp::ClockH clock) {
+    return MakeSutSystem(std::make_shared<CountingOutInterface>(), clock);
+}
+
+/**
+ * @brief RootBpdu encodes designated information of the root bridge better than the tested one
+ * @param designatedPortNo port of the root bridge which sends the BPDU
+ * @param rootPriority priority of the root bridge, lower than priority of the tested one
+ * @param helloTimeMs hello time advertised by the root bridge
+ */
+inline Stp::ByteStream RootBpdu(const Stp::u16 designatedPortNo, const Stp::u16 rootPriority = 0,
+                                const Stp::u32 helloTimeMs = 2000) {
+    using namespace Stp;
+    BridgeId rootId{};
+    rootId.SetPriority(rootPriority);
+    rootId.SetAddress(Mac{ Bpdu::BridgeSystemIdHandler{ { 0x00, 0x00, 0x00, 0x00, 0x00,
+                                                          0x01 } } });
+    PortId portId{};
+    portId.SetPortNum(designatedPortNo);
+    Bpdu bpdu{};
+    bpdu.SetProtocolVersionIdentifier(+Bpdu::ProtocolVersionIdentifier::Rst);
+    bpdu.SetBpduType(+Bpdu::Type::Rst);
+    bpdu.SetPortRoleFlag(PortRole::Designated);
+    bpdu.SetRootIdentifier(rootId.ConvertToBpduData());
+    bpdu.SetBridgeIdentifier(rootId.ConvertToBpduData());
+    bpdu.SetPortIdentifier(portId.ConvertToBpduData());
+    bpdu.SetMaxAge(20 * Time::BpduUnitsPerSecond);
+    bpdu.SetHelloTime(Time::ToBpduUnits(helloTimeMs));
+    bpdu.SetForwardDelay(15 * Time::BpduUnitsPerSecond);
+
+    ByteStream data{};
+    bpdu.Encode(data);
+    return data;
+}
+
+/**
+ * @brief Converge runs the engine as StpManager does, while the root bridge is reached through
+ *        ports 1 and 2
+ * @param bpduPeriodTicks ticks between BPDUs received from the root bridge
+ */
+inline void Converge(Stp::Engine& engine, Stp::VirtualClock& clock, const Stp::u32 durationMs,
+                     const Stp::u32 bpduPeriodTicks = 1) {
+    for (Stp::u32 elapsedMs = 0; elapsedMs < durationMs; elapsedMs += engine.TickIntervalMs()) {
+        if (0 == (elapsedMs / engine.TickIntervalMs()) % bpduPeriodTicks) {
+            engine.ProcessBpdu(1, RootBpdu(1));
+            engine.ProcessBpdu(2, RootBpdu(2));
+        }
+
+        clock.Advance(std::chrono::milliseconds{ engine.TickIntervalMs() });
+        engine.Tick();
+    }
+}
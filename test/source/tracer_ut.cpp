@@ -0,0 +1,137 @@
+/**
+ * @author Pawel Maslanka (pawmas)
+ *
+ * Contact: pawmas@hotmail.com
+ */
+
+// Tested project's headers
+#include <stp/bridge_id.hpp>
+#include <stp/clock.hpp>
+#include <stp/engine.hpp>
+#include <stp/port_id.hpp>
+#include <stp/tracer.hpp>
+// UT dependencies
+#include "sut_engine.hpp"
+
+// GTest headers
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+using namespace Stp;
+using namespace std::chrono_literals;
+
+class TracerTest : public ::testing::Test {
+protected:
+    TracerTest()
+        : _clock{ std::make_shared<VirtualClock>() },
+          _sutEngine{ Mac{}, MakeSutSystem(_clock) } {
+        _sutEngine.AddPort(1, 1000, true);
+        _sutEngine.AddPort(2, 1000, true);
+    }
+
+    void Tick(const u32 ticks) {
+        for (u32 tick = 0; tick < ticks; ++tick) {
+            _clock->Advance(1s);
+            _sutEngine.Tick();
+        }
+    }
+
+    /// @brief Designated information of root bridge better than the tested one
+    ByteStream SuperiorBpdu() const {
+        BridgeId rootId{};
+        rootId.SetPriority(0);
+        PortId portId{};
+        portId.SetPortNum(1);
+        Bpdu bpdu{};
+        bpdu.SetProtocolVersionIdentifier(+Bpdu::ProtocolVersionIdentifier::Rst);
+        bpdu.SetBpduType(+Bpdu::Type::Rst);
+        bpdu.SetPortRoleFlag(PortRole::Designated);
+        bpdu.SetRootIdentifier(rootId.ConvertToBpduData());
+        bpdu.SetBridgeIdentifier(rootId.ConvertToBpduData());
+        bpdu.SetPortIdentifier(portId.ConvertToBpduData());
+        bpdu.SetMaxAge(20 * Time::BpduUnitsPerSecond);
+        bpdu.SetHelloTime(2 * Time::BpduUnitsPerSecond);
+        bpdu.SetForwardDelay(15 * Time::BpduUnitsPerSecond);
+
+        ByteStream data{};
+        bpdu.Encode(data);
+        return data;
+    }
+
+    std::size_t CountEvents(const TraceEvent event) const {
+        const std::vector<TraceRecord> records = _sutEngine.BridgeInstance().TracerInstance()
+                                                     .Records();
+        return static_cast<std::size_t>(std::count_if(records.begin(), records.end(),
+                                                      [event](const TraceRecord& record) {
+            return event == record.Event;
+        }));
+    }
+
+    Sptr<VirtualClock> _clock;
+    Engine _sutEngine;
+};
+
+TEST_F(TracerTest, testRecords_whenTracingDisabled_shouldBeEmpty) {
+    Tick(5);
+
+    EXPECT_TRUE(_sutEngine.BridgeInstance().TracerInstance().Records().empty());
+    EXPECT_EQ(0u, _sutEngine.BridgeInstance().TracerInstance().Recorded());
+}
+
+TEST_F(TracerTest, testRecords_afterSuperiorBpdu_shouldContainEveryKindOfEvent) {
+    ASSERT_EQ(Result::Success, _sutEngine.StartTrace(4096, false));
+    Tick(3);
+    ASSERT_EQ(Result::Success, _sutEngine.ProcessBpdu(1, SuperiorBpdu()));
+    _sutEngine.Evaluate();
+    Tick(40);
+    _sutEngine.StopTrace();
+
+    EXPECT_LT(0u, CountEvents(TraceEvent::StateChange));
+    EXPECT_EQ(1u, CountEvents(TraceEvent::BpduRx));
+    EXPECT_LT(0u, CountEvents(TraceEvent::BpduTx));
+    EXPECT_LT(0u, CountEvents(TraceEvent::TimerExpiry));
+    EXPECT_LT(0u, CountEvents(TraceEvent::HardwareCall));
+
+    const u64 recorded = _sutEngine.BridgeInstance().TracerInstance().Recorded();
+    Tick(5);
+    EXPECT_EQ(recorded, _sutEngine.BridgeInstance().TracerInstance().Recorded());
+
+    std::ostringstream json{};
+    _sutEngine.WriteTrace(json);
+    EXPECT_EQ(0u, json.str().find("{\"displayTimeUnit\":\"ms\""));
+    EXPECT_NE(std::string::npos, json.str().find("\"name\":\"Rx RST\""));
+    EXPECT_NE(std::string::npos, json.str().find("\"name\":\"SetForwarding\""));
+    EXPECT_NE(std::string::npos, json.str().find("\"args\":{\"name\":\"Port 1\"}"));
+    EXPECT_EQ(std::string::npos, json.str().find("\"ph\":\"X\""));
+}
+
+TEST_F(TracerTest, testWriteChromeTrace_withStateSpans_shouldExportDurations) {
+    ASSERT_EQ(Result::Success, _sutEngine.StartTrace(4096, true));
+    Tick(40);
+
+    std::ostringstream json{};
+    _sutEngine.WriteTrace(json);
+    EXPECT_NE(std::string::npos, json.str().find("\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, json.str().find("\"dur\":"));
+}
+
+TEST_F(TracerTest, testRecords_whenBufferFull_shouldKeepNewestEvents) {
+    ASSERT_EQ(Result::Fail, _sutEngine.StartTrace(0, false));
+    ASSERT_EQ(Result::Success, _sutEngine.StartTrace(8, false));
+    Tick(40);
+
+    const Tracer& tracer = _sutEngine.BridgeInstance().TracerInstance();
+    const std::vector<TraceRecord> records = tracer.Records();
+    ASSERT_EQ(8u, records.size());
+    EXPECT_LT(8u, tracer.Recorded());
+    EXPECT_TRUE(std::is_sorted(records.begin(), records.end(),
+                               [](const TraceRecord& lhs, const TraceRecord& rhs) {
+        return lhs.TimeNs < rhs.TimeNs;
+    }));
+    // Hello is sent out every two seconds, so the newest events come from the last ticks
+    EXPECT_LE(static_cast<u64>((_clock->Now() - 2s).count()), records.front().TimeNs);
+}